@@ -1,42 +1,82 @@
+#include <string.h>
 #include "nxtiot_board.h"
 #include "gpio.h"
-#include "uart.h"
-#include "sigfox_wisol.h"
+#include "tick.h"
+#include "soft_uart.h"
+#include "console.h"
 
-uint8_t serialAvailable = 0;
+// Time the LED is on after a press, in milliseconds
+#define LED_ON_MS   1000UL
 
-int main(void)
+static uint8_t led_on;
+static uint32_t led_since;
+
+static void
+led(uint8_t argc, char* argv[])
+{
+    if ( (argc == 2) && (strcmp(argv[1], "on") == 0) )
+    {
+        gpio_write_pin(LED_PORT, LED_PIN, GPIO_PIN_HIGH);
+    }
+    else if ( (argc == 2) && (strcmp(argv[1], "off") == 0) )
+    {
+        gpio_write_pin(LED_PORT, LED_PIN, GPIO_PIN_LOW);
+    }
+    else
+    {
+        soft_uart_send("usage: led on|off\r\n");
+    }
+}
+
+static void
+button(uint8_t argc, char* argv[])
+{
+    if (gpio_read_pin(SW_PORT, SW_PIN) == GPIO_PIN_LOW)
+    {
+        soft_uart_send("pressed\r\n");
+    }
+    else
+    {
+        soft_uart_send("released\r\n");
+    }
+}
+
+static const console_command commands[] PROGMEM =
 {
-    char fooStr[] = "Hello from NXTIOT board!\n";
-    char str[20];
+    {"led", led},
+    {"button", button}
+};
 
+int main(void)
+{
     gpio_init_pin(LED_PORT, LED_PIN, GPIO_PIN_OUTPUT);
     gpio_init_pin(SW_PORT, SW_PIN, GPIO_PIN_INPUT);
     gpio_write_pin(LED_PORT, LED_PIN, GPIO_PIN_LOW);
 
+    // The console uses the software UART, the UART is kept for the Wisol
+    // module
+    tick_init();
+    soft_uart_init();
+    sei();
+
+    soft_uart_send("Hello from NXTIOT board!\r\n");
+    console_init(commands, sizeof(commands) / sizeof(commands[0]));
+
     while (1)
     {
-        if (gpio_read_pin(SW_PORT, SW_PIN) == GPIO_PIN_LOW)
+        // The LED is timed with the tick, the console keeps running
+        if ( !led_on && (gpio_read_pin(SW_PORT, SW_PIN) == GPIO_PIN_LOW) )
         {
             gpio_write_pin(LED_PORT, LED_PIN, GPIO_PIN_HIGH);
-            _delay_ms(1000);
-            gpio_write_pin(LED_PORT, LED_PIN, GPIO_PIN_LOW);
-            uart_send(fooStr);
+            led_on = 1;
+            led_since = tick_get_ms();
         }
-
-        if (serialAvailable == 1)
+        if ( led_on && ((tick_get_ms() - led_since) >= LED_ON_MS) )
         {
-            serialAvailable = 0;
-            uart_read(str, sizeof(str));
-            uart_send(str);
-            uart_flush();
-            uart_enable_rx_isr();
+            gpio_write_pin(LED_PORT, LED_PIN, GPIO_PIN_LOW);
+            led_on = 0;
         }
+
+        console_poll();
     }
 }
-
-ISR(USART_RX_vect)
-{
-    serialAvailable = 1;
-    uart_disable_rx_isr();
-}
\ No newline at end of file
@@ -1,14 +1,64 @@
 #include "nxtiot_board.h"
 #include "gpio.h"
 #include "uart.h"
+#include "tick.h"
 #include "sigfox_wisol.h"
+#include "pipeline.h"
+#include "arena.h"
 
-uint8_t serialAvailable = 0;
+// The push button is sampled every 10 s and its duty in per mille is sent
+// every 15 min, within the 140 messages per day
+#define SAMPLE_MS       10000UL
+#define SAMPLES         90
+#define BLINK_MS        1000UL
+// Line of the ID and of the PAC, decoded in place
+#define TEXT_SIZE       20
+
+static int16_t
+read_button(void)
+{
+    return (gpio_read_pin(SW_PORT, SW_PIN) == GPIO_PIN_LOW) ? 1000 : 0;
+}
+
+// Sends the bytes in hexadecimal, as the module answered them
+static void
+send_hex(const uint8_t* data, uint8_t length)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char text[3] = {0};
+    uint8_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        text[0] = hex[data[i] >> 4];
+        text[1] = hex[data[i] & 0x0F];
+        uart_send(text);
+    }
+    uart_send("\n");
+}
+
+static pipeline_source button = PIPELINE_SOURCE(read_button, SAMPLE_MS);
+static pipeline_aggregate window = PIPELINE_AGGREGATE(SAMPLES);
+static pipeline_pack pack = {pipeline_pack_summary};
+
+PIPELINE_QUEUE(samples, int16_t, 2);
+PIPELINE_QUEUE(summaries, pipeline_summary, 1);
+PIPELINE_QUEUE(frames, pipeline_frame, 1);
+
+static const pipeline_stage stages[] PROGMEM =
+{
+    {pipeline_source_step,      &button,    NULL,       &samples},
+    {pipeline_aggregate_step,   &window,    &samples,   &summaries},
+    {pipeline_pack_step,        &pack,      &summaries, &frames},
+    {pipeline_uplink_step,      NULL,       &frames,    NULL}
+};
 
 int main(void)
 {
-    char fooStr[] = "Checkpoint!\n";
-    char str[20];
+    uint8_t* buffer;
+    uint8_t length;
+    uint32_t blink = 0;
+    uint32_t now;
 
     gpio_init_pin(LED_PORT, LED_PIN, GPIO_PIN_OUTPUT);
     gpio_init_pin(SW_PORT, SW_PIN, GPIO_PIN_INPUT);
@@ -16,19 +66,34 @@ int main(void)
     // Set LOW to LED
     gpio_write_pin(LED_PORT, LED_PIN, GPIO_PIN_LOW);
 
+    // The buffers come from the arena, allocated once at init
+    arena_init();
+    buffer = arena_alloc(TEXT_SIZE);
+    arena_lock();
+
+    tick_init();
     sigfox_wisol_init();
+    sei();
+
+    sigfox_wisol_get_id(buffer, TEXT_SIZE, &length);
+    send_hex(buffer, length);
 
-    sigfox_wisol_get_id(str, sizeof(str));
-    uart_send(str);
+    sigfox_wisol_get_pac(buffer, TEXT_SIZE, &length);
+    send_hex(buffer, length);
 
-    sigfox_wisol_get_pac(str, sizeof(str));
-    uart_send(str);
+    arena_report();
 
     while (1)
     {
-        gpio_write_pin(LED_PORT, LED_PIN, GPIO_PIN_HIGH);
-        _delay_ms(1000);
-        gpio_write_pin(LED_PORT, LED_PIN, GPIO_PIN_LOW);
-        _delay_ms(1000);
+        now = tick_get_ms();
+
+        pipeline_poll(stages, sizeof(stages) / sizeof(stages[0]), now);
+
+        // The LED blinks without delays, the pipeline keeps running
+        if ((now - blink) >= BLINK_MS)
+        {
+            blink += BLINK_MS;
+            gpio_toggle_pin(LED_PORT, LED_PIN);
+        }
     }
 }
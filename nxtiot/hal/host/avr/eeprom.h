@@ -0,0 +1,44 @@
+/******************************************************************************
+* Title                 :   Host AVR EEPROM header
+* Filename              :   eeprom.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file eeprom.h
+ *  @brief Host replacement of the avr-libc <avr/eeprom.h> header.
+ *
+ *  The EEPROM is simulated as a RAM array that also counts the number of
+ *  writes of every cell, so the tests can check the wear of the memory.
+ */
+
+#ifndef __HOST_AVR_EEPROM_H
+#define __HOST_AVR_EEPROM_H
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include "avr/io.h"
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+/*! Simulated EEPROM contents */
+extern uint8_t avr_sim_eeprom[E2END + 1];
+/*! Number of writes of each EEPROM cell */
+extern uint32_t avr_sim_eeprom_writes[E2END + 1];
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+uint8_t eeprom_read_byte(const uint8_t* addr);
+void eeprom_write_byte(uint8_t* addr, uint8_t value);
+void eeprom_update_byte(uint8_t* addr, uint8_t value);
+void eeprom_read_block(void* dst, const void* src, uint16_t size);
+uint8_t eeprom_is_ready(void);
+
+#endif /* __HOST_AVR_EEPROM_H */
@@ -0,0 +1,33 @@
+/******************************************************************************
+* Title                 :   Host AVR interrupt header
+* Filename              :   interrupt.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file interrupt.h
+ *  @brief Host replacement of the avr-libc <avr/interrupt.h> header.
+ *
+ *  Interrupt service routines become plain functions named after their
+ *  vector so the tests can call them to simulate an interrupt.
+ */
+
+#ifndef __HOST_AVR_INTERRUPT_H
+#define __HOST_AVR_INTERRUPT_H
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "avr/io.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define ISR(vector, ...)    void vector(void); void vector(void)
+#define sei()               (SREG |= _BV(SREG_I))
+#define cli()               (SREG &= ~_BV(SREG_I))
+
+#endif /* __HOST_AVR_INTERRUPT_H */
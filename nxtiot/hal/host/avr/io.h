@@ -0,0 +1,376 @@
+/******************************************************************************
+* Title                 :   Host AVR IO header
+* Filename              :   io.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file io.h
+ *  @brief Host replacement of the avr-libc <avr/io.h> header.
+ *
+ *  The ATmega328P IO registers are simulated as an array indexed by the data
+ *  space address of each register, so register pointers (ex. &PORTB) keep the
+ *  same layout as on the target and the drivers compile unmodified.
+ *
+ *  Every register access goes through avr_sim_access, which lets the
+ *  simulated peripherals and the virtual clock run once the simulation is
+ *  started (see avr_sim.h). Until then the registers are plain memory, as
+ *  the unit tests expect. Taking the address of a register is an access,
+ *  so it can not be used in a static initializer on the host.
+ */
+
+#ifndef __HOST_AVR_IO_H
+#define __HOST_AVR_IO_H
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Size of the simulated data space holding the IO registers */
+#define AVR_SIM_IO_SIZE     0x100
+/*! Last address of the internal SRAM */
+#define RAMEND              0x8FF
+/*! Last address of the internal EEPROM */
+#define E2END               0x3FF
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define _BV(bit)            (1 << (bit))
+#ifdef AVR_SIM_RAW_ACCESS
+#define _MMIO_BYTE(mem_addr) (*(volatile uint8_t *)(mem_addr))
+#else
+#define _MMIO_BYTE(mem_addr) (*avr_sim_access((volatile uint8_t *)(mem_addr)))
+#endif
+#define _MMIO_WORD(mem_addr) (*(volatile uint16_t *)&_MMIO_BYTE(mem_addr))
+#define _SFR_MEM8(addr)     _MMIO_BYTE(&avr_sim_io[(addr)])
+#define _SFR_MEM16(addr)    _MMIO_WORD(&avr_sim_io[(addr)])
+
+/**** Registers **************************************************************/
+#define PINB        _SFR_MEM8(0x23)
+#define DDRB        _SFR_MEM8(0x24)
+#define PORTB       _SFR_MEM8(0x25)
+#define PINC        _SFR_MEM8(0x26)
+#define DDRC        _SFR_MEM8(0x27)
+#define PORTC       _SFR_MEM8(0x28)
+#define PIND        _SFR_MEM8(0x29)
+#define DDRD        _SFR_MEM8(0x2A)
+#define PORTD       _SFR_MEM8(0x2B)
+#define TIFR0       _SFR_MEM8(0x35)
+#define TIFR1       _SFR_MEM8(0x36)
+#define TIFR2       _SFR_MEM8(0x37)
+#define PCIFR       _SFR_MEM8(0x3B)
+#define EIFR        _SFR_MEM8(0x3C)
+#define EIMSK       _SFR_MEM8(0x3D)
+#define GPIOR0      _SFR_MEM8(0x3E)
+#define EECR        _SFR_MEM8(0x3F)
+#define EEDR        _SFR_MEM8(0x40)
+#define EEAR        _SFR_MEM16(0x41)
+#define EEARL       _SFR_MEM8(0x41)
+#define EEARH       _SFR_MEM8(0x42)
+#define GTCCR       _SFR_MEM8(0x43)
+#define TCCR0A      _SFR_MEM8(0x44)
+#define TCCR0B      _SFR_MEM8(0x45)
+#define TCNT0       _SFR_MEM8(0x46)
+#define OCR0A       _SFR_MEM8(0x47)
+#define OCR0B       _SFR_MEM8(0x48)
+#define GPIOR1      _SFR_MEM8(0x4A)
+#define GPIOR2      _SFR_MEM8(0x4B)
+#define SPCR        _SFR_MEM8(0x4C)
+#define SPSR        _SFR_MEM8(0x4D)
+#define SPDR        _SFR_MEM8(0x4E)
+#define ACSR        _SFR_MEM8(0x50)
+#define SMCR        _SFR_MEM8(0x53)
+#define MCUSR       _SFR_MEM8(0x54)
+#define MCUCR       _SFR_MEM8(0x55)
+#define SPMCSR      _SFR_MEM8(0x57)
+#define SPL         _SFR_MEM8(0x5D)
+#define SPH         _SFR_MEM8(0x5E)
+#define SP          _SFR_MEM16(0x5D)
+#define SREG        _SFR_MEM8(0x5F)
+#define WDTCSR      _SFR_MEM8(0x60)
+#define CLKPR       _SFR_MEM8(0x61)
+#define PRR         _SFR_MEM8(0x64)
+#define OSCCAL      _SFR_MEM8(0x66)
+#define PCICR       _SFR_MEM8(0x68)
+#define EICRA       _SFR_MEM8(0x69)
+#define PCMSK0      _SFR_MEM8(0x6B)
+#define PCMSK1      _SFR_MEM8(0x6C)
+#define PCMSK2      _SFR_MEM8(0x6D)
+#define TIMSK0      _SFR_MEM8(0x6E)
+#define TIMSK1      _SFR_MEM8(0x6F)
+#define TIMSK2      _SFR_MEM8(0x70)
+#define ADC         _SFR_MEM16(0x78)
+#define ADCL        _SFR_MEM8(0x78)
+#define ADCH        _SFR_MEM8(0x79)
+#define ADCSRA      _SFR_MEM8(0x7A)
+#define ADCSRB      _SFR_MEM8(0x7B)
+#define ADMUX       _SFR_MEM8(0x7C)
+#define DIDR0       _SFR_MEM8(0x7E)
+#define DIDR1       _SFR_MEM8(0x7F)
+#define TCCR1A      _SFR_MEM8(0x80)
+#define TCCR1B      _SFR_MEM8(0x81)
+#define TCCR1C      _SFR_MEM8(0x82)
+#define TCNT1       _SFR_MEM16(0x84)
+#define TCNT1L      _SFR_MEM8(0x84)
+#define TCNT1H      _SFR_MEM8(0x85)
+#define ICR1        _SFR_MEM16(0x86)
+#define ICR1L       _SFR_MEM8(0x86)
+#define ICR1H       _SFR_MEM8(0x87)
+#define OCR1A       _SFR_MEM16(0x88)
+#define OCR1AL      _SFR_MEM8(0x88)
+#define OCR1AH      _SFR_MEM8(0x89)
+#define OCR1B       _SFR_MEM16(0x8A)
+#define OCR1BL      _SFR_MEM8(0x8A)
+#define OCR1BH      _SFR_MEM8(0x8B)
+#define TCCR2A      _SFR_MEM8(0xB0)
+#define TCCR2B      _SFR_MEM8(0xB1)
+#define TCNT2       _SFR_MEM8(0xB2)
+#define OCR2A       _SFR_MEM8(0xB3)
+#define OCR2B       _SFR_MEM8(0xB4)
+#define ASSR        _SFR_MEM8(0xB6)
+#define TWBR        _SFR_MEM8(0xB8)
+#define TWSR        _SFR_MEM8(0xB9)
+#define TWAR        _SFR_MEM8(0xBA)
+#define TWDR        _SFR_MEM8(0xBB)
+#define TWCR        _SFR_MEM8(0xBC)
+#define TWAMR       _SFR_MEM8(0xBD)
+#define UCSR0A      _SFR_MEM8(0xC0)
+#define UCSR0B      _SFR_MEM8(0xC1)
+#define UCSR0C      _SFR_MEM8(0xC2)
+#define UBRR0       _SFR_MEM16(0xC4)
+#define UBRR0L      _SFR_MEM8(0xC4)
+#define UBRR0H      _SFR_MEM8(0xC5)
+#define UDR0        _SFR_MEM8(0xC6)
+
+/**** Register Bits **********************************************************/
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+#define PC6 6
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+#define PIND0 0
+#define PIND1 1
+#define PIND2 2
+#define PIND3 3
+#define PIND4 4
+#define PIND5 5
+#define PIND6 6
+#define PIND7 7
+
+/* EECR */
+#define EEPM1 5
+#define EEPM0 4
+#define EERIE 3
+#define EEMPE 2
+#define EEPE 1
+#define EERE 0
+
+/* TCCR0A / TCCR0B / TIMSK0 / TIFR0 */
+#define COM0A1 7
+#define COM0A0 6
+#define COM0B1 5
+#define COM0B0 4
+#define WGM01 1
+#define WGM00 0
+#define FOC0A 7
+#define FOC0B 6
+#define WGM02 3
+#define CS02 2
+#define CS01 1
+#define CS00 0
+#define OCIE0B 2
+#define OCIE0A 1
+#define TOIE0 0
+#define OCF0B 2
+#define OCF0A 1
+#define TOV0 0
+
+/* TCCR1A / TCCR1B / TIMSK1 / TIFR1 */
+#define COM1A1 7
+#define COM1A0 6
+#define COM1B1 5
+#define COM1B0 4
+#define WGM11 1
+#define WGM10 0
+#define ICNC1 7
+#define ICES1 6
+#define WGM13 4
+#define WGM12 3
+#define CS12 2
+#define CS11 1
+#define CS10 0
+#define ICIE1 5
+#define OCIE1B 2
+#define OCIE1A 1
+#define TOIE1 0
+#define ICF1 5
+#define OCF1B 2
+#define OCF1A 1
+#define TOV1 0
+
+/* TCCR2A / TCCR2B / TIMSK2 / TIFR2 / ASSR */
+#define COM2A1 7
+#define COM2A0 6
+#define COM2B1 5
+#define COM2B0 4
+#define WGM21 1
+#define WGM20 0
+#define FOC2A 7
+#define FOC2B 6
+#define WGM22 3
+#define CS22 2
+#define CS21 1
+#define CS20 0
+#define OCIE2B 2
+#define OCIE2A 1
+#define TOIE2 0
+#define OCF2B 2
+#define OCF2A 1
+#define TOV2 0
+#define AS2 5
+
+/* SPCR / SPSR */
+#define SPIE 7
+#define SPE 6
+#define DORD 5
+#define MSTR 4
+#define CPOL 3
+#define CPHA 2
+#define SPR1 1
+#define SPR0 0
+#define SPIF 7
+#define WCOL 6
+#define SPI2X 0
+
+/* TWCR / TWSR */
+#define TWINT 7
+#define TWEA 6
+#define TWSTA 5
+#define TWSTO 4
+#define TWWC 3
+#define TWEN 2
+#define TWIE 0
+#define TWPS1 1
+#define TWPS0 0
+
+/* WDTCSR / MCUSR / SMCR / PRR */
+#define WDIF 7
+#define WDIE 6
+#define WDP3 5
+#define WDCE 4
+#define WDE 3
+#define WDP2 2
+#define WDP1 1
+#define WDP0 0
+#define WDRF 3
+#define BORF 2
+#define EXTRF 1
+#define PORF 0
+#define SM2 3
+#define SM1 2
+#define SM0 1
+#define SE 0
+#define PRTWI 7
+#define PRTIM2 6
+#define PRTIM0 5
+#define PRTIM1 3
+#define PRSPI 2
+#define PRUSART0 1
+#define PRADC 0
+
+/* PCICR / PCIFR / EIMSK / EICRA / EIFR */
+#define PCIE2 2
+#define PCIE1 1
+#define PCIE0 0
+#define PCIF2 2
+#define PCIF1 1
+#define PCIF0 0
+#define INT1 1
+#define INT0 0
+#define ISC11 3
+#define ISC10 2
+#define ISC01 1
+#define ISC00 0
+#define INTF1 1
+#define INTF0 0
+
+/* ADCSRA / ADMUX */
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIF 4
+#define ADIE 3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+#define REFS1 7
+#define REFS0 6
+#define ADLAR 5
+
+/* UCSR0A / UCSR0B / UCSR0C */
+#define RXC0 7
+#define TXC0 6
+#define UDRE0 5
+#define FE0 4
+#define DOR0 3
+#define UPE0 2
+#define U2X0 1
+#define MPCM0 0
+#define RXCIE0 7
+#define TXCIE0 6
+#define UDRIE0 5
+#define RXEN0 4
+#define TXEN0 3
+#define UCSZ02 2
+#define RXB80 1
+#define TXB80 0
+#define UMSEL01 7
+#define UMSEL00 6
+#define UPM01 5
+#define UPM00 4
+#define USBS0 3
+#define UCSZ01 2
+#define UCSZ00 1
+#define UCPOL0 0
+
+/* SREG */
+#define SREG_I 7
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+/*! Simulated IO registers indexed by data space address */
+extern volatile uint8_t avr_sim_io[AVR_SIM_IO_SIZE];
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+volatile uint8_t* avr_sim_access(volatile uint8_t* reg);
+
+#endif /* __HOST_AVR_IO_H */
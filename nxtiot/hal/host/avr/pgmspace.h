@@ -0,0 +1,44 @@
+/******************************************************************************
+* Title                 :   Host AVR program space header
+* Filename              :   pgmspace.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file pgmspace.h
+ *  @brief Host replacement of the avr-libc <avr/pgmspace.h> header.
+ *
+ *  The host has a single address space, so PROGMEM data stays in the
+ *  constant data and the program space reads are plain reads.
+ */
+
+#ifndef __HOST_AVR_PGMSPACE_H
+#define __HOST_AVR_PGMSPACE_H
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <string.h>
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define PROGMEM
+#define PGM_P                   const char*
+#define PSTR(s)                 (s)
+
+#define pgm_read_byte(addr)     (*(const uint8_t *) (addr))
+#define pgm_read_word(addr)     (*(const uint16_t *) (addr))
+#define pgm_read_dword(addr)    (*(const uint32_t *) (addr))
+#define pgm_read_ptr(addr)      (*(void * const *) (addr))
+
+#define memcpy_P                memcpy
+#define strlen_P                strlen
+#define strcmp_P                strcmp
+#define strncmp_P               strncmp
+
+#endif /* __HOST_AVR_PGMSPACE_H */
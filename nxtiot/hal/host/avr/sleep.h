@@ -0,0 +1,52 @@
+/******************************************************************************
+* Title                 :   Host AVR sleep header
+* Filename              :   sleep.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file sleep.h
+ *  @brief Host replacement of the avr-libc <avr/sleep.h> header.
+ *
+ *  The sleep mode is written to SMCR as on the target. The CPU does not
+ *  stop, sleep_cpu only advances the virtual clock so the interrupts of the
+ *  simulated peripherals can wake it up. The tests replace sleep_cpu to
+ *  simulate the peripherals that run while sleeping, as the watchdog.
+ */
+
+#ifndef __HOST_AVR_SLEEP_H
+#define __HOST_AVR_SLEEP_H
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "avr/io.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+#define SLEEP_MODE_IDLE         0x00
+#define SLEEP_MODE_ADC          _BV(SM0)
+#define SLEEP_MODE_PWR_DOWN     _BV(SM1)
+#define SLEEP_MODE_PWR_SAVE     (_BV(SM0) | _BV(SM1))
+#define SLEEP_MODE_STANDBY      (_BV(SM1) | _BV(SM2))
+#define SLEEP_MODE_EXT_STANDBY  (_BV(SM0) | _BV(SM1) | _BV(SM2))
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define set_sleep_mode(mode)                                                  \
+    (SMCR = (SMCR & ~(_BV(SM0) | _BV(SM1) | _BV(SM2))) | (mode))
+#define sleep_enable()          (SMCR |= _BV(SE))
+#define sleep_disable()         (SMCR &= ~_BV(SE))
+#define sleep_bod_disable()     do { } while (0)
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void sleep_cpu(void);
+
+#endif /* __HOST_AVR_SLEEP_H */
@@ -0,0 +1,31 @@
+/******************************************************************************
+* Title                 :   Host AVR watchdog header
+* Filename              :   wdt.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file wdt.h
+ *  @brief Host replacement of the avr-libc <avr/wdt.h> header.
+ *
+ *  The watchdog registers are plain memory and wdt_reset does nothing. The
+ *  tests replace wdt_reset to know when the watchdog counter restarts.
+ */
+
+#ifndef __HOST_AVR_WDT_H
+#define __HOST_AVR_WDT_H
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "avr/io.h"
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void wdt_reset(void);
+
+#endif /* __HOST_AVR_WDT_H */
@@ -0,0 +1,1500 @@
+/******************************************************************************
+* Title                 :   Host AVR simulation source file
+* Filename              :   avr_sim.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file        avr_sim.c
+ *  @brief       Simulated ATmega328P of the host backend
+ *
+ *  ## Overview ##
+ *  Linked with the drivers built for the host, in place of the avr-libc
+ *  library. It holds the simulated registers and EEPROM and, once the
+ *  simulation is started, runs the timers, the UART, the pins and the
+ *  interrupts against a virtual clock counted in CPU cycles.
+ *
+ *  Every register access of a driver first resolves the previous access (a
+ *  read or a write, see avr_sim.h), then advances the virtual clock by
+ *  AVR_SIM_ACCESS_CYCLES. The clock advances in steps that end at the next
+ *  timer clock, UART bit or scheduled event, and the pending interrupts are
+ *  dispatched after every step.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      avr_sim_start();
+ *      avr_sim_uart_set_handler(print_byte);
+ *
+ *      uart_init();
+ *      avr_sim_uart_rx((const uint8_t *) "OK\r\n", 4);
+ *      uart_read_until(str, sizeof(str), '\n', 100, NULL);
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#define AVR_SIM_RAW_ACCESS
+#include <stdio.h>
+#include <stdlib.h>
+#include "avr_sim.h"
+#include "avr/eeprom.h"
+#include "avr/sleep.h"
+#include "avr/wdt.h"
+#include "util/delay.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! CPU cycles per microsecond */
+#define CYCLES_PER_US   ((uint32_t) (F_CPU / 1000000UL))
+/*! Unused bit of the interrupt flag registers, reads as 1 to detect writes */
+#define FLAG_MARK       0x80
+/*! Number of simulated timers */
+#define TIMERS          3
+/*! Number of simulated ports (B, C and D) */
+#define PORTS           3
+/*! Address of the PINB register, the ports follow every 3 addresses */
+#define PORT_BASE       0x23
+/*! No register access pending */
+#define NO_ACCESS       -1
+/*! UCSR0A bits set by the UART only */
+#define UCSR0A_STATUS   (_BV(RXC0) | _BV(UDRE0) | _BV(FE0) | _BV(DOR0) | \
+                         _BV(UPE0))
+/*! Pin UART state: start bit */
+#define PIN_UART_START  1
+/*! Pin UART state: stop bit, after the 8 data bits */
+#define PIN_UART_STOP   (PIN_UART_START + 8)
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! Macro used to get the data space address of a register */
+#define ADDR(reg)       ((int16_t) (&(reg) - avr_sim_io))
+/*! Macro used to get the PORTx register of a port index */
+#define PORT_REG(index) (&avr_sim_io[PORT_BASE + 3 * (index) + 2])
+/*! Macro used to wrap an index of the RX queues */
+#define QUEUE_WRAP(i)   ((i) & (AVR_SIM_RX_QUEUE_SIZE - 1))
+/*! Macro used to define an interrupt vector not defined by the drivers */
+#define AVR_SIM_VECTOR(vector)                                              \
+    void vector(void) __attribute__((weak));                                \
+    void vector(void) { _avr_sim_bad_interrupt(#vector); }
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  Simulated timer
+  */
+typedef struct
+{
+    volatile uint8_t* tccra;
+    volatile uint8_t* tccrb;
+    volatile uint8_t* tcnt;
+    volatile uint8_t* ocra;
+    volatile uint8_t* ocrb;
+    volatile uint8_t* icr;
+    volatile uint8_t* tifr;
+    const uint16_t* prescalers;
+    uint8_t wide;
+    uint16_t count;
+    uint16_t compare_a;         /*! OCRnA in use, loaded at BOTTOM in PWM */
+    uint16_t compare_b;         /*! OCRnB in use, loaded at BOTTOM in PWM */
+} avr_sim_timer;
+
+/*!
+  * @brief  Interrupt source, in vector priority order
+  */
+typedef struct
+{
+    volatile uint8_t* flag;
+    uint8_t flag_bit;
+    volatile uint8_t* enable;
+    uint8_t enable_bit;
+    uint8_t clear;
+    void (*vector)(void);
+} avr_sim_irq;
+
+/*!
+  * @brief  Scheduled event
+  */
+typedef struct
+{
+    uint64_t due;
+    avr_sim_event event;
+} avr_sim_slot;
+
+/*!
+  * @brief  Queue of bytes to be received by the simulated CPU
+  */
+typedef struct
+{
+    uint8_t data[AVR_SIM_RX_QUEUE_SIZE];
+    uint16_t head;
+    uint16_t tail;
+} avr_sim_queue;
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+volatile uint8_t avr_sim_io[AVR_SIM_IO_SIZE];
+uint8_t avr_sim_eeprom[E2END + 1];
+uint32_t avr_sim_eeprom_writes[E2END + 1];
+uint32_t avr_sim_delay_us;
+
+/*! Set while the simulation runs */
+static uint8_t avr_sim_running;
+/*! Virtual clock in CPU cycles */
+static uint64_t avr_sim_now;
+/*! Address of the last register accessed, NO_ACCESS once resolved */
+static int16_t avr_sim_pending = NO_ACCESS;
+/*! Value of the last register accessed before the access */
+static uint8_t avr_sim_pending_value;
+/*! Set when the last register accessed was UDR0 with a received byte */
+static uint8_t avr_sim_pending_rx;
+/*! Scheduled events */
+static avr_sim_slot avr_sim_events[AVR_SIM_EVENTS];
+
+/*! Prescalers of Timer0 and Timer1 by clock select value */
+static const uint16_t avr_sim_prescalers[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+/*! Prescalers of Timer2 by clock select value */
+static const uint16_t avr_sim_prescalers2[8] = {0, 1, 8, 32, 64, 128, 256,
+                                                1024};
+/*! Simulated timers */
+static avr_sim_timer avr_sim_timers[TIMERS] =
+{
+    {&TCCR0A, &TCCR0B, &TCNT0, &OCR0A, &OCR0B, NULL, &TIFR0,
+     avr_sim_prescalers, 0, 0, 0, 0},
+    {&TCCR1A, &TCCR1B, &TCNT1L, &OCR1AL, &OCR1BL, &ICR1L, &TIFR1,
+     avr_sim_prescalers, 1, 0, 0, 0},
+    {&TCCR2A, &TCCR2B, &TCNT2, &OCR2A, &OCR2B, NULL, &TIFR2,
+     avr_sim_prescalers2, 0, 0, 0, 0},
+};
+
+/*! Function called at the end of every period of a timer */
+static avr_sim_timer_handler avr_sim_timer_period;
+
+/*! Function called with every byte sent by UART0 */
+static avr_sim_byte_handler avr_sim_uart_tx_handler;
+/*! Set while UART0 shifts out a byte */
+static uint8_t avr_sim_uart_tx_busy;
+/*! Cycles left to shift out the byte */
+static uint32_t avr_sim_uart_tx_left;
+/*! Byte being shifted out */
+static uint8_t avr_sim_uart_tx_shift;
+/*! Byte written to UDR0 waiting for the shift register */
+static uint8_t avr_sim_uart_tx_buffer;
+/*! Bytes to be received by UART0 */
+static avr_sim_queue avr_sim_uart_queue;
+/*! Set while UART0 shifts in a byte */
+static uint8_t avr_sim_uart_rx_busy;
+/*! Cycles left to shift in the byte */
+static uint32_t avr_sim_uart_rx_left;
+/*! Receive FIFO of UART0 */
+static uint8_t avr_sim_uart_fifo[2];
+/*! Number of bytes in the receive FIFO */
+static uint8_t avr_sim_uart_fifo_count;
+
+/*! Levels driven on the pins from outside */
+static uint8_t avr_sim_pin_level[PORTS];
+/*! Pins driven from outside */
+static uint8_t avr_sim_pin_driven[PORTS];
+/*! Pin levels of the last step */
+static uint8_t avr_sim_pin_last[PORTS];
+/*! Function called when the level of a pin changes */
+static avr_sim_pin_handler avr_sim_pin_changed;
+
+/*! Port of the pin UART, NO_ACCESS when not used */
+static int8_t avr_sim_pin_uart_port = NO_ACCESS;
+/*! Pin sent by the simulated CPU */
+static uint8_t avr_sim_pin_uart_tx_pin;
+/*! Pin received by the simulated CPU */
+static uint8_t avr_sim_pin_uart_rx_pin;
+/*! Cycles per bit of the pin UART */
+static uint32_t avr_sim_pin_uart_bit;
+/*! Function called with every byte sent on the pin */
+static avr_sim_byte_handler avr_sim_pin_uart_handler;
+/*! Bit being decoded, 0 while waiting for a start bit */
+static uint8_t avr_sim_pin_dec_state;
+/*! Cycles left to the next sample */
+static uint32_t avr_sim_pin_dec_left;
+/*! Byte being decoded */
+static uint8_t avr_sim_pin_dec_byte;
+/*! Bytes to be sent on the pin */
+static avr_sim_queue avr_sim_pin_queue;
+/*! Bit being sent, 0 while idle */
+static uint8_t avr_sim_pin_enc_state;
+/*! Cycles left to the next bit */
+static uint32_t avr_sim_pin_enc_left;
+/*! Byte being sent */
+static uint8_t avr_sim_pin_enc_byte;
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static void _avr_sim_bad_interrupt(const char* vector);
+static void _avr_sim_resolve(void);
+static void _avr_sim_advance(uint32_t cycles);
+static uint16_t _avr_sim_read(volatile uint8_t* reg, uint8_t wide);
+static uint16_t _avr_sim_timer_top(const avr_sim_timer* timer, uint8_t* ctc);
+static uint8_t _avr_sim_timer_buffered(const avr_sim_timer* timer);
+static void _avr_sim_timer_tick(avr_sim_timer* timer);
+static uint32_t _avr_sim_uart_frame(void);
+static void _avr_sim_uart_write(uint8_t data);
+static void _avr_sim_uart_step(uint32_t step);
+static void _avr_sim_queues(void);
+static void _avr_sim_pin_uart_step(uint32_t step);
+static void _avr_sim_pins(void);
+static void _avr_sim_interrupts(void);
+static uint16_t _avr_sim_queue_push(avr_sim_queue* queue, const uint8_t* data,
+                                    uint16_t size);
+static int8_t _avr_sim_port_index(volatile uint8_t* port);
+
+/******************************************************************************
+* Interrupt Vectors
+******************************************************************************/
+AVR_SIM_VECTOR(INT0_vect)
+AVR_SIM_VECTOR(INT1_vect)
+AVR_SIM_VECTOR(PCINT0_vect)
+AVR_SIM_VECTOR(PCINT1_vect)
+AVR_SIM_VECTOR(PCINT2_vect)
+AVR_SIM_VECTOR(TIMER2_COMPA_vect)
+AVR_SIM_VECTOR(TIMER2_COMPB_vect)
+AVR_SIM_VECTOR(TIMER2_OVF_vect)
+AVR_SIM_VECTOR(TIMER1_COMPA_vect)
+AVR_SIM_VECTOR(TIMER1_COMPB_vect)
+AVR_SIM_VECTOR(TIMER1_OVF_vect)
+AVR_SIM_VECTOR(TIMER0_COMPA_vect)
+AVR_SIM_VECTOR(TIMER0_COMPB_vect)
+AVR_SIM_VECTOR(TIMER0_OVF_vect)
+AVR_SIM_VECTOR(USART_RX_vect)
+AVR_SIM_VECTOR(USART_UDRE_vect)
+AVR_SIM_VECTOR(USART_TX_vect)
+
+/*! Interrupt sources, in vector priority order */
+static const avr_sim_irq avr_sim_irqs[] =
+{
+    {&EIFR, INTF0, &EIMSK, INT0, 1, INT0_vect},
+    {&EIFR, INTF1, &EIMSK, INT1, 1, INT1_vect},
+    {&PCIFR, PCIF0, &PCICR, PCIE0, 1, PCINT0_vect},
+    {&PCIFR, PCIF1, &PCICR, PCIE1, 1, PCINT1_vect},
+    {&PCIFR, PCIF2, &PCICR, PCIE2, 1, PCINT2_vect},
+    {&TIFR2, OCF2A, &TIMSK2, OCIE2A, 1, TIMER2_COMPA_vect},
+    {&TIFR2, OCF2B, &TIMSK2, OCIE2B, 1, TIMER2_COMPB_vect},
+    {&TIFR2, TOV2, &TIMSK2, TOIE2, 1, TIMER2_OVF_vect},
+    {&TIFR1, OCF1A, &TIMSK1, OCIE1A, 1, TIMER1_COMPA_vect},
+    {&TIFR1, OCF1B, &TIMSK1, OCIE1B, 1, TIMER1_COMPB_vect},
+    {&TIFR1, TOV1, &TIMSK1, TOIE1, 1, TIMER1_OVF_vect},
+    {&TIFR0, OCF0A, &TIMSK0, OCIE0A, 1, TIMER0_COMPA_vect},
+    {&TIFR0, OCF0B, &TIMSK0, OCIE0B, 1, TIMER0_COMPB_vect},
+    {&TIFR0, TOV0, &TIMSK0, TOIE0, 1, TIMER0_OVF_vect},
+    {&UCSR0A, RXC0, &UCSR0B, RXCIE0, 0, USART_RX_vect},
+    {&UCSR0A, UDRE0, &UCSR0B, UDRIE0, 0, USART_UDRE_vect},
+    {&UCSR0A, TXC0, &UCSR0B, TXCIE0, 1, USART_TX_vect},
+};
+
+/*! Interrupt flag registers, cleared by writing 1 */
+static volatile uint8_t* const avr_sim_flags[] =
+{
+    &TIFR0, &TIFR1, &TIFR2, &PCIFR, &EIFR
+};
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup avr_sim
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to start the simulation.
+ *
+ * The registers get their reset values, the virtual clock starts at 0 and
+ * the scheduled events, queues and handlers are cleared.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+avr_sim_start(void)
+{
+    uint16_t addr;
+    uint8_t i;
+
+    for (addr = 0; addr < AVR_SIM_IO_SIZE; addr++)
+    {
+        avr_sim_io[addr] = 0;
+    }
+    UCSR0A = _BV(UDRE0);
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);
+
+    for (i = 0; i < TIMERS; i++)
+    {
+        avr_sim_timers[i].count = 0;
+        avr_sim_timers[i].compare_a = 0;
+        avr_sim_timers[i].compare_b = 0;
+    }
+    for (i = 0; i < AVR_SIM_EVENTS; i++)
+    {
+        avr_sim_events[i].event = NULL;
+    }
+    for (i = 0; i < PORTS; i++)
+    {
+        avr_sim_pin_level[i] = 0;
+        avr_sim_pin_driven[i] = 0;
+        avr_sim_pin_last[i] = 0;
+    }
+
+    avr_sim_now = 0;
+    avr_sim_pending = NO_ACCESS;
+    avr_sim_timer_period = NULL;
+    avr_sim_uart_tx_handler = NULL;
+    avr_sim_uart_tx_busy = 0;
+    avr_sim_uart_rx_busy = 0;
+    avr_sim_uart_fifo_count = 0;
+    avr_sim_uart_queue.head = avr_sim_uart_queue.tail = 0;
+    avr_sim_pin_changed = NULL;
+    avr_sim_pin_uart_port = NO_ACCESS;
+    avr_sim_pin_dec_state = 0;
+    avr_sim_pin_enc_state = 0;
+    avr_sim_pin_queue.head = avr_sim_pin_queue.tail = 0;
+    avr_sim_running = 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to stop the simulation, the registers become plain memory.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+avr_sim_stop(void)
+{
+    _avr_sim_resolve();
+    avr_sim_running = 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to advance the virtual clock, running the peripherals and
+ * the interrupts.
+ *
+ * @param cycles Number of CPU cycles.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+avr_sim_run(uint32_t cycles)
+{
+    if (avr_sim_running)
+    {
+        _avr_sim_resolve();
+        _avr_sim_advance(cycles);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the virtual clock.
+ *
+ * @return CPU cycles since the simulation started.
+ */
+/*****************************************************************************/
+uint64_t
+avr_sim_cycles(void)
+{
+    return avr_sim_now;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the virtual clock in microseconds.
+ *
+ * @return Microseconds since the simulation started.
+ */
+/*****************************************************************************/
+uint64_t
+avr_sim_micros(void)
+{
+    return avr_sim_now / CYCLES_PER_US;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to call a function after a virtual time.
+ *
+ * The function is called from the simulation, between two instructions of
+ * the simulated CPU, and can schedule other events.
+ *
+ * @param delay_us Virtual time in microseconds.
+ * @param event Function to be called.
+ *
+ * @return 1 if the event was scheduled, 0 if AVR_SIM_EVENTS are pending.
+ */
+/*****************************************************************************/
+uint8_t
+avr_sim_schedule(uint32_t delay_us, avr_sim_event event)
+{
+    uint8_t i;
+
+    for (i = 0; i < AVR_SIM_EVENTS; i++)
+    {
+        if (avr_sim_events[i].event == NULL)
+        {
+            avr_sim_events[i].due = avr_sim_now +
+                                    (uint64_t) delay_us * CYCLES_PER_US;
+            avr_sim_events[i].event = event;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to set the function called at the end of every period of
+ * a timer, with the TOP and the compare values the period ran with.
+ *
+ * @param handler Function called with the timer number (0 to 2), the TOP
+ *                and the compare values in use of OCRnA and OCRnB, NULL for
+ *                none.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+avr_sim_timer_set_handler(avr_sim_timer_handler handler)
+{
+    avr_sim_timer_period = handler;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to set the function called with the bytes sent by UART0.
+ *
+ * @param handler Function called at the end of the stop bit of every byte,
+ *                NULL to discard the bytes.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+avr_sim_uart_set_handler(avr_sim_byte_handler handler)
+{
+    avr_sim_uart_tx_handler = handler;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to queue bytes to be received by UART0.
+ *
+ * The bytes arrive one after the other at the baud rate of UART0, while its
+ * receiver is enabled. A byte that finds the receive FIFO full is lost and
+ * sets DOR0.
+ *
+ * @param data Pointer to the bytes.
+ * @param size Number of bytes.
+ *
+ * @return Number of bytes queued.
+ */
+/*****************************************************************************/
+uint16_t
+avr_sim_uart_rx(const uint8_t* data, uint16_t size)
+{
+    return _avr_sim_queue_push(&avr_sim_uart_queue, data, size);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of bytes still to be received by UART0.
+ *
+ * @return Number of bytes queued, including the one being received.
+ */
+/*****************************************************************************/
+uint16_t
+avr_sim_uart_rx_pending(void)
+{
+    return QUEUE_WRAP(avr_sim_uart_queue.head - avr_sim_uart_queue.tail);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to drive a pin from outside.
+ *
+ * The level is read on the pin while it is an input. A released input reads
+ * high with the pull-up enabled and low otherwise.
+ *
+ * @param port Port address (ex. &PORTD).
+ * @param pin Pin number.
+ * @param level 0 or 1 to drive the pin low or high, -1 to release it.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+avr_sim_pin_drive(volatile uint8_t* port, uint8_t pin, int8_t level)
+{
+    int8_t index = _avr_sim_port_index(port);
+
+    if (index < 0)
+    {
+        return;
+    }
+
+    if (level < 0)
+    {
+        avr_sim_pin_driven[index] &= ~_BV(pin);
+    }
+    else
+    {
+        avr_sim_pin_driven[index] |= _BV(pin);
+        if (level)
+        {
+            avr_sim_pin_level[index] |= _BV(pin);
+        }
+        else
+        {
+            avr_sim_pin_level[index] &= ~_BV(pin);
+        }
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to set the function called when the level of a pin
+ * changes.
+ *
+ * @param handler Function called with the port address (ex. &PORTB), the
+ *                pin number and the new level, NULL for none.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+avr_sim_pin_set_handler(avr_sim_pin_handler handler)
+{
+    avr_sim_pin_changed = handler;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to connect a UART to two pins of a port, 8N1.
+ *
+ * The bytes sent by the simulated CPU on the TX pin are decoded and passed
+ * to the handler, the bytes queued with avr_sim_pin_uart_rx_pin are sent on the
+ * RX pin, which idles high.
+ *
+ * @param port Port address (ex. &PORTD).
+ * @param tx_pin Pin the simulated CPU sends on.
+ * @param rx_pin Pin the simulated CPU receives on.
+ * @param baud Baud rate.
+ * @param handler Function called with every byte decoded.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+avr_sim_pin_uart(volatile uint8_t* port, uint8_t tx_pin, uint8_t rx_pin,
+                 uint32_t baud, avr_sim_byte_handler handler)
+{
+    avr_sim_pin_uart_port = _avr_sim_port_index(port);
+    avr_sim_pin_uart_tx_pin = tx_pin;
+    avr_sim_pin_uart_rx_pin = rx_pin;
+    avr_sim_pin_uart_bit = (uint32_t) F_CPU / baud;
+    avr_sim_pin_uart_handler = handler;
+    avr_sim_pin_dec_state = 0;
+    avr_sim_pin_enc_state = 0;
+    avr_sim_pin_drive(port, rx_pin, 1);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to queue bytes to be sent on the RX pin of the pin UART.
+ *
+ * @param data Pointer to the bytes.
+ * @param size Number of bytes.
+ *
+ * @return Number of bytes queued.
+ */
+/*****************************************************************************/
+uint16_t
+avr_sim_pin_uart_rx(const uint8_t* data, uint16_t size)
+{
+    return _avr_sim_queue_push(&avr_sim_pin_queue, data, size);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used by the register macros on every register access.
+ *
+ * @param reg Pointer to the register.
+ *
+ * @return Pointer to the register.
+ */
+/*****************************************************************************/
+volatile uint8_t*
+avr_sim_access(volatile uint8_t* reg)
+{
+    uintptr_t offset = (uintptr_t) reg - (uintptr_t) avr_sim_io;
+    uint8_t i;
+
+    if ( !avr_sim_running || (offset >= AVR_SIM_IO_SIZE) )
+    {
+        return reg;
+    }
+
+    _avr_sim_resolve();
+    _avr_sim_advance(AVR_SIM_ACCESS_CYCLES);
+
+    avr_sim_pending = (int16_t) offset;
+    avr_sim_pending_rx = 0;
+
+    if (avr_sim_pending == ADDR(UDR0))
+    {
+        if (avr_sim_uart_fifo_count > 0)
+        {
+            UDR0 = avr_sim_uart_fifo[0];
+            avr_sim_pending_rx = 1;
+        }
+    }
+    else
+    {
+        for (i = 0; i < sizeof(avr_sim_flags) / sizeof(avr_sim_flags[0]); i++)
+        {
+            if (reg == avr_sim_flags[i])
+            {
+                *reg |= FLAG_MARK;
+            }
+        }
+    }
+    avr_sim_pending_value = *reg;
+
+    return reg;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to resolve the last register access as a read or a write.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_avr_sim_resolve(void)
+{
+    int16_t addr = avr_sim_pending;
+    uint8_t before = avr_sim_pending_value;
+    uint8_t value;
+    uint8_t i;
+
+    if (addr == NO_ACCESS)
+    {
+        return;
+    }
+    avr_sim_pending = NO_ACCESS;
+    value = avr_sim_io[addr];
+
+    if (addr == ADDR(UDR0))
+    {
+        if (avr_sim_pending_rx && (value == before))
+        {
+            // Read, the next byte of the FIFO moves up
+            avr_sim_uart_fifo[0] = avr_sim_uart_fifo[1];
+            if (--avr_sim_uart_fifo_count == 0)
+            {
+                UCSR0A &= ~_BV(RXC0);
+            }
+        }
+        else
+        {
+            _avr_sim_uart_write(value);
+        }
+        return;
+    }
+
+    if (addr == ADDR(UCSR0A))
+    {
+        if (value != before)
+        {
+            UCSR0A = (before & UCSR0A_STATUS) |
+                     (before & _BV(TXC0) & ~value) |
+                     (value & (_BV(U2X0) | _BV(MPCM0)));
+        }
+        return;
+    }
+
+    for (i = 0; i < sizeof(avr_sim_flags) / sizeof(avr_sim_flags[0]); i++)
+    {
+        if (&avr_sim_io[addr] == avr_sim_flags[i])
+        {
+            // A read keeps the mark, a write clears the flags written to 1
+            // (a read-modify-write clears all of them, as on the target)
+            before &= ~FLAG_MARK;
+            avr_sim_io[addr] = (value == (before | FLAG_MARK)) ?
+                               before : (before & ~value);
+            return;
+        }
+    }
+
+    if ( (addr >= PORT_BASE) && (addr < PORT_BASE + 3 * PORTS) &&
+         (((addr - PORT_BASE) % 3) == 0) && (value != before) )
+    {
+        // Writing a 1 to a PINx bit toggles the PORTx bit
+        avr_sim_io[addr + 2] ^= value;
+        avr_sim_io[addr] = before;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to advance the virtual clock.
+ *
+ * @param cycles Number of CPU cycles.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_avr_sim_advance(uint32_t cycles)
+{
+    avr_sim_timer* timer;
+    avr_sim_event event;
+    uint32_t prescaler;
+    uint32_t step;
+    uint8_t i;
+
+    while (cycles > 0)
+    {
+        _avr_sim_queues();
+
+        // The step ends at the next timer clock, UART bit or event
+        step = cycles;
+        for (i = 0; i < TIMERS; i++)
+        {
+            timer = &avr_sim_timers[i];
+            prescaler = timer->prescalers[*timer->tccrb & 0x07];
+            if (timer->count >= prescaler)
+            {
+                timer->count = 0;
+            }
+            if ( (prescaler > 0) && (prescaler - timer->count < step) )
+            {
+                step = prescaler - timer->count;
+            }
+        }
+        if ( avr_sim_uart_tx_busy && (avr_sim_uart_tx_left < step) )
+        {
+            step = avr_sim_uart_tx_left;
+        }
+        if ( avr_sim_uart_rx_busy && (avr_sim_uart_rx_left < step) )
+        {
+            step = avr_sim_uart_rx_left;
+        }
+        if ( avr_sim_pin_dec_state && (avr_sim_pin_dec_left < step) )
+        {
+            step = avr_sim_pin_dec_left;
+        }
+        if ( avr_sim_pin_enc_state && (avr_sim_pin_enc_left < step) )
+        {
+            step = avr_sim_pin_enc_left;
+        }
+        for (i = 0; i < AVR_SIM_EVENTS; i++)
+        {
+            if ( (avr_sim_events[i].event != NULL) &&
+                 (avr_sim_events[i].due > avr_sim_now) &&
+                 (avr_sim_events[i].due - avr_sim_now < step) )
+            {
+                step = (uint32_t) (avr_sim_events[i].due - avr_sim_now);
+            }
+        }
+
+        avr_sim_now += step;
+        cycles -= step;
+
+        for (i = 0; i < TIMERS; i++)
+        {
+            timer = &avr_sim_timers[i];
+            prescaler = timer->prescalers[*timer->tccrb & 0x07];
+            if (prescaler > 0)
+            {
+                timer->count += step;
+                if (timer->count >= prescaler)
+                {
+                    timer->count = 0;
+                    _avr_sim_timer_tick(timer);
+                }
+            }
+        }
+        _avr_sim_uart_step(step);
+        _avr_sim_pin_uart_step(step);
+
+        for (i = 0; i < AVR_SIM_EVENTS; i++)
+        {
+            event = avr_sim_events[i].event;
+            if ( (event != NULL) && (avr_sim_events[i].due <= avr_sim_now) )
+            {
+                avr_sim_events[i].event = NULL;
+                event();
+            }
+        }
+
+        _avr_sim_pins();
+        _avr_sim_interrupts();
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read an 8 or 16 bits register.
+ *
+ * @param reg Pointer to the register, the low byte for 16 bits.
+ * @param wide 1 for a 16 bits register.
+ *
+ * @return Value of the register.
+ */
+/*****************************************************************************/
+static uint16_t
+_avr_sim_read(volatile uint8_t* reg, uint8_t wide)
+{
+    return wide ? (uint16_t) (reg[0] | (reg[1] << 8)) : reg[0];
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the top value of a timer.
+ *
+ * @param timer Pointer to the timer.
+ * @param ctc Pointer where 1 is written in CTC mode.
+ *
+ * @return Value the timer clears after.
+ */
+/*****************************************************************************/
+static uint16_t
+_avr_sim_timer_top(const avr_sim_timer* timer, uint8_t* ctc)
+{
+    uint8_t wgm;
+
+    if (!timer->wide)
+    {
+        wgm = (*timer->tccra & 0x03) | ((*timer->tccrb >> 1) & 0x04);
+        *ctc = (wgm == 2);
+
+        if (wgm == 2)
+        {
+            return *timer->ocra;
+        }
+
+        return ( (wgm == 5) || (wgm == 7) ) ? timer->compare_a : 0xFF;
+    }
+
+    wgm = (*timer->tccra & 0x03) | ((*timer->tccrb >> 1) & 0x0C);
+    *ctc = ( (wgm == 4) || (wgm == 12) );
+
+    switch (wgm)
+    {
+        case 1:
+        case 5:
+            return 0x00FF;
+        case 2:
+        case 6:
+            return 0x01FF;
+        case 3:
+        case 7:
+            return 0x03FF;
+        case 4:
+            return _avr_sim_read(timer->ocra, 1);
+        case 9:
+        case 11:
+        case 15:
+            return timer->compare_a;
+        case 8:
+        case 10:
+        case 12:
+        case 14:
+            return _avr_sim_read(timer->icr, 1);
+        default:
+            return 0xFFFF;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to know if the compare registers of a timer are double
+ * buffered, which they are in the PWM modes.
+ *
+ * @param timer Pointer to the timer.
+ *
+ * @return 1 in a PWM mode, 0 in the normal and CTC modes.
+ */
+/*****************************************************************************/
+static uint8_t
+_avr_sim_timer_buffered(const avr_sim_timer* timer)
+{
+    uint8_t wgm;
+
+    if (!timer->wide)
+    {
+        wgm = (*timer->tccra & 0x03) | ((*timer->tccrb >> 1) & 0x04);
+
+        return (wgm & 0x01);
+    }
+
+    wgm = (*timer->tccra & 0x03) | ((*timer->tccrb >> 1) & 0x0C);
+
+    return (wgm != 0) && (wgm != 4) && (wgm != 12) && (wgm != 13);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to count a timer clock.
+ *
+ * The timers always count up, the phase correct modes count as fast PWM.
+ * In the PWM modes OCRnA and OCRnB are double buffered, the values written
+ * are used from the next BOTTOM, while ICR1 is used at once.
+ *
+ * @param timer Pointer to the timer.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_avr_sim_timer_tick(avr_sim_timer* timer)
+{
+    uint16_t max = timer->wide ? 0xFFFF : 0xFF;
+    uint8_t buffered = _avr_sim_timer_buffered(timer);
+    uint8_t ctc;
+    uint16_t top;
+    uint16_t count = _avr_sim_read(timer->tcnt, timer->wide);
+
+    if (!buffered)
+    {
+        timer->compare_a = _avr_sim_read(timer->ocra, timer->wide);
+        timer->compare_b = _avr_sim_read(timer->ocrb, timer->wide);
+    }
+    top = _avr_sim_timer_top(timer, &ctc);
+
+    if ( (count == top) || (count == max) )
+    {
+        if ( !ctc || (count == max) )
+        {
+            *timer->tifr |= _BV(TOV0);
+        }
+        if (avr_sim_timer_period != NULL)
+        {
+            avr_sim_timer_period((uint8_t) (timer - avr_sim_timers), count,
+                                 timer->compare_a, timer->compare_b);
+        }
+        count = 0;
+        if (buffered)
+        {
+            timer->compare_a = _avr_sim_read(timer->ocra, timer->wide);
+            timer->compare_b = _avr_sim_read(timer->ocrb, timer->wide);
+        }
+    }
+    else
+    {
+        count++;
+    }
+
+    timer->tcnt[0] = (uint8_t) count;
+    if (timer->wide)
+    {
+        timer->tcnt[1] = (uint8_t) (count >> 8);
+    }
+
+    if (count == timer->compare_a)
+    {
+        *timer->tifr |= _BV(OCF0A);
+    }
+    if (count == timer->compare_b)
+    {
+        *timer->tifr |= _BV(OCF0B);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the time of a UART0 frame.
+ *
+ * @return CPU cycles of a frame at the current baud rate and format.
+ */
+/*****************************************************************************/
+static uint32_t
+_avr_sim_uart_frame(void)
+{
+    uint32_t bit = ((UCSR0A & _BV(U2X0)) ? 8UL : 16UL) *
+                   ((UBRR0 & 0x0FFF) + 1UL);
+    uint8_t bits = 1 + 5 + ((UCSR0C >> UCSZ00) & 0x03) +
+                   ((UCSR0C & _BV(UPM01)) ? 1 : 0) +
+                   ((UCSR0C & _BV(USBS0)) ? 2 : 1);
+
+    return bit * bits;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to handle a byte written to UDR0.
+ *
+ * @param data Byte written.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_avr_sim_uart_write(uint8_t data)
+{
+    if ( !(UCSR0B & _BV(TXEN0)) || !(UCSR0A & _BV(UDRE0)) )
+    {
+        return;
+    }
+
+    if (!avr_sim_uart_tx_busy)
+    {
+        avr_sim_uart_tx_shift = data;
+        avr_sim_uart_tx_left = _avr_sim_uart_frame();
+        avr_sim_uart_tx_busy = 1;
+    }
+    else
+    {
+        avr_sim_uart_tx_buffer = data;
+        UCSR0A &= ~_BV(UDRE0);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to advance the transmitter and the receiver of UART0.
+ *
+ * @param step Number of CPU cycles.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_avr_sim_uart_step(uint32_t step)
+{
+    avr_sim_queue* queue = &avr_sim_uart_queue;
+
+    if (avr_sim_uart_tx_busy)
+    {
+        avr_sim_uart_tx_left -= step;
+        if (avr_sim_uart_tx_left == 0)
+        {
+            if (avr_sim_uart_tx_handler != NULL)
+            {
+                avr_sim_uart_tx_handler(avr_sim_uart_tx_shift);
+            }
+
+            if ( !(UCSR0A & _BV(UDRE0)) )
+            {
+                avr_sim_uart_tx_shift = avr_sim_uart_tx_buffer;
+                avr_sim_uart_tx_left = _avr_sim_uart_frame();
+                UCSR0A |= _BV(UDRE0);
+            }
+            else
+            {
+                avr_sim_uart_tx_busy = 0;
+                UCSR0A |= _BV(TXC0);
+            }
+        }
+    }
+
+    if (avr_sim_uart_rx_busy)
+    {
+        avr_sim_uart_rx_left -= step;
+        if (avr_sim_uart_rx_left == 0)
+        {
+            avr_sim_uart_rx_busy = 0;
+            if (avr_sim_uart_fifo_count < 2)
+            {
+                avr_sim_uart_fifo[avr_sim_uart_fifo_count++] =
+                    queue->data[queue->tail];
+                UCSR0A = (UCSR0A & ~_BV(DOR0)) | _BV(RXC0);
+            }
+            else
+            {
+                UCSR0A |= _BV(DOR0);
+            }
+            queue->tail = QUEUE_WRAP(queue->tail + 1);
+        }
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to start receiving the next queued bytes.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_avr_sim_queues(void)
+{
+    avr_sim_queue* queue = &avr_sim_uart_queue;
+
+    if ( !avr_sim_uart_rx_busy && (queue->head != queue->tail) &&
+         (UCSR0B & _BV(RXEN0)) )
+    {
+        avr_sim_uart_rx_left = _avr_sim_uart_frame();
+        avr_sim_uart_rx_busy = 1;
+    }
+
+    queue = &avr_sim_pin_queue;
+    if ( (avr_sim_pin_uart_port >= 0) && !avr_sim_pin_enc_state &&
+         (queue->head != queue->tail) )
+    {
+        avr_sim_pin_enc_byte = queue->data[queue->tail];
+        queue->tail = QUEUE_WRAP(queue->tail + 1);
+        avr_sim_pin_drive(PORT_REG(avr_sim_pin_uart_port),
+                          avr_sim_pin_uart_rx_pin, 0);
+        avr_sim_pin_enc_left = avr_sim_pin_uart_bit;
+        avr_sim_pin_enc_state = PIN_UART_START;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to advance the decoder and the encoder of the pin UART.
+ *
+ * @param step Number of CPU cycles.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_avr_sim_pin_uart_step(uint32_t step)
+{
+    volatile uint8_t* port;
+    uint8_t level;
+    uint8_t state;
+
+    if (avr_sim_pin_uart_port < 0)
+    {
+        return;
+    }
+    port = PORT_REG(avr_sim_pin_uart_port);
+
+    if (avr_sim_pin_dec_state)
+    {
+        avr_sim_pin_dec_left -= step;
+        if (avr_sim_pin_dec_left == 0)
+        {
+            state = avr_sim_pin_dec_state;
+            level = (port[-2] >> avr_sim_pin_uart_tx_pin) & 0x01;
+            avr_sim_pin_dec_left = avr_sim_pin_uart_bit;
+
+            if (state < PIN_UART_STOP)
+            {
+                avr_sim_pin_dec_byte = (avr_sim_pin_dec_byte >> 1) |
+                                       (level << 7);
+                avr_sim_pin_dec_state = state + 1;
+            }
+            else
+            {
+                if ( level && (avr_sim_pin_uart_handler != NULL) )
+                {
+                    avr_sim_pin_uart_handler(avr_sim_pin_dec_byte);
+                }
+                avr_sim_pin_dec_state = 0;
+            }
+        }
+    }
+
+    if (avr_sim_pin_enc_state)
+    {
+        avr_sim_pin_enc_left -= step;
+        if (avr_sim_pin_enc_left == 0)
+        {
+            state = avr_sim_pin_enc_state++;
+            avr_sim_pin_enc_left = avr_sim_pin_uart_bit;
+
+            if (state < PIN_UART_STOP)
+            {
+                avr_sim_pin_drive(port, avr_sim_pin_uart_rx_pin,
+                                  avr_sim_pin_enc_byte & 0x01);
+                avr_sim_pin_enc_byte >>= 1;
+            }
+            else if (state == PIN_UART_STOP)
+            {
+                avr_sim_pin_drive(port, avr_sim_pin_uart_rx_pin, 1);
+            }
+            else
+            {
+                avr_sim_pin_enc_state = 0;
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to update the pin levels and the pin interrupt flags.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_avr_sim_pins(void)
+{
+    volatile uint8_t* pin;
+    uint8_t changed;
+    uint8_t level;
+    uint8_t edge;
+    uint8_t ddr;
+    uint8_t out;
+    uint8_t i;
+    uint8_t j;
+
+    for (i = 0; i < PORTS; i++)
+    {
+        pin = &avr_sim_io[PORT_BASE + 3 * i];
+        ddr = pin[1];
+        out = pin[2];
+        level = (out & ddr) |
+                (~ddr & ((avr_sim_pin_driven[i] & avr_sim_pin_level[i]) |
+                         (~avr_sim_pin_driven[i] & out)));
+        *pin = level;
+
+        changed = level ^ avr_sim_pin_last[i];
+        if (changed == 0)
+        {
+            continue;
+        }
+        avr_sim_pin_last[i] = level;
+
+        if (changed & (&PCMSK0)[i])
+        {
+            PCIFR |= _BV(i);
+        }
+
+        if (i == 2)
+        {
+            // INT0 on PD2 and INT1 on PD3, low level sense is not simulated
+            for (j = 0; j < 2; j++)
+            {
+                edge = (EICRA >> (2 * j)) & 0x03;
+                if ( (changed & _BV(PD2 + j)) &&
+                     ( (edge == 1) ||
+                       ((edge == 2) && !(level & _BV(PD2 + j))) ||
+                       ((edge == 3) && (level & _BV(PD2 + j))) ) )
+                {
+                    EIFR |= _BV(j);
+                }
+            }
+        }
+
+        if ( (i == avr_sim_pin_uart_port) && !avr_sim_pin_dec_state &&
+             (changed & _BV(avr_sim_pin_uart_tx_pin)) &&
+             !(level & _BV(avr_sim_pin_uart_tx_pin)) )
+        {
+            // Start bit, the first data bit is sampled in its middle
+            avr_sim_pin_dec_left = avr_sim_pin_uart_bit +
+                                   avr_sim_pin_uart_bit / 2;
+            avr_sim_pin_dec_state = PIN_UART_START;
+        }
+
+        if (avr_sim_pin_changed != NULL)
+        {
+            for (j = 0; j < 8; j++)
+            {
+                if (changed & _BV(j))
+                {
+                    avr_sim_pin_changed(&pin[2], j, (level >> j) & 0x01);
+                }
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to dispatch the pending interrupt of highest priority.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_avr_sim_interrupts(void)
+{
+    const avr_sim_irq* irq;
+    uint8_t i;
+
+    if ( !(SREG & _BV(SREG_I)) )
+    {
+        return;
+    }
+
+    for (i = 0; i < sizeof(avr_sim_irqs) / sizeof(avr_sim_irqs[0]); i++)
+    {
+        irq = &avr_sim_irqs[i];
+        if ( (*irq->flag & _BV(irq->flag_bit)) &&
+             (*irq->enable & _BV(irq->enable_bit)) )
+        {
+            if (irq->clear)
+            {
+                *irq->flag &= ~_BV(irq->flag_bit);
+            }
+
+            // The I flag is cleared while the routine runs, set by RETI
+            SREG &= ~_BV(SREG_I);
+            irq->vector();
+            _avr_sim_resolve();
+            SREG |= _BV(SREG_I);
+            return;
+        }
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to queue bytes.
+ *
+ * @param queue Pointer to the queue.
+ * @param data Pointer to the bytes.
+ * @param size Number of bytes.
+ *
+ * @return Number of bytes queued.
+ */
+/*****************************************************************************/
+static uint16_t
+_avr_sim_queue_push(avr_sim_queue* queue, const uint8_t* data, uint16_t size)
+{
+    uint16_t queued = 0;
+
+    while ( (queued < size) && (QUEUE_WRAP(queue->head + 1) != queue->tail) )
+    {
+        queue->data[queue->head] = data[queued++];
+        queue->head = QUEUE_WRAP(queue->head + 1);
+    }
+
+    return queued;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the index of a port.
+ *
+ * @param port Port address (ex. &PORTD).
+ *
+ * @return 0 to 2 for the ports B to D, -1 otherwise.
+ */
+/*****************************************************************************/
+static int8_t
+_avr_sim_port_index(volatile uint8_t* port)
+{
+    uintptr_t offset = (uintptr_t) port - (uintptr_t) avr_sim_io;
+
+    if ( (offset < PORT_BASE + 2) || (offset >= PORT_BASE + 3 * PORTS) ||
+         (((offset - PORT_BASE - 2) % 3) != 0) )
+    {
+        return -1;
+    }
+
+    return (int8_t) ((offset - PORT_BASE - 2) / 3);
+}
+
+/*****************************************************************************/
+/*!
+ * Function called by the interrupts not defined by the drivers, the target
+ * would restart.
+ *
+ * @param vector Name of the interrupt vector.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_avr_sim_bad_interrupt(const char* vector)
+{
+    fprintf(stderr, "avr_sim: %s enabled without handler\n", vector);
+    abort();
+}
+
+/**** avr-libc replacements **************************************************/
+
+uint8_t
+eeprom_read_byte(const uint8_t* addr)
+{
+    return avr_sim_eeprom[(uintptr_t) addr];
+}
+
+void
+eeprom_write_byte(uint8_t* addr, uint8_t value)
+{
+    avr_sim_eeprom[(uintptr_t) addr] = value;
+    avr_sim_eeprom_writes[(uintptr_t) addr]++;
+}
+
+void
+eeprom_update_byte(uint8_t* addr, uint8_t value)
+{
+    if (avr_sim_eeprom[(uintptr_t) addr] != value)
+    {
+        eeprom_write_byte(addr, value);
+    }
+}
+
+void
+eeprom_read_block(void* dst, const void* src, uint16_t size)
+{
+    uint8_t* out = (uint8_t *) dst;
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        out[i] = avr_sim_eeprom[(uintptr_t) src + i];
+    }
+}
+
+uint8_t
+eeprom_is_ready(void)
+{
+    return 1;
+}
+
+/* Weak so the tests can simulate the watchdog and the time asleep */
+void sleep_cpu(void) __attribute__((weak));
+void wdt_reset(void) __attribute__((weak));
+
+void
+sleep_cpu(void)
+{
+    // The CPU keeps running, a millisecond lets the peripherals wake it up
+    avr_sim_run(F_CPU / 1000UL);
+}
+
+void
+wdt_reset(void)
+{
+
+}
+
+void
+_delay_ms(double ms)
+{
+    _delay_us(ms * 1000.0);
+}
+
+void
+_delay_us(double us)
+{
+    avr_sim_delay_us += (uint32_t) us;
+    avr_sim_run((uint32_t) (us * CYCLES_PER_US));
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
@@ -0,0 +1,132 @@
+/******************************************************************************
+* Title                 :   Host AVR simulation header file
+* Filename              :   avr_sim.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file avr_sim.h
+ *  @brief Defines the host AVR simulation function definitions.
+ *
+ *  The drivers reach the hardware through the avr-libc headers, which form
+ *  the hardware abstraction layer of the project. The backend is selected
+ *  when building: for the target the include path holds the avr-libc
+ *  headers, so there is no overhead at all, and for the host it holds the
+ *  headers of this folder and avr_sim.c is linked.
+ *
+ *  The host backend is a simulated ATmega328P register file. Until
+ *  avr_sim_start is called the registers are plain memory, which is what the
+ *  unit tests use. Once started, a virtual clock advances a few cycles on
+ *  every register access and through the delay functions, and it runs:
+ *   * Timer0, Timer1 and Timer2 (normal, CTC and fast PWM counting), with
+ *     OCRnA and OCRnB double buffered until BOTTOM in the PWM modes
+ *   * UART0 transmitter and receiver, with the frame time of the baud rate
+ *   * Pin levels, pin change (PCINT) and external (INT0/1) interrupt flags
+ *   * Interrupts dispatched by priority while the I flag of SREG is set
+ *   * A UART decoded and generated on two pins, for the software UART
+ *
+ *  A read and a write are the same pointer access on the host, so the
+ *  simulation tells them apart by comparing the register before and after
+ *  the access. Writing a register with the value it already holds is seen
+ *  as a read, except for the interrupt flag registers, whose unused bit 7
+ *  reads as 1 to detect the writes. A byte written to UDR0 equal to a
+ *  received byte not read yet is also taken as a read, and a read of UDR0
+ *  with no received byte as a write.
+ *
+ *  A loop waiting for a variable set by an interrupt must access a register
+ *  while waiting (ex. cli and sei), otherwise the virtual clock does not
+ *  advance. SPI, TWI, ADC, EEPROM and watchdog registers are plain memory
+ *  and sleep_cpu does not stop the CPU (see avr/sleep.h).
+ */
+
+#ifndef __HOST_AVR_SIM_H
+#define __HOST_AVR_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include "avr/io.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Frequency of the simulated CPU */
+#ifndef F_CPU
+    #define F_CPU 16000000UL
+#endif
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*! Cycles the virtual clock advances on every register access */
+#ifndef AVR_SIM_ACCESS_CYCLES
+    #define AVR_SIM_ACCESS_CYCLES   4
+#endif
+
+/*! Maximum number of scheduled events */
+#ifndef AVR_SIM_EVENTS
+    #define AVR_SIM_EVENTS          8
+#endif
+
+/*! Size of the queues of the bytes to be received, must be a power of 2 */
+#ifndef AVR_SIM_RX_QUEUE_SIZE
+    #define AVR_SIM_RX_QUEUE_SIZE   256
+#endif
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Function called with every byte sent by the simulated CPU
+  */
+typedef void (*avr_sim_byte_handler)(uint8_t data);
+
+/*!
+  * @brief  Function called when the level of a pin changes
+  */
+typedef void (*avr_sim_pin_handler)(volatile uint8_t* port, uint8_t pin,
+                                    uint8_t level);
+
+/*!
+  * @brief  Function called when a scheduled event is due
+  */
+typedef void (*avr_sim_event)(void);
+
+/*!
+  * @brief  Function called at the end of every period of a timer
+  */
+typedef void (*avr_sim_timer_handler)(uint8_t timer, uint16_t top,
+                                      uint16_t compare_a, uint16_t compare_b);
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void avr_sim_start(void);
+void avr_sim_stop(void);
+void avr_sim_run(uint32_t cycles);
+uint64_t avr_sim_cycles(void);
+uint64_t avr_sim_micros(void);
+uint8_t avr_sim_schedule(uint32_t delay_us, avr_sim_event event);
+void avr_sim_timer_set_handler(avr_sim_timer_handler handler);
+void avr_sim_uart_set_handler(avr_sim_byte_handler handler);
+uint16_t avr_sim_uart_rx(const uint8_t* data, uint16_t size);
+uint16_t avr_sim_uart_rx_pending(void);
+void avr_sim_pin_drive(volatile uint8_t* port, uint8_t pin, int8_t level);
+void avr_sim_pin_set_handler(avr_sim_pin_handler handler);
+void avr_sim_pin_uart(volatile uint8_t* port, uint8_t tx_pin, uint8_t rx_pin,
+                      uint32_t baud, avr_sim_byte_handler handler);
+uint16_t avr_sim_pin_uart_rx(const uint8_t* data, uint16_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_AVR_SIM_H */
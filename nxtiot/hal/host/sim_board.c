@@ -0,0 +1,298 @@
+/******************************************************************************
+* Title                 :   Host NXTIOT board source file
+* Filename              :   sim_board.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file        sim_board.c
+ *  @brief       Virtual NXTIOT board built around the simulated ATmega328P
+ *
+ *  ## Overview ##
+ *  Linked with the examples built for the host, it starts the simulation
+ *  before main and wires the simulated CPU to the terminal:
+ *   * The bytes sent by UART0 and by the software UART (SOFT_UART_TX_PIN)
+ *     are written to stdout.
+ *   * The bytes read from stdin are received by UART0 while its receiver is
+ *     enabled, by the software UART (SOFT_UART_RX_PIN) otherwise.
+ *   * The changes of the LED and of the Wisol enable pin are logged to stderr
+ *     with the virtual time.
+ *   * The push button is released (high) and pressed at the times given by
+ *     NXTIOT_SIM_PRESS.
+ *
+ *  When stdin is a terminal the virtual clock is kept at the wall clock, so
+ *  the examples can be used interactively, otherwise it runs as fast as
+ *  possible. The process exits after NXTIOT_SIM_TIME seconds of virtual time.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      make host
+ *      NXTIOT_SIM_TIME=5 NXTIOT_SIM_PRESS=1000,3000 \
+ *          ./build/button_nxtiot_gcc_host
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#define AVR_SIM_RAW_ACCESS
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "avr_sim.h"
+#include "nxtiot_board.h"
+#include "soft_uart.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Virtual time in seconds before exiting, 0 to run until interrupted */
+#define SIM_TIME_DEFAULT    10
+/*! Period in microseconds of the stdin polling */
+#define POLL_PERIOD_US      10000UL
+/*! Time in microseconds the push button is held pressed */
+#define PRESS_TIME_US       200000UL
+/*! Maximum number of push button presses */
+#define PRESSES             16
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Press times of the push button in milliseconds */
+static uint32_t sim_board_press[PRESSES];
+/*! Number of push button presses */
+static uint8_t sim_board_presses;
+/*! Next push button press */
+static uint8_t sim_board_next_press;
+/*! Set when the virtual clock follows the wall clock */
+static uint8_t sim_board_realtime;
+/*! Wall clock when the simulation started */
+static struct timespec sim_board_start;
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static void _sim_board_output(uint8_t data);
+static void _sim_board_pin_changed(volatile uint8_t* port, uint8_t pin,
+                                   uint8_t level);
+static void _sim_board_poll(void);
+static void _sim_board_press(void);
+static void _sim_board_release(void);
+static void _sim_board_schedule_press(void);
+static void _sim_board_exit(void);
+static void _sim_board_init(void) __attribute__((constructor));
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function called before main to start the simulation and wire the board.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_sim_board_init(void)
+{
+    const char* value;
+    char* end;
+    uint32_t seconds = SIM_TIME_DEFAULT;
+
+    avr_sim_start();
+    avr_sim_uart_set_handler(_sim_board_output);
+    avr_sim_pin_set_handler(_sim_board_pin_changed);
+    avr_sim_pin_uart(PORTD_ADDR, SOFT_UART_TX_PIN, SOFT_UART_RX_PIN,
+                     SOFT_UART_BAUD, _sim_board_output);
+    avr_sim_pin_drive(SW_PORT, SW_PIN, 1);
+
+    value = getenv("NXTIOT_SIM_TIME");
+    if (value != NULL)
+    {
+        seconds = strtoul(value, NULL, 10);
+    }
+    if (seconds > 0)
+    {
+        avr_sim_schedule(seconds * 1000000UL, _sim_board_exit);
+    }
+
+    value = getenv("NXTIOT_SIM_PRESS");
+    while ( (value != NULL) && (*value != 0x00) &&
+            (sim_board_presses < PRESSES) )
+    {
+        sim_board_press[sim_board_presses++] = strtoul(value, &end, 10);
+        value = (*end == ',') ? end + 1 : NULL;
+    }
+    _sim_board_schedule_press();
+
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+    sim_board_realtime = isatty(STDIN_FILENO);
+    clock_gettime(CLOCK_MONOTONIC, &sim_board_start);
+    avr_sim_schedule(POLL_PERIOD_US, _sim_board_poll);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to write a byte sent by the simulated CPU to stdout.
+ *
+ * @param data Byte sent.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_sim_board_output(uint8_t data)
+{
+    putchar(data);
+    fflush(stdout);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to log the changes of the LED and the Wisol enable pin.
+ *
+ * @param port Port address.
+ * @param pin Pin number.
+ * @param level New level.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_sim_board_pin_changed(volatile uint8_t* port, uint8_t pin, uint8_t level)
+{
+    const char* name = NULL;
+    uint64_t us = avr_sim_micros();
+
+    if ( (port == LED_PORT) && (pin == LED_PIN) )
+    {
+        name = "LED";
+    }
+    else if ( (port == WISOL_EN_PORT) && (pin == WISOL_EN_PIN) )
+    {
+        name = "WISOL EN";
+    }
+
+    if (name != NULL)
+    {
+        fprintf(stderr, "[%4lu.%06lu] %s %s\n", (unsigned long) (us / 1000000),
+                (unsigned long) (us % 1000000), name, level ? "HIGH" : "LOW");
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function called every POLL_PERIOD_US to receive the bytes of stdin and
+ * to keep the virtual clock at the wall clock.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_sim_board_poll(void)
+{
+    struct timespec now;
+    struct timespec wait;
+    uint8_t data[64];
+    int64_t ahead;
+    ssize_t size;
+
+    size = read(STDIN_FILENO, data, sizeof(data));
+    if (size > 0)
+    {
+        if (UCSR0B & _BV(RXEN0))
+        {
+            avr_sim_uart_rx(data, (uint16_t) size);
+        }
+        else
+        {
+            avr_sim_pin_uart_rx(data, (uint16_t) size);
+        }
+    }
+
+    if (sim_board_realtime)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        ahead = (int64_t) avr_sim_micros() -
+                ((int64_t) (now.tv_sec - sim_board_start.tv_sec) * 1000000 +
+                 (now.tv_nsec - sim_board_start.tv_nsec) / 1000);
+        if (ahead > 0)
+        {
+            wait.tv_sec = ahead / 1000000;
+            wait.tv_nsec = (ahead % 1000000) * 1000;
+            nanosleep(&wait, NULL);
+        }
+    }
+
+    avr_sim_schedule(POLL_PERIOD_US, _sim_board_poll);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to press the push button.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_sim_board_press(void)
+{
+    avr_sim_pin_drive(SW_PORT, SW_PIN, 0);
+    avr_sim_schedule(PRESS_TIME_US, _sim_board_release);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to release the push button.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_sim_board_release(void)
+{
+    avr_sim_pin_drive(SW_PORT, SW_PIN, 1);
+    _sim_board_schedule_press();
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to schedule the next push button press.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_sim_board_schedule_press(void)
+{
+    uint64_t at;
+    uint64_t now = avr_sim_micros();
+
+    if (sim_board_next_press < sim_board_presses)
+    {
+        at = sim_board_press[sim_board_next_press++] * 1000ULL;
+        avr_sim_schedule((at > now) ? (uint32_t) (at - now) : 0,
+                         _sim_board_press);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to end the simulation.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_sim_board_exit(void)
+{
+    fflush(stdout);
+    exit(0);
+}
@@ -0,0 +1,68 @@
+/******************************************************************************
+* Title                 :   Host AVR CRC16 header
+* Filename              :   crc16.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file crc16.h
+ *  @brief Host replacement of the avr-libc <util/crc16.h> header.
+ *
+ *  Same results as the optimized avr-libc versions, written in plain C.
+ */
+
+#ifndef __HOST_UTIL_CRC16_H
+#define __HOST_UTIL_CRC16_H
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+static inline uint16_t
+_crc_xmodem_update(uint16_t crc, uint8_t data)
+{
+    crc ^= ((uint16_t) data << 8);
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        if (crc & 0x8000)
+        {
+            crc = (crc << 1) ^ 0x1021;
+        }
+        else
+        {
+            crc <<= 1;
+        }
+    }
+
+    return crc;
+}
+
+static inline uint8_t
+_crc8_ccitt_update(uint8_t crc, uint8_t data)
+{
+    crc ^= data;
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        if (crc & 0x80)
+        {
+            crc = (crc << 1) ^ 0x07;
+        }
+        else
+        {
+            crc <<= 1;
+        }
+    }
+
+    return crc;
+}
+
+#endif /* __HOST_UTIL_CRC16_H */
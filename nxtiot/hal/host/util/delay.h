@@ -0,0 +1,38 @@
+/******************************************************************************
+* Title                 :   Host AVR delay header
+* Filename              :   delay.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file delay.h
+ *  @brief Host replacement of the avr-libc <util/delay.h> header.
+ *
+ *  The delays do not wait, they only accumulate the requested time so the
+ *  tests can check how long a driver would have blocked.
+ */
+
+#ifndef __HOST_UTIL_DELAY_H
+#define __HOST_UTIL_DELAY_H
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+/*! Total time in microseconds requested through the delay functions */
+extern uint32_t avr_sim_delay_us;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void _delay_ms(double ms);
+void _delay_us(double us);
+
+#endif /* __HOST_UTIL_DELAY_H */
@@ -0,0 +1,773 @@
+/******************************************************************************
+* Title                 :   Host Wisol emulator source file
+* Filename              :   wisol_sim.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file        wisol_sim.c
+ *  @brief       Emulator of the Sigfox Wisol module
+ *
+ *  ## Overview ##
+ *  The emulator is a state machine of the module power (off, waking up,
+ *  ready, sleep and deep sleep) which collects the received bytes in a
+ *  command line. A complete line is answered after the latency of its
+ *  command, and a frame after its air time and the downlink wait, by a
+ *  single pending response: the bytes received while a response is pending
+ *  are lost, as the module does not listen while it transmits.
+ *
+ *  The times are microseconds of the caller's clock, the virtual clock of
+ *  the simulation or the wall clock, so the results are reproducible on the
+ *  virtual clock.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      wisol_sim_config config;
+ *      uint8_t id[8];
+ *
+ *      avr_sim_start();
+ *      wisol_sim_default_config(&config);
+ *      config.error_every = 10;
+ *      wisol_sim_attach(&config);
+ *
+ *      tick_init();
+ *      sigfox_wisol_init();
+ *      sei();
+ *      sigfox_wisol_get_id(id, sizeof(id), NULL);
+ *
+ *      latency = wisol_sim_get_stats()->last_latency_us;
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#define AVR_SIM_RAW_ACCESS
+#include <stddef.h>
+#include <string.h>
+#include "wisol_sim.h"
+#include "avr_sim.h"
+#include "nxtiot_board.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Microseconds of a day, the period of the quotas */
+#define DAY_US          86400000000ULL
+/*! Maximum payload of a frame in bytes */
+#define FRAME_MAX       12
+/*! Size of a downlink in bytes */
+#define DOWNLINK_SIZE   8
+/*! Response of the commands accepted */
+#define RESPONSE_OK     "OK\r\n"
+/*! Response of the commands rejected */
+#define RESPONSE_ERROR  "ERROR\r\n"
+/*! Response of a downlink not received */
+#define RESPONSE_NO_RX  "ERR_SFX_ERR_SEND_FRAME_WAIT_TIMEOUT\r\n"
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  Power state of the module
+  */
+typedef enum
+{
+    WISOL_SIM_OFF = 0,
+    WISOL_SIM_WAKING,
+    WISOL_SIM_READY,
+    WISOL_SIM_SLEEP,
+    WISOL_SIM_DEEP_SLEEP
+} wisol_sim_state;
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Behaviour of the module */
+static wisol_sim_config wisol_sim_cfg;
+/*! Function called with the responses */
+static wisol_sim_output wisol_sim_out;
+/*! Statistics */
+static wisol_sim_stats wisol_sim_statistics;
+/*! Power state */
+static wisol_sim_state wisol_sim_power;
+/*! Time the module is ready after waking up */
+static uint64_t wisol_sim_ready_at;
+/*! Time the module woke up */
+static uint64_t wisol_sim_awake_at;
+/*! Command line being received */
+static char wisol_sim_line[WISOL_SIM_LINE_SIZE];
+/*! Length of the command line, WISOL_SIM_LINE_SIZE after an overflow */
+static uint8_t wisol_sim_line_length;
+/*! Time of the first byte of the command line */
+static uint64_t wisol_sim_line_start;
+/*! Pending response */
+static char wisol_sim_response[WISOL_SIM_RESPONSE_SIZE];
+/*! Time the pending response is due, WISOL_SIM_IDLE if none */
+static uint64_t wisol_sim_due;
+/*! Set when the pending response ends a frame, 2 with a downlink */
+static uint8_t wisol_sim_frame;
+/*! Power state entered after the pending response */
+static wisol_sim_state wisol_sim_next_power;
+/*! Fault injected in the next commands */
+static wisol_sim_fault wisol_sim_fault_type;
+/*! Number of next commands with the fault */
+static uint8_t wisol_sim_faults;
+/*! Day of the quota counters */
+static uint64_t wisol_sim_day;
+/*! Frames sent in the day */
+static uint16_t wisol_sim_day_uplinks;
+/*! Downlinks requested in the day */
+static uint8_t wisol_sim_day_downlinks;
+/*! Time of the next avr_sim event, WISOL_SIM_IDLE if none */
+static uint64_t wisol_sim_scheduled;
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static void _wisol_sim_wake(uint64_t now);
+static void _wisol_sim_power_down(wisol_sim_state state, uint64_t now);
+static void _wisol_sim_update(uint64_t now);
+static void _wisol_sim_command(uint64_t now);
+static void _wisol_sim_frame(const char* args, uint8_t bit, uint64_t now);
+static void _wisol_sim_respond(const char* response, uint32_t delay,
+                               uint64_t now);
+static uint8_t _wisol_sim_hex_length(const char* str);
+static void _wisol_sim_uart_output(const uint8_t* data, uint16_t size);
+static void _wisol_sim_uart_received(uint8_t data);
+static void _wisol_sim_schedule(void);
+static void _wisol_sim_event(void);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup wisol_sim
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to get the default behaviour of the module.
+ *
+ * The times are typical of the WSSFM10 module in the RC1 zone and the
+ * quotas those of the Sigfox platinum subscription.
+ *
+ * @param config Pointer to the configuration to be filled.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+wisol_sim_default_config(wisol_sim_config* config)
+{
+    config->id = "0123ABCD";
+    config->pac = "1234567890ABCDEF";
+    config->downlink = "0102030405060708";
+    config->wakeup_us = 30000UL;
+    config->latency_us = 5000UL;
+    config->uplink_us = 6000000UL;
+    config->downlink_us = 25000000UL;
+    config->uplinks_per_day = 140;
+    config->downlinks_per_day = 4;
+    config->error_every = 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize the emulator, the module is powered off.
+ *
+ * @param config Pointer to the behaviour of the module, copied.
+ * @param output Function called with the responses.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+wisol_sim_init(const wisol_sim_config* config, wisol_sim_output output)
+{
+    wisol_sim_cfg = *config;
+    wisol_sim_out = output;
+    memset(&wisol_sim_statistics, 0, sizeof(wisol_sim_statistics));
+    wisol_sim_power = WISOL_SIM_OFF;
+    wisol_sim_line_length = 0;
+    wisol_sim_due = WISOL_SIM_IDLE;
+    wisol_sim_frame = 0;
+    wisol_sim_faults = 0;
+    wisol_sim_day = 0;
+    wisol_sim_day_uplinks = 0;
+    wisol_sim_day_downlinks = 0;
+    wisol_sim_scheduled = WISOL_SIM_IDLE;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to change the level of the enable pin of the module.
+ *
+ * The module wakes up when the pin rises and powers off when it falls,
+ * aborting the pending response.
+ *
+ * @param level Level of the enable pin.
+ * @param now Current time in microseconds.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+wisol_sim_enable(uint8_t level, uint64_t now)
+{
+    if (level && (wisol_sim_power == WISOL_SIM_OFF))
+    {
+        _wisol_sim_wake(now);
+    }
+    else if (!level && (wisol_sim_power != WISOL_SIM_OFF))
+    {
+        if ( (wisol_sim_due != WISOL_SIM_IDLE) && wisol_sim_frame )
+        {
+            wisol_sim_statistics.aborted++;
+        }
+        wisol_sim_due = WISOL_SIM_IDLE;
+        wisol_sim_line_length = 0;
+        _wisol_sim_power_down(WISOL_SIM_OFF, now);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to pass a byte received by the module.
+ *
+ * @param data Received byte.
+ * @param now Current time in microseconds.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+wisol_sim_receive(uint8_t data, uint64_t now)
+{
+    _wisol_sim_update(now);
+
+    if (wisol_sim_power == WISOL_SIM_SLEEP)
+    {
+        // The first byte wakes the module up and is lost
+        _wisol_sim_wake(now);
+    }
+    if ( (wisol_sim_power != WISOL_SIM_READY) ||
+         (wisol_sim_due != WISOL_SIM_IDLE) )
+    {
+        wisol_sim_statistics.lost++;
+        return;
+    }
+
+    if ( (data == '\r') || (data == '\n') )
+    {
+        if (wisol_sim_line_length > 0)
+        {
+            _wisol_sim_command(now);
+            wisol_sim_line_length = 0;
+        }
+        return;
+    }
+
+    if (wisol_sim_line_length == 0)
+    {
+        wisol_sim_line_start = now;
+    }
+    if (wisol_sim_line_length < WISOL_SIM_LINE_SIZE - 1)
+    {
+        wisol_sim_line[wisol_sim_line_length++] = (char) data;
+    }
+    else
+    {
+        wisol_sim_line_length = WISOL_SIM_LINE_SIZE;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send the pending response when it is due.
+ *
+ * @param now Current time in microseconds.
+ *
+ * @return Time the pending response is due, WISOL_SIM_IDLE if none.
+ */
+/*****************************************************************************/
+uint64_t
+wisol_sim_poll(uint64_t now)
+{
+    _wisol_sim_update(now);
+
+    if ( (wisol_sim_due == WISOL_SIM_IDLE) || (now < wisol_sim_due) )
+    {
+        return wisol_sim_due;
+    }
+
+    wisol_sim_due = WISOL_SIM_IDLE;
+    if (wisol_sim_frame)
+    {
+        wisol_sim_statistics.uplinks++;
+        if ( (wisol_sim_frame == 2) &&
+             (strncmp(wisol_sim_response, RESPONSE_OK,
+                      strlen(RESPONSE_OK)) == 0) )
+        {
+            wisol_sim_statistics.downlinks++;
+        }
+        wisol_sim_frame = 0;
+    }
+    wisol_sim_out((const uint8_t *) wisol_sim_response,
+                  (uint16_t) strlen(wisol_sim_response));
+
+    if (wisol_sim_next_power != WISOL_SIM_READY)
+    {
+        _wisol_sim_power_down(wisol_sim_next_power, now);
+    }
+
+    return WISOL_SIM_IDLE;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to inject a fault in the next commands.
+ *
+ * @param fault Fault injected.
+ * @param count Number of commands with the fault.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+wisol_sim_inject(wisol_sim_fault fault, uint8_t count)
+{
+    wisol_sim_fault_type = fault;
+    wisol_sim_faults = count;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the statistics of the module.
+ *
+ * @return Pointer to the statistics.
+ */
+/*****************************************************************************/
+const wisol_sim_stats*
+wisol_sim_get_stats(void)
+{
+    return &wisol_sim_statistics;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to connect the emulator to the simulated ATmega328P.
+ *
+ * The bytes sent by UART0 are received by the module, the responses are
+ * received by UART0 and the Wisol enable pin powers the module. The UART0
+ * handler and the pin handler of the simulation are replaced, a board
+ * with its own pin handler passes the changes to wisol_sim_pin_changed.
+ *
+ * @param config Pointer to the behaviour of the module, copied.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+wisol_sim_attach(const wisol_sim_config* config)
+{
+    wisol_sim_init(config, _wisol_sim_uart_output);
+    avr_sim_uart_set_handler(_wisol_sim_uart_received);
+    avr_sim_pin_set_handler(wisol_sim_pin_changed);
+
+    if (*WISOL_EN_PORT & _BV(WISOL_EN_PIN))
+    {
+        wisol_sim_enable(1, avr_sim_micros());
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to pass the pin changes of the simulation to the emulator,
+ * the changes of other pins than the Wisol enable pin are ignored.
+ *
+ * @param port Port address.
+ * @param pin Pin number.
+ * @param level New level.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+wisol_sim_pin_changed(volatile uint8_t* port, uint8_t pin, uint8_t level)
+{
+    if ( (port == WISOL_EN_PORT) && (pin == WISOL_EN_PIN) )
+    {
+        wisol_sim_enable(level, avr_sim_micros());
+        _wisol_sim_schedule();
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to wake the module up.
+ *
+ * @param now Current time in microseconds.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wisol_sim_wake(uint64_t now)
+{
+    wisol_sim_power = WISOL_SIM_WAKING;
+    wisol_sim_ready_at = now + wisol_sim_cfg.wakeup_us;
+    wisol_sim_awake_at = now;
+    wisol_sim_statistics.wakeups++;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to power the module off or put it to sleep.
+ *
+ * @param state Power state entered.
+ * @param now Current time in microseconds.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wisol_sim_power_down(wisol_sim_state state, uint64_t now)
+{
+    if ( (wisol_sim_power == WISOL_SIM_WAKING) ||
+         (wisol_sim_power == WISOL_SIM_READY) )
+    {
+        wisol_sim_statistics.awake_us += now - wisol_sim_awake_at;
+    }
+    wisol_sim_power = state;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to end the wake-up and to reset the quotas every day.
+ *
+ * @param now Current time in microseconds.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wisol_sim_update(uint64_t now)
+{
+    if ( (wisol_sim_power == WISOL_SIM_WAKING) && (now >= wisol_sim_ready_at) )
+    {
+        wisol_sim_power = WISOL_SIM_READY;
+    }
+
+    if (now / DAY_US != wisol_sim_day)
+    {
+        wisol_sim_day = now / DAY_US;
+        wisol_sim_day_uplinks = 0;
+        wisol_sim_day_downlinks = 0;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to answer the received command line.
+ *
+ * @param now Current time in microseconds.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wisol_sim_command(uint64_t now)
+{
+    const char* line = wisol_sim_line;
+    uint32_t latency = wisol_sim_cfg.latency_us;
+
+    wisol_sim_statistics.commands++;
+    wisol_sim_next_power = WISOL_SIM_READY;
+
+    if (wisol_sim_faults > 0)
+    {
+        wisol_sim_faults--;
+        if (wisol_sim_fault_type == WISOL_SIM_FAULT_SILENT)
+        {
+            return;
+        }
+        _wisol_sim_respond(RESPONSE_ERROR, latency, now);
+        return;
+    }
+    if ( (wisol_sim_cfg.error_every > 0) &&
+         ((wisol_sim_statistics.commands % wisol_sim_cfg.error_every) == 0) )
+    {
+        _wisol_sim_respond(RESPONSE_ERROR, latency, now);
+        return;
+    }
+    if (wisol_sim_line_length >= WISOL_SIM_LINE_SIZE)
+    {
+        _wisol_sim_respond(RESPONSE_ERROR, latency, now);
+        return;
+    }
+    wisol_sim_line[wisol_sim_line_length] = 0x00;
+
+    if (strcmp(line, "AT") == 0)
+    {
+        _wisol_sim_respond(RESPONSE_OK, latency, now);
+    }
+    else if (strcmp(line, "AT$I=10") == 0)
+    {
+        _wisol_sim_respond(wisol_sim_cfg.id, latency, now);
+        strcat(wisol_sim_response, "\r\n");
+    }
+    else if (strcmp(line, "AT$I=11") == 0)
+    {
+        _wisol_sim_respond(wisol_sim_cfg.pac, latency, now);
+        strcat(wisol_sim_response, "\r\n");
+    }
+    else if (strncmp(line, "AT$SF=", 6) == 0)
+    {
+        _wisol_sim_frame(line + 6, 0, now);
+    }
+    else if (strncmp(line, "AT$SB=", 6) == 0)
+    {
+        _wisol_sim_frame(line + 6, 1, now);
+    }
+    else if ( (strncmp(line, "AT$P=", 5) == 0) && (line[5] >= '0') &&
+              (line[5] <= '2') && (line[6] == 0x00) )
+    {
+        // 0 resets the software, 1 sleeps and 2 sleeps until powered off
+        wisol_sim_next_power = (line[5] == '1') ? WISOL_SIM_SLEEP :
+                               (line[5] == '2') ? WISOL_SIM_DEEP_SLEEP :
+                                                  WISOL_SIM_READY;
+        _wisol_sim_respond(RESPONSE_OK, latency, now);
+    }
+    else if (strcmp(line, "AT$RC") == 0)
+    {
+        _wisol_sim_respond(RESPONSE_OK, latency, now);
+    }
+    else
+    {
+        _wisol_sim_respond(RESPONSE_ERROR, latency, now);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to answer AT$SF (hexadecimal payload) and AT$SB (bit), with
+ * an optional ",1" requesting a downlink.
+ *
+ * @param args Arguments of the command.
+ * @param bit 1 for AT$SB, 0 for AT$SF.
+ * @param now Current time in microseconds.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wisol_sim_frame(const char* args, uint8_t bit, uint64_t now)
+{
+    uint8_t length = bit ? 1 : _wisol_sim_hex_length(args);
+    uint8_t downlink = 0;
+    uint32_t delay = wisol_sim_cfg.uplink_us;
+    const char* hex = wisol_sim_cfg.downlink;
+    char* out;
+    uint8_t i;
+
+    if ( bit && (args[0] != '0') && (args[0] != '1') )
+    {
+        length = 0;
+    }
+    if (args[length] == ',')
+    {
+        if ( ((args[length + 1] != '0') && (args[length + 1] != '1')) ||
+             (args[length + 2] != 0x00) )
+        {
+            length = 0;
+        }
+        downlink = (args[length + 1] == '1');
+    }
+    else if (args[length] != 0x00)
+    {
+        length = 0;
+    }
+
+    if ( (length == 0) || (length > 2 * FRAME_MAX) ||
+         ((length & 0x01) && !bit) ||
+         (wisol_sim_day_uplinks >= wisol_sim_cfg.uplinks_per_day) )
+    {
+        _wisol_sim_respond(RESPONSE_ERROR, wisol_sim_cfg.latency_us, now);
+        return;
+    }
+    wisol_sim_day_uplinks++;
+
+    if (!downlink)
+    {
+        _wisol_sim_respond(RESPONSE_OK, delay, now);
+        wisol_sim_frame = 1;
+        return;
+    }
+
+    delay += wisol_sim_cfg.downlink_us;
+    if ( (hex == NULL) ||
+         (wisol_sim_day_downlinks >= wisol_sim_cfg.downlinks_per_day) )
+    {
+        _wisol_sim_respond(RESPONSE_NO_RX, delay, now);
+    }
+    else
+    {
+        wisol_sim_day_downlinks++;
+        _wisol_sim_respond(RESPONSE_OK "RX=", delay, now);
+        out = wisol_sim_response + strlen(wisol_sim_response);
+        for (i = 0; i < DOWNLINK_SIZE; i++)
+        {
+            *out++ = hex[2 * i];
+            *out++ = hex[2 * i + 1];
+            *out++ = (i < DOWNLINK_SIZE - 1) ? ' ' : '\r';
+        }
+        *out++ = '\n';
+        *out = 0x00;
+    }
+    wisol_sim_frame = 2;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to set the pending response.
+ *
+ * @param response Response, completed by the caller if needed.
+ * @param delay Time to the response in microseconds.
+ * @param now Current time in microseconds.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wisol_sim_respond(const char* response, uint32_t delay, uint64_t now)
+{
+    uint32_t latency;
+
+    // Room is left for the end of line added to the ID and the PAC
+    strncpy(wisol_sim_response, response, WISOL_SIM_RESPONSE_SIZE - 3);
+    wisol_sim_response[WISOL_SIM_RESPONSE_SIZE - 3] = 0x00;
+    wisol_sim_due = now + delay;
+
+    if (strcmp(response, RESPONSE_ERROR) == 0)
+    {
+        wisol_sim_statistics.errors++;
+    }
+
+    latency = (uint32_t) (wisol_sim_due - wisol_sim_line_start);
+    wisol_sim_statistics.last_latency_us = latency;
+    if (latency > wisol_sim_statistics.max_latency_us)
+    {
+        wisol_sim_statistics.max_latency_us = latency;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of hexadecimal digits at the start of a
+ * string.
+ *
+ * @param str Pointer to the string.
+ *
+ * @return Number of hexadecimal digits.
+ */
+/*****************************************************************************/
+static uint8_t
+_wisol_sim_hex_length(const char* str)
+{
+    uint8_t length = 0;
+
+    while ( ((str[length] >= '0') && (str[length] <= '9')) ||
+            ((str[length] >= 'A') && (str[length] <= 'F')) ||
+            ((str[length] >= 'a') && (str[length] <= 'f')) )
+    {
+        length++;
+    }
+
+    return length;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to pass the responses to UART0 of the simulation.
+ *
+ * @param data Pointer to the bytes of the response.
+ * @param size Number of bytes.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wisol_sim_uart_output(const uint8_t* data, uint16_t size)
+{
+    avr_sim_uart_rx(data, size);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to pass the bytes sent by UART0 of the simulation.
+ *
+ * @param data Byte sent.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wisol_sim_uart_received(uint8_t data)
+{
+    wisol_sim_receive(data, avr_sim_micros());
+    _wisol_sim_schedule();
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send the pending response when due and to schedule the
+ * next one on the virtual clock.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wisol_sim_schedule(void)
+{
+    uint64_t now = avr_sim_micros();
+    uint64_t due = wisol_sim_poll(now);
+
+    // A response sooner than the scheduled event needs its own event
+    if ( (due < wisol_sim_scheduled) &&
+         avr_sim_schedule((uint32_t) (due - now), _wisol_sim_event) )
+    {
+        wisol_sim_scheduled = due;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function called by the simulation when the pending response is due.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wisol_sim_event(void)
+{
+    if (avr_sim_micros() >= wisol_sim_scheduled)
+    {
+        wisol_sim_scheduled = WISOL_SIM_IDLE;
+    }
+    _wisol_sim_schedule();
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
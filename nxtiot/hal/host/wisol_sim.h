@@ -0,0 +1,137 @@
+/******************************************************************************
+* Title                 :   Host Wisol emulator header file
+* Filename              :   wisol_sim.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   Host backend of the HAL
+******************************************************************************/
+/*! @file wisol_sim.h
+ *  @brief Defines the host Wisol emulator function definitions.
+ *
+ *  The emulator answers the AT commands of the Sigfox Wisol module as the
+ *  module would, with configurable timing, so the flows of sigfox_wisol.c
+ *  can be run and timed without the module:
+ *   * Wake-up delay after the enable pin rises, the bytes received before
+ *     are lost
+ *   * Response latency of every command and air time of the frames
+ *   * Downlink replies of the frames sent with the downlink flag
+ *   * Uplink and downlink quotas per day, answered with ERROR when exceeded
+ *   * Errors and missing responses injected on demand or periodically
+ *   * Sleep and deep sleep of AT$P=1 and AT$P=2
+ *
+ *  The emulator is independent of the transport: the received bytes and the
+ *  enable pin are passed with the time they happen and the responses are
+ *  given to an output function when wisol_sim_poll is called at their due
+ *  time. wisol_sim_attach connects it to UART0 and to the Wisol enable pin
+ *  of the simulated ATmega328P (see avr_sim.h) and tools/wisol_emu connects
+ *  it to a Linux pseudo terminal.
+ *
+ *  The statistics give the latency of the commands, from their first byte
+ *  to their response, and the time the module was awake, which is what the
+ *  energy used by the driver depends on.
+ */
+
+#ifndef __HOST_WISOL_SIM_H
+#define __HOST_WISOL_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Returned by wisol_sim_poll when no response is pending */
+#define WISOL_SIM_IDLE          UINT64_MAX
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*! Maximum length of a command line */
+#ifndef WISOL_SIM_LINE_SIZE
+    #define WISOL_SIM_LINE_SIZE     48
+#endif
+
+/*! Maximum length of a response, at least 40 for the downlinks */
+#ifndef WISOL_SIM_RESPONSE_SIZE
+    #define WISOL_SIM_RESPONSE_SIZE 64
+#endif
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Fault injected in the responses
+  */
+typedef enum
+{
+    WISOL_SIM_FAULT_ERROR = 0,  /*! The command is answered with ERROR */
+    WISOL_SIM_FAULT_SILENT      /*! The command is not answered */
+} wisol_sim_fault;
+
+/*!
+  * @brief  Behaviour of the emulated module
+  */
+typedef struct
+{
+    const char* id;             /*! Answer of AT$I=10 */
+    const char* pac;            /*! Answer of AT$I=11 */
+    const char* downlink;       /*! 8 bytes in hexadecimal, NULL for none */
+    uint32_t wakeup_us;         /*! Time from the enable pin or a byte */
+    uint32_t latency_us;        /*! Time to answer a command */
+    uint32_t uplink_us;         /*! Air time of a frame */
+    uint32_t downlink_us;       /*! Wait of the downlink after the frame */
+    uint16_t uplinks_per_day;   /*! Frames accepted per day */
+    uint8_t downlinks_per_day;  /*! Downlinks accepted per day */
+    uint8_t error_every;        /*! Every n commands fail, 0 for none */
+} wisol_sim_config;
+
+/*!
+  * @brief  Statistics of the emulated module
+  */
+typedef struct
+{
+    uint32_t commands;          /*! Commands received */
+    uint32_t errors;            /*! Commands answered with an error */
+    uint32_t uplinks;           /*! Frames sent */
+    uint32_t downlinks;         /*! Downlinks received */
+    uint32_t aborted;           /*! Frames aborted by powering the module off */
+    uint32_t lost;              /*! Bytes lost while not listening */
+    uint32_t wakeups;           /*! Times the module woke up */
+    uint64_t awake_us;          /*! Time awake, up to the last power change */
+    uint32_t last_latency_us;   /*! Latency of the last command */
+    uint32_t max_latency_us;    /*! Maximum latency of a command */
+} wisol_sim_stats;
+
+/*!
+  * @brief  Function called with the bytes of a response
+  */
+typedef void (*wisol_sim_output)(const uint8_t* data, uint16_t size);
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void wisol_sim_default_config(wisol_sim_config* config);
+void wisol_sim_init(const wisol_sim_config* config, wisol_sim_output output);
+void wisol_sim_enable(uint8_t level, uint64_t now);
+void wisol_sim_receive(uint8_t data, uint64_t now);
+uint64_t wisol_sim_poll(uint64_t now);
+void wisol_sim_inject(wisol_sim_fault fault, uint8_t count);
+const wisol_sim_stats* wisol_sim_get_stats(void);
+void wisol_sim_attach(const wisol_sim_config* config);
+void wisol_sim_pin_changed(volatile uint8_t* port, uint8_t pin,
+                           uint8_t level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_WISOL_SIM_H */
@@ -0,0 +1,109 @@
+/******************************************************************************
+* Title                 :   Arena header file
+* Filename              :   arena.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file arena.h
+ *  @brief Defines the arena function definitions.
+ *
+ *  This is the header file for the definition of the arena and pool
+ *  function prototypes of the methods of the module.
+ */
+
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "nxtiot_board.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Alignment of the allocations, 1 on the AVR */
+#define ARENA_ALIGN             _Alignof(max_align_t)
+/*! Maximum number of blocks of a pool */
+#define ARENA_POOL_COUNT_MAX    16
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/*! Size rounded up to the alignment of the allocations */
+#define ARENA_ROUND(size)       ((((size) + ARENA_ALIGN - 1) / ARENA_ALIGN) * \
+                                 ARENA_ALIGN)
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Pools enumeration, sized in nxtiot_board.h
+  */
+typedef enum
+{
+    ARENA_POOL_SMALL = 0,
+    ARENA_POOL_LARGE,
+    ARENA_POOLS
+} arena_pool_id;
+
+/*!
+  * @brief  Usage of a pool
+  */
+typedef struct
+{
+    uint16_t block;             /*! Bytes of a block */
+    uint8_t count;              /*! Blocks */
+    uint8_t used;               /*! Blocks allocated now */
+    uint8_t peak;               /*! Maximum blocks allocated at once */
+    uint8_t failures;           /*! Allocations failed, saturated */
+} arena_pool_usage;
+
+/*!
+  * @brief  Usage of the RAM share of the drivers
+  */
+typedef struct
+{
+    uint16_t budget;            /*! BOARD_DRIVERS_RAM */
+    uint16_t drivers;           /*! Static buffers of the drivers */
+    uint16_t size;              /*! Bytes of the arena */
+    uint16_t used;              /*! Bytes of the arena allocated */
+    uint8_t failures;           /*! Arena allocations failed, saturated */
+    uint8_t locked;             /*! 1 after arena_lock */
+    arena_pool_usage pools[ARENA_POOLS];
+} arena_usage;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void arena_init(void);
+void* arena_alloc(uint16_t size);
+void arena_lock(void);
+void* arena_pool_alloc(arena_pool_id pool);
+void arena_pool_free(arena_pool_id pool, void* block);
+void arena_get_usage(arena_usage* usage);
+void arena_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ARENA_H */
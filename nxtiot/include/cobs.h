@@ -0,0 +1,115 @@
+/******************************************************************************
+* Title                 :   COBS framing header file
+* Filename              :   cobs.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file cobs.h
+ *  @brief Defines the COBS framing function definitions.
+ *
+ *  This is the header file for the definition of the COBS framing function
+ *  prototypes of the methods of the driver.
+ */
+
+#ifndef __COBS_H
+#define __COBS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Byte that delimits the frames */
+#define COBS_DELIMITER      0x00
+
+/*! Size of the CRC appended to every frame */
+#define COBS_CRC_SIZE       2
+
+/*! Maximum number of data bytes of a COBS block */
+#define COBS_BLOCK_SIZE     254
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/*! Maximum number of bytes sent for a frame of size bytes: the CRC, a code
+ *  byte every 254 bytes and the delimiter */
+#define COBS_FRAME_MAX(size)    ((size) + COBS_CRC_SIZE + \
+                                 ((size) + COBS_CRC_SIZE) / COBS_BLOCK_SIZE + \
+                                 2)
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Function used to send the encoded bytes, as uart_write
+  */
+typedef void (*cobs_write_fn)(const uint8_t* data, uint8_t size);
+
+/*!
+  * @brief  Part of a frame, the parts are sent one after the other
+  */
+typedef struct
+{
+    const uint8_t* data;
+    uint16_t size;
+} cobs_segment;
+
+/*!
+  * @brief  COBS decoder result enumeration
+  */
+typedef enum
+{
+    COBS_PENDING = 0U,  /*! The frame is not completed */
+    COBS_FRAME,         /*! A valid frame was received */
+    COBS_ERROR          /*! A frame with a wrong CRC, too short or too long */
+} cobs_status;
+
+/*!
+  * @brief  COBS decoder, filled by the cobs_decoder_init function
+  */
+typedef struct
+{
+    uint8_t* buffer;
+    uint16_t size;
+    uint16_t length;
+    uint16_t crc;
+    uint8_t code;
+    uint8_t remaining;
+    uint8_t error;
+} cobs_decoder;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void cobs_send(const cobs_segment* segments, uint8_t count,
+               cobs_write_fn write);
+void cobs_send_frame(const uint8_t* data, uint16_t size, cobs_write_fn write);
+void cobs_decoder_init(cobs_decoder* decoder, uint8_t* buffer, uint16_t size);
+cobs_status cobs_decode(cobs_decoder* decoder, uint8_t data);
+uint16_t cobs_frame_size(const cobs_decoder* decoder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __COBS_H */
@@ -0,0 +1,102 @@
+/******************************************************************************
+* Title                 :   Console shell header file
+* Filename              :   console.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file console.h
+ *  @brief Defines the console shell function definitions.
+ *
+ *  This is the header file for the definition of the console shell function
+ *  prototypes of the methods of the driver.
+ */
+
+#ifndef __CONSOLE_H
+#define __CONSOLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "nxtiot_board.h"
+#include "soft_uart.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Size of the name of a command, terminator included */
+#define CONSOLE_NAME_SIZE       8
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*! Size of the line being edited, terminator included */
+#ifndef CONSOLE_LINE_SIZE
+    #define CONSOLE_LINE_SIZE       32
+#endif
+
+/*! Bytes of the line and of the history */
+#define CONSOLE_RAM_SIZE        (2 * CONSOLE_LINE_SIZE)
+
+/*! Maximum number of arguments of a command, its name included */
+#ifndef CONSOLE_MAX_ARGS
+    #define CONSOLE_MAX_ARGS        6
+#endif
+
+/*! Maximum number of received bytes processed by every console_poll */
+#ifndef CONSOLE_BYTES_PER_POLL
+    #define CONSOLE_BYTES_PER_POLL  4
+#endif
+
+/*! Prompt shown before every line */
+#ifndef CONSOLE_PROMPT
+    #define CONSOLE_PROMPT          "> "
+#endif
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Function run by a command, with the words of the line
+  */
+typedef void (*console_handler)(uint8_t argc, char* argv[]);
+
+/*!
+  * @brief  Command of the console, the table is kept in flash (PROGMEM)
+  */
+typedef struct
+{
+    char name[CONSOLE_NAME_SIZE];   /*! Name typed to run the command */
+    console_handler handler;        /*! Function run */
+} console_command;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void console_init(const console_command* commands, uint8_t count);
+void console_poll(void);
+uint8_t console_tokenize(char* line, char* argv[], uint8_t max);
+void console_prompt(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CONSOLE_H */
@@ -0,0 +1,93 @@
+/******************************************************************************
+* Title                 :   EEPROM log header file
+* Filename              :   eeprom_log.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file eeprom_log.h
+ *  @brief Defines the EEPROM log function definitions.
+ *
+ *  This is the header file for the definition of the EEPROM log function
+ *  prototypes of the methods of the driver.
+ */
+
+#ifndef __EEPROM_LOG_H
+#define __EEPROM_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <string.h>
+#include "nxtiot_board.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Maximum size of the payload of a record (a Sigfox frame) */
+#define EEPROM_LOG_PAYLOAD_SIZE     12
+/*! Size of a record in the EEPROM: seq, ack, size, payload and CRC */
+#define EEPROM_LOG_RECORD_SIZE      (5 + EEPROM_LOG_PAYLOAD_SIZE + 2)
+/*! Bytes of the record buffer */
+#define EEPROM_LOG_RAM_SIZE         EEPROM_LOG_RECORD_SIZE
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*! First EEPROM address used by the log */
+#ifndef EEPROM_LOG_START_ADDR
+    #define EEPROM_LOG_START_ADDR   0x000
+#endif
+
+/*! Number of records of the log, by default the whole 1 KB EEPROM is used */
+#ifndef EEPROM_LOG_SLOTS
+    #define EEPROM_LOG_SLOTS        ((E2END + 1 - EEPROM_LOG_START_ADDR) / \
+                                     EEPROM_LOG_RECORD_SIZE)
+#endif
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  EEPROM log operation result enumeration
+  */
+typedef enum
+{
+    EEPROM_LOG_OK = 0U,
+    EEPROM_LOG_BUSY,
+    EEPROM_LOG_EMPTY,
+    EEPROM_LOG_INVALID
+} eeprom_log_status;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void eeprom_log_init(void);
+eeprom_log_status eeprom_log_append(const uint8_t* data, uint8_t size);
+eeprom_log_status eeprom_log_peek(uint8_t* data, uint8_t* size);
+eeprom_log_status eeprom_log_pop(void);
+uint8_t eeprom_log_count(void);
+uint8_t eeprom_log_busy(void);
+uint16_t eeprom_log_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EEPROM_LOG_H */
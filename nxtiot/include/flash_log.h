@@ -0,0 +1,131 @@
+/******************************************************************************
+* Title                 :   Flash log header file
+* Filename              :   flash_log.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file flash_log.h
+ *  @brief Defines the flash log function definitions.
+ *
+ *  This is the header file for the definition of the flash log function
+ *  prototypes of the methods of the driver.
+ */
+
+#ifndef __FLASH_LOG_H
+#define __FLASH_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <string.h>
+#include "nxtiot_board.h"
+#include "spi.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Size of the header of a block: sequence, count, record size and CRC */
+#define FLASH_LOG_HEADER_SIZE       8
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*! Size of a record in bytes */
+#ifndef FLASH_LOG_RECORD_SIZE
+    #define FLASH_LOG_RECORD_SIZE   8
+#endif
+
+/*! Size of a block, the unit buffered in RAM and programmed at once. It
+ *  must divide the 256 bytes program page of the flash. Two blocks are
+ *  buffered in RAM */
+#ifndef FLASH_LOG_BLOCK_SIZE
+    #define FLASH_LOG_BLOCK_SIZE    128
+#endif
+
+/*! Bytes of the two blocks, their flags and the buffers of the enable,
+ *  status and command transactions */
+#define FLASH_LOG_RAM_SIZE          (2 * FLASH_LOG_BLOCK_SIZE + 2 + 1 + 4 + 4)
+
+/*! Size of the erase sector of the flash */
+#ifndef FLASH_LOG_SECTOR_SIZE
+    #define FLASH_LOG_SECTOR_SIZE   4096UL
+#endif
+
+/*! Number of sectors used by the log, by default 1 MB */
+#ifndef FLASH_LOG_SECTORS
+    #define FLASH_LOG_SECTORS       256
+#endif
+
+/*! First flash address used by the log, aligned to a sector */
+#ifndef FLASH_LOG_START_ADDR
+    #define FLASH_LOG_START_ADDR    0x000000UL
+#endif
+
+/*! SPI clock of the flash in Hz */
+#ifndef FLASH_LOG_CLOCK
+    #define FLASH_LOG_CLOCK         8000000UL
+#endif
+
+/*! Number of records of a block */
+#define FLASH_LOG_BLOCK_RECORDS     ((FLASH_LOG_BLOCK_SIZE - \
+                                      FLASH_LOG_HEADER_SIZE) / \
+                                     FLASH_LOG_RECORD_SIZE)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Flash log operation result enumeration
+  */
+typedef enum
+{
+    FLASH_LOG_OK = 0U,
+    FLASH_LOG_BUSY,
+    FLASH_LOG_EMPTY,
+    FLASH_LOG_FULL
+} flash_log_status;
+
+/*!
+  * @brief  Sequential reader of the records of the log
+  */
+typedef struct
+{
+    uint32_t seq;       /*! Sequence number of the block being read */
+    uint8_t index;      /*! Index of the next record of the block */
+    uint8_t count;      /*! Records of the block, 0 if not loaded */
+} flash_log_reader;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void flash_log_init(uint8_t* cs_port, uint8_t cs_pin);
+flash_log_status flash_log_append(const uint8_t* record);
+void flash_log_flush(void);
+void flash_log_poll(void);
+uint8_t flash_log_busy(void);
+uint16_t flash_log_dropped(void);
+void flash_log_reader_init(flash_log_reader* reader);
+flash_log_status flash_log_read(flash_log_reader* reader, uint8_t* record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FLASH_LOG_H */
@@ -27,10 +27,7 @@ extern "C" {
 * Includes
 ******************************************************************************/
 #include <stdint.h>
-
-#ifndef TEST
-  #include "nxtiot_board.h"
-#endif
+#include "nxtiot_board.h"
 
 /******************************************************************************
 * Preprocessor Constants
@@ -44,9 +41,6 @@ extern "C" {
 /******************************************************************************
 * Macros
 ******************************************************************************/
-#ifdef TEST
-  #define _BV(bit) (1 << (bit))
-#endif
 
 /******************************************************************************
 * Typedefs
@@ -70,6 +64,15 @@ typedef enum
     GPIO_PIN_OUTPUT
 } gpio_pin_mode;
 
+/*!
+  * @brief  GPIO pin descriptor, used by the drivers that own a pin
+  */
+typedef struct
+{
+    uint8_t* port;
+    uint8_t pin;
+} gpio_pin;
+
 /******************************************************************************
 * Variables
 ******************************************************************************/
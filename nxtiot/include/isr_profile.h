@@ -0,0 +1,156 @@
+/******************************************************************************
+* Title                 :   ISR profile header file
+* Filename              :   isr_profile.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file isr_profile.h
+ *  @brief Defines the ISR profile function definitions.
+ *
+ *  This is the header file for the definition of the ISR profile function
+ *  prototypes of the methods of the driver and of the macros used to
+ *  instrument the interrupts and the critical sections of the drivers.
+ */
+
+#ifndef __ISR_PROFILE_H
+#define __ISR_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include "nxtiot_board.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*!
+ * Enables the instrumentation macros. When it is 0 the interrupts and the
+ * critical sections of the drivers are built as without the profile and
+ * Timer1 is free.
+ */
+#ifndef ISR_PROFILE_ENABLE
+    #define ISR_PROFILE_ENABLE          0
+#endif
+
+/*!
+ * Prescaler of Timer1: 1, 8 or 64. With 1 the times are CPU cycles and the
+ * periods longer than 4 ms at 16 MHz are not measured.
+ */
+#ifndef ISR_PROFILE_PRESCALER
+    #define ISR_PROFILE_PRESCALER       1
+#endif
+
+/*! Number of slots of the application */
+#ifndef ISR_PROFILE_USER_SLOTS
+    #define ISR_PROFILE_USER_SLOTS      2
+#endif
+
+/*! Bytes of the measures of the slots and of the table of the names of
+ *  the slots of the drivers, on the AVR */
+#define ISR_PROFILE_RAM_SIZE        (ISR_PROFILE_SLOTS * 24 + \
+                                     ISR_PROFILE_USER * 2)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/*!
+ * Macros used to instrument the drivers. ISR_PROFILED replaces ISR and
+ * measures the body of the interrupt, ISR_PROFILE_ENTER and ISR_PROFILE_EXIT
+ * surround a critical section, right after cli and right before the
+ * status register is restored.
+ */
+#if ISR_PROFILE_ENABLE
+    #define ISR_PROFILED(vector, slot)                                        \
+        static inline void _isr_profile_##vector(void)                        \
+            __attribute__((always_inline));                                   \
+        ISR(vector)                                                           \
+        {                                                                     \
+            isr_profile_enter(slot);                                          \
+            _isr_profile_##vector();                                          \
+            isr_profile_exit(slot);                                           \
+        }                                                                     \
+        static inline void _isr_profile_##vector(void)
+    #define ISR_PROFILE_ENTER(slot)     isr_profile_enter(slot)
+    #define ISR_PROFILE_EXIT(slot)      isr_profile_exit(slot)
+#else
+    #define ISR_PROFILED(vector, slot)  ISR(vector)
+    #define ISR_PROFILE_ENTER(slot)     do { } while (0)
+    #define ISR_PROFILE_EXIT(slot)      do { } while (0)
+#endif
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Profile slots enumeration
+  *
+  * A slot per interrupt of the drivers and per critical section with the
+  * interrupts disabled (CS). The application uses the slots from
+  * ISR_PROFILE_USER.
+  */
+typedef enum
+{
+    ISR_PROFILE_TICK = 0U,      /*! TIMER0_COMPA_vect */
+    ISR_PROFILE_UART_RX,        /*! USART_RX_vect */
+    ISR_PROFILE_SOFT_UART_TX,   /*! TIMER2_COMPA_vect */
+    ISR_PROFILE_SOFT_UART_START,/*! PCINT2_vect */
+    ISR_PROFILE_SOFT_UART_RX,   /*! TIMER2_COMPB_vect */
+    ISR_PROFILE_SPI,            /*! SPI_STC_vect */
+    ISR_PROFILE_TWI,            /*! TWI_vect */
+    ISR_PROFILE_EEPROM,         /*! EE_READY_vect */
+    ISR_PROFILE_PWM,            /*! TIMER0/1/2_OVF_vect */
+    ISR_PROFILE_CS_TICK,        /*! tick_get_ms */
+    ISR_PROFILE_CS_SOFT_UART,   /*! soft_uart_write and soft_uart_errors */
+    ISR_PROFILE_CS_SPI,         /*! spi_transfer */
+    ISR_PROFILE_CS_TWI,         /*! twi_transfer and twi_poll */
+    ISR_PROFILE_USER,
+    ISR_PROFILE_SLOTS = ISR_PROFILE_USER + ISR_PROFILE_USER_SLOTS
+} isr_profile_slot;
+
+/*!
+  * @brief  Minimum, maximum and sum of the measures, in Timer1 counts
+  */
+typedef struct
+{
+    uint16_t count;         /*! Measures, halved with the sum when full */
+    uint16_t min;           /*! Minimum measure */
+    uint16_t max;           /*! Maximum measure */
+    uint32_t sum;           /*! Sum of the measures */
+} isr_profile_stat;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void isr_profile_init(void);
+void isr_profile_clear(void);
+void isr_profile_enter(uint8_t slot);
+void isr_profile_exit(uint8_t slot);
+void isr_profile_stat_add(isr_profile_stat* stat, uint16_t value);
+uint16_t isr_profile_stat_average(const isr_profile_stat* stat);
+uint8_t isr_profile_get(uint8_t slot, isr_profile_stat* duration,
+                        isr_profile_stat* period);
+uint16_t isr_profile_worst_off(void);
+void isr_profile_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ISR_PROFILE_H */
@@ -0,0 +1,72 @@
+/******************************************************************************
+* Title                 :   Lookup table header file
+* Filename              :   lut.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file lut.h
+ *  @brief Defines the lookup table function definitions.
+ *
+ *  This is the header file for the definition of the lookup table function
+ *  prototypes of the methods of the module.
+ */
+
+#ifndef __LUT_H
+#define __LUT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Largest distance between the points, 2^8 */
+#define LUT_MAX_SHIFT       8
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Piecewise linear table of equally spaced points, in flash
+  */
+typedef struct
+{
+    uint16_t x0;                /*! Input of the first point */
+    uint16_t points;            /*! Number of points */
+    uint8_t shift;              /*! Distance between the points, 2^shift */
+    const int16_t* y;           /*! Outputs at the points, in flash */
+} lut_table;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+int16_t lut_eval(const lut_table* table, uint16_t x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LUT_H */
@@ -149,6 +149,58 @@
 /*! Wisol EN pin number */
 #define WISOL_EN_PIN    PD7
 
+/**** RAM Budget Definitions *************************************************/
+
+/*! SRAM of the ATmega328P in bytes */
+#define BOARD_RAM_SIZE          2048
+
+/*!
+ * Share of the SRAM given to the drivers: their buffers, the arena and the
+ * pools. The build fails when they do not fit (see arena.c), the rest is
+ * left to the application variables and the stack.
+ */
+#ifndef BOARD_DRIVERS_RAM
+    #define BOARD_DRIVERS_RAM       1024
+#endif
+
+/*!
+ * Drivers linked by the application, whose static buffers are counted in
+ * BOARD_DRIVERS_RAM: DRIVER(prefix) for each one, the prefix of its
+ * <prefix>_RAM_SIZE constant. Every driver defines that constant next to
+ * the configuration of its buffers and checks it against their sizes at
+ * build time. TRACE and ISR_PROFILE are left out by default as their
+ * instrumentation is disabled, add them when they are linked.
+ */
+#ifndef BOARD_RAM_DRIVERS
+    #define BOARD_RAM_DRIVERS(DRIVER)   DRIVER(UART) DRIVER(SOFT_UART)     \
+                                        DRIVER(WISOL_PARSER)               \
+                                        DRIVER(SIGFOX_WISOL)               \
+                                        DRIVER(CONSOLE) DRIVER(FLASH_LOG)  \
+                                        DRIVER(EEPROM_LOG)                 \
+                                        DRIVER(WDT_SCHEDULER) DRIVER(PWM)
+#endif
+
+/*! Bytes of the arena, allocated once at init time */
+#ifndef BOARD_ARENA_SIZE
+    #define BOARD_ARENA_SIZE        128
+#endif
+
+/*! Size and number of the blocks of the small pool */
+#ifndef BOARD_POOL_SMALL_BLOCK
+    #define BOARD_POOL_SMALL_BLOCK  16
+#endif
+#ifndef BOARD_POOL_SMALL_COUNT
+    #define BOARD_POOL_SMALL_COUNT  4
+#endif
+
+/*! Size and number of the blocks of the large pool */
+#ifndef BOARD_POOL_LARGE_BLOCK
+    #define BOARD_POOL_LARGE_BLOCK  32
+#endif
+#ifndef BOARD_POOL_LARGE_COUNT
+    #define BOARD_POOL_LARGE_COUNT  2
+#endif
+
 /******************************************************************************
 * Macros
 ******************************************************************************/
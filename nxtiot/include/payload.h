@@ -0,0 +1,98 @@
+/******************************************************************************
+* Title                 :   Payload header file
+* Filename              :   payload.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file payload.h
+ *  @brief Defines the payload function definitions.
+ *
+ *  This is the header file for the definition of the payload function
+ *  prototypes and of the fields of the uplink payloads. The field lists are
+ *  shared with the host decoder (tools/payload_decode), they must only use
+ *  the preprocessor and stdint.h.
+ */
+
+#ifndef __PAYLOAD_H
+#define __PAYLOAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Size of a summary packed by pipeline_pack_summary */
+#define PAYLOAD_SUMMARY_SIZE        PAYLOAD_SIZE(PAYLOAD_SUMMARY_FIELDS)
+/*! Size of the counters packed by sigfox_wisol_pack_uplink_stats */
+#define PAYLOAD_UPLINK_STATS_SIZE   PAYLOAD_SIZE(PAYLOAD_UPLINK_STATS_FIELDS)
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/*!
+ * Fields of a payload, one FIELD(name, first, bits, is_signed) per field:
+ * the first bit counted from the most significant bit of the first byte,
+ * the number of bits, up to 32, and 1 for the two's complement fields.
+ */
+
+/*!
+ * Size in bytes of a payload from its field list. The fields follow each
+ * other without gaps, so the size is their bits rounded up to bytes, which
+ * is checked at build time by payload.c.
+ */
+#define PAYLOAD_SIZE(FIELDS)        ((0 FIELDS(_PAYLOAD_BITS) + 7) / 8)
+#define _PAYLOAD_BITS(name, first, bits, is_signed)     + (bits)
+
+/*! Fields of the summary of a window of samples (pipeline_summary) */
+#define PAYLOAD_SUMMARY_FIELDS(FIELD)           \
+    FIELD(min,          0,  16, 1)              \
+    FIELD(mean,         16, 16, 1)              \
+    FIELD(max,          32, 16, 1)              \
+    FIELD(count,        48, 8,  0)
+
+/*! Fields of the counters of the uplink messages, saturated at 255 */
+#define PAYLOAD_UPLINK_STATS_FIELDS(FIELD)      \
+    FIELD(sent,         0,  8,  0)              \
+    FIELD(error,        8,  8,  0)              \
+    FIELD(timeout,      16, 8,  0)              \
+    FIELD(not_ready,    24, 8,  0)              \
+    FIELD(retries,      32, 8,  0)              \
+    FIELD(dropped,      40, 8,  0)              \
+    FIELD(deferred,     48, 8,  0)              \
+    FIELD(day_uplinks,  56, 8,  0)
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void payload_put(uint8_t* data, uint8_t first, uint8_t bits, uint32_t value);
+int32_t payload_get(const uint8_t* data, uint8_t first, uint8_t bits,
+                    uint8_t is_signed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PAYLOAD_H */
@@ -0,0 +1,198 @@
+/******************************************************************************
+* Title                 :   Pipeline header file
+* Filename              :   pipeline.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file pipeline.h
+ *  @brief Defines the pipeline function definitions.
+ *
+ *  This is the header file for the definition of the pipeline function
+ *  prototypes of the methods of the framework and of its stages.
+ */
+
+#ifndef __PIPELINE_H
+#define __PIPELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "nxtiot_board.h"
+#include "sigfox_wisol.h"
+#include "payload.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Returned by a stage that took the item of its input */
+#define PIPELINE_TAKEN          0x01
+/*! Returned by a stage that filled the free item of its output */
+#define PIPELINE_GIVEN          0x02
+
+/*! Size of a summary packed by pipeline_pack_summary */
+#define PIPELINE_SUMMARY_SIZE   PAYLOAD_SUMMARY_SIZE
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/*!
+ * Defines a queue of items of a type between two stages.
+ *
+ * @param name Name of the queue.
+ * @param type Type of the items.
+ * @param items Number of items.
+ */
+#define PIPELINE_QUEUE(name, type, items)                                   \
+    static type name##_items[items];                                        \
+    static pipeline_queue name = {(uint8_t *) name##_items, sizeof(type),   \
+                                  items, 0, 0}
+
+/*! Initializer of a source read every period in milliseconds */
+#define PIPELINE_SOURCE(read, period)   {read, period, 0, 0, 0}
+
+/*! Initializer of an exponential filter with a weight of 1 / 2^shift */
+#define PIPELINE_EMA(shift)             {shift, 0, 0}
+
+/*! Initializer of an aggregate of a window of samples */
+#define PIPELINE_AGGREGATE(window)      {window, 0, 0, 0, 0}
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Queue of fixed size items between two stages
+  */
+typedef struct
+{
+    uint8_t* buffer;            /*! Items */
+    uint8_t item_size;          /*! Size of an item in bytes */
+    uint8_t items;              /*! Number of items */
+    uint8_t head;               /*! Index of the oldest item */
+    uint8_t count;              /*! Items in the queue */
+} pipeline_queue;
+
+/*!
+  * @brief  Function of a stage
+  *
+  * Called on every poll with the oldest item of the input, or NULL when
+  * there is none, and the free item of the output, or NULL when it is full.
+  * Returns PIPELINE_TAKEN when the input item was used and PIPELINE_GIVEN
+  * when the output item was filled, an input item not taken is given again.
+  */
+typedef uint8_t (*pipeline_step)(void* ctx, uint32_t now, const void* in,
+                                 void* out);
+
+/*!
+  * @brief  Stage of a pipeline, the tables are kept in flash (PROGMEM)
+  */
+typedef struct
+{
+    pipeline_step step;         /*! Function of the stage */
+    void* ctx;                  /*! State of the stage */
+    pipeline_queue* in;         /*! Input queue, NULL for a source */
+    pipeline_queue* out;        /*! Output queue, NULL for a sink */
+} pipeline_stage;
+
+/*!
+  * @brief  Source of int16_t samples read on a period
+  */
+typedef struct
+{
+    int16_t (*read)(void);      /*! Function reading a sample */
+    uint32_t period;            /*! Period in milliseconds */
+    uint32_t next;              /*! Time of the next sample */
+    uint8_t started;            /*! Set after the first sample */
+    uint16_t overruns;          /*! Samples lost with the output full */
+} pipeline_source;
+
+/*!
+  * @brief  Exponential moving average of int16_t samples
+  */
+typedef struct
+{
+    uint8_t shift;              /*! Weight of a new sample, 1 / 2^shift */
+    uint8_t primed;             /*! Set after the first sample */
+    int32_t acc;                /*! Average scaled by 2^shift */
+} pipeline_ema;
+
+/*!
+  * @brief  Aggregate of a window of int16_t samples
+  */
+typedef struct
+{
+    uint8_t window;             /*! Samples of a summary */
+    uint8_t count;              /*! Samples of the current summary */
+    int32_t sum;                /*! Sum of the samples */
+    int16_t min;                /*! Minimum of the samples */
+    int16_t max;                /*! Maximum of the samples */
+} pipeline_aggregate;
+
+/*!
+  * @brief  Summary of a window of samples
+  */
+typedef struct
+{
+    int16_t min;                /*! Minimum */
+    int16_t mean;               /*! Mean, rounded toward zero */
+    int16_t max;                /*! Maximum */
+    uint8_t count;              /*! Samples */
+} pipeline_summary;
+
+/*!
+  * @brief  Payload of an uplink message
+  */
+typedef struct
+{
+    uint8_t size;                       /*! Bytes of the payload */
+    uint8_t data[WISOL_FRAME_MAX];      /*! Payload */
+} pipeline_frame;
+
+/*!
+  * @brief  Packing of items in payloads
+  */
+typedef struct
+{
+    /*! Function packing an item, returns the size of the payload or 0 */
+    uint8_t (*pack)(const void* item, uint8_t* data, uint8_t size);
+} pipeline_pack;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+uint8_t pipeline_poll(const pipeline_stage* stages, uint8_t count,
+                      uint32_t now);
+uint8_t pipeline_queue_count(const pipeline_queue* queue);
+uint8_t pipeline_source_step(void* ctx, uint32_t now, const void* in,
+                             void* out);
+uint8_t pipeline_ema_step(void* ctx, uint32_t now, const void* in, void* out);
+uint8_t pipeline_aggregate_step(void* ctx, uint32_t now, const void* in,
+                                void* out);
+uint8_t pipeline_pack_step(void* ctx, uint32_t now, const void* in,
+                           void* out);
+uint8_t pipeline_uplink_step(void* ctx, uint32_t now, const void* in,
+                             void* out);
+uint8_t pipeline_pack_summary(const void* item, uint8_t* data, uint8_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PIPELINE_H */
@@ -0,0 +1,98 @@
+/******************************************************************************
+* Title                 :   PWM header file
+* Filename              :   pwm.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file pwm.h
+ *  @brief Defines the PWM function definitions.
+ *
+ *  This is the header file for the definition of the PWM function
+ *  prototypes of the methods of the driver.
+ */
+
+#ifndef __PWM_H
+#define __PWM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include "nxtiot_board.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Duty cycle of an output always high */
+#define PWM_DUTY_MAX        0xFFFFU
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*! Steps per second of the fades, the duty changes at most this often */
+#ifndef PWM_FADE_RATE
+    #define PWM_FADE_RATE   100UL
+#endif
+
+/*! Bytes of the state of the channels on the AVR */
+#define PWM_RAM_SIZE        (PWM_CHANNELS * 37)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  PWM channels enumeration, one per header pin with a timer output
+  */
+typedef enum
+{
+    PWM_B1 = 0U,        /*! PB1, OC1A of Timer1, 16 bits */
+    PWM_D3,             /*! PD3, OC2B of Timer2, 8 bits */
+    PWM_D5,             /*! PD5, OC0B of Timer0, at the tick period */
+    PWM_CHANNELS
+} pwm_channel;
+
+/*!
+  * @brief  PWM status enumeration
+  */
+typedef enum
+{
+    PWM_OK = 0U,        /*! Done, or queued for the next TOP */
+    PWM_BUSY,           /*! Timer used by another driver, or D5 without tick */
+    PWM_RANGE,          /*! Frequency and steps not reachable by the timer */
+    PWM_UNSUPPORTED     /*! Not initialized, or tone on D5 */
+} pwm_status;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+pwm_status pwm_init(pwm_channel channel, uint32_t frequency, uint16_t steps);
+pwm_status pwm_set_frequency(pwm_channel channel, uint32_t frequency,
+                             uint16_t steps);
+pwm_status pwm_set_duty(pwm_channel channel, uint16_t duty);
+pwm_status pwm_fade(pwm_channel channel, uint16_t duty, uint16_t ms);
+pwm_status pwm_tone(pwm_channel channel, uint32_t frequency, uint16_t ms);
+uint8_t pwm_busy(pwm_channel channel);
+uint16_t pwm_get_steps(pwm_channel channel);
+void pwm_stop(pwm_channel channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PWM_H */
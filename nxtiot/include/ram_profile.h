@@ -0,0 +1,78 @@
+/******************************************************************************
+* Title                 :   RAM profile header file
+* Filename              :   ram_profile.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file ram_profile.h
+ *  @brief Defines the RAM profile function definitions.
+ *
+ *  This is the header file for the definition of the RAM profile function
+ *  prototypes of the methods of the driver.
+ */
+
+#ifndef __RAM_PROFILE_H
+#define __RAM_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include "nxtiot_board.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Value written to the free RAM at startup */
+#define RAM_PROFILE_CANARY      0xC5
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  RAM usage in bytes
+  */
+typedef struct
+{
+    uint16_t data;          /*! Initialized variables (.data) */
+    uint16_t bss;           /*! Zero initialized variables (.bss) */
+    uint16_t stack;         /*! Stack used now */
+    uint16_t stack_peak;    /*! Maximum stack used since the reset */
+    uint16_t unused;        /*! RAM never used since the reset */
+} ram_profile_info;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void ram_profile_paint(uint8_t* low, uint8_t* high);
+uint16_t ram_profile_scan(const uint8_t* low, const uint8_t* high);
+#ifdef __AVR__
+void ram_profile_get(ram_profile_info* info);
+void ram_profile_report(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RAM_PROFILE_H */
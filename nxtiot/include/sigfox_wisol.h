@@ -27,14 +27,83 @@ extern "C" {
 ******************************************************************************/
 #include "gpio.h"
 #include "uart.h"
+#include "payload.h"
+#include "wisol_parser.h"
 
 /******************************************************************************
 * Preprocessor Constants
 ******************************************************************************/
+/*! Time to the next command when it is not known */
+#define WISOL_NEXT_UNKNOWN          UINT32_MAX
+/*! Maximum payload of a frame in bytes */
+#define WISOL_FRAME_MAX             12
+/*! Size of the uplink counters packed by sigfox_wisol_pack_uplink_stats */
+#define WISOL_UPLINK_STATS_SIZE     PAYLOAD_UPLINK_STATS_SIZE
+/*! Bytes of the payload buffer of the uplinks */
+#define SIGFOX_WISOL_RAM_SIZE       WISOL_FRAME_MAX
 
 /******************************************************************************
 * Configuration Constants
 ******************************************************************************/
+/*! Maximum time to wait for a response of the module in milliseconds */
+#ifndef WISOL_RESPONSE_TIMEOUT
+    #define WISOL_RESPONSE_TIMEOUT  1000
+#endif
+
+/*! Wait after the enable pin rises until the module answers, in ms */
+#ifndef WISOL_POWER_ON_MS
+    #define WISOL_POWER_ON_MS       1000
+#endif
+
+/*! Wait after the byte that wakes the module from AT$P=1, in ms */
+#ifndef WISOL_SLEEP_WAKEUP_MS
+    #define WISOL_SLEEP_WAKEUP_MS   50
+#endif
+
+/*!
+ * Power state policy, from the time to the next command in ms: below
+ * WISOL_IDLE_MS the module stays ready, below WISOL_SLEEP_MS it sleeps with
+ * AT$P=1, below WISOL_DEEP_SLEEP_MS it sleeps with AT$P=2 and beyond it is
+ * powered off. The deep sleep is only left by restarting the module through
+ * the enable pin, which costs the same as powering it on, so it is not used
+ * unless WISOL_DEEP_SLEEP_MS is raised.
+ */
+#ifndef WISOL_IDLE_MS
+    #define WISOL_IDLE_MS           100UL
+#endif
+
+#ifndef WISOL_SLEEP_MS
+    #define WISOL_SLEEP_MS          60000UL
+#endif
+
+#ifndef WISOL_DEEP_SLEEP_MS
+    #define WISOL_DEEP_SLEEP_MS     WISOL_SLEEP_MS
+#endif
+
+/*! Maximum time to wait for the answer of a frame, air time included, in ms */
+#ifndef WISOL_FRAME_TIMEOUT
+    #define WISOL_FRAME_TIMEOUT     10000
+#endif
+
+/*! Attempts to send an uplink message before it is dropped */
+#ifndef WISOL_SEND_ATTEMPTS
+    #define WISOL_SEND_ATTEMPTS     3
+#endif
+
+/*! Wait before the first retry, doubled on every retry, in ms */
+#ifndef WISOL_RETRY_BASE_MS
+    #define WISOL_RETRY_BASE_MS     30000UL
+#endif
+
+/*! Maximum wait before a retry in ms */
+#ifndef WISOL_RETRY_MAX_MS
+    #define WISOL_RETRY_MAX_MS      600000UL
+#endif
+
+/*! Frames sent per day, the message budget of the Sigfox subscription */
+#ifndef WISOL_UPLINKS_PER_DAY
+    #define WISOL_UPLINKS_PER_DAY   140
+#endif
 
 /******************************************************************************
 * Macros
@@ -43,6 +112,60 @@ extern "C" {
 /******************************************************************************
 * Typedefs
 ******************************************************************************/
+/*!
+  * @brief  Power states of the module enumeration
+  */
+typedef enum
+{
+    WISOL_POWER_OFF = 0U,       /*! Enable pin low */
+    WISOL_POWER_READY,          /*! Listening to the commands */
+    WISOL_POWER_SLEEP,          /*! AT$P=1, woken by a byte on the UART */
+    WISOL_POWER_DEEP_SLEEP,     /*! AT$P=2, woken by a restart */
+    WISOL_POWER_STATES
+} sigfox_wisol_power;
+
+/*!
+  * @brief  Time spent in every power state
+  */
+typedef struct
+{
+    uint32_t ms[WISOL_POWER_STATES];    /*! Milliseconds in each state */
+    uint16_t transitions;               /*! Changes of state */
+    uint16_t wakeups;                   /*! Changes to WISOL_POWER_READY */
+} sigfox_wisol_power_stats;
+
+/*!
+  * @brief  Outcome of sending a frame enumeration
+  */
+typedef enum
+{
+    WISOL_SEND_OK = 0U,         /*! Frame sent */
+    WISOL_SEND_ERROR,           /*! Frame answered with an error */
+    WISOL_SEND_TIMEOUT,         /*! Frame not answered */
+    WISOL_SEND_NOT_READY,       /*! Module not answering AT, frame not sent */
+    WISOL_SEND_RESULTS
+} sigfox_wisol_result;
+
+/*!
+  * @brief  State of the uplink message enumeration
+  */
+typedef enum
+{
+    WISOL_UPLINK_IDLE = 0U,     /*! No message, the last one was sent */
+    WISOL_UPLINK_PENDING,       /*! Message waiting for its attempt */
+    WISOL_UPLINK_DROPPED        /*! Last message dropped after its attempts */
+} sigfox_wisol_uplink_state;
+
+/*!
+  * @brief  Counters of the uplink messages
+  */
+typedef struct
+{
+    uint16_t results[WISOL_SEND_RESULTS];   /*! Attempts by outcome */
+    uint16_t retries;                       /*! Attempts after a failure */
+    uint16_t dropped;                       /*! Messages dropped */
+    uint16_t deferred;                      /*! Attempts put off by budget */
+} sigfox_wisol_uplink_stats;
 
 /******************************************************************************
 * Variables
@@ -52,9 +175,21 @@ extern "C" {
 * Function Prototypes
 ******************************************************************************/
 void sigfox_wisol_init(void);
-void sigfox_wisol_get_id(char* id, uint8_t size);
-void sigfox_wisol_get_pac(char* pac, uint8_t size);
+wisol_token_type sigfox_wisol_get_id(uint8_t* id, uint8_t size,
+                                     uint8_t* length);
+wisol_token_type sigfox_wisol_get_pac(uint8_t* pac, uint8_t size,
+                                      uint8_t* length);
 void sigfox_wisol_send_msg(const char* msg, uint8_t size);
+void sigfox_wisol_set_next(uint32_t ms);
+void sigfox_wisol_power_down(void);
+sigfox_wisol_power sigfox_wisol_get_power(void);
+void sigfox_wisol_get_power_stats(sigfox_wisol_power_stats* stats);
+sigfox_wisol_result sigfox_wisol_send_frame(const uint8_t* data, uint8_t size);
+uint8_t sigfox_wisol_uplink(const uint8_t* data, uint8_t size);
+sigfox_wisol_uplink_state sigfox_wisol_uplink_poll(uint32_t now);
+uint32_t sigfox_wisol_uplink_next(uint32_t now);
+void sigfox_wisol_get_uplink_stats(sigfox_wisol_uplink_stats* stats);
+uint8_t sigfox_wisol_pack_uplink_stats(uint8_t* data, uint8_t size);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,94 @@
+/******************************************************************************
+* Title                 :   Software UART header file
+* Filename              :   soft_uart.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file soft_uart.h
+ *  @brief Defines the software UART function definitions.
+ *
+ *  This is the header file for the definition of the software UART function
+ *  prototypes of the methods of the driver.
+ */
+
+#ifndef __SOFT_UART_H
+#define __SOFT_UART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include "nxtiot_board.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*! Baud rate, from 4800 to 38400 bauds */
+#ifndef SOFT_UART_BAUD
+    #define SOFT_UART_BAUD              19200UL
+#endif
+
+/*! TX pin number, one of the header pins D2_PIN to D5_PIN of PORTD */
+#ifndef SOFT_UART_TX_PIN
+    #define SOFT_UART_TX_PIN            D3_PIN
+#endif
+
+/*! RX pin number, one of the header pins D2_PIN to D5_PIN of PORTD */
+#ifndef SOFT_UART_RX_PIN
+    #define SOFT_UART_RX_PIN            D2_PIN
+#endif
+
+/*! Size of the TX buffer, must be a power of 2 */
+#ifndef SOFT_UART_TX_BUFFER_SIZE
+    #define SOFT_UART_TX_BUFFER_SIZE    32
+#endif
+
+/*! Size of the RX buffer, must be a power of 2 */
+#ifndef SOFT_UART_RX_BUFFER_SIZE
+    #define SOFT_UART_RX_BUFFER_SIZE    16
+#endif
+
+/*! Bytes of the TX and RX buffers */
+#define SOFT_UART_RAM_SIZE      (SOFT_UART_TX_BUFFER_SIZE + \
+                                 SOFT_UART_RX_BUFFER_SIZE)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void soft_uart_init(void);
+uint8_t soft_uart_write(const uint8_t* data, uint8_t size);
+void soft_uart_send(const char* str);
+uint8_t soft_uart_tx_pending(void);
+uint8_t soft_uart_try_read_char(unsigned char* data);
+uint8_t soft_uart_available(void);
+uint16_t soft_uart_errors(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SOFT_UART_H */
@@ -0,0 +1,129 @@
+/******************************************************************************
+* Title                 :   SPI header file
+* Filename              :   spi.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file spi.h
+ *  @brief Defines the SPI function definitions.
+ *
+ *  This is the header file for the definition of the SPI function prototypes
+ *  of the methods of the driver.
+ */
+
+#ifndef __SPI_H
+#define __SPI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "nxtiot_board.h"
+#include "gpio.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Byte sent when a transaction has no TX buffer */
+#define SPI_FILL_BYTE       0xFF
+
+/*! Transaction flag: keep the chip select asserted after the transaction */
+#define SPI_KEEP_CS         0x01
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  SPI clock polarity and phase modes enumeration
+  */
+typedef enum
+{
+    SPI_MODE_0 = 0U,    /*! CPOL 0, CPHA 0 */
+    SPI_MODE_1,         /*! CPOL 0, CPHA 1 */
+    SPI_MODE_2,         /*! CPOL 1, CPHA 0 */
+    SPI_MODE_3          /*! CPOL 1, CPHA 1 */
+} spi_mode;
+
+/*!
+  * @brief  SPI bit order enumeration
+  */
+typedef enum
+{
+    SPI_MSB_FIRST = 0U,
+    SPI_LSB_FIRST
+} spi_bit_order;
+
+/*!
+  * @brief  SPI transaction status enumeration
+  */
+typedef enum
+{
+    SPI_DONE = 0U,
+    SPI_PENDING,
+    SPI_BUSY
+} spi_status;
+
+/*!
+  * @brief  SPI device, filled by the spi_device_init function
+  */
+typedef struct
+{
+    gpio_pin cs;
+    uint8_t spcr;
+    uint8_t spsr;
+} spi_device;
+
+/*!
+  * @brief  SPI transaction
+  *
+  * The transaction is owned by the caller and must not be modified until its
+  * status is SPI_DONE. The callback is executed from the SPI interrupt.
+  */
+typedef struct spi_transaction
+{
+    const spi_device* device;
+    const uint8_t* tx;
+    uint8_t* rx;
+    uint16_t size;
+    uint8_t flags;
+    void (*callback)(struct spi_transaction* transaction);
+    void* context;
+    volatile spi_status status;
+    struct spi_transaction* next;
+} spi_transaction;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void spi_init(void);
+void spi_device_init(spi_device* device, uint8_t* cs_port, uint8_t cs_pin,
+                     uint32_t clock, spi_mode mode, spi_bit_order order);
+spi_status spi_submit(spi_transaction* transaction);
+uint8_t spi_busy(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPI_H */
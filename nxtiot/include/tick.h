@@ -0,0 +1,61 @@
+/******************************************************************************
+* Title                 :   Tick header file  
+* Filename              :   tick.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file tick.h
+ *  @brief Defines the tick function definitions.
+ * 
+ *  This is the header file for the definition of the tick function prototypes
+ *  of the methods of the driver.
+ */
+
+#ifndef __TICK_H
+#define __TICK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include "nxtiot_board.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void tick_init(void);
+uint32_t tick_get_ms(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TICK_H */
@@ -0,0 +1,132 @@
+/******************************************************************************
+* Title                 :   Trace header file
+* Filename              :   trace.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file trace.h
+ *  @brief Defines the trace function definitions.
+ *
+ *  This is the header file for the definition of the trace function
+ *  prototypes of the methods of the driver and of the TRACE macro used to
+ *  instrument the drivers.
+ */
+
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include "nxtiot_board.h"
+#include "tick.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! First byte of a trace dump */
+#define TRACE_MAGIC_0           'T'
+/*! Second byte of a trace dump */
+#define TRACE_MAGIC_1           'R'
+/*! Size of the header of a trace dump: magic, count and dropped records */
+#define TRACE_HEADER_SIZE       6
+/*! Size of a record in a trace dump */
+#define TRACE_RECORD_SIZE       6
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*!
+ * Enables the TRACE macro. When it is 0 the instrumentation points of the
+ * drivers are removed by the preprocessor and cost nothing.
+ */
+#ifndef TRACE_ENABLE
+    #define TRACE_ENABLE        0
+#endif
+
+/*! Number of records of the trace buffer, must be a power of 2 */
+#ifndef TRACE_BUFFER_SIZE
+    #define TRACE_BUFFER_SIZE   32
+#endif
+
+/*! Bytes of the trace buffer */
+#define TRACE_RAM_SIZE          (TRACE_BUFFER_SIZE * TRACE_RECORD_SIZE)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/*! Macro used to record an event from the drivers and the application */
+#if TRACE_ENABLE
+    #define TRACE(id, arg)      trace_event((id), (uint16_t) (arg))
+#else
+    #define TRACE(id, arg)      do { } while (0)
+#endif
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Trace event identifiers enumeration
+  *
+  * The identifiers are part of the dump format, new events are added at the
+  * end of the drivers range. The application uses the identifiers from
+  * TRACE_USER.
+  */
+typedef enum
+{
+    TRACE_NONE = 0U,
+    TRACE_GPIO_INIT,            /*! arg: port address << 8 | pin << 4 | mode */
+    TRACE_GPIO_WRITE,           /*! arg: port address << 8 | pin << 4 | state */
+    TRACE_GPIO_TOGGLE,          /*! arg: port address << 8 | pin << 4 */
+    TRACE_UART_RX,              /*! arg: received character */
+    TRACE_UART_RX_DROP,         /*! arg: dropped character */
+    TRACE_UART_SEND,            /*! arg: number of characters sent */
+    TRACE_UART_READ,            /*! arg: status << 8 | characters read */
+    TRACE_WISOL_POWER,          /*! arg: sigfox_wisol_power, 0 off, 1 ready */
+    TRACE_WISOL_CMD,            /*! arg: command index */
+    TRACE_WISOL_RESPONSE,       /*! arg: wisol_token_type of the response */
+    TRACE_USER = 0x80U
+} trace_event_id;
+
+/*!
+  * @brief  Trace record
+  *
+  * The timestamp is made of the low 16 bits of the tick and the Timer0
+  * counter, in 4 us steps at 16 MHz.
+  */
+typedef struct
+{
+    uint16_t ms;
+    uint8_t sub;
+    uint8_t id;
+    uint16_t arg;
+} trace_record;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void trace_clear(void);
+void trace_event(uint8_t id, uint16_t arg);
+uint8_t trace_count(void);
+uint16_t trace_dropped(void);
+uint8_t trace_get(uint8_t index, trace_record* record);
+void trace_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TRACE_H */
@@ -0,0 +1,107 @@
+/******************************************************************************
+* Title                 :   TWI header file
+* Filename              :   twi.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file twi.h
+ *  @brief Defines the TWI function definitions.
+ *
+ *  This is the header file for the definition of the TWI (I2C) function
+ *  prototypes of the methods of the driver.
+ */
+
+#ifndef __TWI_H
+#define __TWI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "nxtiot_board.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Standard mode clock in Hz */
+#define TWI_CLOCK_STANDARD  100000UL
+/*! Fast mode clock in Hz */
+#define TWI_CLOCK_FAST      400000UL
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*! Time in milliseconds without bus activity after which a transaction is
+ *  aborted and the bus is recovered */
+#ifndef TWI_TIMEOUT_MS
+#define TWI_TIMEOUT_MS      25
+#endif
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  TWI transaction status enumeration
+  */
+typedef enum
+{
+    TWI_DONE = 0U,      /*! Completed */
+    TWI_PENDING,        /*! Queued or in progress */
+    TWI_BUSY,           /*! Already queued, returned by twi_submit */
+    TWI_NACK,           /*! Address or data not acknowledged by the slave */
+    TWI_BUS_ERROR,      /*! Illegal start or stop condition on the bus */
+    TWI_TIMEOUT         /*! No bus activity for TWI_TIMEOUT_MS */
+} twi_status;
+
+/*!
+  * @brief  TWI transaction
+  *
+  * The tx bytes are written first, then the rx bytes are read after a
+  * repeated start. A transaction with only tx bytes is a write and one with
+  * only rx bytes is a read. The transaction is owned by the caller and must
+  * not be modified until its status is not TWI_PENDING. The callback is
+  * executed from the TWI interrupt or from twi_poll on a timeout.
+  */
+typedef struct twi_transaction
+{
+    uint8_t address;
+    const uint8_t* tx;
+    uint8_t tx_size;
+    uint8_t* rx;
+    uint8_t rx_size;
+    void (*callback)(struct twi_transaction* transaction);
+    void* context;
+    volatile twi_status status;
+    struct twi_transaction* next;
+} twi_transaction;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void twi_init(uint32_t clock);
+twi_status twi_submit(twi_transaction* transaction);
+uint8_t twi_busy(void);
+void twi_poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TWI_H */
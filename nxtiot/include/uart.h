@@ -28,14 +28,73 @@ extern "C" {
 #include <stdint.h>
 #include <string.h>
 #include "nxtiot_board.h"
+#include "tick.h"
 
 /******************************************************************************
 * Preprocessor Constants
 ******************************************************************************/
+/*! Timeout value used to wait forever */
+#define UART_TIMEOUT_INFINITE   0xFFFF
+
+/*! Flag of the UBRR settings using the double speed mode (U2X0) */
+#define UART_UBRR_U2X           0x8000
+/*! UBRR setting of a baud rate that can not be generated */
+#define UART_UBRR_INVALID       0xFFFF
+
+/*! Frame with 5 data bits */
+#define UART_DATA_5             0x00
+/*! Frame with 6 data bits */
+#define UART_DATA_6             _BV(UCSZ00)
+/*! Frame with 7 data bits */
+#define UART_DATA_7             _BV(UCSZ01)
+/*! Frame with 8 data bits */
+#define UART_DATA_8             (_BV(UCSZ01) | _BV(UCSZ00))
+/*! Frame without parity bit */
+#define UART_PARITY_NONE        0x00
+/*! Frame with even parity bit */
+#define UART_PARITY_EVEN        _BV(UPM01)
+/*! Frame with odd parity bit */
+#define UART_PARITY_ODD         (_BV(UPM01) | _BV(UPM00))
+/*! Frame with 1 stop bit */
+#define UART_STOP_1             0x00
+/*! Frame with 2 stop bits */
+#define UART_STOP_2             _BV(USBS0)
+
+/*! Frame with 8 data bits, no parity and 1 stop bit */
+#define UART_FRAME_8N1          (UART_DATA_8 | UART_PARITY_NONE | UART_STOP_1)
+/*! Frame with 8 data bits, even parity and 1 stop bit */
+#define UART_FRAME_8E1          (UART_DATA_8 | UART_PARITY_EVEN | UART_STOP_1)
+/*! Frame with 8 data bits, no parity and 2 stop bits */
+#define UART_FRAME_8N2          (UART_DATA_8 | UART_PARITY_NONE | UART_STOP_2)
 
 /******************************************************************************
 * Configuration Constants
 ******************************************************************************/
+/*!
+ * Size of the RX buffer filled by the RX interrupt, must be a power of 2.
+ * 
+ * @note When it is 0 the driver does not define the USART_RX_vect interrupt
+ *       and the application can define its own.
+ */
+#ifndef UART_RX_BUFFER_SIZE
+    #define UART_RX_BUFFER_SIZE 0
+#endif
+
+/*! Bytes of the RX buffer */
+#define UART_RAM_SIZE           UART_RX_BUFFER_SIZE
+
+/*! Baud rate set by uart_init */
+#ifndef UART_BAUD_RATE
+    #define UART_BAUD_RATE      9600UL
+#endif
+
+/*!
+ * Maximum baud rate error accepted by uart_init_config, in tenths of 
+ * percent. The default accepts 115200 bauds with a 16 MHz clock (2.1 %).
+ */
+#ifndef UART_BAUD_TOLERANCE
+    #define UART_BAUD_TOLERANCE 25
+#endif
 
 /******************************************************************************
 * Macros
@@ -44,6 +103,17 @@ extern "C" {
 /******************************************************************************
 * Typedefs
 ******************************************************************************/
+/*!
+  * @brief  UART read result enumeration
+  */
+typedef enum
+{
+    UART_OK = 0U,
+    UART_TIMEOUT,
+    UART_BUFFER_FULL,
+    UART_CANCELLED,
+    UART_BAUD_ERROR
+} uart_status;
 
 /******************************************************************************
 * Variables
@@ -53,11 +123,21 @@ extern "C" {
 * Function Prototypes
 ******************************************************************************/
 void uart_init(void);
+uart_status uart_init_config(uint32_t baud, uint8_t frame);
+uint16_t uart_baud_setting(uint32_t f_cpu, uint32_t baud, int16_t* error);
 void uart_send(const char* str);
+void uart_write(const uint8_t* data, uint8_t size);
 void uart_read(char* str, uint8_t size);
 void uart_enable_rx_isr(void);
 void uart_disable_rx_isr(void);
 void uart_flush(void);
+uart_status uart_read_until(char* str, uint8_t size, char delim, 
+                            uint16_t timeout, uint8_t* count);
+uart_status uart_read_exact(uint8_t* data, uint8_t size, uint16_t timeout,
+                            uint8_t* count);
+void uart_cancel_read(void);
+uint8_t uart_available(void);
+uint8_t uart_try_read_char(unsigned char* data);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,97 @@
+/******************************************************************************
+* Title                 :   Watchdog scheduler header file
+* Filename              :   wdt_scheduler.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file wdt_scheduler.h
+ *  @brief Defines the watchdog scheduler function definitions.
+ *
+ *  This is the header file for the definition of the watchdog scheduler
+ *  function prototypes of the methods of the driver.
+ */
+
+#ifndef __WDT_SCHEDULER_H
+#define __WDT_SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include "nxtiot_board.h"
+#include "tick.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Nominal watchdog period with the smallest prescaler, in microseconds */
+#define WDT_SCHEDULER_BASE_US       16000UL
+/*! Largest watchdog prescaler, 8 s */
+#define WDT_SCHEDULER_MAX_PRESCALER 9
+/*! Calibration scale of a watchdog running at its nominal frequency */
+#define WDT_SCHEDULER_SCALE_ONE     65536UL
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*! Maximum number of jobs */
+#ifndef WDT_SCHEDULER_JOBS
+    #define WDT_SCHEDULER_JOBS          4
+#endif
+
+/*! Bytes of the jobs table on the AVR */
+#define WDT_SCHEDULER_RAM_SIZE      (WDT_SCHEDULER_JOBS * 10)
+
+/*!
+ * Watchdog prescaler while the CPU is awake, the periods are measured
+ * against the tick to calibrate the watchdog. 3 is 128 ms.
+ */
+#ifndef WDT_SCHEDULER_AWAKE_PRESCALER
+    #define WDT_SCHEDULER_AWAKE_PRESCALER   3
+#endif
+
+/*! Weight of a new calibration measure, as a right shift (3 is 1/8) */
+#ifndef WDT_SCHEDULER_FILTER
+    #define WDT_SCHEDULER_FILTER        3
+#endif
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Function run by the scheduler
+  */
+typedef void (*wdt_scheduler_job)(void);
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void wdt_scheduler_init(void);
+int8_t wdt_scheduler_every(uint32_t seconds, wdt_scheduler_job job);
+void wdt_scheduler_cancel(int8_t id);
+void wdt_scheduler_run(void);
+uint32_t wdt_scheduler_time_ms(void);
+uint32_t wdt_scheduler_scale(void);
+uint32_t wdt_scheduler_period_us(uint8_t prescaler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __WDT_SCHEDULER_H */
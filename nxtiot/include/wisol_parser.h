@@ -0,0 +1,98 @@
+/******************************************************************************
+* Title                 :   Wisol parser header file
+* Filename              :   wisol_parser.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file wisol_parser.h
+ *  @brief Defines the Wisol response parser function definitions.
+ *
+ *  This is the header file for the definition of the Wisol response parser
+ *  function prototypes of the methods of the driver.
+ */
+
+#ifndef __WISOL_PARSER_H
+#define __WISOL_PARSER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+
+/******************************************************************************
+* Configuration Constants
+******************************************************************************/
+/*! Maximum number of characters of a response line */
+#ifndef WISOL_PARSER_LINE_SIZE
+    #define WISOL_PARSER_LINE_SIZE  40
+#endif
+
+/*! Bytes of the line buffer used when none is given */
+#define WISOL_PARSER_RAM_SIZE   WISOL_PARSER_LINE_SIZE
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Wisol response line types enumeration
+  */
+typedef enum
+{
+    WISOL_TOKEN_NONE = 0U,
+    WISOL_TOKEN_OK,
+    WISOL_TOKEN_ERROR,
+    WISOL_TOKEN_HEX,
+    WISOL_TOKEN_DOWNLINK,
+    WISOL_TOKEN_ECHO,
+    WISOL_TOKEN_TEXT,
+    WISOL_TOKEN_OVERFLOW
+} wisol_token_type;
+
+/*!
+  * @brief  Wisol response line
+  *
+  * The data points to the line buffer of the parser and is valid until the
+  * next character is fed. For WISOL_TOKEN_HEX and WISOL_TOKEN_DOWNLINK the
+  * data holds the decoded bytes, for the rest the characters of the line
+  * (not NULL terminated).
+  */
+typedef struct
+{
+    wisol_token_type type;
+    const uint8_t* data;
+    uint8_t size;
+} wisol_token;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void wisol_parser_init(void);
+void wisol_parser_set_buffer(uint8_t* line, uint8_t size);
+wisol_token_type wisol_parser_feed(uint8_t data, wisol_token* token);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __WISOL_PARSER_H */
@@ -0,0 +1,507 @@
+/******************************************************************************
+* Title                 :   Arena source file
+* Filename              :   arena.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        arena.c
+ *  @brief       Arena implementation
+ *
+ *  To use the arena, include this header file as follows:
+ *  @code
+ *      #include "arena.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The arena gives the buffers of the application and of the new drivers
+ *  out of a share of the 2 KB SRAM sized in nxtiot_board.h, instead of
+ *  every caller declaring its own. There are two allocators, both static
+ *  arrays without a heap:
+ *  - The arena: buffers that live until the reset, allocated at init time
+ *    by moving a pointer. arena_lock ends the init, the allocations after
+ *    it fail, so the usage seen at startup is the usage forever.
+ *  - The pools: blocks of a fixed size, allocated and freed at any time in
+ *    constant time, for buffers held for a while as the text of a message.
+ *    The blocks in use are the bits of a mask, so there is no header in the
+ *    blocks and no fragmentation.
+ *
+ *  The budget is checked at build time: the static buffers of the drivers
+ *  linked, listed in BOARD_RAM_DRIVERS, plus the arena and the pools must
+ *  fit in BOARD_DRIVERS_RAM, otherwise the build of this file fails with
+ *  the name of the limit exceeded. Every driver exports the bytes of its
+ *  buffers as <prefix>_RAM_SIZE, next to their configuration, and checks
+ *  it against them. At run time arena_get_usage and arena_report give the
+ *  bytes and blocks used, the peaks and the failed allocations.
+ *
+ *  ## Usage ##
+ *
+ *  The following code example allocates the buffers at init and a block
+ *  of a pool for a message.
+ *
+ *  @code
+ *      #include "arena.h"
+ *
+ *      static char* id;
+ *      char* text;
+ *
+ *      arena_init();
+ *      id = arena_alloc(16);
+ *      arena_lock();
+ *
+ *      text = arena_pool_alloc(ARENA_POOL_LARGE);
+ *      if (text != NULL)
+ *      {
+ *          ...
+ *          arena_pool_free(ARENA_POOL_LARGE, text);
+ *      }
+ *
+ *      arena_report();
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "arena.h"
+#include "uart.h"
+#include "soft_uart.h"
+#include "trace.h"
+#include "wisol_parser.h"
+#include "sigfox_wisol.h"
+#include "console.h"
+#include "flash_log.h"
+#include "eeprom_log.h"
+#include "isr_profile.h"
+#include "wdt_scheduler.h"
+#include "pwm.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Bytes of the static buffers of the drivers linked (BOARD_RAM_DRIVERS) */
+#define ARENA_DRIVERS_SIZE  (0 BOARD_RAM_DRIVERS(_ARENA_DRIVER_SIZE))
+
+/*! Bytes of the arena, aligned */
+#define ARENA_MEMORY_SIZE   ARENA_ROUND(BOARD_ARENA_SIZE)
+/*! Bytes of a block of the small pool, aligned */
+#define ARENA_SMALL_STRIDE  ARENA_ROUND(BOARD_POOL_SMALL_BLOCK)
+/*! Bytes of a block of the large pool, aligned */
+#define ARENA_LARGE_STRIDE  ARENA_ROUND(BOARD_POOL_LARGE_BLOCK)
+/*! Bytes of the small pool */
+#define ARENA_SMALL_SIZE    (ARENA_SMALL_STRIDE * BOARD_POOL_SMALL_COUNT)
+/*! Bytes of the large pool */
+#define ARENA_LARGE_SIZE    (ARENA_LARGE_STRIDE * BOARD_POOL_LARGE_COUNT)
+
+/*! Bytes of the arena and of the pools */
+#define ARENA_TOTAL_SIZE    (ARENA_MEMORY_SIZE + ARENA_SMALL_SIZE +         \
+                             ARENA_LARGE_SIZE)
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! Macro used to add the buffers of a driver of BOARD_RAM_DRIVERS */
+#define _ARENA_DRIVER_SIZE(prefix)  + prefix##_RAM_SIZE
+
+// Build time checks of the budget in nxtiot_board.h
+_Static_assert(ARENA_DRIVERS_SIZE + ARENA_TOTAL_SIZE <= BOARD_DRIVERS_RAM,
+               "driver buffers, arena and pools exceed BOARD_DRIVERS_RAM");
+_Static_assert(BOARD_DRIVERS_RAM <= BOARD_RAM_SIZE,
+               "BOARD_DRIVERS_RAM exceeds BOARD_RAM_SIZE");
+_Static_assert((BOARD_POOL_SMALL_COUNT <= ARENA_POOL_COUNT_MAX) &&
+               (BOARD_POOL_LARGE_COUNT <= ARENA_POOL_COUNT_MAX),
+               "pools are limited to ARENA_POOL_COUNT_MAX blocks");
+_Static_assert((BOARD_POOL_SMALL_BLOCK > 0) &&
+               (BOARD_POOL_SMALL_BLOCK <= BOARD_POOL_LARGE_BLOCK),
+               "the small pool blocks must not be larger than the large ones");
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  Pool
+  */
+typedef struct
+{
+    uint8_t* blocks;            /*! First block */
+    uint16_t stride;            /*! Bytes from a block to the next */
+    uint16_t block;             /*! Bytes of a block */
+    uint8_t count;              /*! Blocks */
+} arena_pool;
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Memory of the arena */
+static _Alignas(max_align_t) uint8_t arena_memory[ARENA_MEMORY_SIZE];
+/*! Memory of the small pool */
+static _Alignas(max_align_t) uint8_t arena_small[ARENA_SMALL_SIZE];
+/*! Memory of the large pool */
+static _Alignas(max_align_t) uint8_t arena_large[ARENA_LARGE_SIZE];
+
+/*! Pools, in the order of arena_pool_id */
+static const arena_pool arena_pools[ARENA_POOLS] =
+{
+    {arena_small, ARENA_SMALL_STRIDE, BOARD_POOL_SMALL_BLOCK,
+     BOARD_POOL_SMALL_COUNT},
+    {arena_large, ARENA_LARGE_STRIDE, BOARD_POOL_LARGE_BLOCK,
+     BOARD_POOL_LARGE_COUNT}
+};
+
+/*! Bytes of the arena allocated */
+static uint16_t arena_used;
+/*! Arena allocations failed */
+static uint8_t arena_failures;
+/*! Set by arena_lock */
+static uint8_t arena_locked;
+/*! Blocks in use of every pool, one bit per block */
+static uint16_t arena_pool_mask[ARENA_POOLS];
+/*! Maximum blocks in use of every pool */
+static uint8_t arena_pool_peak[ARENA_POOLS];
+/*! Pool allocations failed */
+static uint8_t arena_pool_failures[ARENA_POOLS];
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static uint8_t _arena_count(uint16_t mask);
+static void _arena_print(const char* name, uint16_t value);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup arena
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to empty the arena and the pools, before the drivers and
+ * the application allocate their buffers.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      arena_init();
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+arena_init(void)
+{
+    uint8_t i;
+
+    arena_used = 0;
+    arena_failures = 0;
+    arena_locked = 0;
+
+    for (i = 0; i < ARENA_POOLS; i++)
+    {
+        arena_pool_mask[i] = 0;
+        arena_pool_peak[i] = 0;
+        arena_pool_failures[i] = 0;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to allocate a buffer of the arena, at init time. The
+ * buffer is never freed.
+ *
+ * @param size Bytes of the buffer.
+ *
+ * @return Pointer to the buffer, NULL if the arena is full or locked.
+ *
+ * \b Example:
+ * @code
+ *      char* id = arena_alloc(16);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void*
+arena_alloc(uint16_t size)
+{
+    uint16_t rounded = ARENA_ROUND(size);
+    void* buffer;
+
+    if ( arena_locked || (size == 0) || (rounded < size) ||
+         (rounded > (sizeof(arena_memory) - arena_used)) )
+    {
+        arena_failures += (arena_failures < UINT8_MAX);
+        return NULL;
+    }
+
+    buffer = &arena_memory[arena_used];
+    arena_used += rounded;
+
+    return buffer;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to end the init time, the arena allocations after it fail.
+ * The pools can still be used.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      arena_lock();
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+arena_lock(void)
+{
+    arena_locked = 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to allocate a block of a pool. It can be called from the
+ * interrupts.
+ *
+ * @param pool Pool of the block.
+ *
+ * @return Pointer to the block, NULL if all the blocks are in use.
+ *
+ * \b Example:
+ * @code
+ *      char* text = arena_pool_alloc(ARENA_POOL_LARGE);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void*
+arena_pool_alloc(arena_pool_id pool)
+{
+    const arena_pool* descriptor = &arena_pools[pool];
+    uint16_t all = (uint16_t) ((1UL << descriptor->count) - 1);
+    uint16_t free_mask;
+    uint8_t index = 0;
+    uint8_t used;
+    uint8_t sreg = SREG;
+
+    cli();
+
+    free_mask = ~arena_pool_mask[pool] & all;
+    if (free_mask == 0)
+    {
+        arena_pool_failures[pool] += (arena_pool_failures[pool] < UINT8_MAX);
+        SREG = sreg;
+        return NULL;
+    }
+
+    // The lowest free block
+    free_mask &= -free_mask;
+    while ( (free_mask >> index) != 1 )
+    {
+        index++;
+    }
+
+    arena_pool_mask[pool] |= free_mask;
+    used = _arena_count(arena_pool_mask[pool]);
+    if (used > arena_pool_peak[pool])
+    {
+        arena_pool_peak[pool] = used;
+    }
+
+    SREG = sreg;
+
+    return &descriptor->blocks[(uint16_t) index * descriptor->stride];
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to give back a block to its pool. A pointer that is not a
+ * block in use of the pool is ignored.
+ *
+ * @param pool Pool of the block.
+ * @param block Pointer to the block.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      arena_pool_free(ARENA_POOL_LARGE, text);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+arena_pool_free(arena_pool_id pool, void* block)
+{
+    const arena_pool* descriptor = &arena_pools[pool];
+    uint8_t* address = (uint8_t *) block;
+    uint16_t offset;
+    uint8_t sreg;
+
+    if ( (address < descriptor->blocks) ||
+         (address >= descriptor->blocks +
+                     (uint16_t) descriptor->count * descriptor->stride) )
+    {
+        return;
+    }
+
+    offset = (uint16_t) (address - descriptor->blocks);
+    if ( (offset % descriptor->stride) != 0 )
+    {
+        return;
+    }
+
+    sreg = SREG;
+    cli();
+    arena_pool_mask[pool] &= (uint16_t) ~(1U << (offset / descriptor->stride));
+    SREG = sreg;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the usage of the RAM share of the drivers.
+ *
+ * @param usage Pointer to the usage to be filled.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      arena_usage usage;
+ *
+ *      arena_get_usage(&usage);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+arena_get_usage(arena_usage* usage)
+{
+    uint8_t i;
+
+    usage->budget = BOARD_DRIVERS_RAM;
+    usage->drivers = ARENA_DRIVERS_SIZE;
+    usage->size = sizeof(arena_memory);
+    usage->used = arena_used;
+    usage->failures = arena_failures;
+    usage->locked = arena_locked;
+
+    for (i = 0; i < ARENA_POOLS; i++)
+    {
+        usage->pools[i].block = arena_pools[i].block;
+        usage->pools[i].count = arena_pools[i].count;
+        usage->pools[i].used = _arena_count(arena_pool_mask[i]);
+        usage->pools[i].peak = arena_pool_peak[i];
+        usage->pools[i].failures = arena_pool_failures[i];
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send the usage of the RAM share of the drivers through
+ * the UART, as a line of named values.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      arena_report();
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+arena_report(void)
+{
+    arena_usage usage;
+    uint8_t i;
+
+    arena_get_usage(&usage);
+
+    uart_send("ARENA");
+    _arena_print(" budget ", usage.budget);
+    _arena_print(" drivers ", usage.drivers);
+    _arena_print(" used ", usage.used);
+    _arena_print("/", usage.size);
+    _arena_print(" fail ", usage.failures);
+
+    for (i = 0; i < ARENA_POOLS; i++)
+    {
+        _arena_print(" pool ", usage.pools[i].block);
+        _arena_print(" used ", usage.pools[i].used);
+        _arena_print("/", usage.pools[i].count);
+        _arena_print(" peak ", usage.pools[i].peak);
+        _arena_print(" fail ", usage.pools[i].failures);
+    }
+
+    uart_send("\n");
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
+
+/******************************************************************************
+* Private Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to count the blocks in use of a pool.
+ *
+ * @param mask Blocks in use, one bit per block.
+ *
+ * @return Number of blocks in use.
+ */
+/*****************************************************************************/
+static uint8_t
+_arena_count(uint16_t mask)
+{
+    uint8_t count = 0;
+
+    while (mask != 0)
+    {
+        mask &= mask - 1;
+        count++;
+    }
+
+    return count;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send a named value through the UART.
+ *
+ * @param name Name of the value.
+ * @param value Value to be sent.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_arena_print(const char* name, uint16_t value)
+{
+    char str[6];
+    uint8_t i = sizeof(str) - 1;
+
+    str[i] = '\0';
+    do
+    {
+        str[--i] = (char) ('0' + (value % 10));
+        value /= 10;
+    } while (value != 0);
+
+    uart_send(name);
+    uart_send(&str[i]);
+}
@@ -0,0 +1,439 @@
+/******************************************************************************
+* Title                 :   COBS framing source file
+* Filename              :   cobs.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        cobs.c
+ *  @brief       COBS framing implementation
+ *
+ *  To use the COBS framing, include this header file as follows:
+ *  @code
+ *      #include "cobs.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The COBS (Consistent Overhead Byte Stuffing) framing sends binary frames
+ *  through a serial port. The zero bytes of the frame are removed, so a zero
+ *  byte only delimits the frames and the receiver synchronizes with the
+ *  next delimiter after an error. The overhead is one byte every 254 bytes
+ *  plus the delimiter, so a binary frame is sent with about half the bytes
+ *  of the same frame encoded as hexadecimal text.
+ *
+ *  A CRC16 (XMODEM) is appended to every frame, big endian, so the CRC of a
+ *  valid frame including its CRC is zero.
+ *
+ *  The encoder reads the frame from the buffers of the caller, a list of
+ *  segments such as a header and a payload, and sends every run of non zero
+ *  bytes directly from them, so the frame is never copied. The decoder is
+ *  fed byte by byte, as they are received, and writes the decoded bytes
+ *  directly to the buffer of the frame.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      #include "cobs.h"
+ *      #include "uart.h"
+ *
+ *      uint8_t header[2] = {0x01, 0x00};
+ *      cobs_segment frame[2] = {{header, sizeof(header)},
+ *                               {samples, sizeof(samples)}};
+ *      cobs_decoder decoder;
+ *      uint8_t received[32 + COBS_CRC_SIZE];
+ *      unsigned char data;
+ *
+ *      cobs_send(frame, 2, uart_write);
+ *
+ *      cobs_decoder_init(&decoder, received, sizeof(received));
+ *      while (1)
+ *      {
+ *          if ( uart_try_read_char(&data) &&
+ *               (cobs_decode(&decoder, data) == COBS_FRAME) )
+ *          {
+ *              // cobs_frame_size(&decoder) bytes in received
+ *          }
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "cobs.h"
+#include <util/crc16.h>
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Initial value of the CRC */
+#define CRC_INIT        0xFFFF
+
+/*! Code of the decoder waiting for the first block of a frame */
+#define CODE_START      0x00
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  Position in the segments of a frame being encoded
+  */
+typedef struct
+{
+    const cobs_segment* segments;
+    uint8_t count;
+    const uint8_t* crc;
+    uint8_t index;
+    uint16_t offset;
+} cobs_cursor;
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static uint16_t _cobs_piece(cobs_cursor* cursor, const uint8_t** data);
+static void _cobs_emit(cobs_decoder* decoder, uint8_t data);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup cobs
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to send a frame made of segments.
+ *
+ * The segments are sent one after the other as a single frame, followed by
+ * the CRC and the delimiter. The bytes are read twice from the segments,
+ * to compute the CRC and to send them, and are never copied.
+ *
+ * @param segments Pointer to the segments of the frame.
+ * @param count Number of segments.
+ * @param write Function used to send the encoded bytes (ex. uart_write).
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      cobs_segment frame[2] = {{header, sizeof(header)},
+ *                               {payload, size}};
+ *
+ *      cobs_send(frame, 2, uart_write);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+cobs_send(const cobs_segment* segments, uint8_t count, cobs_write_fn write)
+{
+    uint8_t crc[COBS_CRC_SIZE];
+    uint16_t value = CRC_INIT;
+    cobs_cursor cursor = {segments, count, crc, 0, 0};
+    cobs_cursor scan;
+    const uint8_t* data;
+    uint16_t size;
+    uint16_t i;
+    uint8_t run;
+    uint8_t code;
+    uint8_t zero;
+
+    for (i = 0; i < count; i++)
+    {
+        for (size = 0; size < segments[i].size; size++)
+        {
+            value = _crc_xmodem_update(value, segments[i].data[size]);
+        }
+    }
+    crc[0] = (uint8_t) (value >> 8);
+    crc[1] = (uint8_t) value;
+
+    do
+    {
+        // Length of the run of non zero bytes of the next block
+        scan = cursor;
+        run = 0;
+        zero = 0;
+        while ( (run < COBS_BLOCK_SIZE) &&
+                ((size = _cobs_piece(&scan, &data)) > 0) )
+        {
+            for (i = 0; (i < size) && (run < COBS_BLOCK_SIZE); i++)
+            {
+                if (data[i] == 0)
+                {
+                    zero = 1;
+                    break;
+                }
+                run++;
+            }
+            scan.offset += i;
+            if (zero)
+            {
+                break;
+            }
+        }
+
+        code = run + 1;
+        write(&code, 1);
+
+        // The run is sent from the segments
+        while (run > 0)
+        {
+            size = _cobs_piece(&cursor, &data);
+            if (size > run)
+            {
+                size = run;
+            }
+            write(data, (uint8_t) size);
+            cursor.offset += size;
+            run -= size;
+        }
+
+        // The zero may start the next segment or the CRC, the cursor is
+        // moved to it before it is skipped
+        if (zero)
+        {
+            _cobs_piece(&cursor, &data);
+            cursor.offset++;
+        }
+    } while ( zero || (_cobs_piece(&cursor, &data) > 0) );
+
+    code = COBS_DELIMITER;
+    write(&code, 1);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send a frame from a single buffer.
+ *
+ * @param data Pointer to the bytes of the frame.
+ * @param size Number of bytes of the frame.
+ * @param write Function used to send the encoded bytes (ex. uart_write).
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      cobs_send_frame(config, sizeof(config), uart_write);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+cobs_send_frame(const uint8_t* data, uint16_t size, cobs_write_fn write)
+{
+    cobs_segment segment = {data, size};
+
+    cobs_send(&segment, 1, write);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize a decoder.
+ *
+ * @param decoder Pointer to the decoder.
+ * @param buffer Buffer where the frames are decoded, including the CRC.
+ * @param size Size of the buffer, the maximum frame size plus
+ *        COBS_CRC_SIZE.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      cobs_decoder decoder;
+ *      uint8_t frame[64 + COBS_CRC_SIZE];
+ *
+ *      cobs_decoder_init(&decoder, frame, sizeof(frame));
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+cobs_decoder_init(cobs_decoder* decoder, uint8_t* buffer, uint16_t size)
+{
+    decoder->buffer = buffer;
+    decoder->size = size;
+    decoder->length = 0;
+    decoder->crc = CRC_INIT;
+    decoder->code = CODE_START;
+    decoder->remaining = 0;
+    decoder->error = 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to decode a received byte.
+ *
+ * The decoded bytes are written to the buffer of the decoder. When the
+ * delimiter is received the CRC of the frame is checked. The frame is kept
+ * in the buffer until the next byte is decoded. The bytes of a frame too
+ * long for the buffer are ignored until the delimiter.
+ *
+ * @param decoder Pointer to the decoder.
+ * @param data Received byte.
+ *
+ * @return COBS_FRAME if a valid frame was completed, COBS_ERROR if a wrong
+ *         frame was completed or COBS_PENDING otherwise.
+ *
+ * \b Example:
+ * @code
+ *      if (cobs_decode(&decoder, data) == COBS_FRAME)
+ *      {
+ *          handle_frame(frame, cobs_frame_size(&decoder));
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+cobs_status
+cobs_decode(cobs_decoder* decoder, uint8_t data)
+{
+    cobs_status status = COBS_PENDING;
+
+    if (data == COBS_DELIMITER)
+    {
+        // Consecutive delimiters are not frames
+        if (decoder->code != CODE_START)
+        {
+            if ( !decoder->error && (decoder->remaining == 0) &&
+                 (decoder->length >= COBS_CRC_SIZE) && (decoder->crc == 0) )
+            {
+                status = COBS_FRAME;
+            }
+            else
+            {
+                status = COBS_ERROR;
+            }
+        }
+        decoder->code = CODE_START;
+        decoder->remaining = 0;
+
+        return status;
+    }
+
+    if (decoder->code == CODE_START)
+    {
+        decoder->length = 0;
+        decoder->crc = CRC_INIT;
+        decoder->error = 0;
+    }
+    else if (decoder->error)
+    {
+        return COBS_PENDING;
+    }
+
+    if (decoder->remaining == 0)
+    {
+        // A block shorter than the maximum was followed by a zero
+        if ( (decoder->code != CODE_START) &&
+             (decoder->code != COBS_BLOCK_SIZE + 1) )
+        {
+            _cobs_emit(decoder, 0);
+        }
+        decoder->code = data;
+        decoder->remaining = data - 1;
+    }
+    else
+    {
+        _cobs_emit(decoder, data);
+        decoder->remaining--;
+    }
+
+    return COBS_PENDING;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the size of the last frame decoded.
+ *
+ * @param decoder Pointer to the decoder.
+ *
+ * @return Number of bytes of the frame, without the CRC.
+ */
+/*****************************************************************************/
+uint16_t
+cobs_frame_size(const cobs_decoder* decoder)
+{
+    return decoder->length - COBS_CRC_SIZE;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the contiguous bytes at a position of a frame.
+ *
+ * The empty and completed segments are skipped. The CRC follows the last
+ * segment.
+ *
+ * @param cursor Pointer to the position, moved to the next segment with
+ *        bytes.
+ * @param data Pointer where the address of the bytes is stored.
+ *
+ * @return Number of contiguous bytes, 0 at the end of the frame.
+ */
+/*****************************************************************************/
+static uint16_t
+_cobs_piece(cobs_cursor* cursor, const uint8_t** data)
+{
+    while (cursor->index < cursor->count)
+    {
+        if (cursor->offset < cursor->segments[cursor->index].size)
+        {
+            *data = &cursor->segments[cursor->index].data[cursor->offset];
+            return cursor->segments[cursor->index].size - cursor->offset;
+        }
+        cursor->index++;
+        cursor->offset = 0;
+    }
+
+    if (cursor->offset < COBS_CRC_SIZE)
+    {
+        *data = &cursor->crc[cursor->offset];
+        return COBS_CRC_SIZE - cursor->offset;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to store a decoded byte.
+ *
+ * @param decoder Pointer to the decoder.
+ * @param data Decoded byte.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_cobs_emit(cobs_decoder* decoder, uint8_t data)
+{
+    if (decoder->length >= decoder->size)
+    {
+        decoder->error = 1;
+        return;
+    }
+
+    decoder->buffer[decoder->length++] = data;
+    decoder->crc = _crc_xmodem_update(decoder->crc, data);
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
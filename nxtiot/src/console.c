@@ -0,0 +1,513 @@
+/******************************************************************************
+* Title                 :   Console shell source file
+* Filename              :   console.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        console.c
+ *  @brief       Console shell implementation
+ *
+ *  To use the console shell, include this header file as follows:
+ *  @code
+ *      #include "console.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The console shell reads command lines from the software UART, the UART
+ *  being kept for the Wisol module, and runs the matching command of a
+ *  table kept in flash. console_poll never waits for a byte: it edits the
+ *  line with at most CONSOLE_BYTES_PER_POLL received bytes and returns, so
+ *  it is called from the main loop between the other tasks. A byte is only
+ *  taken when its echo fits in the TX buffer, so editing never waits for
+ *  the line either.
+ *
+ *  The line is edited in place:
+ *  - Backspace (BS or DEL) erases the last character.
+ *  - Enter (CR, LF or CR LF) runs the line.
+ *  - Up arrow (ESC [ A) or Ctrl-P recalls the last line run.
+ *  - Ctrl-C drops the line.
+ *
+ *  The line is split in words at the spaces, in place, and a word between
+ *  double quotes can hold spaces. The first word selects the command, and
+ *  help lists the commands when the table does not define it.
+ *
+ *  The output of the commands, the prompt and a recalled line are sent with
+ *  soft_uart_send, which waits when the TX buffer is full.
+ *
+ *  ## Usage ##
+ *
+ *  The following code example toggles a LED from the console.
+ *
+ *  @code
+ *      #include "console.h"
+ *
+ *      static void
+ *      led(uint8_t argc, char* argv[])
+ *      {
+ *          gpio_toggle_pin(LED_PORT, LED_PIN);
+ *      }
+ *
+ *      static const console_command commands[] PROGMEM =
+ *      {
+ *          {"led", led}
+ *      };
+ *
+ *      soft_uart_init();
+ *      sei();
+ *      console_init(commands, sizeof(commands) / sizeof(commands[0]));
+ *
+ *      while (1)
+ *      {
+ *          console_poll();
+ *          ...
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "console.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Longest echo of a received byte, "\b \b" */
+#define CONSOLE_ECHO_MAX        3
+
+#define KEY_CTRL_C              0x03
+#define KEY_BACKSPACE           0x08
+#define KEY_CTRL_P              0x10
+#define KEY_ESCAPE              0x1B
+#define KEY_DELETE              0x7F
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  State of the escape sequence being received
+  */
+typedef enum
+{
+    CONSOLE_ESCAPE_NONE = 0U,   /*! Plain bytes */
+    CONSOLE_ESCAPE_START,       /*! ESC received */
+    CONSOLE_ESCAPE_CSI          /*! ESC [ received */
+} console_escape;
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Table of commands, in flash */
+static const console_command* console_commands;
+/*! Number of commands */
+static uint8_t console_count;
+/*! Line being edited */
+static char console_line[CONSOLE_LINE_SIZE];
+/*! Characters of the line */
+static uint8_t console_length;
+/*! Last line run, before being split in words */
+static char console_history[CONSOLE_LINE_SIZE];
+/*! State of the escape sequence */
+static console_escape console_esc;
+/*! Set when the last byte was a CR, to take CR LF as one enter */
+static uint8_t console_cr;
+
+_Static_assert(sizeof(console_line) + sizeof(console_history) ==
+               CONSOLE_RAM_SIZE,
+               "CONSOLE_RAM_SIZE does not match the buffers");
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static void _console_key(uint8_t key);
+static void _console_echo(const char* str, uint8_t size);
+static void _console_send_P(PGM_P str);
+static void _console_run(void);
+static void _console_recall(void);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup console
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize the console and to show the prompt.
+ *
+ * @pre The software UART must be initialized and the global interrupts
+ *      enabled.
+ *
+ * @param commands Pointer to the table of commands, in flash (PROGMEM).
+ * @param count Number of commands.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+console_init(const console_command* commands, uint8_t count)
+{
+    console_commands = commands;
+    console_count = count;
+    console_length = 0;
+    console_history[0] = 0x00;
+    console_esc = CONSOLE_ESCAPE_NONE;
+    console_cr = 0;
+
+    console_prompt();
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to process the bytes received, without waiting.
+ *
+ * At most CONSOLE_BYTES_PER_POLL bytes are taken, and only while their
+ * echo fits in the TX buffer. A complete line runs its command before
+ * returning.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      while (1)
+ *      {
+ *          console_poll();
+ *          sensor_poll();
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+console_poll(void)
+{
+    unsigned char data;
+    uint8_t i;
+
+    for (i = 0; i < CONSOLE_BYTES_PER_POLL; i++)
+    {
+        if ( (SOFT_UART_TX_BUFFER_SIZE - 1 - soft_uart_tx_pending()) <
+             CONSOLE_ECHO_MAX )
+        {
+            break;
+        }
+        if (!soft_uart_try_read_char(&data))
+        {
+            break;
+        }
+        _console_key(data);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to split a line in words, in place. The spaces after every
+ * word are replaced by the terminator, and a word between double quotes
+ * keeps its spaces, without the quotes.
+ *
+ * @param line Line to be split, modified.
+ * @param argv Array filled with the pointers to the words.
+ * @param max Size of argv.
+ *
+ * @return Number of words of the line, more than max when argv is too
+ *         small, the words that do not fit are not stored.
+ */
+/*****************************************************************************/
+uint8_t
+console_tokenize(char* line, char* argv[], uint8_t max)
+{
+    uint8_t argc = 0;
+    char end;
+
+    while (1)
+    {
+        while (*line == ' ')
+        {
+            line++;
+        }
+        if (*line == 0x00)
+        {
+            break;
+        }
+
+        end = ' ';
+        if (*line == '"')
+        {
+            end = '"';
+            line++;
+        }
+
+        if (argc < max)
+        {
+            argv[argc] = line;
+        }
+        if (argc < 0xFF)
+        {
+            argc++;
+        }
+
+        while ( (*line != end) && (*line != 0x00) )
+        {
+            line++;
+        }
+        if (*line != 0x00)
+        {
+            *line++ = 0x00;
+        }
+    }
+
+    return argc;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to show the prompt again, after the application wrote to
+ * the console outside of a command.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+console_prompt(void)
+{
+    soft_uart_send(CONSOLE_PROMPT);
+    console_line[console_length] = 0x00;
+    soft_uart_send(console_line);
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
+
+/******************************************************************************
+* Private Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to edit the line with a received byte.
+ *
+ * @param key Byte received.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_console_key(uint8_t key)
+{
+    uint8_t cr = console_cr;
+
+    console_cr = 0;
+
+    if (console_esc == CONSOLE_ESCAPE_START)
+    {
+        console_esc = (key == '[') ? CONSOLE_ESCAPE_CSI : CONSOLE_ESCAPE_NONE;
+        return;
+    }
+    if (console_esc == CONSOLE_ESCAPE_CSI)
+    {
+        // Parameters until the final byte of the sequence
+        if ( (key >= 0x40) && (key <= 0x7E) )
+        {
+            console_esc = CONSOLE_ESCAPE_NONE;
+            if (key == 'A')
+            {
+                _console_recall();
+            }
+        }
+        return;
+    }
+
+    switch (key)
+    {
+        case '\r':
+            console_cr = 1;
+            _console_run();
+            break;
+
+        case '\n':
+            if (!cr)
+            {
+                _console_run();
+            }
+            break;
+
+        case KEY_BACKSPACE:
+        case KEY_DELETE:
+            if (console_length > 0)
+            {
+                console_length--;
+                _console_echo("\b \b", 3);
+            }
+            break;
+
+        case KEY_CTRL_C:
+            console_length = 0;
+            soft_uart_send("^C\r\n");
+            console_prompt();
+            break;
+
+        case KEY_CTRL_P:
+            _console_recall();
+            break;
+
+        case KEY_ESCAPE:
+            console_esc = CONSOLE_ESCAPE_START;
+            break;
+
+        default:
+            // Printable characters, the bell when the line is full
+            if ( (key >= ' ') && (key < KEY_DELETE) )
+            {
+                if (console_length < (CONSOLE_LINE_SIZE - 1))
+                {
+                    console_line[console_length++] = (char) key;
+                    _console_echo((const char *) &key, 1);
+                }
+                else
+                {
+                    _console_echo("\a", 1);
+                }
+            }
+            break;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to echo the edition of the line, console_poll checks that
+ * it fits in the TX buffer.
+ *
+ * @param str Bytes to be sent.
+ * @param size Number of bytes.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_console_echo(const char* str, uint8_t size)
+{
+    soft_uart_write((const uint8_t *) str, size);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send a string stored in flash.
+ *
+ * @param str String in flash.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_console_send_P(PGM_P str)
+{
+    uint8_t c;
+
+    while ((c = pgm_read_byte(str++)) != 0x00)
+    {
+        while (soft_uart_write(&c, 1) == 0)
+        {
+
+        }
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to run the line and to start a new one.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_console_run(void)
+{
+    char* argv[CONSOLE_MAX_ARGS];
+    console_handler handler;
+    uint8_t argc;
+    uint8_t i;
+
+    soft_uart_send("\r\n");
+
+    console_line[console_length] = 0x00;
+    if (console_length > 0)
+    {
+        memcpy(console_history, console_line, console_length + 1);
+    }
+    console_length = 0;
+
+    argc = console_tokenize(console_line, argv, CONSOLE_MAX_ARGS);
+    if (argc > CONSOLE_MAX_ARGS)
+    {
+        soft_uart_send("too many arguments\r\n");
+    }
+    else if (argc > 0)
+    {
+        for (i = 0; i < console_count; i++)
+        {
+            if (strncmp_P(argv[0], console_commands[i].name,
+                          CONSOLE_NAME_SIZE) == 0)
+            {
+                break;
+            }
+        }
+
+        if (i < console_count)
+        {
+            handler = (console_handler)
+                      pgm_read_ptr(&console_commands[i].handler);
+            handler(argc, argv);
+        }
+        else if (strcmp(argv[0], "help") == 0)
+        {
+            for (i = 0; i < console_count; i++)
+            {
+                _console_send_P(console_commands[i].name);
+                soft_uart_send("\r\n");
+            }
+        }
+        else
+        {
+            soft_uart_send("unknown command\r\n");
+        }
+    }
+
+    console_prompt();
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to replace the line with the last line run.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_console_recall(void)
+{
+    console_length = (uint8_t) strlen(console_history);
+    memcpy(console_line, console_history, console_length + 1);
+
+    // Back to the start of the line and erase what is after the recall
+    soft_uart_send("\r");
+    console_prompt();
+    soft_uart_send("\x1B[K");
+}
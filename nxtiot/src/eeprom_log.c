@@ -0,0 +1,608 @@
+/******************************************************************************
+* Title                 :   EEPROM log source file
+* Filename              :   eeprom_log.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        eeprom_log.c
+ *  @brief       EEPROM log implementation
+ *
+ *  To use the EEPROM log, include this header file as follows:
+ *  @code
+ *      #include "eeprom_log.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The EEPROM log implements a queue of records stored in the internal EEPROM
+ *  that survives resets, so the messages waiting for the Sigfox Wisol module
+ *  are not lost on a brown out or a watchdog reset.
+ *
+ *  The EEPROM is divided in EEPROM_LOG_SLOTS slots of EEPROM_LOG_RECORD_SIZE
+ *  bytes that are always written one after the other as a ring, so every
+ *  slot is erased the same number of times. Each record has the following
+ *  layout:
+ *      [0..1]  Sequence number of the record
+ *      [2..3]  Sequence number of the last record consumed by the application
+ *      [4]     Size of the payload, 0 for the records that only consume
+ *      [5..16] Payload
+ *      [17..18] CRC16 of the sequence numbers, size and payload
+ *
+ *  At boot the log is recovered scanning the slots once looking for the
+ *  valid record with the newest sequence number. Its consumed sequence
+ *  number tells which records are still pending. A record interrupted by a
+ *  reset fails the CRC check and is ignored.
+ *
+ *  The records are written by the EEPROM ready interrupt one byte per
+ *  interrupt, so the CPU is not blocked during the 3.4 ms that takes each
+ *  byte. Bytes that already hold the right value are not written again.
+ *
+ *  ## Usage ##
+ *
+ *  To use the EEPROM log, the log must be first initialized using the
+ *  eeprom_log_init function and the global interrupts must be enabled.
+ *
+ *  The following code example stores a message and sends it once the
+ *  module is available.
+ *
+ *  @code
+ *      #include "eeprom_log.h"
+ *
+ *      uint8_t msg[EEPROM_LOG_PAYLOAD_SIZE];
+ *      uint8_t size;
+ *
+ *      eeprom_log_init();
+ *      sei();
+ *
+ *      eeprom_log_append(msg, 4);
+ *
+ *      if (eeprom_log_peek(msg, &size) == EEPROM_LOG_OK)
+ *      {
+ *          // Send the message
+ *          eeprom_log_pop();
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+#include "eeprom_log.h"
+#include "isr_profile.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Offset of the sequence number of the record */
+#define OFFSET_SEQ      0
+/*! Offset of the sequence number of the last consumed record */
+#define OFFSET_ACK      2
+/*! Offset of the payload size */
+#define OFFSET_SIZE     4
+/*! Offset of the payload */
+#define OFFSET_DATA     5
+/*! Offset of the CRC */
+#define OFFSET_CRC      (OFFSET_DATA + EEPROM_LOG_PAYLOAD_SIZE)
+/*! Initial value of the CRC, so an erased record is never valid */
+#define CRC_INIT        0xFFFF
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! Macro used to get the EEPROM address of a slot */
+#define SLOT_ADDR(slot) ((uint8_t *) (uintptr_t) (EEPROM_LOG_START_ADDR + \
+                         (uint16_t) (slot) * EEPROM_LOG_RECORD_SIZE))
+/*! Macro used to read a little endian 16 bit field of a record */
+#define GET16(buf, off) ((uint16_t) ((buf)[(off)] | ((buf)[(off) + 1] << 8)))
+/*! Macro used to write a little endian 16 bit field of a record */
+#define SET16(buf, off, val)                                                  \
+    do                                                                        \
+    {                                                                         \
+        (buf)[(off)] = (uint8_t) (val);                                       \
+        (buf)[(off) + 1] = (uint8_t) ((val) >> 8);                            \
+    } while (0)
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Slot of the newest record */
+static uint8_t eeprom_log_head_slot;
+/*! Sequence number of the newest record */
+static uint16_t eeprom_log_head_seq;
+/*! Sequence number of the last consumed record */
+static uint16_t eeprom_log_ack_seq;
+/*! Number of records waiting to be consumed */
+static uint8_t eeprom_log_pending;
+/*! Number of records overwritten before being consumed */
+static uint16_t eeprom_log_dropped_count;
+
+/*! Record being written by the EEPROM ready interrupt */
+static uint8_t eeprom_log_record[EEPROM_LOG_RECORD_SIZE];
+/*! Address of the slot being written */
+static uint8_t* eeprom_log_wr_addr;
+/*! Index of the next byte of the record to be written */
+static uint8_t eeprom_log_wr_index;
+/*! Number of bytes of the record before the CRC */
+static uint8_t eeprom_log_wr_end;
+/*! Flag set while a record is being written */
+static volatile uint8_t eeprom_log_writing;
+/*! Consumed sequence number once the record is written */
+static uint16_t eeprom_log_next_ack;
+/*! Number of pending records once the record is written */
+static uint8_t eeprom_log_next_pending;
+/*! Flag set if the record being written drops a pending record */
+static uint8_t eeprom_log_next_dropped;
+
+_Static_assert(sizeof(eeprom_log_record) == EEPROM_LOG_RAM_SIZE,
+               "EEPROM_LOG_RAM_SIZE does not match the buffers");
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static uint8_t _eeprom_log_read_record(uint8_t slot, uint8_t* record);
+static uint16_t _eeprom_log_crc(const uint8_t* record, uint8_t size);
+static uint8_t _eeprom_log_find_oldest(uint8_t* record);
+static void _eeprom_log_write(uint16_t ack, const uint8_t* data, uint8_t size);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup eeprom_log
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize the EEPROM log.
+ *
+ * This function recovers the state of the log scanning every slot of the
+ * EEPROM. Any write in progress is cancelled.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      eeprom_log_init();
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+eeprom_log_init(void)
+{
+    uint8_t record[EEPROM_LOG_RECORD_SIZE];
+    uint8_t found = 0;
+    uint16_t seq;
+
+    EECR &= ~_BV(EERIE);
+    eeprom_log_writing = 0;
+    eeprom_log_dropped_count = 0;
+
+    eeprom_log_head_slot = EEPROM_LOG_SLOTS - 1;
+    eeprom_log_head_seq = 0;
+    eeprom_log_ack_seq = 0;
+    eeprom_log_pending = 0;
+
+    // Find the newest valid record
+    for (uint8_t slot = 0; slot < EEPROM_LOG_SLOTS; slot++)
+    {
+        if (_eeprom_log_read_record(slot, record))
+        {
+            seq = GET16(record, OFFSET_SEQ);
+            if ( (!found) || ((int16_t) (seq - eeprom_log_head_seq) > 0) )
+            {
+                found = 1;
+                eeprom_log_head_slot = slot;
+                eeprom_log_head_seq = seq;
+                eeprom_log_ack_seq = GET16(record, OFFSET_ACK);
+            }
+        }
+    }
+
+    if (!found)
+    {
+        return;
+    }
+
+    // Only the last EEPROM_LOG_SLOTS records can still be in the EEPROM
+    if ((uint16_t) (eeprom_log_head_seq - eeprom_log_ack_seq) >
+        EEPROM_LOG_SLOTS)
+    {
+        eeprom_log_ack_seq = eeprom_log_head_seq - EEPROM_LOG_SLOTS;
+    }
+
+    // Count the records not consumed yet
+    for (uint8_t slot = 0; slot < EEPROM_LOG_SLOTS; slot++)
+    {
+        if ( _eeprom_log_read_record(slot, record) &&
+             (record[OFFSET_SIZE] != 0) )
+        {
+            seq = GET16(record, OFFSET_SEQ);
+            if ( ((int16_t) (seq - eeprom_log_ack_seq) > 0) &&
+                 ((int16_t) (eeprom_log_head_seq - seq) >= 0) )
+            {
+                eeprom_log_pending++;
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to append a record to the EEPROM log.
+ *
+ * The record is written in background by the EEPROM ready interrupt. If the
+ * log is full the oldest pending record is overwritten.
+ *
+ * @param data Pointer to the payload of the record.
+ * @param size Size of the payload, from 1 to EEPROM_LOG_PAYLOAD_SIZE.
+ *
+ * @return EEPROM_LOG_OK if the write was started, EEPROM_LOG_BUSY if another
+ *         record is being written or EEPROM_LOG_INVALID if the size is not
+ *         valid.
+ *
+ * \b Example:
+ * @code
+ *      uint8_t msg[] = {0x01, 0x02};
+ *      eeprom_log_append(msg, sizeof(msg));
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+eeprom_log_status
+eeprom_log_append(const uint8_t* data, uint8_t size)
+{
+    if ( (size == 0) || (size > EEPROM_LOG_PAYLOAD_SIZE) )
+    {
+        return EEPROM_LOG_INVALID;
+    }
+
+    if (eeprom_log_writing)
+    {
+        return EEPROM_LOG_BUSY;
+    }
+
+    _eeprom_log_write(eeprom_log_ack_seq, data, size);
+
+    return EEPROM_LOG_OK;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read the oldest pending record of the EEPROM log.
+ *
+ * @param data Pointer to the buffer where the payload will be written, it
+ *             must hold EEPROM_LOG_PAYLOAD_SIZE bytes.
+ * @param size Pointer where the size of the payload will be written.
+ *
+ * @return EEPROM_LOG_OK if a record was read, EEPROM_LOG_BUSY if a record is
+ *         being written or EEPROM_LOG_EMPTY if there are no pending records.
+ */
+/*****************************************************************************/
+eeprom_log_status
+eeprom_log_peek(uint8_t* data, uint8_t* size)
+{
+    uint8_t record[EEPROM_LOG_RECORD_SIZE];
+
+    if (eeprom_log_writing)
+    {
+        return EEPROM_LOG_BUSY;
+    }
+
+    if (!_eeprom_log_find_oldest(record))
+    {
+        return EEPROM_LOG_EMPTY;
+    }
+
+    *size = record[OFFSET_SIZE];
+    memcpy(data, &record[OFFSET_DATA], *size);
+
+    return EEPROM_LOG_OK;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to consume the oldest pending record of the EEPROM log.
+ *
+ * A record without payload is appended to store the consumed sequence
+ * number, so the record is not returned again after a reset.
+ *
+ * @return EEPROM_LOG_OK if the record was consumed, EEPROM_LOG_BUSY if a
+ *         record is being written or EEPROM_LOG_EMPTY if there are no
+ *         pending records.
+ */
+/*****************************************************************************/
+eeprom_log_status
+eeprom_log_pop(void)
+{
+    uint8_t record[EEPROM_LOG_RECORD_SIZE];
+
+    if (eeprom_log_writing)
+    {
+        return EEPROM_LOG_BUSY;
+    }
+
+    if (!_eeprom_log_find_oldest(record))
+    {
+        return EEPROM_LOG_EMPTY;
+    }
+
+    _eeprom_log_write(GET16(record, OFFSET_SEQ), 0, 0);
+
+    return EEPROM_LOG_OK;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of pending records of the EEPROM log.
+ *
+ * @return Number of records not consumed yet.
+ */
+/*****************************************************************************/
+uint8_t
+eeprom_log_count(void)
+{
+    return eeprom_log_pending;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to know if a record is being written.
+ *
+ * @return 1 if a record is being written, 0 otherwise.
+ */
+/*****************************************************************************/
+uint8_t
+eeprom_log_busy(void)
+{
+    return eeprom_log_writing;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of records overwritten before being
+ * consumed since the log was initialized.
+ *
+ * @return Number of dropped records.
+ */
+/*****************************************************************************/
+uint16_t
+eeprom_log_dropped(void)
+{
+    return eeprom_log_dropped_count;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read and validate the record stored in a slot.
+ *
+ * @param slot Slot number.
+ * @param record Pointer to the buffer where the record will be written.
+ *
+ * @return 1 if the record is valid, 0 otherwise.
+ */
+/*****************************************************************************/
+static uint8_t
+_eeprom_log_read_record(uint8_t slot, uint8_t* record)
+{
+    uint8_t size;
+
+    eeprom_read_block(record, SLOT_ADDR(slot), EEPROM_LOG_RECORD_SIZE);
+
+    size = record[OFFSET_SIZE];
+    if (size > EEPROM_LOG_PAYLOAD_SIZE)
+    {
+        return 0;
+    }
+
+    return ( _eeprom_log_crc(record, OFFSET_DATA + size) ==
+             GET16(record, OFFSET_CRC) );
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to compute the CRC16 (CCITT) of a record.
+ *
+ * @param record Pointer to the record.
+ * @param size Number of bytes of the record covered by the CRC.
+ *
+ * @return CRC of the record.
+ */
+/*****************************************************************************/
+static uint16_t
+_eeprom_log_crc(const uint8_t* record, uint8_t size)
+{
+    uint16_t crc = CRC_INIT;
+
+    for (uint8_t i = 0; i < size; i++)
+    {
+        crc = _crc_xmodem_update(crc, record[i]);
+    }
+
+    return crc;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to find the oldest pending record.
+ *
+ * The records after the last consumed one are checked in order, skipping
+ * the records without payload and the corrupted ones.
+ *
+ * @param record Pointer to the buffer where the record will be written.
+ *
+ * @return 1 if a pending record was found, 0 otherwise.
+ */
+/*****************************************************************************/
+static uint8_t
+_eeprom_log_find_oldest(uint8_t* record)
+{
+    uint16_t seq = eeprom_log_ack_seq;
+    uint16_t distance;
+    uint8_t slot;
+
+    if (eeprom_log_pending == 0)
+    {
+        return 0;
+    }
+
+    while (seq != eeprom_log_head_seq)
+    {
+        seq++;
+        distance = eeprom_log_head_seq - seq;
+        if (distance <= eeprom_log_head_slot)
+        {
+            slot = eeprom_log_head_slot - distance;
+        }
+        else
+        {
+            slot = eeprom_log_head_slot + EEPROM_LOG_SLOTS - distance;
+        }
+
+        if ( _eeprom_log_read_record(slot, record) &&
+             (GET16(record, OFFSET_SEQ) == seq) &&
+             (record[OFFSET_SIZE] != 0) )
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to start writing a record after the newest one.
+ *
+ * The state of the log is updated by the EEPROM ready interrupt once the
+ * whole record is written.
+ *
+ * @param ack Sequence number of the last consumed record.
+ * @param data Pointer to the payload of the record.
+ * @param size Size of the payload.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_eeprom_log_write(uint16_t ack, const uint8_t* data, uint8_t size)
+{
+    uint8_t old[EEPROM_LOG_RECORD_SIZE];
+    uint8_t slot;
+    uint16_t seq = eeprom_log_head_seq + 1;
+    uint16_t oldest = seq - EEPROM_LOG_SLOTS;
+    uint16_t crc;
+
+    slot = eeprom_log_head_slot + 1;
+    if (slot >= EEPROM_LOG_SLOTS)
+    {
+        slot = 0;
+    }
+
+    // A record with payload is added, a record without payload consumes one
+    if (size != 0)
+    {
+        eeprom_log_next_pending = eeprom_log_pending + 1;
+    }
+    else
+    {
+        eeprom_log_next_pending = eeprom_log_pending - 1;
+    }
+
+    // The record in the slot is lost, consume it if it is still pending
+    eeprom_log_next_dropped = 0;
+    if ((int16_t) (oldest - ack) > 0)
+    {
+        if ( _eeprom_log_read_record(slot, old) &&
+             (GET16(old, OFFSET_SEQ) == oldest) &&
+             (old[OFFSET_SIZE] != 0) )
+        {
+            eeprom_log_next_pending--;
+            eeprom_log_next_dropped = 1;
+        }
+        ack = oldest;
+    }
+    eeprom_log_next_ack = ack;
+
+    SET16(eeprom_log_record, OFFSET_SEQ, seq);
+    SET16(eeprom_log_record, OFFSET_ACK, ack);
+    eeprom_log_record[OFFSET_SIZE] = size;
+    if (size != 0)
+    {
+        memcpy(&eeprom_log_record[OFFSET_DATA], data, size);
+    }
+
+    crc = _eeprom_log_crc(eeprom_log_record, OFFSET_DATA + size);
+    SET16(eeprom_log_record, OFFSET_CRC, crc);
+
+    eeprom_log_wr_addr = SLOT_ADDR(slot);
+    eeprom_log_wr_end = OFFSET_DATA + size;
+    eeprom_log_wr_index = 0;
+    eeprom_log_writing = 1;
+
+    EECR |= _BV(EERIE);
+}
+
+/*****************************************************************************/
+/*!
+ * EEPROM ready interrupt.
+ *
+ * Writes the next byte of the record that differs from the EEPROM contents.
+ * Once the record is completely written the interrupt is disabled and the
+ * state of the log is updated.
+ */
+/*****************************************************************************/
+ISR_PROFILED(EE_READY_vect, ISR_PROFILE_EEPROM)
+{
+    uint8_t index;
+    uint8_t* addr;
+
+    while (eeprom_log_wr_index < (eeprom_log_wr_end + 2))
+    {
+        index = eeprom_log_wr_index++;
+        if (index >= eeprom_log_wr_end)
+        {
+            index += OFFSET_CRC - eeprom_log_wr_end;
+        }
+
+        addr = eeprom_log_wr_addr + index;
+        if (eeprom_read_byte(addr) != eeprom_log_record[index])
+        {
+            eeprom_write_byte(addr, eeprom_log_record[index]);
+            return;
+        }
+    }
+
+    EECR &= ~_BV(EERIE);
+
+    eeprom_log_head_slot++;
+    if (eeprom_log_head_slot >= EEPROM_LOG_SLOTS)
+    {
+        eeprom_log_head_slot = 0;
+    }
+    eeprom_log_head_seq++;
+    eeprom_log_ack_seq = eeprom_log_next_ack;
+    eeprom_log_pending = eeprom_log_next_pending;
+    eeprom_log_dropped_count += eeprom_log_next_dropped;
+
+    eeprom_log_writing = 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
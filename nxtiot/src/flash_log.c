@@ -0,0 +1,882 @@
+/******************************************************************************
+* Title                 :   Flash log source file
+* Filename              :   flash_log.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        flash_log.c
+ *  @brief       Flash log implementation
+ *
+ *  To use the flash log, include this header file as follows:
+ *  @code
+ *      #include "flash_log.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The flash log stores fixed size records in an external SPI NOR flash
+ *  (W25Qxx or compatible) used as a circular log.
+ *
+ *  The records are buffered in RAM in blocks of FLASH_LOG_BLOCK_SIZE bytes.
+ *  When a block is full it is programmed at once through the interrupt
+ *  driven SPI driver, while the records that follow are buffered in a
+ *  second block. The flash_log_poll function, called from the main loop,
+ *  starts the program and erase operations and reads the status of the
+ *  flash, so the CPU never waits for the flash.
+ *
+ *  Every block has a header with its sequence number, the number of
+ *  records and a CRC of the block. The address of a block is given by its
+ *  sequence number, so the log is written sequentially and every sector is
+ *  erased once per turn of the log. The sector after the one being written
+ *  is erased ahead of time, so writing a block never waits for an erase.
+ *  When a sector is erased the oldest records are lost.
+ *
+ *  At boot the write position is recovered reading the first header of
+ *  every sector and a binary search in the newest sector.
+ *
+ *  ## Usage ##
+ *
+ *  To use the flash log, the SPI driver must be first initialized and the
+ *  global interrupts must be enabled. The flash_log_poll function must be
+ *  called from the main loop. The functions must not be used from an
+ *  interrupt.
+ *
+ *  @code
+ *      #include "flash_log.h"
+ *
+ *      uint8_t sample[FLASH_LOG_RECORD_SIZE];
+ *      flash_log_reader reader;
+ *
+ *      spi_init();
+ *      sei();
+ *      flash_log_init(B1_PORT, B1_PIN);
+ *
+ *      while (1)
+ *      {
+ *          if (sample_ready())
+ *          {
+ *              flash_log_append(sample);
+ *          }
+ *          flash_log_poll();
+ *      }
+ *
+ *      // Later, read the records from the oldest one
+ *      flash_log_flush();
+ *      flash_log_reader_init(&reader);
+ *      while (flash_log_read(&reader, sample) != FLASH_LOG_EMPTY)
+ *      {
+ *          flash_log_poll();
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "flash_log.h"
+#include <util/crc16.h>
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Program page of the flash */
+#define PAGE_SIZE           256
+/*! Number of blocks of a sector */
+#define SECTOR_BLOCKS       ((uint16_t) (FLASH_LOG_SECTOR_SIZE / \
+                                         FLASH_LOG_BLOCK_SIZE))
+/*! Number of blocks of the log */
+#define LOG_BLOCKS          ((uint32_t) FLASH_LOG_SECTORS * SECTOR_BLOCKS)
+
+/*! Flash commands */
+#define CMD_PROGRAM         0x02
+#define CMD_READ            0x03
+#define CMD_READ_STATUS     0x05
+#define CMD_WRITE_ENABLE    0x06
+#define CMD_SECTOR_ERASE    0x20
+
+/*! Write in progress bit of the status register */
+#define STATUS_WIP          0x01
+
+/*! Offset of the sequence number in the header */
+#define OFFSET_SEQ          0
+/*! Offset of the number of records in the header */
+#define OFFSET_COUNT        4
+/*! Offset of the record size in the header */
+#define OFFSET_RECORD_SIZE  5
+/*! Offset of the CRC in the header */
+#define OFFSET_CRC          6
+
+/*! Initial value of the CRC */
+#define CRC_INIT            0xFFFF
+
+/*! Size of the chunks read to check the CRC of a block */
+#define CHUNK_SIZE          16
+
+/*! Sequence number of an erased header */
+#define SEQ_ERASED          0xFFFFFFFFUL
+
+#if (PAGE_SIZE % FLASH_LOG_BLOCK_SIZE) != 0
+    #error "FLASH_LOG_BLOCK_SIZE must divide the 256 bytes page"
+#endif
+
+#if (FLASH_LOG_SECTOR_SIZE % FLASH_LOG_BLOCK_SIZE) != 0
+    #error "FLASH_LOG_SECTOR_SIZE must be a multiple of FLASH_LOG_BLOCK_SIZE"
+#endif
+
+#if (FLASH_LOG_SECTORS < 3)
+    #error "FLASH_LOG_SECTORS must be at least 3"
+#endif
+
+#if (FLASH_LOG_BLOCK_RECORDS < 1) || (FLASH_LOG_BLOCK_RECORDS > 255)
+    #error "FLASH_LOG_RECORD_SIZE does not fit in FLASH_LOG_BLOCK_SIZE"
+#endif
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! Macro used to get the flash address of a block */
+#define BLOCK_ADDR(seq)     (FLASH_LOG_START_ADDR + \
+                             ((seq) % LOG_BLOCKS) * FLASH_LOG_BLOCK_SIZE)
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  Flash operation in progress enumeration
+  */
+typedef enum
+{
+    FLASH_LOG_IDLE = 0U,
+    FLASH_LOG_PROGRAM,
+    FLASH_LOG_ERASE
+} flash_log_operation;
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! SPI device of the flash */
+static spi_device flash_log_device;
+
+/*! Blocks buffered in RAM */
+static uint8_t flash_log_buffer[2][FLASH_LOG_BLOCK_SIZE];
+/*! Flags set when a block is full and waiting to be programmed */
+static uint8_t flash_log_ready[2];
+/*! Block being filled */
+static uint8_t flash_log_fill;
+/*! Number of records of the block being filled */
+static uint8_t flash_log_records;
+/*! Block being programmed or the next one to be programmed */
+static uint8_t flash_log_write;
+
+/*! Sequence number of the next block filled */
+static uint32_t flash_log_seq;
+/*! Sequence number of the next block programmed */
+static uint32_t flash_log_head;
+/*! Sequence number of the oldest block in the flash */
+static uint32_t flash_log_oldest;
+/*! Sequence number of the first block of the next sector to be erased */
+static uint32_t flash_log_erase_seq;
+/*! Number of sectors waiting to be erased */
+static uint8_t flash_log_erase_pending;
+/*! Number of records dropped because both blocks were full */
+static uint16_t flash_log_dropped_count;
+
+/*! Flash operation in progress */
+static flash_log_operation flash_log_state;
+
+/*! SPI transactions and their buffers */
+static spi_transaction flash_log_enable;
+static spi_transaction flash_log_command;
+static spi_transaction flash_log_data;
+static spi_transaction flash_log_rdsr;
+static const uint8_t flash_log_enable_tx[1] = {CMD_WRITE_ENABLE};
+static const uint8_t flash_log_rdsr_tx[2] = {CMD_READ_STATUS, 0xFF};
+static uint8_t flash_log_rdsr_rx[2];
+static uint8_t flash_log_command_tx[4];
+
+// Every array of the driver, the SPI transaction descriptors aside
+_Static_assert(sizeof(flash_log_buffer) + sizeof(flash_log_ready) +
+               sizeof(flash_log_enable_tx) + sizeof(flash_log_rdsr_tx) +
+               sizeof(flash_log_rdsr_rx) + sizeof(flash_log_command_tx) ==
+               FLASH_LOG_RAM_SIZE,
+               "FLASH_LOG_RAM_SIZE does not match the buffers");
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static void _flash_log_submit(spi_transaction* transaction,
+                              const uint8_t* tx, uint8_t* rx, uint16_t size,
+                              uint8_t flags);
+static void _flash_log_command(uint8_t command, uint32_t address,
+                               uint8_t flags);
+static void _flash_log_wait(spi_transaction* transaction);
+static void _flash_log_read(uint32_t address, uint8_t* data, uint16_t size);
+static uint8_t _flash_log_blank(uint32_t seq);
+static uint16_t _flash_log_crc(uint16_t crc, const uint8_t* data,
+                               uint8_t size);
+static uint8_t _flash_log_load(uint32_t seq);
+static void _flash_log_close(void);
+static void _flash_log_recover(void);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup flash_log
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize the flash log.
+ *
+ * The write position is recovered from the flash and the erase of the
+ * sectors ahead of it is scheduled. It waits for the SPI transfers, so it
+ * should only be called at boot.
+ *
+ * @pre The SPI driver must be initialized and the global interrupts must be
+ *      enabled.
+ *
+ * @param cs_port Chip select pin port address of the flash (ex. &PORTB).
+ * @param cs_pin Chip select pin number of the flash (ex. PB2).
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      flash_log_init(B1_PORT, B1_PIN);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+flash_log_init(uint8_t* cs_port, uint8_t cs_pin)
+{
+    spi_device_init(&flash_log_device, cs_port, cs_pin, FLASH_LOG_CLOCK,
+                    SPI_MODE_0, SPI_MSB_FIRST);
+
+    flash_log_ready[0] = 0;
+    flash_log_ready[1] = 0;
+    flash_log_fill = 0;
+    flash_log_write = 0;
+    flash_log_records = 0;
+    flash_log_dropped_count = 0;
+    flash_log_state = FLASH_LOG_IDLE;
+
+    // An operation started before a reset of the microcontroller
+    do
+    {
+        _flash_log_submit(&flash_log_rdsr, flash_log_rdsr_tx,
+                          flash_log_rdsr_rx, 2, 0);
+        _flash_log_wait(&flash_log_rdsr);
+    } while (flash_log_rdsr_rx[1] & STATUS_WIP);
+
+    _flash_log_recover();
+    flash_log_seq = flash_log_head;
+
+    // The sector of the head is erased too when no block is written in it
+    if ((flash_log_head % SECTOR_BLOCKS) == 0)
+    {
+        flash_log_erase_seq = flash_log_head;
+        flash_log_erase_pending = 2;
+    }
+    else
+    {
+        flash_log_erase_seq = flash_log_head - (flash_log_head %
+                                                SECTOR_BLOCKS) +
+                              SECTOR_BLOCKS;
+        flash_log_erase_pending = 1;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to append a record to the log.
+ *
+ * The record is copied to the block being filled, which is programmed by
+ * flash_log_poll when it is full.
+ *
+ * @param record Pointer to the record of FLASH_LOG_RECORD_SIZE bytes.
+ *
+ * @return FLASH_LOG_OK if the record was appended or FLASH_LOG_FULL if both
+ *         blocks are waiting to be programmed and the record was dropped.
+ *
+ * \b Example:
+ * @code
+ *      if (flash_log_append(sample) == FLASH_LOG_FULL)
+ *      {
+ *          // flash_log_poll is not called often enough
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+flash_log_status
+flash_log_append(const uint8_t* record)
+{
+    uint8_t* block = flash_log_buffer[flash_log_fill];
+
+    if (flash_log_ready[flash_log_fill])
+    {
+        flash_log_dropped_count++;
+        return FLASH_LOG_FULL;
+    }
+
+    memcpy(&block[FLASH_LOG_HEADER_SIZE + flash_log_records *
+                  FLASH_LOG_RECORD_SIZE], record, FLASH_LOG_RECORD_SIZE);
+    flash_log_records++;
+
+    if (flash_log_records == FLASH_LOG_BLOCK_RECORDS)
+    {
+        _flash_log_close();
+    }
+
+    return FLASH_LOG_OK;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to close the block being filled.
+ *
+ * The block is programmed with the records appended so far, for example
+ * before reading the log or sleeping. The remaining space of the block is
+ * not used.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+flash_log_flush(void)
+{
+    if (!flash_log_ready[flash_log_fill])
+    {
+        _flash_log_close();
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to run the flash operations.
+ *
+ * It checks if the operation in progress is completed and starts the next
+ * one: the program of a full block or the erase of a sector ahead. It never
+ * waits for the flash and must be called periodically from the main loop.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      while (1)
+ *      {
+ *          flash_log_poll();
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+flash_log_poll(void)
+{
+    uint32_t oldest;
+
+    if (flash_log_state != FLASH_LOG_IDLE)
+    {
+        if (flash_log_rdsr.status == SPI_PENDING)
+        {
+            return;
+        }
+
+        if (flash_log_rdsr_rx[1] & STATUS_WIP)
+        {
+            _flash_log_submit(&flash_log_rdsr, flash_log_rdsr_tx,
+                              flash_log_rdsr_rx, 2, 0);
+            return;
+        }
+
+        if (flash_log_state == FLASH_LOG_PROGRAM)
+        {
+            flash_log_ready[flash_log_write] = 0;
+            flash_log_write ^= 1;
+            flash_log_head++;
+
+            // The head enters a new sector, the next one is erased ahead
+            if ((flash_log_head % SECTOR_BLOCKS) == 0)
+            {
+                flash_log_erase_pending++;
+            }
+        }
+        else
+        {
+            flash_log_erase_seq += SECTOR_BLOCKS;
+            flash_log_erase_pending--;
+        }
+
+        flash_log_state = FLASH_LOG_IDLE;
+    }
+
+    if ( flash_log_ready[flash_log_write] &&
+         ((flash_log_erase_pending == 0) ||
+          (flash_log_head < flash_log_erase_seq)) )
+    {
+        uint8_t* block = flash_log_buffer[flash_log_write];
+
+        flash_log_state = FLASH_LOG_PROGRAM;
+        _flash_log_submit(&flash_log_enable, flash_log_enable_tx, NULL, 1, 0);
+        _flash_log_command(CMD_PROGRAM, BLOCK_ADDR(flash_log_head),
+                           SPI_KEEP_CS);
+        _flash_log_submit(&flash_log_data, block, NULL,
+                          FLASH_LOG_HEADER_SIZE + block[OFFSET_COUNT] *
+                          FLASH_LOG_RECORD_SIZE, 0);
+        _flash_log_submit(&flash_log_rdsr, flash_log_rdsr_tx,
+                          flash_log_rdsr_rx, 2, 0);
+    }
+    else if (flash_log_erase_pending > 0)
+    {
+        // The blocks of the previous turn in the sector are lost
+        if ((flash_log_erase_seq + SECTOR_BLOCKS) > LOG_BLOCKS)
+        {
+            oldest = flash_log_erase_seq + SECTOR_BLOCKS - LOG_BLOCKS;
+            if (flash_log_oldest < oldest)
+            {
+                flash_log_oldest = oldest;
+            }
+        }
+
+        flash_log_state = FLASH_LOG_ERASE;
+        _flash_log_submit(&flash_log_enable, flash_log_enable_tx, NULL, 1, 0);
+        _flash_log_command(CMD_SECTOR_ERASE, BLOCK_ADDR(flash_log_erase_seq),
+                           0);
+        _flash_log_submit(&flash_log_rdsr, flash_log_rdsr_tx,
+                          flash_log_rdsr_rx, 2, 0);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to check if there are flash operations pending.
+ *
+ * @return 1 if a block or an erase is pending or in progress, 0 otherwise.
+ */
+/*****************************************************************************/
+uint8_t
+flash_log_busy(void)
+{
+    return ( (flash_log_state != FLASH_LOG_IDLE) || flash_log_ready[0] ||
+             flash_log_ready[1] || (flash_log_erase_pending > 0) );
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of records dropped because both blocks
+ * were waiting to be programmed.
+ *
+ * @return Number of records dropped since the initialization.
+ */
+/*****************************************************************************/
+uint16_t
+flash_log_dropped(void)
+{
+    return flash_log_dropped_count;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize a reader at the oldest record of the log.
+ *
+ * @param reader Pointer to the reader.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+flash_log_reader_init(flash_log_reader* reader)
+{
+    reader->seq = flash_log_oldest;
+    reader->index = 0;
+    reader->count = 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read the next record of the log.
+ *
+ * The records are read from the oldest to the newest one programmed in the
+ * flash. The records buffered in RAM are not read until they are
+ * programmed. A block with a wrong CRC, written while the power failed, is
+ * skipped. If the records of the reader are erased, the reader continues
+ * at the oldest record. It waits for the SPI transfers of the record.
+ *
+ * @param reader Pointer to the reader.
+ * @param record Pointer to the buffer of FLASH_LOG_RECORD_SIZE bytes where
+ *        the record is stored.
+ *
+ * @return FLASH_LOG_OK if a record was read, FLASH_LOG_EMPTY if there are no
+ *         more records or FLASH_LOG_BUSY if the flash is busy, so
+ *         flash_log_poll must be called before trying again.
+ *
+ * \b Example:
+ * @code
+ *      flash_log_reader reader;
+ *      uint8_t sample[FLASH_LOG_RECORD_SIZE];
+ *
+ *      flash_log_reader_init(&reader);
+ *      while (flash_log_read(&reader, sample) == FLASH_LOG_OK)
+ *      {
+ *          // Summarize the sample
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+flash_log_status
+flash_log_read(flash_log_reader* reader, uint8_t* record)
+{
+    if (flash_log_state != FLASH_LOG_IDLE)
+    {
+        return FLASH_LOG_BUSY;
+    }
+
+    if (reader->seq < flash_log_oldest)
+    {
+        flash_log_reader_init(reader);
+    }
+
+    while (reader->seq < flash_log_head)
+    {
+        if (reader->count == 0)
+        {
+            reader->count = _flash_log_load(reader->seq);
+            reader->index = 0;
+        }
+
+        if (reader->index < reader->count)
+        {
+            _flash_log_read(BLOCK_ADDR(reader->seq) + FLASH_LOG_HEADER_SIZE +
+                            (uint16_t) reader->index * FLASH_LOG_RECORD_SIZE,
+                            record, FLASH_LOG_RECORD_SIZE);
+            reader->index++;
+
+            return FLASH_LOG_OK;
+        }
+
+        reader->seq++;
+        reader->count = 0;
+    }
+
+    return FLASH_LOG_EMPTY;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to submit a SPI transaction to the flash.
+ *
+ * @param transaction Pointer to the transaction.
+ * @param tx Bytes to be sent, NULL to send the fill byte.
+ * @param rx Buffer of the received bytes, NULL to discard them.
+ * @param size Number of bytes.
+ * @param flags Transaction flags.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_flash_log_submit(spi_transaction* transaction, const uint8_t* tx,
+                  uint8_t* rx, uint16_t size, uint8_t flags)
+{
+    transaction->device = &flash_log_device;
+    transaction->tx = tx;
+    transaction->rx = rx;
+    transaction->size = size;
+    transaction->flags = flags;
+    transaction->callback = NULL;
+    spi_submit(transaction);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to submit a command with an address to the flash.
+ *
+ * @param command Flash command.
+ * @param address Flash address of the command.
+ * @param flags SPI_KEEP_CS if data follows the command, 0 otherwise.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_flash_log_command(uint8_t command, uint32_t address, uint8_t flags)
+{
+    flash_log_command_tx[0] = command;
+    flash_log_command_tx[1] = (uint8_t) (address >> 16);
+    flash_log_command_tx[2] = (uint8_t) (address >> 8);
+    flash_log_command_tx[3] = (uint8_t) address;
+    _flash_log_submit(&flash_log_command, flash_log_command_tx, NULL, 4,
+                      flags);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to wait until a SPI transaction is completed.
+ *
+ * @param transaction Pointer to the transaction.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_flash_log_wait(spi_transaction* transaction)
+{
+    while (transaction->status == SPI_PENDING)
+    {
+
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read bytes from the flash.
+ *
+ * @param address Flash address of the first byte.
+ * @param data Buffer of the bytes read.
+ * @param size Number of bytes.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_flash_log_read(uint32_t address, uint8_t* data, uint16_t size)
+{
+    _flash_log_command(CMD_READ, address, SPI_KEEP_CS);
+    _flash_log_submit(&flash_log_data, NULL, data, size, 0);
+    _flash_log_wait(&flash_log_data);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to check if the header of a block is erased.
+ *
+ * @param seq Sequence number of the block.
+ *
+ * @return 1 if the header is erased, 0 otherwise.
+ */
+/*****************************************************************************/
+static uint8_t
+_flash_log_blank(uint32_t seq)
+{
+    uint8_t header[FLASH_LOG_HEADER_SIZE];
+    uint8_t i;
+
+    _flash_log_read(BLOCK_ADDR(seq), header, sizeof(header));
+    for (i = 0; i < sizeof(header); i++)
+    {
+        if (header[i] != 0xFF)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to update the CRC with bytes.
+ *
+ * @param crc CRC of the previous bytes.
+ * @param data Pointer to the bytes.
+ * @param size Number of bytes.
+ *
+ * @return Updated CRC.
+ */
+/*****************************************************************************/
+static uint16_t
+_flash_log_crc(uint16_t crc, const uint8_t* data, uint8_t size)
+{
+    uint8_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        crc = _crc_xmodem_update(crc, data[i]);
+    }
+
+    return crc;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to check a block of the flash.
+ *
+ * @param seq Sequence number of the block.
+ *
+ * @return Number of records of the block or 0 if the block is not valid.
+ */
+/*****************************************************************************/
+static uint8_t
+_flash_log_load(uint32_t seq)
+{
+    uint8_t header[FLASH_LOG_HEADER_SIZE];
+    uint8_t chunk[CHUNK_SIZE];
+    uint32_t address = BLOCK_ADDR(seq);
+    uint16_t crc;
+    uint16_t remaining;
+    uint8_t size;
+    uint8_t count;
+
+    _flash_log_read(address, header, sizeof(header));
+    count = header[OFFSET_COUNT];
+
+    if ( ((header[0] | ((uint32_t) header[1] << 8) |
+           ((uint32_t) header[2] << 16) | ((uint32_t) header[3] << 24)) !=
+          seq) ||
+         (header[OFFSET_RECORD_SIZE] != FLASH_LOG_RECORD_SIZE) ||
+         (count == 0) || (count > FLASH_LOG_BLOCK_RECORDS) )
+    {
+        return 0;
+    }
+
+    crc = _flash_log_crc(CRC_INIT, header, OFFSET_CRC);
+    address += FLASH_LOG_HEADER_SIZE;
+    remaining = (uint16_t) count * FLASH_LOG_RECORD_SIZE;
+    while (remaining > 0)
+    {
+        size = (remaining > CHUNK_SIZE) ? CHUNK_SIZE : remaining;
+        _flash_log_read(address, chunk, size);
+        crc = _flash_log_crc(crc, chunk, size);
+        address += size;
+        remaining -= size;
+    }
+
+    if ( (header[OFFSET_CRC] != (uint8_t) crc) ||
+         (header[OFFSET_CRC + 1] != (uint8_t) (crc >> 8)) )
+    {
+        return 0;
+    }
+
+    return count;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to close the block being filled.
+ *
+ * The header is completed and the block waits to be programmed.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_flash_log_close(void)
+{
+    uint8_t* block = flash_log_buffer[flash_log_fill];
+    uint16_t crc;
+
+    if (flash_log_records == 0)
+    {
+        return;
+    }
+
+    block[OFFSET_SEQ] = (uint8_t) flash_log_seq;
+    block[OFFSET_SEQ + 1] = (uint8_t) (flash_log_seq >> 8);
+    block[OFFSET_SEQ + 2] = (uint8_t) (flash_log_seq >> 16);
+    block[OFFSET_SEQ + 3] = (uint8_t) (flash_log_seq >> 24);
+    block[OFFSET_COUNT] = flash_log_records;
+    block[OFFSET_RECORD_SIZE] = FLASH_LOG_RECORD_SIZE;
+
+    crc = _flash_log_crc(CRC_INIT, block, OFFSET_CRC);
+    crc = _flash_log_crc(crc, &block[FLASH_LOG_HEADER_SIZE],
+                         flash_log_records * FLASH_LOG_RECORD_SIZE);
+    block[OFFSET_CRC] = (uint8_t) crc;
+    block[OFFSET_CRC + 1] = (uint8_t) (crc >> 8);
+
+    flash_log_seq++;
+    flash_log_records = 0;
+    flash_log_ready[flash_log_fill] = 1;
+    flash_log_fill ^= 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to recover the write position and the oldest block.
+ *
+ * The first header of every sector gives the newest and the oldest sectors.
+ * The blocks of a sector are written in order, so the first erased block of
+ * the newest sector is found with a binary search. A block partially written
+ * counts as written, so it is never programmed again before an erase.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_flash_log_recover(void)
+{
+    uint8_t header[FLASH_LOG_HEADER_SIZE];
+    uint32_t first;
+    uint32_t seq;
+    uint32_t newest = SEQ_ERASED;
+    uint32_t oldest = SEQ_ERASED;
+    uint16_t sector;
+    uint16_t low;
+    uint16_t high;
+    uint16_t middle;
+
+    for (sector = 0; sector < FLASH_LOG_SECTORS; sector++)
+    {
+        first = (uint32_t) sector * SECTOR_BLOCKS;
+        _flash_log_read(BLOCK_ADDR(first), header, sizeof(header));
+        seq = header[0] | ((uint32_t) header[1] << 8) |
+              ((uint32_t) header[2] << 16) | ((uint32_t) header[3] << 24);
+
+        if ( (seq == SEQ_ERASED) || ((seq % LOG_BLOCKS) != first) ||
+             (header[OFFSET_RECORD_SIZE] != FLASH_LOG_RECORD_SIZE) )
+        {
+            continue;
+        }
+
+        if ( (newest == SEQ_ERASED) || (seq > newest) )
+        {
+            newest = seq;
+        }
+        if ( (oldest == SEQ_ERASED) || (seq < oldest) )
+        {
+            oldest = seq;
+        }
+    }
+
+    if (newest == SEQ_ERASED)
+    {
+        flash_log_head = 0;
+        flash_log_oldest = 0;
+        return;
+    }
+
+    // The first block of the newest sector is written
+    low = 1;
+    high = SECTOR_BLOCKS;
+    while (low < high)
+    {
+        middle = low + (high - low) / 2;
+        if (_flash_log_blank(newest + middle))
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+
+    flash_log_head = newest + low;
+    flash_log_oldest = oldest;
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
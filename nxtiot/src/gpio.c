@@ -53,6 +53,7 @@
 * Includes
 ******************************************************************************/
 #include "gpio.h"
+#include "trace.h"
 
 /******************************************************************************
 * Module Preprocessor Constants
@@ -74,7 +75,10 @@
 * Module Preprocessor Macros
 ******************************************************************************/
 /*! Macro used to dereference an IO memory address */
-#define MMIO(addr)      (*(volatile uint8_t *)(addr))
+#define MMIO(addr)      _MMIO_BYTE(addr)
+/*! Macro used to pack a pin and a value as the argument of a trace event */
+#define TRACE_PIN(port, pin, value) \
+    ((uint16_t) ((uint8_t) (uintptr_t) (port) << 8) | ((pin) << 4) | (value))
 
 /******************************************************************************
 * Module Typedefs
@@ -119,6 +123,8 @@
 /*****************************************************************************/
 void gpio_init_pin(uint8_t* port, uint8_t pin, gpio_pin_mode mode)
 {
+    TRACE(TRACE_GPIO_INIT, TRACE_PIN(port, pin, mode));
+
     if (mode == GPIO_PIN_INPUT)
     {
         MMIO(port - OFFSET_DDR) &= ~_BV(pin);
@@ -157,6 +163,8 @@ void gpio_init_pin(uint8_t* port, uint8_t pin, gpio_pin_mode mode)
 /*****************************************************************************/
 void gpio_write_pin(uint8_t* port, uint8_t pin, gpio_pin_state state)
 {
+    TRACE(TRACE_GPIO_WRITE, TRACE_PIN(port, pin, state));
+
     if (state == GPIO_PIN_LOW)
     {
         MMIO(port - OFFSET_PORT) &= ~_BV(pin);
@@ -190,6 +198,8 @@ void gpio_write_pin(uint8_t* port, uint8_t pin, gpio_pin_state state)
 /*****************************************************************************/
 void gpio_toggle_pin(uint8_t* port, uint8_t pin)
 {
+    TRACE(TRACE_GPIO_TOGGLE, TRACE_PIN(port, pin, 0));
+
     MMIO(port - OFFSET_PORT) ^= _BV(pin);
 }
 
@@ -0,0 +1,458 @@
+/******************************************************************************
+* Title                 :   ISR profile source file
+* Filename              :   isr_profile.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        isr_profile.c
+ *  @brief       ISR profile implementation
+ *
+ *  To use the ISR profile, include this header file as follows:
+ *  @code
+ *      #include "isr_profile.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The ISR profile measures how long the interrupts of the drivers run and
+ *  how long the drivers keep the interrupts disabled, against Timer1 running
+ *  free. For every slot, an interrupt or a critical section, it keeps:
+ *   * the duration: from the entry to the exit, without the time of the
+ *     measure itself, calibrated by isr_profile_init.
+ *   * the period: between two entries, the jitter of a periodic interrupt
+ *     is the difference between the maximum and the minimum. The periods
+ *     longer than a Timer1 overflow are not counted.
+ *
+ *  The latency of an interrupt is at most the longest time the interrupts
+ *  are disabled, by another interrupt or by a critical section, plus the
+ *  response of the CPU and the prologue of the handler (about 20 cycles).
+ *  isr_profile_worst_off gives that time.
+ *
+ *  The minimum, the maximum and the sum are aggregated on every measure in
+ *  a few cycles with the interrupts disabled, so nothing is stored per
+ *  event. When the counter is full the counter and the sum are halved, so
+ *  the average is kept.
+ *
+ *  ## Usage ##
+ *
+ *  The drivers and the application are built with -DISR_PROFILE_ENABLE=1,
+ *  Timer1 is then used by the profile.
+ *
+ *  @code
+ *      #include "isr_profile.h"
+ *
+ *      uart_init();
+ *      isr_profile_init();
+ *      sei();
+ *
+ *      ISR_PROFILE_ENTER(ISR_PROFILE_USER);
+ *      adc_start();
+ *      ISR_PROFILE_EXIT(ISR_PROFILE_USER);
+ *      ...
+ *      isr_profile_report();
+ *  @endcode
+ *
+ *  The report is a line per slot used, in Timer1 counts:
+ *  @code
+ *      ISR n dur min/avg/max per min/avg/max
+ *      tick 1000 41/41/42 15998/16000/16003
+ *      cs_tick 2000 12/12/12 110/7990/15870
+ *      off 42
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "isr_profile.h"
+#include "uart.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Clock select bits of Timer1 */
+#if ISR_PROFILE_PRESCALER == 1
+    #define ISR_PROFILE_CLOCK   _BV(CS10)
+#elif ISR_PROFILE_PRESCALER == 8
+    #define ISR_PROFILE_CLOCK   _BV(CS11)
+#elif ISR_PROFILE_PRESCALER == 64
+    #define ISR_PROFILE_CLOCK   (_BV(CS11) | _BV(CS10))
+#else
+    #error "ISR_PROFILE_PRESCALER must be 1, 8 or 64"
+#endif
+
+/*! Counter value below which an overflow flag belongs to the counter read */
+#define HALF_RANGE          0x8000U
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  Measures of a slot
+  */
+typedef struct
+{
+    isr_profile_stat duration;  /*! Time from the entry to the exit */
+    isr_profile_stat period;    /*! Time between two entries */
+    uint16_t entry;             /*! Timer1 at the last entry */
+    uint8_t epoch;              /*! Timer1 overflows at the last entry */
+    uint8_t entered;            /*! Set after the first entry */
+} isr_profile_data;
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Measures of every slot */
+static isr_profile_data isr_profile_slots[ISR_PROFILE_SLOTS];
+/*! Timer1 overflows seen, modulo 256 */
+static uint8_t isr_profile_epoch;
+/*! Timer1 counts of an empty measure */
+static uint16_t isr_profile_overhead;
+/*! Names of the slots in the report */
+static const char* const isr_profile_names[ISR_PROFILE_USER] =
+{
+    "tick", "uart_rx", "sw_tx", "sw_start", "sw_rx", "spi", "twi", "eeprom",
+    "pwm", "cs_tick", "cs_sw_uart", "cs_spi", "cs_twi"
+};
+
+#ifdef __AVR__
+// The slots and the pointers of the names, unpadded on the AVR
+_Static_assert(sizeof(isr_profile_slots) + sizeof(isr_profile_names) ==
+               ISR_PROFILE_RAM_SIZE,
+               "ISR_PROFILE_RAM_SIZE does not match the buffers");
+#endif
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static void _isr_profile_print(const char* separator, uint32_t value);
+static void _isr_profile_print_stat(const isr_profile_stat* stat);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup isr_profile
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to start Timer1 running free, to calibrate the measures
+ * and to clear them.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+isr_profile_init(void)
+{
+    isr_profile_stat stat;
+    uint8_t sreg = SREG;
+
+    TCCR1A = 0;
+    TCCR1B = ISR_PROFILE_CLOCK;
+    TIMSK1 = 0;
+
+    // An empty measure gives the time of the measure itself
+    cli();
+    isr_profile_overhead = 0;
+    isr_profile_enter(0);
+    isr_profile_exit(0);
+    isr_profile_get(0, &stat, NULL);
+    isr_profile_overhead = stat.min;
+    SREG = sreg;
+
+    isr_profile_clear();
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to clear the measures of every slot.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+isr_profile_clear(void)
+{
+    uint8_t sreg = SREG;
+
+    cli();
+    memset(isr_profile_slots, 0, sizeof(isr_profile_slots));
+    SREG = sreg;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to record the entry in a slot.
+ *
+ * It must be called with the interrupts disabled, the drivers use the
+ * ISR_PROFILED and ISR_PROFILE_ENTER macros instead.
+ *
+ * @param slot Slot, one of isr_profile_slot.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+isr_profile_enter(uint8_t slot)
+{
+    isr_profile_data* data = &isr_profile_slots[slot];
+    uint16_t now = TCNT1;
+    uint8_t epochs;
+
+    // An overflow flagged with a high count happened after the read, it is
+    // left to the next entry
+    if ( (TIFR1 & _BV(TOV1)) && (now < HALF_RANGE) )
+    {
+        TIFR1 = _BV(TOV1);
+        isr_profile_epoch++;
+    }
+
+    epochs = isr_profile_epoch - data->epoch;
+    if ( data->entered &&
+         ((epochs == 0) || ((epochs == 1) && (now < data->entry))) )
+    {
+        isr_profile_stat_add(&data->period, now - data->entry);
+    }
+
+    data->entry = now;
+    data->epoch = isr_profile_epoch;
+    data->entered = 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to record the exit of a slot.
+ *
+ * It must be called with the interrupts disabled, the drivers use the
+ * ISR_PROFILED and ISR_PROFILE_EXIT macros instead.
+ *
+ * @param slot Slot, one of isr_profile_slot.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+isr_profile_exit(uint8_t slot)
+{
+    isr_profile_data* data = &isr_profile_slots[slot];
+    uint16_t duration = TCNT1 - data->entry;
+
+    duration = (duration > isr_profile_overhead) ?
+               duration - isr_profile_overhead : 0;
+    isr_profile_stat_add(&data->duration, duration);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to add a measure to the minimum, maximum and sum.
+ *
+ * @param stat Pointer to the aggregated measures.
+ * @param value Measure.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+isr_profile_stat_add(isr_profile_stat* stat, uint16_t value)
+{
+    if (stat->count == UINT16_MAX)
+    {
+        stat->count >>= 1;
+        stat->sum >>= 1;
+    }
+
+    if ( (stat->count == 0) || (value < stat->min) )
+    {
+        stat->min = value;
+    }
+    if ( (stat->count == 0) || (value > stat->max) )
+    {
+        stat->max = value;
+    }
+    stat->count++;
+    stat->sum += value;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the average of the measures.
+ *
+ * @param stat Pointer to the aggregated measures.
+ *
+ * @return Average, rounded, 0 without measures.
+ */
+/*****************************************************************************/
+uint16_t
+isr_profile_stat_average(const isr_profile_stat* stat)
+{
+    if (stat->count == 0)
+    {
+        return 0;
+    }
+
+    return (uint16_t) ((stat->sum + stat->count / 2) / stat->count);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read the measures of a slot.
+ *
+ * @param slot Slot, one of isr_profile_slot.
+ * @param duration Pointer where the durations are written, or NULL.
+ * @param period Pointer where the periods are written, or NULL.
+ *
+ * @return 1 if the slot was entered, 0 otherwise.
+ */
+/*****************************************************************************/
+uint8_t
+isr_profile_get(uint8_t slot, isr_profile_stat* duration,
+                isr_profile_stat* period)
+{
+    uint8_t entered;
+    uint8_t sreg = SREG;
+
+    cli();
+    if (duration != NULL)
+    {
+        *duration = isr_profile_slots[slot].duration;
+    }
+    if (period != NULL)
+    {
+        *period = isr_profile_slots[slot].period;
+    }
+    entered = isr_profile_slots[slot].entered;
+    SREG = sreg;
+
+    return entered;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the longest time the interrupts were disabled by the
+ * slots, the bound of the latency of the interrupts without the response
+ * of the CPU.
+ *
+ * @return Longest duration of every slot in Timer1 counts.
+ */
+/*****************************************************************************/
+uint16_t
+isr_profile_worst_off(void)
+{
+    isr_profile_stat duration;
+    uint16_t worst = 0;
+    uint8_t slot;
+
+    for (slot = 0; slot < ISR_PROFILE_SLOTS; slot++)
+    {
+        isr_profile_get(slot, &duration, NULL);
+        if ( (duration.count > 0) && (duration.max > worst) )
+        {
+            worst = duration.max;
+        }
+    }
+
+    return worst;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send the measures through the UART as a table, a line
+ * per slot entered and the longest time the interrupts were disabled.
+ *
+ * @pre The UART must be initialized using the uart_init function.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+isr_profile_report(void)
+{
+    isr_profile_stat duration;
+    isr_profile_stat period;
+    uint8_t slot;
+
+    uart_send("ISR n dur min/avg/max per min/avg/max\n");
+
+    for (slot = 0; slot < ISR_PROFILE_SLOTS; slot++)
+    {
+        if (!isr_profile_get(slot, &duration, &period))
+        {
+            continue;
+        }
+
+        if (slot < ISR_PROFILE_USER)
+        {
+            uart_send(isr_profile_names[slot]);
+        }
+        else
+        {
+            _isr_profile_print("user", slot - ISR_PROFILE_USER);
+        }
+        _isr_profile_print(" ", duration.count);
+        _isr_profile_print_stat(&duration);
+        _isr_profile_print_stat(&period);
+        uart_send("\n");
+    }
+
+    _isr_profile_print("off ", isr_profile_worst_off());
+    uart_send("\n");
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send a value in decimal through the UART.
+ *
+ * @param separator String sent before the value.
+ * @param value Value to be sent.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_isr_profile_print(const char* separator, uint32_t value)
+{
+    char str[11];
+    uint8_t i = sizeof(str) - 1;
+
+    str[i] = 0x00;
+    do
+    {
+        str[--i] = '0' + (value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    uart_send(separator);
+    uart_send(&str[i]);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send the minimum, average and maximum through the UART.
+ *
+ * @param stat Pointer to the aggregated measures.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_isr_profile_print_stat(const isr_profile_stat* stat)
+{
+    _isr_profile_print(" ", stat->min);
+    _isr_profile_print("/", isr_profile_stat_average(stat));
+    _isr_profile_print("/", stat->max);
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
@@ -0,0 +1,141 @@
+/******************************************************************************
+* Title                 :   Lookup table source file
+* Filename              :   lut.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        lut.c
+ *  @brief       Lookup table implementation
+ *
+ *  To use the lookup tables, include this header file as follows:
+ *  @code
+ *      #include "lut.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The lookup tables convert the raw counts of non-linear sensors, as the
+ *  thermistors on the analog pins, without the log and pow calls of the
+ *  soft float library. A table holds the outputs of the sensor curve at
+ *  equally spaced inputs, 2^shift counts apart, in fixed point (ex. 1/100
+ *  of degree), and lut_eval interpolates linearly between the two points
+ *  around the input: a shift, a mask and one 16 x 8 bits multiplication.
+ *
+ *  The tables are generated on the host by tools/lut_gen from the
+ *  parameters of the sensor curve, as a header kept in flash (PROGMEM). The
+ *  generator prints the largest interpolation error over the inputs of the
+ *  table, which is lowered by a smaller shift at the cost of flash. The
+ *  size target of the tests reports the flash of a conversion with a table
+ *  and with the float math, as ntc_lut_program and ntc_float_program.
+ *
+ *  ## Usage ##
+ *
+ *  The following code example generates the table of a 10 kOhm NTC with a
+ *  beta of 3950 below a 10 kOhm resistor, read with the 10 bits ADC, and
+ *  converts a count to 1/100 of degree.
+ *
+ *  @code
+ *      lut_gen -n ntc_10k -m beta -B 3950 -l 96 -u 928 -s 4 > ntc_10k.h
+ *  @endcode
+ *
+ *  @code
+ *      #include "lut.h"
+ *      #include "ntc_10k.h"
+ *
+ *      int16_t centi_celsius = lut_eval(&ntc_10k, adc_count);
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "lut.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup lut
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to get the output of a table, interpolated between the two
+ * points around the input. The inputs out of the table give the output of
+ * the nearest end.
+ *
+ * @param table Pointer to the table, in flash (PROGMEM).
+ * @param x Input.
+ *
+ * @return Output, rounded to the nearest.
+ *
+ * \b Example:
+ * @code
+ *      int16_t centi_celsius = lut_eval(&ntc_10k, adc_count);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+int16_t
+lut_eval(const lut_table* table, uint16_t x)
+{
+    lut_table lut;
+    uint16_t index;
+    uint8_t frac;
+    int16_t y0;
+    int16_t y1;
+
+    memcpy_P(&lut, table, sizeof(lut));
+
+    if (x <= lut.x0)
+    {
+        return (int16_t) pgm_read_word(&lut.y[0]);
+    }
+
+    x -= lut.x0;
+    index = x >> lut.shift;
+    if (index >= (lut.points - 1))
+    {
+        return (int16_t) pgm_read_word(&lut.y[lut.points - 1]);
+    }
+
+    frac = (uint8_t) (x & ((1U << lut.shift) - 1));
+    y0 = (int16_t) pgm_read_word(&lut.y[index]);
+    y1 = (int16_t) pgm_read_word(&lut.y[index + 1]);
+
+    return y0 + (int16_t) ((((int32_t) (y1 - y0) * frac) +
+                            ((1L << lut.shift) >> 1)) >> lut.shift);
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
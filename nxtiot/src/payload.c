@@ -0,0 +1,192 @@
+/******************************************************************************
+* Title                 :   Payload source file
+* Filename              :   payload.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        payload.c
+ *  @brief       Payload implementation
+ *
+ *  To use the payloads, include this header file as follows:
+ *  @code
+ *      #include "payload.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The payload functions write and read bit fields of the uplink and
+ *  downlink payloads, most significant bit first, as the Sigfox backend
+ *  shows them. The layout of the payloads sent by the drivers is defined
+ *  by the field lists of payload.h, which are expanded by the encoders of
+ *  the firmware and by the host decoder, so both always agree.
+ *
+ *  ## Usage ##
+ *
+ *  The following code example packs a summary with its field list.
+ *
+ *  @code
+ *      #include "payload.h"
+ *
+ *      #define PACK_FIELD(name, first, bits, is_signed) \
+ *          payload_put(data, first, bits, (uint32_t) summary.name);
+ *
+ *      uint8_t data[PAYLOAD_SUMMARY_SIZE];
+ *
+ *      PAYLOAD_SUMMARY_FIELDS(PACK_FIELD)
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "payload.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! Fail the build when a field ends past the size of its payload */
+#define _PAYLOAD_CHECK_SUMMARY(name, first, bits, is_signed)                \
+    _Static_assert((first) + (bits) <= _PAYLOAD_SUMMARY_BITS,               \
+                   "summary field " #name " past the payload size");
+#define _PAYLOAD_CHECK_UPLINK_STATS(name, first, bits, is_signed)           \
+    _Static_assert((first) + (bits) <= _PAYLOAD_UPLINK_STATS_BITS,          \
+                   "uplink stats field " #name " past the payload size");
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+ * Bits of the payloads, as constants since a field list is not expanded
+ * again inside its own fields
+ */
+enum
+{
+    _PAYLOAD_SUMMARY_BITS = PAYLOAD_SUMMARY_SIZE * 8,
+    _PAYLOAD_UPLINK_STATS_BITS = PAYLOAD_UPLINK_STATS_SIZE * 8
+};
+
+PAYLOAD_SUMMARY_FIELDS(_PAYLOAD_CHECK_SUMMARY)
+PAYLOAD_UPLINK_STATS_FIELDS(_PAYLOAD_CHECK_UPLINK_STATS)
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup payload
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to write a field of a payload, the other bits of the bytes
+ * are kept.
+ *
+ * @param data Pointer to the payload.
+ * @param first First bit of the field, from the most significant bit of
+ *              the first byte.
+ * @param bits Number of bits of the field, 1 to 32.
+ * @param value Value, only its low bits are written.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      payload_put(data, 16, 16, (uint32_t) mean);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+payload_put(uint8_t* data, uint8_t first, uint8_t bits, uint32_t value)
+{
+    uint8_t* byte = &data[first >> 3];
+    uint8_t room = 8 - (first & 0x07);
+    uint8_t take;
+    uint8_t mask;
+
+    while (bits > 0)
+    {
+        take = (bits < room) ? bits : room;
+        mask = (uint8_t) (((1U << take) - 1) << (room - take));
+
+        *byte = (uint8_t) ((*byte & ~mask) |
+                           (((uint8_t) (value >> (bits - take)) <<
+                             (room - take)) & mask));
+
+        bits -= take;
+        byte++;
+        room = 8;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read a field of a payload.
+ *
+ * @param data Pointer to the payload.
+ * @param first First bit of the field, from the most significant bit of
+ *              the first byte.
+ * @param bits Number of bits of the field, 1 to 32.
+ * @param is_signed 1 to extend the sign of a two's complement field.
+ *
+ * @return Value of the field.
+ *
+ * \b Example:
+ * @code
+ *      int16_t mean = (int16_t) payload_get(data, 16, 16, 1);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+int32_t
+payload_get(const uint8_t* data, uint8_t first, uint8_t bits,
+            uint8_t is_signed)
+{
+    const uint8_t* byte = &data[first >> 3];
+    uint8_t room = 8 - (first & 0x07);
+    uint8_t left = bits;
+    uint8_t take;
+    uint32_t value = 0;
+
+    while (left > 0)
+    {
+        take = (left < room) ? left : room;
+        value = (value << take) |
+                ((*byte >> (room - take)) & ((1U << take) - 1));
+
+        left -= take;
+        byte++;
+        room = 8;
+    }
+
+    if ( is_signed && (bits < 32) && (value & (1UL << (bits - 1))) )
+    {
+        value |= ~((1UL << bits) - 1);
+    }
+
+    return (int32_t) value;
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
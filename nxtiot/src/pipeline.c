@@ -0,0 +1,497 @@
+/******************************************************************************
+* Title                 :   Pipeline source file
+* Filename              :   pipeline.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        pipeline.c
+ *  @brief       Pipeline implementation
+ *
+ *  To use the pipeline, include this header file as follows:
+ *  @code
+ *      #include "pipeline.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  A pipeline is a table of stages linked by queues of fixed size items,
+ *  all of them defined statically: the table is kept in flash and the
+ *  queues and the state of the stages in RAM. pipeline_poll calls every
+ *  stage once, from the last one to the first one, so the items move at
+ *  most one stage per poll and the queues are emptied before being filled.
+ *  A stage never waits: it is given the oldest item of its input and a free
+ *  item of its output, and it tells which of them it used.
+ *
+ *  A stage whose output is full does not take its input, so a stage that
+ *  stops taking items fills the queues before it, up to the source, which
+ *  counts the samples lost. The uplink stage stops taking payloads while the
+ *  Sigfox driver holds a message, retrying it or waiting for the next day
+ *  when the daily budget is spent (see sigfox_wisol_uplink_poll).
+ *
+ *  The stages of the framework are:
+ *  - pipeline_source_step: reads an int16_t sample every period.
+ *  - pipeline_ema_step: exponential moving average of the samples.
+ *  - pipeline_aggregate_step: minimum, mean and maximum of a window.
+ *  - pipeline_pack_step: packs an item in a payload with a function.
+ *  - pipeline_uplink_step: sends the payloads with sigfox_wisol_uplink.
+ *
+ *  Any function with the pipeline_step signature can be a stage.
+ *
+ *  ## Usage ##
+ *
+ *  The following code example sends the minimum, mean and maximum of a
+ *  filtered sensor read every minute, once per hour.
+ *
+ *  @code
+ *      #include "pipeline.h"
+ *
+ *      static pipeline_source sensor = PIPELINE_SOURCE(read_sensor, 60000UL);
+ *      static pipeline_ema filter = PIPELINE_EMA(2);
+ *      static pipeline_aggregate hour = PIPELINE_AGGREGATE(60);
+ *      static pipeline_pack pack = {pipeline_pack_summary};
+ *
+ *      PIPELINE_QUEUE(samples, int16_t, 2);
+ *      PIPELINE_QUEUE(filtered, int16_t, 2);
+ *      PIPELINE_QUEUE(summaries, pipeline_summary, 1);
+ *      PIPELINE_QUEUE(frames, pipeline_frame, 1);
+ *
+ *      static const pipeline_stage stages[] PROGMEM =
+ *      {
+ *          {pipeline_source_step,      &sensor,    NULL,       &samples},
+ *          {pipeline_ema_step,         &filter,    &samples,   &filtered},
+ *          {pipeline_aggregate_step,   &hour,      &filtered,  &summaries},
+ *          {pipeline_pack_step,        &pack,      &summaries, &frames},
+ *          {pipeline_uplink_step,      NULL,       &frames,    NULL}
+ *      };
+ *
+ *      tick_init();
+ *      sigfox_wisol_init();
+ *      sei();
+ *
+ *      while (1)
+ *      {
+ *          pipeline_poll(stages, sizeof(stages) / sizeof(stages[0]),
+ *                        tick_get_ms());
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stddef.h>
+#include "pipeline.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! Writes a field of a summary in a payload, see PAYLOAD_SUMMARY_FIELDS */
+#define _PIPELINE_PACK_FIELD(name, first, bits, is_signed)                  \
+    payload_put(data, first, bits, (uint32_t) summary->name);
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static void* _pipeline_peek(pipeline_queue* queue);
+static void* _pipeline_slot(pipeline_queue* queue);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup pipeline
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to run every stage of a pipeline once, without waiting
+ * other than the blocking calls of the stages (the attempts of the uplink).
+ *
+ * @param stages Pointer to the table of stages, in flash (PROGMEM).
+ * @param count Number of stages.
+ * @param now Current time in milliseconds.
+ *
+ * @return Number of items moved, 0 when the pipeline is idle.
+ *
+ * \b Example:
+ * @code
+ *      while (1)
+ *      {
+ *          pipeline_poll(stages, STAGES, tick_get_ms());
+ *          console_poll();
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+uint8_t
+pipeline_poll(const pipeline_stage* stages, uint8_t count, uint32_t now)
+{
+    pipeline_step step;
+    pipeline_queue* in;
+    pipeline_queue* out;
+    uint8_t moved = 0;
+    uint8_t result;
+
+    while (count-- > 0)
+    {
+        step = (pipeline_step) pgm_read_ptr(&stages[count].step);
+        in = (pipeline_queue *) pgm_read_ptr(&stages[count].in);
+        out = (pipeline_queue *) pgm_read_ptr(&stages[count].out);
+
+        result = step(pgm_read_ptr(&stages[count].ctx), now,
+                      _pipeline_peek(in), _pipeline_slot(out));
+
+        if ( (result & PIPELINE_TAKEN) && (in != NULL) && (in->count > 0) )
+        {
+            in->head = (in->head + 1 == in->items) ? 0 : in->head + 1;
+            in->count--;
+            moved++;
+        }
+        if ( (result & PIPELINE_GIVEN) && (out != NULL) &&
+             (out->count < out->items) )
+        {
+            out->count++;
+            moved++;
+        }
+    }
+
+    return moved;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of items in a queue.
+ *
+ * @param queue Pointer to the queue.
+ *
+ * @return Number of items.
+ */
+/*****************************************************************************/
+uint8_t
+pipeline_queue_count(const pipeline_queue* queue)
+{
+    return queue->count;
+}
+
+/*****************************************************************************/
+/*!
+ * Stage reading an int16_t sample every period. The first sample is read
+ * on the first poll, the periods missed are skipped and a sample due with
+ * the output full is lost and counted in overruns.
+ *
+ * @param ctx Pointer to the pipeline_source.
+ * @param now Current time in milliseconds.
+ * @param in Not used.
+ * @param out Free int16_t of the output, or NULL.
+ *
+ * @return PIPELINE_GIVEN when a sample is read.
+ */
+/*****************************************************************************/
+uint8_t
+pipeline_source_step(void* ctx, uint32_t now, const void* in, void* out)
+{
+    pipeline_source* source = (pipeline_source *) ctx;
+
+    (void) in;
+
+    if (!source->started)
+    {
+        source->next = now;
+        source->started = 1;
+    }
+    if ((int32_t) (now - source->next) < 0)
+    {
+        return 0;
+    }
+
+    source->next += source->period;
+    if ((int32_t) (now - source->next) >= 0)
+    {
+        source->next = now + source->period;
+    }
+
+    if (out == NULL)
+    {
+        source->overruns++;
+        return 0;
+    }
+
+    *(int16_t *) out = source->read();
+
+    return PIPELINE_GIVEN;
+}
+
+/*****************************************************************************/
+/*!
+ * Stage filtering int16_t samples with an exponential moving average, the
+ * first sample starts the average.
+ *
+ * @param ctx Pointer to the pipeline_ema.
+ * @param now Not used.
+ * @param in Sample of the input, or NULL.
+ * @param out Free int16_t of the output, or NULL.
+ *
+ * @return PIPELINE_TAKEN | PIPELINE_GIVEN when a sample is filtered.
+ */
+/*****************************************************************************/
+uint8_t
+pipeline_ema_step(void* ctx, uint32_t now, const void* in, void* out)
+{
+    pipeline_ema* ema = (pipeline_ema *) ctx;
+    int32_t sample;
+
+    (void) now;
+
+    if ( (in == NULL) || (out == NULL) )
+    {
+        return 0;
+    }
+
+    sample = *(const int16_t *) in;
+    if (!ema->primed)
+    {
+        ema->acc = sample * ((int32_t) 1 << ema->shift);
+        ema->primed = 1;
+    }
+    else
+    {
+        ema->acc += sample - (ema->acc >> ema->shift);
+    }
+
+    *(int16_t *) out = (int16_t) (ema->acc >> ema->shift);
+
+    return PIPELINE_TAKEN | PIPELINE_GIVEN;
+}
+
+/*****************************************************************************/
+/*!
+ * Stage summarizing every window of int16_t samples. The last sample of a
+ * window is only taken when the summary fits in the output.
+ *
+ * @param ctx Pointer to the pipeline_aggregate.
+ * @param now Not used.
+ * @param in Sample of the input, or NULL.
+ * @param out Free pipeline_summary of the output, or NULL.
+ *
+ * @return PIPELINE_TAKEN when a sample is added, with PIPELINE_GIVEN when
+ *         it completes the window.
+ */
+/*****************************************************************************/
+uint8_t
+pipeline_aggregate_step(void* ctx, uint32_t now, const void* in, void* out)
+{
+    pipeline_aggregate* aggregate = (pipeline_aggregate *) ctx;
+    pipeline_summary* summary = (pipeline_summary *) out;
+    int16_t sample;
+
+    (void) now;
+
+    if ( (in == NULL) ||
+         ((aggregate->count + 1 >= aggregate->window) && (out == NULL)) )
+    {
+        return 0;
+    }
+
+    sample = *(const int16_t *) in;
+    if ( (aggregate->count == 0) || (sample < aggregate->min) )
+    {
+        aggregate->min = sample;
+    }
+    if ( (aggregate->count == 0) || (sample > aggregate->max) )
+    {
+        aggregate->max = sample;
+    }
+    aggregate->sum = (aggregate->count == 0) ? sample :
+                     aggregate->sum + sample;
+    aggregate->count++;
+
+    if (aggregate->count < aggregate->window)
+    {
+        return PIPELINE_TAKEN;
+    }
+
+    summary->min = aggregate->min;
+    summary->max = aggregate->max;
+    summary->mean = (int16_t) (aggregate->sum / aggregate->count);
+    summary->count = aggregate->count;
+    aggregate->count = 0;
+
+    return PIPELINE_TAKEN | PIPELINE_GIVEN;
+}
+
+/*****************************************************************************/
+/*!
+ * Stage packing the items of the input in payloads, with the function of
+ * the pipeline_pack. An item that can not be packed is dropped.
+ *
+ * @param ctx Pointer to the pipeline_pack.
+ * @param now Not used.
+ * @param in Item of the input, or NULL.
+ * @param out Free pipeline_frame of the output, or NULL.
+ *
+ * @return PIPELINE_TAKEN | PIPELINE_GIVEN when an item is packed.
+ */
+/*****************************************************************************/
+uint8_t
+pipeline_pack_step(void* ctx, uint32_t now, const void* in, void* out)
+{
+    pipeline_pack* pack = (pipeline_pack *) ctx;
+    pipeline_frame* frame = (pipeline_frame *) out;
+
+    (void) now;
+
+    if ( (in == NULL) || (out == NULL) )
+    {
+        return 0;
+    }
+
+    frame->size = pack->pack(in, frame->data, sizeof(frame->data));
+
+    return (frame->size > 0) ? (PIPELINE_TAKEN | PIPELINE_GIVEN) :
+                               PIPELINE_TAKEN;
+}
+
+/*****************************************************************************/
+/*!
+ * Stage sending the payloads of the input as Sigfox uplink messages. The
+ * pending message is attempted when it is due, and a payload is only taken
+ * once the driver does not hold a message, which stops the pipeline while
+ * it is retried or the daily budget is spent.
+ *
+ * @param ctx Not used.
+ * @param now Current time in milliseconds.
+ * @param in pipeline_frame of the input, or NULL.
+ * @param out Not used.
+ *
+ * @return PIPELINE_TAKEN when a payload is given to the driver.
+ */
+/*****************************************************************************/
+uint8_t
+pipeline_uplink_step(void* ctx, uint32_t now, const void* in, void* out)
+{
+    const pipeline_frame* frame = (const pipeline_frame *) in;
+
+    (void) ctx;
+    (void) out;
+
+    if (sigfox_wisol_uplink_poll(now) == WISOL_UPLINK_PENDING)
+    {
+        return 0;
+    }
+    if (frame == NULL)
+    {
+        return 0;
+    }
+
+    // A payload rejected by the driver is dropped
+    sigfox_wisol_uplink(frame->data, frame->size);
+
+    return PIPELINE_TAKEN;
+}
+
+/*****************************************************************************/
+/*!
+ * Function packing a pipeline_summary as the minimum, mean and maximum in
+ * big endian, followed by the number of samples, as defined by
+ * PAYLOAD_SUMMARY_FIELDS.
+ *
+ * @param item Pointer to the pipeline_summary.
+ * @param data Pointer to the payload.
+ * @param size Size of the payload.
+ *
+ * @return PIPELINE_SUMMARY_SIZE, 0 if the payload is too small.
+ */
+/*****************************************************************************/
+uint8_t
+pipeline_pack_summary(const void* item, uint8_t* data, uint8_t size)
+{
+    const pipeline_summary* summary = (const pipeline_summary *) item;
+
+    if (size < PIPELINE_SUMMARY_SIZE)
+    {
+        return 0;
+    }
+
+    PAYLOAD_SUMMARY_FIELDS(_PIPELINE_PACK_FIELD)
+
+    return PIPELINE_SUMMARY_SIZE;
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
+
+/******************************************************************************
+* Private Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to get the oldest item of a queue.
+ *
+ * @param queue Pointer to the queue, or NULL.
+ *
+ * @return Pointer to the item, NULL if there is none.
+ */
+/*****************************************************************************/
+static void*
+_pipeline_peek(pipeline_queue* queue)
+{
+    if ( (queue == NULL) || (queue->count == 0) )
+    {
+        return NULL;
+    }
+
+    return &queue->buffer[(uint16_t) queue->head * queue->item_size];
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the free item after the last one of a queue.
+ *
+ * @param queue Pointer to the queue, or NULL.
+ *
+ * @return Pointer to the item, NULL if the queue is full.
+ */
+/*****************************************************************************/
+static void*
+_pipeline_slot(pipeline_queue* queue)
+{
+    uint8_t tail;
+
+    if ( (queue == NULL) || (queue->count >= queue->items) )
+    {
+        return NULL;
+    }
+
+    tail = queue->head + queue->count;
+    if (tail >= queue->items)
+    {
+        tail -= queue->items;
+    }
+
+    return &queue->buffer[(uint16_t) tail * queue->item_size];
+}
+
@@ -0,0 +1,957 @@
+/******************************************************************************
+* Title                 :   PWM driver source file
+* Filename              :   pwm.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        pwm.c
+ *  @brief       PWM driver implementation
+ *
+ *  To use the PWM driver, include this header file as follows:
+ *  @code
+ *      #include "pwm.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The PWM driver generates the waveforms of buzzers, LEDs and small
+ *  actuators with the timers in fast PWM mode, so the CPU is free and the
+ *  edges have no jitter. A channel is a header pin wired to a timer output:
+ *      - B1 (PB1/OC1A): Timer1 with TOP = ICR1, 2 to 65535 steps at any
+ *        frequency from 1 Hz.
+ *      - D3 (PD3/OC2B): Timer2 with TOP = OCR2A, 2 to 256 steps from 61 Hz.
+ *      - D5 (PD5/OC0B): Timer0 with TOP = OCR0A. The tick keeps the timer
+ *        and its period, so the frequency is the one of the tick (1 kHz)
+ *        with 250 steps, and the tick interrupt still runs every
+ *        millisecond.
+ *
+ *  The frequency selects the smallest prescaler reaching it, which gives
+ *  the most steps, and the steps requested are the minimum resolution
+ *  accepted. The duty cycle goes from 0 (output low) to PWM_DUTY_MAX
+ *  (output high) and is scaled to the steps of the timer.
+ *
+ *  The updates never cut a period. The new values are kept by the driver
+ *  and written by the overflow interrupt, at the timer TOP: first the
+ *  compare registers, double buffered by the timer until the next BOTTOM,
+ *  then at the next TOP the registers applied at once (ICR1, the prescaler
+ *  and the connection of the output). Both take effect in the same period,
+ *  one or two periods after the request. The overflow interrupt is enabled
+ *  only while an update, a tone or a fade is running.
+ *
+ *  The same interrupt runs the tone and fade engine: a tone of a given
+ *  length on B1 or D3, counted in periods, and a fade of the duty cycle in
+ *  PWM_FADE_RATE steps per second.
+ *
+ *  @note The channels share the timers with other drivers, pwm_init
+ *        returns PWM_BUSY when the timer is already running:
+ *          - Timer1 with the ISR profile (ISR_PROFILE_ENABLE).
+ *          - Timer2 with the software UART, whose default TX pin is D3.
+ *          - D5 requires the tick, tick_init must be called before.
+ *
+ *  ## Usage ##
+ *
+ *  The following code example drives a LED at 500 Hz, fades it in, and
+ *  beeps a buzzer for 100 ms.
+ *
+ *  @code
+ *      #include "pwm.h"
+ *
+ *      pwm_init(PWM_B1, 500, 1000);
+ *      pwm_init(PWM_D3, 2000, 0);
+ *      sei();
+ *
+ *      pwm_fade(PWM_B1, PWM_DUTY_MAX, 2000);
+ *      pwm_tone(PWM_D3, 4000, 100);
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <avr/pgmspace.h>
+#include "pwm.h"
+#include "isr_profile.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Clock select of the tick, a prescaler of 64 */
+#define PWM_TICK_CLOCK      (_BV(CS01) | _BV(CS00))
+/*! Prescaler of the tick */
+#define PWM_TICK_PRESCALER  64UL
+/*! Clock select bits of the timers */
+#define PWM_CLOCK_MASK      0x07
+/*! Maximum steps of Timer1, TOP = 65534 */
+#define PWM_STEPS_TIMER1    65535UL
+/*! Maximum steps of Timer2 */
+#define PWM_STEPS_TIMER2    256UL
+/*! Duty cycle of a tone, 50 % */
+#define PWM_TONE_DUTY       0x8000U
+
+/*! Update written at the next TOP: the compare registers */
+#define PWM_STAGE_BUFFERED  1
+/*! Update written at the next TOP: the registers applied at once */
+#define PWM_STAGE_DIRECT    2
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  State of a channel
+  */
+typedef struct
+{
+    uint32_t frequency;         /*! Periods per second */
+    uint16_t top;               /*! TOP, the period is top + 1 counts */
+    uint16_t compare;           /*! Compare value of the duty cycle */
+    uint16_t duty;              /*! Duty cycle, 0 to PWM_DUTY_MAX */
+    uint8_t clock;              /*! Clock select */
+    uint8_t running;            /*! Set by pwm_init */
+    uint8_t pending;            /*! Stage of the update, 0 for none */
+    uint32_t tone_left;         /*! Periods left of the tone, 0 for none */
+    int32_t fade_level;         /*! Duty cycle of the fade, x256 */
+    int32_t fade_step;          /*! Change of fade_level per step */
+    uint16_t fade_steps;        /*! Steps left of the fade, 0 for none */
+    uint16_t fade_target;       /*! Duty cycle at the end of the fade */
+    uint32_t fade_every;        /*! Periods per step */
+    uint32_t fade_count;        /*! Periods left to the next step */
+} pwm_state;
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! State of the channels */
+static volatile pwm_state pwm_states[PWM_CHANNELS];
+/*! Prescalers of Timer1 by clock select value - 1 */
+static const uint16_t pwm_prescalers1[] PROGMEM = {1, 8, 64, 256, 1024};
+/*! Prescalers of Timer2 by clock select value - 1 */
+static const uint16_t pwm_prescalers2[] PROGMEM = {1, 8, 32, 64, 128, 256,
+                                                   1024};
+
+#ifdef __AVR__
+// 37 bytes per channel on the AVR, the host pads the structure
+_Static_assert(sizeof(pwm_states) == PWM_RAM_SIZE,
+               "PWM_RAM_SIZE does not match the buffers");
+#endif
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static pwm_status _pwm_select(pwm_channel channel, uint32_t frequency,
+                              uint16_t steps, volatile pwm_state* state);
+static uint16_t _pwm_compare(uint16_t duty, uint16_t top);
+static uint32_t _pwm_periods(const volatile pwm_state* state, uint16_t ms);
+static void _pwm_schedule(pwm_channel channel);
+static void _pwm_interrupt(pwm_channel channel, uint8_t enable);
+static void _pwm_write_buffered(pwm_channel channel);
+static void _pwm_write_direct(pwm_channel channel);
+static void _pwm_period(pwm_channel channel);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup pwm
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize a PWM channel.
+ *
+ * The pin is configured as output and kept low, the duty cycle is 0. The
+ * timer is started in fast PWM mode at once, for D5 the tick keeps running.
+ *
+ * @param channel Channel.
+ * @param frequency Frequency in Hz, for D5 the one of the tick (1000).
+ * @param steps Minimum steps of the duty cycle, 0 for any.
+ *
+ * @return PWM_OK, PWM_BUSY if the timer is used by another driver or
+ *         PWM_RANGE if the timer can not reach the frequency and steps.
+ *
+ * \b Example:
+ * @code
+ *      pwm_init(PWM_B1, 20000, 800);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+pwm_status
+pwm_init(pwm_channel channel, uint32_t frequency, uint16_t steps)
+{
+    volatile pwm_state* state;
+    pwm_status status;
+    uint8_t sreg;
+
+    if (channel >= PWM_CHANNELS)
+    {
+        return PWM_UNSUPPORTED;
+    }
+    state = &pwm_states[channel];
+
+    if ( !state->running &&
+         (((channel == PWM_B1) && (TCCR1B & PWM_CLOCK_MASK)) ||
+          ((channel == PWM_D3) && (TCCR2B & PWM_CLOCK_MASK))) )
+    {
+        return PWM_BUSY;
+    }
+
+    status = _pwm_select(channel, frequency, steps, state);
+    if (status != PWM_OK)
+    {
+        return status;
+    }
+
+    sreg = SREG;
+    cli();
+
+    state->duty = 0;
+    state->compare = 0;
+    state->pending = 0;
+    state->tone_left = 0;
+    state->fade_steps = 0;
+    state->running = 1;
+    _pwm_interrupt(channel, 0);
+
+    // Output low, the timers stopped in normal mode write OCRnx at once
+    switch (channel)
+    {
+        case PWM_B1:
+            PORTB &= ~_BV(B1_PIN);
+            DDRB |= _BV(B1_PIN);
+            TCCR1B = 0;
+            TCCR1A = 0;
+            TCNT1 = 0;
+            break;
+
+        case PWM_D3:
+            PORTD &= ~_BV(D3_PIN);
+            DDRD |= _BV(D3_PIN);
+            TCCR2B = 0;
+            TCCR2A = 0;
+            TCNT2 = 0;
+            break;
+
+        default:
+            PORTD &= ~_BV(D5_PIN);
+            DDRD |= _BV(D5_PIN);
+            break;
+    }
+
+    _pwm_write_buffered(channel);
+    _pwm_write_direct(channel);
+
+    SREG = sreg;
+
+    return PWM_OK;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to change the frequency of a channel.
+ *
+ * The duty cycle is kept and scaled to the new steps. The change is
+ * applied at the timer TOP, the current period is not cut.
+ *
+ * @param channel Channel.
+ * @param frequency Frequency in Hz.
+ * @param steps Minimum steps of the duty cycle, 0 for any.
+ *
+ * @return PWM_OK, PWM_RANGE if the timer can not reach the frequency and
+ *         steps or PWM_UNSUPPORTED if the channel is not initialized.
+ *
+ * \b Example:
+ * @code
+ *      pwm_set_frequency(PWM_B1, 25000, 0);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+pwm_status
+pwm_set_frequency(pwm_channel channel, uint32_t frequency, uint16_t steps)
+{
+    volatile pwm_state* state;
+    pwm_status status;
+    pwm_state selected;
+    uint8_t sreg;
+
+    if ( (channel >= PWM_CHANNELS) || !pwm_states[channel].running )
+    {
+        return PWM_UNSUPPORTED;
+    }
+    state = &pwm_states[channel];
+
+    status = _pwm_select(channel, frequency, steps, &selected);
+    if (status != PWM_OK)
+    {
+        return status;
+    }
+
+    sreg = SREG;
+    cli();
+
+    state->frequency = selected.frequency;
+    state->top = selected.top;
+    state->clock = selected.clock;
+    state->compare = _pwm_compare(state->duty, state->top);
+    _pwm_schedule(channel);
+
+    SREG = sreg;
+
+    return PWM_OK;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to set the duty cycle of a channel.
+ *
+ * The duty cycle is applied at the timer TOP, the current period is not
+ * cut. A tone or a fade running is stopped.
+ *
+ * @param channel Channel.
+ * @param duty Duty cycle, 0 (low) to PWM_DUTY_MAX (high).
+ *
+ * @return PWM_OK or PWM_UNSUPPORTED if the channel is not initialized.
+ *
+ * \b Example:
+ * @code
+ *      pwm_set_duty(PWM_B1, PWM_DUTY_MAX / 4);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+pwm_status
+pwm_set_duty(pwm_channel channel, uint16_t duty)
+{
+    volatile pwm_state* state;
+    uint8_t sreg;
+
+    if ( (channel >= PWM_CHANNELS) || !pwm_states[channel].running )
+    {
+        return PWM_UNSUPPORTED;
+    }
+    state = &pwm_states[channel];
+
+    sreg = SREG;
+    cli();
+
+    state->tone_left = 0;
+    state->fade_steps = 0;
+    state->duty = duty;
+    state->compare = _pwm_compare(duty, state->top);
+    _pwm_schedule(channel);
+
+    SREG = sreg;
+
+    return PWM_OK;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to fade the duty cycle of a channel.
+ *
+ * The duty cycle moves linearly from the current one to the new one, in
+ * PWM_FADE_RATE steps per second changed at the timer TOP. A tone running
+ * is stopped.
+ *
+ * @param channel Channel.
+ * @param duty Duty cycle at the end, 0 (low) to PWM_DUTY_MAX (high).
+ * @param ms Length of the fade in milliseconds.
+ *
+ * @return PWM_OK or PWM_UNSUPPORTED if the channel is not initialized.
+ *
+ * \b Example:
+ * @code
+ *      pwm_fade(PWM_D5, 0, 1500);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+pwm_status
+pwm_fade(pwm_channel channel, uint16_t duty, uint16_t ms)
+{
+    volatile pwm_state* state;
+    uint32_t every;
+    uint32_t steps;
+    uint8_t sreg;
+
+    if ( (channel >= PWM_CHANNELS) || !pwm_states[channel].running )
+    {
+        return PWM_UNSUPPORTED;
+    }
+    state = &pwm_states[channel];
+
+    // Every step takes the two TOPs of an update
+    every = state->frequency / PWM_FADE_RATE;
+    if (every < 2)
+    {
+        every = 2;
+    }
+    steps = _pwm_periods(state, ms) / every;
+    if (steps == 0)
+    {
+        steps = 1;
+    }
+
+    sreg = SREG;
+    cli();
+
+    state->tone_left = 0;
+    state->fade_level = (int32_t) state->duty << 8;
+    state->fade_step = ((int32_t) duty - state->duty) * 256 / (int32_t) steps;
+    state->fade_steps = (uint16_t) steps;
+    state->fade_target = duty;
+    state->fade_every = every;
+    state->fade_count = every;
+    _pwm_schedule(channel);
+
+    SREG = sreg;
+
+    return PWM_OK;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to play a tone on a channel.
+ *
+ * The frequency changes at the timer TOP with a duty cycle of 50 %, and
+ * the output goes low after the length of the tone. The frequency is kept
+ * for the next duty cycles. A fade running is stopped.
+ *
+ * @param channel Channel, B1 or D3.
+ * @param frequency Frequency in Hz.
+ * @param ms Length of the tone in milliseconds, 0 to play until the next
+ *           duty cycle is set.
+ *
+ * @return PWM_OK, PWM_RANGE if the timer can not reach the frequency or
+ *         PWM_UNSUPPORTED for D5 or if the channel is not initialized.
+ *
+ * \b Example:
+ * @code
+ *      pwm_tone(PWM_D3, 440, 250);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+pwm_status
+pwm_tone(pwm_channel channel, uint32_t frequency, uint16_t ms)
+{
+    volatile pwm_state* state;
+    pwm_status status;
+    pwm_state selected;
+    uint32_t periods;
+    uint8_t sreg;
+
+    if ( (channel >= PWM_D5) || !pwm_states[channel].running )
+    {
+        return PWM_UNSUPPORTED;
+    }
+    state = &pwm_states[channel];
+
+    status = _pwm_select(channel, frequency, 2, &selected);
+    if (status != PWM_OK)
+    {
+        return status;
+    }
+
+    periods = _pwm_periods(&selected, ms);
+    if ( (ms != 0) && (periods == 0) )
+    {
+        periods = 1;
+    }
+
+    sreg = SREG;
+    cli();
+
+    state->fade_steps = 0;
+    state->frequency = selected.frequency;
+    state->top = selected.top;
+    state->clock = selected.clock;
+    state->duty = PWM_TONE_DUTY;
+    state->compare = _pwm_compare(PWM_TONE_DUTY, state->top);
+    state->tone_left = periods;
+    _pwm_schedule(channel);
+
+    SREG = sreg;
+
+    return PWM_OK;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to know if a channel is updating.
+ *
+ * @param channel Channel.
+ *
+ * @return 1 while an update waits for the timer TOP or a tone or a fade
+ *         runs, 0 otherwise.
+ */
+/*****************************************************************************/
+uint8_t
+pwm_busy(pwm_channel channel)
+{
+    volatile pwm_state* state;
+    uint8_t busy;
+    uint8_t sreg;
+
+    if (channel >= PWM_CHANNELS)
+    {
+        return 0;
+    }
+    state = &pwm_states[channel];
+
+    sreg = SREG;
+    cli();
+    busy = (state->pending != 0) || (state->tone_left != 0) ||
+           (state->fade_steps != 0);
+    SREG = sreg;
+
+    return busy;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the steps of the duty cycle of a channel.
+ *
+ * @param channel Channel.
+ *
+ * @return Steps of the last frequency set, 0 if the channel is not
+ *         initialized.
+ */
+/*****************************************************************************/
+uint16_t
+pwm_get_steps(pwm_channel channel)
+{
+    uint16_t steps;
+    uint8_t sreg;
+
+    if ( (channel >= PWM_CHANNELS) || !pwm_states[channel].running )
+    {
+        return 0;
+    }
+
+    sreg = SREG;
+    cli();
+    steps = pwm_states[channel].top + 1;
+    SREG = sreg;
+
+    return steps;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to stop a channel.
+ *
+ * The output goes low at once. Timer1 and Timer2 are stopped, Timer0 goes
+ * back to the CTC mode of the tick with the same period.
+ *
+ * @param channel Channel.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+pwm_stop(pwm_channel channel)
+{
+    volatile pwm_state* state;
+    uint8_t sreg;
+
+    if ( (channel >= PWM_CHANNELS) || !pwm_states[channel].running )
+    {
+        return;
+    }
+    state = &pwm_states[channel];
+
+    sreg = SREG;
+    cli();
+
+    state->running = 0;
+    state->pending = 0;
+    state->tone_left = 0;
+    state->fade_steps = 0;
+    _pwm_interrupt(channel, 0);
+
+    switch (channel)
+    {
+        case PWM_B1:
+            TCCR1B = 0;
+            TCCR1A = 0;
+            break;
+
+        case PWM_D3:
+            TCCR2B = 0;
+            TCCR2A = 0;
+            break;
+
+        default:
+            TCCR0A = _BV(WGM01);
+            TCCR0B = PWM_TICK_CLOCK;
+            break;
+    }
+
+    SREG = sreg;
+}
+
+/*****************************************************************************/
+/*!
+ * Timer1 overflow interrupt, at the TOP of B1.
+ */
+/*****************************************************************************/
+ISR_PROFILED(TIMER1_OVF_vect, ISR_PROFILE_PWM)
+{
+    _pwm_period(PWM_B1);
+}
+
+/*****************************************************************************/
+/*!
+ * Timer2 overflow interrupt, at the TOP of D3.
+ */
+/*****************************************************************************/
+ISR_PROFILED(TIMER2_OVF_vect, ISR_PROFILE_PWM)
+{
+    _pwm_period(PWM_D3);
+}
+
+/*****************************************************************************/
+/*!
+ * Timer0 overflow interrupt, at the TOP of D5.
+ */
+/*****************************************************************************/
+ISR_PROFILED(TIMER0_OVF_vect, ISR_PROFILE_PWM)
+{
+    _pwm_period(PWM_D5);
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
+
+/******************************************************************************
+* Private Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to select the prescaler and TOP of a frequency.
+ *
+ * The smallest prescaler reaching the frequency gives the most steps.
+ *
+ * @param channel Channel.
+ * @param frequency Frequency in Hz.
+ * @param steps Minimum steps of the duty cycle, 0 for any.
+ * @param state Pointer where the frequency, TOP and clock are written.
+ *
+ * @return PWM_OK, PWM_BUSY if the tick is not running for D5 or PWM_RANGE.
+ */
+/*****************************************************************************/
+static pwm_status
+_pwm_select(pwm_channel channel, uint32_t frequency, uint16_t steps,
+            volatile pwm_state* state)
+{
+    const uint16_t* prescalers = pwm_prescalers1;
+    uint8_t count = sizeof(pwm_prescalers1) / sizeof(pwm_prescalers1[0]);
+    uint32_t max = PWM_STEPS_TIMER1;
+    uint32_t prescaler;
+    uint32_t counts;
+    uint8_t i;
+
+    if (channel == PWM_D5)
+    {
+        if ((TCCR0B & PWM_CLOCK_MASK) != PWM_TICK_CLOCK)
+        {
+            return PWM_BUSY;
+        }
+
+        counts = OCR0A + 1UL;
+        if ( (frequency != F_CPU / (PWM_TICK_PRESCALER * counts)) ||
+             (steps > counts) )
+        {
+            return PWM_RANGE;
+        }
+
+        state->frequency = frequency;
+        state->top = (uint16_t) (counts - 1);
+        state->clock = PWM_TICK_CLOCK;
+
+        return PWM_OK;
+    }
+
+    if (channel == PWM_D3)
+    {
+        prescalers = pwm_prescalers2;
+        count = sizeof(pwm_prescalers2) / sizeof(pwm_prescalers2[0]);
+        max = PWM_STEPS_TIMER2;
+    }
+
+    if (frequency == 0)
+    {
+        return PWM_RANGE;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        prescaler = pgm_read_word(&prescalers[i]);
+        counts = (F_CPU / prescaler + frequency / 2) / frequency;
+        if (counts <= max)
+        {
+            if ( (counts < 2) || (counts < steps) )
+            {
+                return PWM_RANGE;
+            }
+
+            state->frequency = F_CPU / (prescaler * counts);
+            state->top = (uint16_t) (counts - 1);
+            state->clock = i + 1;
+
+            return PWM_OK;
+        }
+    }
+
+    return PWM_RANGE;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to scale a duty cycle to the compare value of a TOP.
+ *
+ * @param duty Duty cycle, 0 to PWM_DUTY_MAX.
+ * @param top TOP of the timer.
+ *
+ * @return Compare value, TOP for PWM_DUTY_MAX (output always high).
+ */
+/*****************************************************************************/
+static uint16_t
+_pwm_compare(uint16_t duty, uint16_t top)
+{
+    if (duty == PWM_DUTY_MAX)
+    {
+        return top;
+    }
+
+    return (uint16_t) (((uint32_t) duty * (top + 1UL)) >> 16);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to convert a time to periods of a channel.
+ *
+ * @param state Pointer to the state with the frequency.
+ * @param ms Time in milliseconds.
+ *
+ * @return Periods, rounded down.
+ */
+/*****************************************************************************/
+static uint32_t
+_pwm_periods(const volatile pwm_state* state, uint16_t ms)
+{
+    uint32_t frequency = state->frequency;
+
+    return (frequency / 1000) * ms + ((frequency % 1000) * ms) / 1000;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to write an update at the next TOP, called with the
+ * interrupts disabled.
+ *
+ * @param channel Channel.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_pwm_schedule(pwm_channel channel)
+{
+    pwm_states[channel].pending = PWM_STAGE_BUFFERED;
+    _pwm_interrupt(channel, 1);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to enable or disable the overflow interrupt of a channel.
+ *
+ * The overflow flag set at a previous TOP is cleared before the interrupt
+ * is enabled, so the update is not written in the middle of a period.
+ *
+ * @param channel Channel.
+ * @param enable 1 to enable, 0 to disable.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_pwm_interrupt(pwm_channel channel, uint8_t enable)
+{
+    volatile uint8_t* timsk;
+    volatile uint8_t* tifr;
+
+    switch (channel)
+    {
+        case PWM_B1:
+            timsk = &TIMSK1;
+            tifr = &TIFR1;
+            break;
+
+        case PWM_D3:
+            timsk = &TIMSK2;
+            tifr = &TIFR2;
+            break;
+
+        default:
+            timsk = &TIMSK0;
+            tifr = &TIFR0;
+            break;
+    }
+
+    // TOIE0, TOIE1 and TOIE2 are the same bit, as TOV0, TOV1 and TOV2
+    if (!enable)
+    {
+        *timsk &= ~_BV(TOIE1);
+    }
+    else if ( !(*timsk & _BV(TOIE1)) )
+    {
+        *tifr = _BV(TOV1);
+        *timsk |= _BV(TOIE1);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to write the compare registers of a channel, double
+ * buffered by the timer until the next BOTTOM.
+ *
+ * @param channel Channel.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_pwm_write_buffered(pwm_channel channel)
+{
+    volatile pwm_state* state = &pwm_states[channel];
+
+    switch (channel)
+    {
+        case PWM_B1:
+            OCR1A = state->compare;
+            break;
+
+        case PWM_D3:
+            OCR2A = (uint8_t) state->top;
+            OCR2B = (uint8_t) state->compare;
+            break;
+
+        default:
+            OCR0B = (uint8_t) state->compare;
+            break;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to write the registers of a channel applied at once: TOP
+ * of Timer1, prescaler and output connection, disconnected for a duty
+ * cycle of 0 so the pin stays low.
+ *
+ * @param channel Channel.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_pwm_write_direct(pwm_channel channel)
+{
+    volatile pwm_state* state = &pwm_states[channel];
+    uint8_t on = (state->duty != 0);
+
+    switch (channel)
+    {
+        case PWM_B1:
+            ICR1 = state->top;
+            // A TOP below the count would run the timer up to 0xFFFF
+            if (TCNT1 > state->top)
+            {
+                TCNT1 = 0;
+            }
+            TCCR1A = _BV(WGM11) | (on ? _BV(COM1A1) : 0);
+            TCCR1B = _BV(WGM13) | _BV(WGM12) | state->clock;
+            break;
+
+        case PWM_D3:
+            TCCR2A = _BV(WGM21) | _BV(WGM20) | (on ? _BV(COM2B1) : 0);
+            TCCR2B = _BV(WGM22) | state->clock;
+            break;
+
+        default:
+            TCCR0A = _BV(WGM01) | _BV(WGM00) | (on ? _BV(COM0B1) : 0);
+            TCCR0B = _BV(WGM02) | PWM_TICK_CLOCK;
+            break;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to run a channel at the timer TOP: counts the tone, steps
+ * the fade and writes the update pending.
+ *
+ * @param channel Channel.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_pwm_period(pwm_channel channel)
+{
+    volatile pwm_state* state = &pwm_states[channel];
+
+    if ( (state->tone_left != 0) && (--state->tone_left == 0) )
+    {
+        state->duty = 0;
+        state->pending = PWM_STAGE_BUFFERED;
+    }
+
+    if ( (state->fade_steps != 0) && (--state->fade_count == 0) )
+    {
+        state->fade_count = state->fade_every;
+        state->fade_level += state->fade_step;
+        if (--state->fade_steps == 0)
+        {
+            state->duty = state->fade_target;
+        }
+        else
+        {
+            state->duty = (uint16_t) (state->fade_level >> 8);
+        }
+        state->compare = _pwm_compare(state->duty, state->top);
+        state->pending = PWM_STAGE_BUFFERED;
+    }
+
+    if (state->pending == PWM_STAGE_BUFFERED)
+    {
+        _pwm_write_buffered(channel);
+        state->pending = PWM_STAGE_DIRECT;
+    }
+    else if (state->pending == PWM_STAGE_DIRECT)
+    {
+        _pwm_write_direct(channel);
+        state->pending = 0;
+    }
+
+    if ( (state->pending == 0) && (state->tone_left == 0) &&
+         (state->fade_steps == 0) )
+    {
+        _pwm_interrupt(channel, 0);
+    }
+}
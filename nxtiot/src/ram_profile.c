@@ -0,0 +1,274 @@
+/******************************************************************************
+* Title                 :   RAM profile source file
+* Filename              :   ram_profile.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        ram_profile.c
+ *  @brief       RAM profile implementation
+ *
+ *  To use the RAM profile, include this header file as follows:
+ *  @code
+ *      #include "ram_profile.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The RAM profile reports how much of the 2 KB SRAM is used by the
+ *  variables and the stack. Before the C runtime starts, the RAM between the
+ *  end of the variables (.bss) and the top of the stack is filled with
+ *  RAM_PROFILE_CANARY. The stack grows down over the canary, so the first
+ *  byte that is not a canary from the end of the variables up is the deepest
+ *  point ever reached by the stack.
+ *
+ *  A value written by the stack equal to the canary is counted as unused, so
+ *  the reported peak can be a few bytes less than the real one. When malloc
+ *  is used, the heap is counted as stack.
+ *
+ *  The size of .data and .bss of every driver is reported at build time by
+ *  the ram target of the Makefiles of the examples.
+ *
+ *  On the host only the painting and scanning functions are built.
+ *
+ *  ## Usage ##
+ *
+ *  The RAM is painted automatically when the driver is linked, the usage can
+ *  be read at any time or sent through the UART.
+ *
+ *  @code
+ *      #include "ram_profile.h"
+ *
+ *      ram_profile_info info;
+ *
+ *      uart_init();
+ *
+ *      ram_profile_get(&info);
+ *      if (info.unused < 64)
+ *      {
+ *          ram_profile_report();
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "ram_profile.h"
+#ifdef __AVR__
+#include <stdlib.h>
+#include "uart.h"
+#endif
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+#ifdef __AVR__
+/*! Sections limits defined by the linker */
+extern uint8_t __data_start;
+extern uint8_t __data_end;
+extern uint8_t __bss_start;
+extern uint8_t __bss_end;
+#endif
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+#ifdef __AVR__
+void _ram_profile_paint_init(void) __attribute__((naked, used,
+                                                   section(".init1")));
+static void _ram_profile_print(const char* name, uint16_t value);
+#endif
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup ram_profile
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to fill a region of RAM with the canary.
+ *
+ * The free RAM is painted at startup, this function is used to paint other
+ * regions, such as a buffer whose usage has to be measured.
+ *
+ * @param low Pointer to the first byte of the region.
+ * @param high Pointer to the byte after the region.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+ram_profile_paint(uint8_t* low, uint8_t* high)
+{
+    while (low < high)
+    {
+        *low++ = RAM_PROFILE_CANARY;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to count the bytes of a region never written since it was
+ * painted.
+ *
+ * The region is scanned from the lowest address up to the first byte that is
+ * not the canary, as the stack grows down from the highest address.
+ *
+ * @param low Pointer to the first byte of the region.
+ * @param high Pointer to the byte after the region.
+ *
+ * @return Number of bytes never written.
+ *
+ * \b Example:
+ * @code
+ *      uint8_t buffer[64];
+ *
+ *      ram_profile_paint(buffer, buffer + sizeof(buffer));
+ *      ...
+ *      unused = ram_profile_scan(buffer, buffer + sizeof(buffer));
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+uint16_t
+ram_profile_scan(const uint8_t* low, const uint8_t* high)
+{
+    const uint8_t* p = low;
+
+    while ( (p < high) && (*p == RAM_PROFILE_CANARY) )
+    {
+        p++;
+    }
+
+    return (uint16_t) (p - low);
+}
+
+#ifdef __AVR__
+/*****************************************************************************/
+/*!
+ * Function used to get the RAM usage.
+ *
+ * @param info Pointer where the RAM usage will be written.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+ram_profile_get(ram_profile_info* info)
+{
+    uint8_t* low = &__bss_end;
+    uint8_t* high = (uint8_t *) SP;
+
+    info->data = (uint16_t) (&__data_end - &__data_start);
+    info->bss = (uint16_t) (&__bss_end - &__bss_start);
+    info->stack = (uint16_t) (RAMEND - SP);
+    info->unused = ram_profile_scan(low, high);
+    info->stack_peak = (uint16_t) (RAMEND + 1 - (uintptr_t) low) -
+                       info->unused;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send the RAM usage through the UART.
+ *
+ * The usage is sent as a line of text, for example:
+ *      RAM data 24 bss 310 stack 12 peak 96 unused 1618
+ *
+ * @pre The UART must be initialized using the uart_init function.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+ram_profile_report(void)
+{
+    ram_profile_info info;
+
+    ram_profile_get(&info);
+
+    uart_send("RAM");
+    _ram_profile_print(" data ", info.data);
+    _ram_profile_print(" bss ", info.bss);
+    _ram_profile_print(" stack ", info.stack);
+    _ram_profile_print(" peak ", info.stack_peak);
+    _ram_profile_print(" unused ", info.unused);
+    uart_send("\n");
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send a named value through the UART.
+ *
+ * @param name Name of the value.
+ * @param value Value to be sent.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_ram_profile_print(const char* name, uint16_t value)
+{
+    char str[6];
+
+    uart_send(name);
+    uart_send(utoa(value, str, 10));
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to paint the free RAM before the C runtime starts.
+ *
+ * It is placed in the .init1 section, before the stack pointer and the
+ * variables are initialized, so it can not use the stack: the RAM from the
+ * end of .bss (_end) up to the top of the stack (__stack) is painted with
+ * the Z register.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+_ram_profile_paint_init(void)
+{
+    __asm volatile (
+        "    ldi r30, lo8(_end)      \n"
+        "    ldi r31, hi8(_end)      \n"
+        "    ldi r24, %0             \n"
+        "    ldi r25, hi8(__stack)   \n"
+        "    rjmp 2f                 \n"
+        "1:  st Z+, r24              \n"
+        "2:  cpi r30, lo8(__stack)   \n"
+        "    cpc r31, r25            \n"
+        "    brlo 1b                 \n"
+        "    breq 1b                 \n"
+        :
+        : "i" (RAM_PROFILE_CANARY)
+    );
+}
+#endif
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
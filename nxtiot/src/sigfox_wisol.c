@@ -22,27 +22,77 @@
  *
  *  ## Usage ##
  *
- *  To use the Sigfox Wisol driver, the driver must be first initialized using 
- *  the sigfox_wisol_init function.
+ *  To use the Sigfox Wisol driver, the tick driver must be initialized, then
+ *  the driver using the sigfox_wisol_init function, and the global
+ *  interrupts must be enabled, so the responses of the module can be awaited
+ *  with a timeout. The driver does not initialize the tick, which would
+ *  reset the time kept by the other drivers.
  * 
  *  The following code example initializes the module and reads the ID and PAC 
- *  from the module.
+ *  from the module. The answers are parsed while they are received, by the
+ *  Wisol response parser, and the ID and the PAC are decoded to bytes in the
+ *  buffer given, which must fit the hexadecimal line.
  * 
  *  @code
  *      #include "sigfox_wisol.h"
  *
- *      char str[20];
+ *      uint8_t buffer[16];
  * 
+ *      tick_init();
  *      sigfox_wisol_init();
+ *      sei();
  * 
- *      sigfox_wisol_get_id(str, sizeof(str));
- *      sigfox_wisol_get_pac(str, sizeof(str));
+ *      sigfox_wisol_get_id(buffer, sizeof(buffer), NULL);
+ *      sigfox_wisol_get_pac(buffer, sizeof(buffer), NULL);
+ *  @endcode
+ *
+ *  ## Power states ##
+ *
+ *  The commands wake the module up from its current power state and, once
+ *  answered, put it in the state that costs the least until the next
+ *  command, as told by sigfox_wisol_set_next: ready if it is right away,
+ *  asleep with AT$P=1 if it is within WISOL_SLEEP_MS, as AT$P=1 is left by
+ *  a byte on the UART in a few milliseconds, and powered off through the
+ *  enable pin otherwise, which costs WISOL_POWER_ON_MS to come back. The
+ *  module is powered off when the next command is not known, and when it
+ *  does not accept AT$P.
+ *
+ *  @code
+ *      sigfox_wisol_set_next(0);
+ *      sigfox_wisol_get_id(buffer, sizeof(buffer), NULL);
+ *      sigfox_wisol_set_next(WISOL_NEXT_UNKNOWN);
+ *      sigfox_wisol_get_pac(buffer, sizeof(buffer), NULL);
+ *  @endcode
+ *
+ *  ## Uplink messages ##
+ *
+ *  sigfox_wisol_send_frame makes one attempt and tells its outcome. A
+ *  message given to sigfox_wisol_uplink is instead sent by
+ *  sigfox_wisol_uplink_poll, called from the main loop, which retries it
+ *  after a failure without blocking in between: the waits double from
+ *  WISOL_RETRY_BASE_MS and are shortened by a random jitter, seeded with the
+ *  ID of the module, so the nodes that failed together do not retry
+ *  together. A message is dropped after WISOL_SEND_ATTEMPTS attempts, and
+ *  the attempts over the daily budget wait for the next day. The counters
+ *  of every outcome can be packed in a later message.
+ *
+ *  @code
+ *      sigfox_wisol_uplink(payload, sizeof(payload));
+ *
+ *      while (1)
+ *      {
+ *          now = tick_get_ms();
+ *          sigfox_wisol_uplink_poll(now);
+ *          sigfox_wisol_set_next(sigfox_wisol_uplink_next(now));
+ *      }
  *  @endcode
  */
 /******************************************************************************
 * Includes
 ******************************************************************************/
+#include <string.h>
 #include "sigfox_wisol.h"
+#include "trace.h"
 
 /******************************************************************************
 * Module Preprocessor Constants
@@ -58,9 +108,30 @@ const char* sigfox_wisol_cmds[] =
     "AT$RC\n"             /*! Module reset */
 };
 
+/*! Milliseconds of the budget day */
+#define WISOL_DAY_MS        86400000UL
+/*! Seed of the jitter before the ID is read, or if the ID hashes to 0 */
+#define WISOL_RANDOM_SEED   0xACE1
+
 /******************************************************************************
 * Module Preprocessor Macros
 ******************************************************************************/
+/*! Counters of the fields of PAYLOAD_UPLINK_STATS_FIELDS */
+#define _WISOL_COUNTER_sent         _WISOL_RESULT(WISOL_SEND_OK)
+#define _WISOL_COUNTER_error        _WISOL_RESULT(WISOL_SEND_ERROR)
+#define _WISOL_COUNTER_timeout      _WISOL_RESULT(WISOL_SEND_TIMEOUT)
+#define _WISOL_COUNTER_not_ready    _WISOL_RESULT(WISOL_SEND_NOT_READY)
+#define _WISOL_COUNTER_retries      sigfox_wisol_uplinks.retries
+#define _WISOL_COUNTER_dropped      sigfox_wisol_uplinks.dropped
+#define _WISOL_COUNTER_deferred     sigfox_wisol_uplinks.deferred
+/*! Counter of the attempts with a result */
+#define _WISOL_RESULT(result)       sigfox_wisol_uplinks.results[result]
+#define _WISOL_COUNTER_day_uplinks  sigfox_wisol_day_uplinks
+
+/*! Writes a counter in a payload, see PAYLOAD_UPLINK_STATS_FIELDS */
+#define _WISOL_PACK_FIELD(name, first, bits, is_signed)                     \
+    payload_put(data, first, bits,                                          \
+                _sigfox_wisol_saturate(_WISOL_COUNTER_##name, bits));
 
 /******************************************************************************
 * Module Typedefs
@@ -82,10 +153,56 @@ typedef enum {
 /******************************************************************************
 * Module Variable Definitions
 ******************************************************************************/
+/*! Power state of the module */
+static sigfox_wisol_power sigfox_wisol_state;
+/*! Time from the end of a command to the next one, in milliseconds */
+static uint32_t sigfox_wisol_next;
+/*! Tick of the last change of power state */
+static uint32_t sigfox_wisol_since;
+/*! Time spent in every power state */
+static sigfox_wisol_power_stats sigfox_wisol_stats;
+/*! Payload of the uplink message */
+static uint8_t sigfox_wisol_payload[WISOL_FRAME_MAX];
+/*! Size of the payload of the uplink message */
+static uint8_t sigfox_wisol_payload_size;
+/*! State of the uplink message */
+static sigfox_wisol_uplink_state sigfox_wisol_uplink_st;
+/*! Attempts made for the uplink message */
+static uint8_t sigfox_wisol_attempts;
+/*! Set when the next attempt waits for sigfox_wisol_due */
+static uint8_t sigfox_wisol_waiting;
+/*! Time of the next attempt in milliseconds */
+static uint32_t sigfox_wisol_due;
+/*! Set once the start of the budget day is known */
+static uint8_t sigfox_wisol_day_valid;
+/*! Start of the budget day in milliseconds */
+static uint32_t sigfox_wisol_day_start;
+/*! Frames sent in the budget day */
+static uint16_t sigfox_wisol_day_uplinks;
+/*! Counters of the uplink messages */
+static sigfox_wisol_uplink_stats sigfox_wisol_uplinks;
+/*! State of the generator of the jitter */
+static uint16_t sigfox_wisol_random;
+
+_Static_assert(sizeof(sigfox_wisol_payload) == SIGFOX_WISOL_RAM_SIZE,
+               "SIGFOX_WISOL_RAM_SIZE does not match the buffers");
 
 /******************************************************************************
 * Private Function Prototypes
 ******************************************************************************/
+static void _sigfox_wisol_enter(sigfox_wisol_power state);
+static void _sigfox_wisol_wake(void);
+static void _sigfox_wisol_release(void);
+static uint8_t _sigfox_wisol_set_power_mode(uint8_t mode);
+static sigfox_wisol_result _sigfox_wisol_command(uint8_t index,
+                                                 const char* cmd,
+                                                 uint16_t timeout);
+static wisol_token_type _sigfox_wisol_read_hex(uint8_t index, uint8_t* data,
+                                               uint8_t size, uint8_t* count);
+static wisol_token_type _sigfox_wisol_response(wisol_token* token,
+                                               uint16_t timeout);
+static uint32_t _sigfox_wisol_backoff(uint8_t attempts);
+static uint32_t _sigfox_wisol_saturate(uint16_t value, uint8_t bits);
 
 /******************************************************************************
 * Function Definitions
@@ -102,7 +219,11 @@ typedef enum {
 /*!
  * Function used to initialize the Sigfox Wisol module.
  * 
- * This function initializes the UART and initializes the Wisol enable pin.
+ * This function initializes the UART and the Wisol enable pin. The module is
+ * powered off and the next command is not known.
+ *
+ * @note The tick driver is used for the timeouts and must be initialized
+ *       before, with tick_init.
  * 
  * @return None. 
  */
@@ -111,61 +232,123 @@ void
 sigfox_wisol_init(void)
 {
     gpio_init_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_OUTPUT);
+    gpio_write_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_LOW);
     uart_init();
+
+    sigfox_wisol_state = WISOL_POWER_OFF;
+    sigfox_wisol_next = WISOL_NEXT_UNKNOWN;
+    sigfox_wisol_since = tick_get_ms();
+    memset(&sigfox_wisol_stats, 0, sizeof(sigfox_wisol_stats));
+
+    sigfox_wisol_uplink_st = WISOL_UPLINK_IDLE;
+    sigfox_wisol_day_valid = 0;
+    sigfox_wisol_day_uplinks = 0;
+    memset(&sigfox_wisol_uplinks, 0, sizeof(sigfox_wisol_uplinks));
+    sigfox_wisol_random = WISOL_RANDOM_SEED;
 }
 
 /*****************************************************************************/
 /*!
  * Function used to get the ID of the Sigfox Wisol module.
  * 
- * @param id Pointer to the string where the ID will be written.
- * @param size Size of the string.
+ * The answer is received and decoded in place in the buffer, by the Wisol
+ * response parser, so the buffer must fit the whole line: 8 characters for
+ * the 4 bytes of the ID.
+ * 
+ * @param id Pointer to the buffer where the ID will be written.
+ * @param size Size of the buffer.
+ * @param length Pointer where the number of bytes of the ID will be
+ *               stored, or NULL.
+ * 
+ * @return WISOL_TOKEN_HEX if the ID was read, WISOL_TOKEN_NONE if the module
+ *         did not answer within WISOL_RESPONSE_TIMEOUT milliseconds,
+ *         WISOL_TOKEN_OVERFLOW if the buffer is too small or the type of any
+ *         other answer.
+ * 
+ * \b Example:
+ * @code
+ *      uint8_t id[8];
+ *      uint8_t length;
+ *
+ *      if (sigfox_wisol_get_id(id, sizeof(id), &length) == WISOL_TOKEN_HEX)
+ *      {
+ *          // id holds the length bytes of the ID
+ *      }
+ * @endcode
  * 
- * @return None. 
  */
 /*****************************************************************************/
-void
-sigfox_wisol_get_id(char* id, uint8_t size)
+wisol_token_type
+sigfox_wisol_get_id(uint8_t* id, uint8_t size, uint8_t* length)
 {
-    gpio_write_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_HIGH);
-    _delay_ms(1000);
+    wisol_token_type type;
+    uint8_t count;
+    uint8_t i;
 
-    uart_send(sigfox_wisol_cmds[WISOL_CMD_INFORMATION_ID]);
-    uart_read(id, size);
+    type = _sigfox_wisol_read_hex(WISOL_CMD_INFORMATION_ID, id, size, &count);
 
-    _delay_ms(1000);
-    gpio_write_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_LOW);
+    // The ID is unique, it seeds the jitter of the retries
+    for (i = 0; i < count; i++)
+    {
+        sigfox_wisol_random = (sigfox_wisol_random * 31U) + id[i];
+    }
+    // The xorshift would stay at 0
+    if (sigfox_wisol_random == 0)
+    {
+        sigfox_wisol_random = WISOL_RANDOM_SEED;
+    }
+
+    if (length != NULL)
+    {
+        *length = count;
+    }
+
+    return type;
 }
 
 /*****************************************************************************/
 /*!
  * Function used to get the PAC of the Sigfox Wisol module.
  * 
- * @param pac Pointer to the string where the PAC will be written.
- * @param size Size of the string.
+ * The answer is decoded in the buffer as by sigfox_wisol_get_id, the buffer
+ * must fit 16 characters for the 8 bytes of the PAC.
  * 
- * @return None. 
+ * @param pac Pointer to the buffer where the PAC will be written.
+ * @param size Size of the buffer.
+ * @param length Pointer where the number of bytes of the PAC will be
+ *               stored, or NULL.
+ * 
+ * @return WISOL_TOKEN_HEX if the PAC was read, WISOL_TOKEN_NONE if the
+ *         module did not answer within WISOL_RESPONSE_TIMEOUT milliseconds,
+ *         WISOL_TOKEN_OVERFLOW if the buffer is too small or the type of any
+ *         other answer.
  */
 /*****************************************************************************/
-void
-sigfox_wisol_get_pac(char* pac, uint8_t size)
+wisol_token_type
+sigfox_wisol_get_pac(uint8_t* pac, uint8_t size, uint8_t* length)
 {
-    gpio_write_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_HIGH);
-    _delay_ms(1000);
+    wisol_token_type type;
+    uint8_t count;
 
-    uart_send(sigfox_wisol_cmds[WISOL_CMD_INFORMATION_PAC]);
-    uart_read(pac, size);
+    type = _sigfox_wisol_read_hex(WISOL_CMD_INFORMATION_PAC, pac, size,
+                                  &count);
 
-    _delay_ms(1000);
-    gpio_write_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_LOW);
+    if (length != NULL)
+    {
+        *length = count;
+    }
+
+    return type;
 }
 
 /*****************************************************************************/
 /*!
  * Function used to send a message using the Sigfox Wisol module.
  * 
- * @param msg Pointer to the string that store the message to be sent.
- * @param size Size of the string.
+ * The message is sent as with sigfox_wisol_send_frame, without its outcome.
+ * 
+ * @param msg Pointer to the bytes of the message.
+ * @param size Number of bytes, up to WISOL_FRAME_MAX.
  * 
  * @return None. 
  */
@@ -173,13 +356,614 @@ sigfox_wisol_get_pac(char* pac, uint8_t size)
 void
 sigfox_wisol_send_msg(const char* msg, uint8_t size)
 {
-    gpio_write_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_HIGH);
-    _delay_ms(1000);
+    sigfox_wisol_send_frame((const uint8_t *) msg, size);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send a frame, waiting for its outcome.
+ * 
+ * The module is checked with AT first, so a module that does not answer is
+ * told apart from a frame that is not answered. The frame is sent with
+ * AT$SF, with the payload in hexadecimal.
+ * 
+ * @param data Pointer to the payload.
+ * @param size Number of bytes, from 1 to WISOL_FRAME_MAX.
+ * 
+ * @return WISOL_SEND_OK if the frame was sent, WISOL_SEND_ERROR if it was
+ *         answered with an error or the size is not valid,
+ *         WISOL_SEND_TIMEOUT if it was not answered within
+ *         WISOL_FRAME_TIMEOUT or WISOL_SEND_NOT_READY if the module did not
+ *         answer AT and the frame was not sent.
+ * 
+ * \b Example:
+ * @code
+ *      uint8_t payload[] = {0x01, 0x02};
+ *
+ *      if (sigfox_wisol_send_frame(payload, sizeof(payload)) != WISOL_SEND_OK)
+ *      {
+ *          ...
+ *      }
+ * @endcode
+ * 
+ */
+/*****************************************************************************/
+sigfox_wisol_result
+sigfox_wisol_send_frame(const uint8_t* data, uint8_t size)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char cmd[sizeof("AT$SF=\n") + (2 * WISOL_FRAME_MAX)] = "AT$SF=";
+    sigfox_wisol_result result;
+    char* out = &cmd[6];
+    uint8_t i;
 
-    uart_send(sigfox_wisol_cmds[WISOL_CMD_SEND_FRAME]);
+    if ( (size == 0) || (size > WISOL_FRAME_MAX) )
+    {
+        return WISOL_SEND_ERROR;
+    }
 
-    _delay_ms(1000);
-    gpio_write_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_LOW);
+    for (i = 0; i < size; i++)
+    {
+        *out++ = hex[data[i] >> 4];
+        *out++ = hex[data[i] & 0x0F];
+    }
+    *out++ = '\n';
+    *out = 0x00;
+
+    _sigfox_wisol_wake();
+
+    result = _sigfox_wisol_command(WISOL_CMD_STATUS,
+                                   sigfox_wisol_cmds[WISOL_CMD_STATUS],
+                                   WISOL_RESPONSE_TIMEOUT);
+    if (result == WISOL_SEND_OK)
+    {
+        result = _sigfox_wisol_command(WISOL_CMD_SEND_FRAME, cmd,
+                                       WISOL_FRAME_TIMEOUT);
+    }
+    else
+    {
+        result = WISOL_SEND_NOT_READY;
+    }
+
+    _sigfox_wisol_release();
+
+    return result;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to give a message to be sent by sigfox_wisol_uplink_poll,
+ * with retries. The first attempt is on the next poll.
+ * 
+ * @param data Pointer to the payload, copied.
+ * @param size Number of bytes, from 1 to WISOL_FRAME_MAX.
+ * 
+ * @return 1 if the message was taken, 0 if the size is not valid or a
+ *         message is pending.
+ */
+/*****************************************************************************/
+uint8_t
+sigfox_wisol_uplink(const uint8_t* data, uint8_t size)
+{
+    if ( (size == 0) || (size > WISOL_FRAME_MAX) ||
+         (sigfox_wisol_uplink_st == WISOL_UPLINK_PENDING) )
+    {
+        return 0;
+    }
+
+    memcpy(sigfox_wisol_payload, data, size);
+    sigfox_wisol_payload_size = size;
+    sigfox_wisol_attempts = 0;
+    sigfox_wisol_waiting = 0;
+    sigfox_wisol_uplink_st = WISOL_UPLINK_PENDING;
+
+    return 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to make the attempt of the uplink message when it is due.
+ * It returns right away otherwise, and blocks during the attempt.
+ * 
+ * @param now Current time in milliseconds, from any time base that counts
+ *            the time asleep as well (ex. wdt_scheduler_time_ms).
+ * 
+ * @return State of the uplink message.
+ */
+/*****************************************************************************/
+sigfox_wisol_uplink_state
+sigfox_wisol_uplink_poll(uint32_t now)
+{
+    sigfox_wisol_result result;
+
+    if (sigfox_wisol_uplink_st != WISOL_UPLINK_PENDING)
+    {
+        return sigfox_wisol_uplink_st;
+    }
+
+    if (!sigfox_wisol_day_valid)
+    {
+        sigfox_wisol_day_start = now;
+        sigfox_wisol_day_valid = 1;
+    }
+    if ((now - sigfox_wisol_day_start) >= WISOL_DAY_MS)
+    {
+        sigfox_wisol_day_start = now - ((now - sigfox_wisol_day_start) %
+                                        WISOL_DAY_MS);
+        sigfox_wisol_day_uplinks = 0;
+    }
+
+    if (sigfox_wisol_waiting && ((int32_t) (now - sigfox_wisol_due) < 0))
+    {
+        return WISOL_UPLINK_PENDING;
+    }
+
+    // Out of budget, the attempt waits for the next day
+    if (sigfox_wisol_day_uplinks >= WISOL_UPLINKS_PER_DAY)
+    {
+        sigfox_wisol_uplinks.deferred++;
+        sigfox_wisol_due = sigfox_wisol_day_start + WISOL_DAY_MS;
+        sigfox_wisol_waiting = 1;
+        return WISOL_UPLINK_PENDING;
+    }
+
+    if (sigfox_wisol_attempts > 0)
+    {
+        sigfox_wisol_uplinks.retries++;
+    }
+    sigfox_wisol_attempts++;
+
+    result = sigfox_wisol_send_frame(sigfox_wisol_payload,
+                                     sigfox_wisol_payload_size);
+    sigfox_wisol_uplinks.results[result]++;
+    if (result != WISOL_SEND_NOT_READY)
+    {
+        sigfox_wisol_day_uplinks++;
+    }
+
+    if (result == WISOL_SEND_OK)
+    {
+        sigfox_wisol_uplink_st = WISOL_UPLINK_IDLE;
+    }
+    else if (sigfox_wisol_attempts >= WISOL_SEND_ATTEMPTS)
+    {
+        sigfox_wisol_uplinks.dropped++;
+        sigfox_wisol_uplink_st = WISOL_UPLINK_DROPPED;
+    }
+    else
+    {
+        sigfox_wisol_due = now + _sigfox_wisol_backoff(sigfox_wisol_attempts);
+        sigfox_wisol_waiting = 1;
+    }
+
+    return sigfox_wisol_uplink_st;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the time to the next attempt of the uplink message,
+ * to be given to sigfox_wisol_set_next or to a scheduler.
+ * 
+ * @param now Current time in milliseconds, as given to
+ *            sigfox_wisol_uplink_poll.
+ * 
+ * @return Milliseconds, 0 if the attempt is due, WISOL_NEXT_UNKNOWN if no
+ *         message is pending.
+ */
+/*****************************************************************************/
+uint32_t
+sigfox_wisol_uplink_next(uint32_t now)
+{
+    if (sigfox_wisol_uplink_st != WISOL_UPLINK_PENDING)
+    {
+        return WISOL_NEXT_UNKNOWN;
+    }
+    if ( !sigfox_wisol_waiting || ((int32_t) (sigfox_wisol_due - now) <= 0) )
+    {
+        return 0;
+    }
+
+    return sigfox_wisol_due - now;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the counters of the uplink messages.
+ * 
+ * @param stats Pointer to the counters to be filled.
+ * 
+ * @return None.
+ */
+/*****************************************************************************/
+void
+sigfox_wisol_get_uplink_stats(sigfox_wisol_uplink_stats* stats)
+{
+    *stats = sigfox_wisol_uplinks;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to pack the counters of the uplink messages in a payload,
+ * as defined by PAYLOAD_UPLINK_STATS_FIELDS: sent, error, timeout, not
+ * ready, retries, dropped, deferred and frames sent in the budget day, each
+ * saturated at the largest value of its field.
+ * 
+ * @param data Pointer to the payload.
+ * @param size Size of the payload, at least WISOL_UPLINK_STATS_SIZE.
+ * 
+ * @return Number of bytes written, 0 if the payload is too small.
+ */
+/*****************************************************************************/
+uint8_t
+sigfox_wisol_pack_uplink_stats(uint8_t* data, uint8_t size)
+{
+    if (size < WISOL_UPLINK_STATS_SIZE)
+    {
+        return 0;
+    }
+
+    PAYLOAD_UPLINK_STATS_FIELDS(_WISOL_PACK_FIELD)
+
+    return WISOL_UPLINK_STATS_SIZE;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to tell the driver when the next command is due, so the
+ * module is left in the power state that costs the least until then.
+ * 
+ * @param ms Time from the end of every command to the next one in
+ *           milliseconds, WISOL_NEXT_UNKNOWN to power the module off.
+ * 
+ * @return None.
+ * 
+ * \b Example:
+ * @code
+ *      sigfox_wisol_set_next(600000UL);
+ * @endcode
+ * 
+ */
+/*****************************************************************************/
+void
+sigfox_wisol_set_next(uint32_t ms)
+{
+    sigfox_wisol_next = ms;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to power the module off right away, from any power state.
+ * 
+ * @return None.
+ */
+/*****************************************************************************/
+void
+sigfox_wisol_power_down(void)
+{
+    if (sigfox_wisol_state != WISOL_POWER_OFF)
+    {
+        gpio_write_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_LOW);
+        _sigfox_wisol_enter(WISOL_POWER_OFF);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the power state of the module.
+ * 
+ * @return Power state.
+ */
+/*****************************************************************************/
+sigfox_wisol_power
+sigfox_wisol_get_power(void)
+{
+    return sigfox_wisol_state;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the time spent in every power state since the
+ * initialization, up to now.
+ * 
+ * @param stats Pointer to the statistics to be filled.
+ * 
+ * @return None.
+ */
+/*****************************************************************************/
+void
+sigfox_wisol_get_power_stats(sigfox_wisol_power_stats* stats)
+{
+    *stats = sigfox_wisol_stats;
+    stats->ms[sigfox_wisol_state] += tick_get_ms() - sigfox_wisol_since;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to change the power state and to account the time spent in
+ * the previous one.
+ * 
+ * @param state Power state entered.
+ * 
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_sigfox_wisol_enter(sigfox_wisol_power state)
+{
+    uint32_t now = tick_get_ms();
+
+    sigfox_wisol_stats.ms[sigfox_wisol_state] += now - sigfox_wisol_since;
+    sigfox_wisol_since = now;
+    sigfox_wisol_stats.transitions++;
+    if (state == WISOL_POWER_READY)
+    {
+        sigfox_wisol_stats.wakeups++;
+    }
+
+    sigfox_wisol_state = state;
+    TRACE(TRACE_WISOL_POWER, state);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the module ready for a command from its power state.
+ * 
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_sigfox_wisol_wake(void)
+{
+    switch (sigfox_wisol_state)
+    {
+        case WISOL_POWER_READY:
+            return;
+
+        case WISOL_POWER_SLEEP:
+            // The byte that wakes the module up is lost, anything sent
+            // while it wakes up is not an answer to the next command
+            uart_send("\n");
+            _delay_ms(WISOL_SLEEP_WAKEUP_MS);
+            uart_flush();
+            break;
+
+        case WISOL_POWER_DEEP_SLEEP:
+            // Only a restart leaves the deep sleep
+            gpio_write_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_LOW);
+            _delay_ms(1);
+            gpio_write_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_HIGH);
+            _delay_ms(WISOL_POWER_ON_MS);
+            break;
+
+        default:
+            gpio_write_pin(WISOL_EN_PORT, WISOL_EN_PIN, GPIO_PIN_HIGH);
+            _delay_ms(WISOL_POWER_ON_MS);
+            break;
+    }
+
+    _sigfox_wisol_enter(WISOL_POWER_READY);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to leave the module, once a command is answered, in the
+ * power state selected by the time to the next command.
+ * 
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_sigfox_wisol_release(void)
+{
+    sigfox_wisol_power state = WISOL_POWER_OFF;
+
+    if (sigfox_wisol_next < WISOL_IDLE_MS)
+    {
+        return;
+    }
+
+    if (sigfox_wisol_next < WISOL_SLEEP_MS)
+    {
+        state = WISOL_POWER_SLEEP;
+    }
+    else if (sigfox_wisol_next < WISOL_DEEP_SLEEP_MS)
+    {
+        state = WISOL_POWER_DEEP_SLEEP;
+    }
+
+    // A module that does not accept AT$P is powered off
+    if ( (state != WISOL_POWER_OFF) &&
+         _sigfox_wisol_set_power_mode((state == WISOL_POWER_SLEEP) ? 1 : 2) )
+    {
+        _sigfox_wisol_enter(state);
+    }
+    else
+    {
+        sigfox_wisol_power_down();
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send AT$P and to wait for its answer.
+ * 
+ * @param mode Power mode, 1 for sleep and 2 for deep sleep.
+ * 
+ * @return 1 if the module accepted the mode, 0 otherwise.
+ */
+/*****************************************************************************/
+static uint8_t
+_sigfox_wisol_set_power_mode(uint8_t mode)
+{
+    char cmd[] = "AT$P=0\n";
+
+    cmd[5] = (char) ('0' + mode);
+
+    return _sigfox_wisol_command(WISOL_CMD_SET_POWER_MODE, cmd,
+                                 WISOL_RESPONSE_TIMEOUT) == WISOL_SEND_OK;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send a command and to classify the first line of its
+ * answer.
+ * 
+ * @param index Index of the command in the trace.
+ * @param cmd Command line.
+ * @param timeout Maximum time to wait for the answer in milliseconds.
+ * 
+ * @return WISOL_SEND_OK if the answer is OK, WISOL_SEND_ERROR if it is
+ *         another line or WISOL_SEND_TIMEOUT if there is no answer.
+ */
+/*****************************************************************************/
+static sigfox_wisol_result
+_sigfox_wisol_command(uint8_t index, const char* cmd, uint16_t timeout)
+{
+    wisol_token token;
+
+    TRACE(TRACE_WISOL_CMD, index);
+    uart_send(cmd);
+
+    switch (_sigfox_wisol_response(&token, timeout))
+    {
+        case WISOL_TOKEN_OK:
+            return WISOL_SEND_OK;
+
+        case WISOL_TOKEN_NONE:
+            return WISOL_SEND_TIMEOUT;
+
+        default:
+            return WISOL_SEND_ERROR;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send a command answered with a hexadecimal line, which
+ * is received and decoded in the buffer of the caller.
+ * 
+ * @param index Index of the command.
+ * @param data Pointer to the buffer.
+ * @param size Size of the buffer.
+ * @param count Pointer where the number of decoded bytes will be stored, 0
+ *              if the answer is not a hexadecimal line.
+ * 
+ * @return Type of the answer, WISOL_TOKEN_NONE if there is no answer.
+ */
+/*****************************************************************************/
+static wisol_token_type
+_sigfox_wisol_read_hex(uint8_t index, uint8_t* data, uint8_t size,
+                       uint8_t* count)
+{
+    wisol_token_type type;
+    wisol_token token;
+
+    _sigfox_wisol_wake();
+
+    TRACE(TRACE_WISOL_CMD, index);
+    uart_send(sigfox_wisol_cmds[index]);
+    wisol_parser_set_buffer(data, size);
+    type = _sigfox_wisol_response(&token, WISOL_RESPONSE_TIMEOUT);
+    wisol_parser_set_buffer(NULL, 0);
+
+    *count = (type == WISOL_TOKEN_HEX) ? token.size : 0;
+
+    _sigfox_wisol_release();
+
+    return type;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to wait for the first line of an answer, fed character by
+ * character to the Wisol response parser. The echo of the command is
+ * skipped.
+ * 
+ * @param token Pointer where the line will be written.
+ * @param timeout Maximum time to wait for the line in milliseconds.
+ * 
+ * @return Type of the line, WISOL_TOKEN_NONE if the timeout expired.
+ */
+/*****************************************************************************/
+static wisol_token_type
+_sigfox_wisol_response(wisol_token* token, uint16_t timeout)
+{
+    wisol_token_type type = WISOL_TOKEN_NONE;
+    uint32_t start = tick_get_ms();
+    unsigned char data;
+
+    wisol_parser_init();
+
+    while ((tick_get_ms() - start) < timeout)
+    {
+        if (!uart_try_read_char(&data))
+        {
+            continue;
+        }
+
+        type = wisol_parser_feed(data, token);
+        if ( (type != WISOL_TOKEN_NONE) && (type != WISOL_TOKEN_ECHO) )
+        {
+            break;
+        }
+        type = WISOL_TOKEN_NONE;
+    }
+    TRACE(TRACE_WISOL_RESPONSE, type);
+
+    return type;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the wait before a retry: the base wait doubled on
+ * every attempt, up to the maximum, of which a random part of up to a half
+ * is taken away.
+ * 
+ * @param attempts Attempts made.
+ * 
+ * @return Milliseconds.
+ */
+/*****************************************************************************/
+static uint32_t
+_sigfox_wisol_backoff(uint8_t attempts)
+{
+    uint32_t wait = WISOL_RETRY_BASE_MS;
+    uint16_t x = sigfox_wisol_random;
+
+    while ( (--attempts > 0) && (wait < WISOL_RETRY_MAX_MS) )
+    {
+        wait <<= 1;
+    }
+    if (wait > WISOL_RETRY_MAX_MS)
+    {
+        wait = WISOL_RETRY_MAX_MS;
+    }
+
+    // Xorshift, never 0 once seeded
+    x ^= x << 7;
+    x ^= x >> 9;
+    x ^= x << 8;
+    sigfox_wisol_random = x;
+
+    return wait - (((wait / 2) >> 8) * (x & 0xFF));
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to saturate a counter at the largest value of a field.
+ * 
+ * @param value Counter.
+ * @param bits Bits of the field, up to 16.
+ * 
+ * @return Value of the field.
+ */
+/*****************************************************************************/
+static uint32_t
+_sigfox_wisol_saturate(uint16_t value, uint8_t bits)
+{
+    uint32_t max = (1UL << bits) - 1;
+
+    return (value > max) ? max : value;
 }
 
 /*****************************************************************************/
@@ -0,0 +1,479 @@
+/******************************************************************************
+* Title                 :   Software UART source file
+* Filename              :   soft_uart.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        soft_uart.c
+ *  @brief       Software UART implementation
+ *
+ *  To use the software UART, include this header file as follows:
+ *  @code
+ *      #include "soft_uart.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The software UART implements a second full duplex serial port on the
+ *  header pins D2 to D5, so the application can print diagnostics while the
+ *  UART talks to the Sigfox Wisol module. The frames have 8 data bits, no
+ *  parity and 1 stop bit.
+ *
+ *  The bits are timed by Timer2 running free with a prescaler of 32 (2 us per
+ *  count at 16 MHz), no delay loop is used:
+ *      - TX: the compare match A interrupt writes a bit of the TX buffer to
+ *        the TX pin and moves OCR2A one bit period ahead. The interrupt is
+ *        enabled only while there are bytes to send.
+ *      - RX: the pin change interrupt detects the falling edge of the start
+ *        bit, then the compare match B interrupt samples every bit in the
+ *        middle and stores the bytes in the RX buffer.
+ *
+ *  Only one interrupt is executed per bit and direction, so at 19200 bauds
+ *  the main loop keeps most of the CPU. The bits are written by the
+ *  interrupt, so they have the jitter of the interrupt latency, a few
+ *  microseconds.
+ *
+ *  @note The driver uses Timer2 and the PCINT2_vect interrupt, so they can
+ *        not be used by the application and the rest of the PORTD pins
+ *        can not use the pin change interrupts.
+ *
+ *  ## Usage ##
+ *
+ *  To use the software UART, the driver must be first initialized using the
+ *  soft_uart_init function and the global interrupts must be enabled.
+ *
+ *  @code
+ *      #include "soft_uart.h"
+ *
+ *      unsigned char data;
+ *
+ *      soft_uart_init();
+ *      sei();
+ *
+ *      soft_uart_send("Hello from NXTIOT board!\n");
+ *
+ *      while (1)
+ *      {
+ *          if (soft_uart_try_read_char(&data))
+ *          {
+ *              soft_uart_write(&data, 1);
+ *          }
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "soft_uart.h"
+#include "isr_profile.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Timer2 prescaler */
+#define SOFT_UART_PRESCALER     32UL
+/*! Timer2 counts in a bit */
+#define BIT_TICKS               ((F_CPU / SOFT_UART_PRESCALER + \
+                                  SOFT_UART_BAUD / 2) / SOFT_UART_BAUD)
+/*! Timer2 counts from the start bit edge to the middle of the first bit */
+#define START_TICKS             (BIT_TICKS + BIT_TICKS / 2)
+/*! TX state used to load the next byte */
+#define TX_NEXT_BYTE            10
+
+#if (START_TICKS > 255) || (BIT_TICKS < 10)
+    #error "SOFT_UART_BAUD out of range"
+#endif
+
+#if (SOFT_UART_TX_PIN < PD2) || (SOFT_UART_TX_PIN > PD5) || \
+    (SOFT_UART_RX_PIN < PD2) || (SOFT_UART_RX_PIN > PD5) || \
+    (SOFT_UART_TX_PIN == SOFT_UART_RX_PIN)
+    #error "The software UART pins must be two of D2_PIN to D5_PIN"
+#endif
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! Macro used to wrap an index of the TX buffer */
+#define TX_WRAP(index)  ((index) & (SOFT_UART_TX_BUFFER_SIZE - 1))
+/*! Macro used to wrap an index of the RX buffer */
+#define RX_WRAP(index)  ((index) & (SOFT_UART_RX_BUFFER_SIZE - 1))
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Bytes waiting to be sent */
+static volatile uint8_t soft_uart_tx_buffer[SOFT_UART_TX_BUFFER_SIZE];
+/*! Index where the next byte to be sent is written */
+static volatile uint8_t soft_uart_tx_head;
+/*! Index of the next byte to be sent */
+static volatile uint8_t soft_uart_tx_tail;
+/*! Byte being sent, shifted one bit at a time */
+static volatile uint8_t soft_uart_tx_byte;
+/*! Bit being sent: start bit 0, data bits 1 to 8 and stop bit 9 */
+static volatile uint8_t soft_uart_tx_state;
+
+/*! Bytes received */
+static volatile uint8_t soft_uart_rx_buffer[SOFT_UART_RX_BUFFER_SIZE];
+/*! Index where the next received byte is written */
+static volatile uint8_t soft_uart_rx_head;
+/*! Index of the next byte to be read */
+static volatile uint8_t soft_uart_rx_tail;
+/*! Byte being received */
+static volatile uint8_t soft_uart_rx_byte;
+/*! Number of bits of the byte received */
+static volatile uint8_t soft_uart_rx_state;
+
+/*! Frames with an invalid stop bit and bytes lost with the RX buffer full */
+static volatile uint16_t soft_uart_error_count;
+
+_Static_assert(sizeof(soft_uart_tx_buffer) + sizeof(soft_uart_rx_buffer) ==
+               SOFT_UART_RAM_SIZE,
+               "SOFT_UART_RAM_SIZE does not match the buffers");
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup soft_uart
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize the software UART.
+ *
+ * The TX pin is configured as output in the idle (high) state, the RX pin as
+ * input with pull-up, Timer2 is started in normal mode and the pin change
+ * interrupt of the RX pin is enabled.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      soft_uart_init();
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+soft_uart_init(void)
+{
+    soft_uart_tx_head = 0;
+    soft_uart_tx_tail = 0;
+    soft_uart_rx_head = 0;
+    soft_uart_rx_tail = 0;
+    soft_uart_error_count = 0;
+
+    // TX idle high, RX with pull-up
+    PORTD |= _BV(SOFT_UART_TX_PIN);
+    DDRD |= _BV(SOFT_UART_TX_PIN);
+    DDRD &= ~_BV(SOFT_UART_RX_PIN);
+    PORTD |= _BV(SOFT_UART_RX_PIN);
+
+    // Timer2 in normal mode with a prescaler of 32, interrupts disabled
+    TIMSK2 &= ~(_BV(OCIE2A) | _BV(OCIE2B) | _BV(TOIE2));
+    TCCR2A = 0;
+    TCCR2B = _BV(CS21) | _BV(CS20);
+
+    // Pin change interrupt of the RX pin, detects the start bit
+    PCMSK2 |= _BV(SOFT_UART_RX_PIN);
+    PCIFR = _BV(PCIF2);
+    PCICR |= _BV(PCIE2);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to queue bytes to be sent.
+ *
+ * This function does not wait, the bytes that do not fit in the TX buffer
+ * are not queued.
+ *
+ * @param data Pointer to the bytes to be sent.
+ * @param size Number of bytes to be sent.
+ *
+ * @return Number of bytes queued.
+ *
+ * \b Example:
+ * @code
+ *      uint8_t frame[] = {0x01, 0x02};
+ *
+ *      if (soft_uart_write(frame, sizeof(frame)) < sizeof(frame))
+ *      {
+ *          // TX buffer full
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+uint8_t
+soft_uart_write(const uint8_t* data, uint8_t size)
+{
+    uint8_t queued = 0;
+    uint8_t head = soft_uart_tx_head;
+    uint8_t sreg;
+
+    while ( (queued < size) && (TX_WRAP(head + 1) != soft_uart_tx_tail) )
+    {
+        soft_uart_tx_buffer[head] = data[queued++];
+        head = TX_WRAP(head + 1);
+    }
+
+    sreg = SREG;
+    cli();
+    ISR_PROFILE_ENTER(ISR_PROFILE_CS_SOFT_UART);
+    soft_uart_tx_head = head;
+
+    // Start the transmission a few counts from now if it is stopped
+    if ( (queued > 0) && !(TIMSK2 & _BV(OCIE2A)) )
+    {
+        soft_uart_tx_state = TX_NEXT_BYTE;
+        OCR2A = TCNT2 + 4;
+        TIFR2 = _BV(OCF2A);
+        TIMSK2 |= _BV(OCIE2A);
+    }
+    ISR_PROFILE_EXIT(ISR_PROFILE_CS_SOFT_UART);
+    SREG = sreg;
+
+    return queued;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send a string.
+ *
+ * This function only waits when the TX buffer is full.
+ *
+ * @pre The global interrupts must be enabled.
+ *
+ * @param str Pointer to the string to be sent. Must be NULL terminated.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      soft_uart_send("Hello!\n");
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+soft_uart_send(const char* str)
+{
+    while (*str != 0x00)
+    {
+        str += soft_uart_write((const uint8_t *) str, 1);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of bytes waiting to be sent.
+ *
+ * @return Number of bytes in the TX buffer, or 1 while the last byte is
+ *         being sent.
+ */
+/*****************************************************************************/
+uint8_t
+soft_uart_tx_pending(void)
+{
+    uint8_t pending = TX_WRAP(soft_uart_tx_head - soft_uart_tx_tail);
+
+    if ( (pending == 0) && (TIMSK2 & _BV(OCIE2A)) )
+    {
+        pending = 1;
+    }
+
+    return pending;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read a received byte without waiting.
+ *
+ * @param data Pointer where the byte will be written.
+ *
+ * @return 1 if a byte was read, 0 if the RX buffer is empty.
+ */
+/*****************************************************************************/
+uint8_t
+soft_uart_try_read_char(unsigned char* data)
+{
+    uint8_t tail = soft_uart_rx_tail;
+
+    if (tail == soft_uart_rx_head)
+    {
+        return 0;
+    }
+
+    *data = soft_uart_rx_buffer[tail];
+    soft_uart_rx_tail = RX_WRAP(tail + 1);
+
+    return 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of received bytes available to be read.
+ *
+ * @return Number of bytes in the RX buffer.
+ */
+/*****************************************************************************/
+uint8_t
+soft_uart_available(void)
+{
+    return RX_WRAP(soft_uart_rx_head - soft_uart_rx_tail);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of receive errors.
+ *
+ * @return Number of frames with an invalid stop bit and of bytes lost
+ *         because the RX buffer was full.
+ */
+/*****************************************************************************/
+uint16_t
+soft_uart_errors(void)
+{
+    uint16_t errors;
+    uint8_t sreg = SREG;
+
+    cli();
+    ISR_PROFILE_ENTER(ISR_PROFILE_CS_SOFT_UART);
+    errors = soft_uart_error_count;
+    ISR_PROFILE_EXIT(ISR_PROFILE_CS_SOFT_UART);
+    SREG = sreg;
+
+    return errors;
+}
+
+/*****************************************************************************/
+/*!
+ * Timer2 compare match A interrupt, sends a bit.
+ */
+/*****************************************************************************/
+ISR_PROFILED(TIMER2_COMPA_vect, ISR_PROFILE_SOFT_UART_TX)
+{
+    uint8_t state = soft_uart_tx_state;
+    uint8_t tail;
+
+    OCR2A += BIT_TICKS;
+
+    if (state == TX_NEXT_BYTE)
+    {
+        tail = soft_uart_tx_tail;
+        if (tail == soft_uart_tx_head)
+        {
+            // Nothing else to send, the line stays in the stop bit state
+            TIMSK2 &= ~_BV(OCIE2A);
+            return;
+        }
+
+        soft_uart_tx_byte = soft_uart_tx_buffer[tail];
+        soft_uart_tx_tail = TX_WRAP(tail + 1);
+        state = 0;
+    }
+
+    if (state == 0)
+    {
+        PORTD &= ~_BV(SOFT_UART_TX_PIN);
+    }
+    else if (state <= 8)
+    {
+        if (soft_uart_tx_byte & 0x01)
+        {
+            PORTD |= _BV(SOFT_UART_TX_PIN);
+        }
+        else
+        {
+            PORTD &= ~_BV(SOFT_UART_TX_PIN);
+        }
+        soft_uart_tx_byte >>= 1;
+    }
+    else
+    {
+        PORTD |= _BV(SOFT_UART_TX_PIN);
+    }
+
+    soft_uart_tx_state = state + 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Pin change interrupt of PORTD, detects the start bit.
+ */
+/*****************************************************************************/
+ISR_PROFILED(PCINT2_vect, ISR_PROFILE_SOFT_UART_START)
+{
+    if ( !(PIND & _BV(SOFT_UART_RX_PIN)) )
+    {
+        // Sample the first data bit in its middle
+        OCR2B = TCNT2 + START_TICKS;
+        TIFR2 = _BV(OCF2B);
+        TIMSK2 |= _BV(OCIE2B);
+
+        PCMSK2 &= ~_BV(SOFT_UART_RX_PIN);
+        soft_uart_rx_state = 0;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Timer2 compare match B interrupt, samples a received bit.
+ */
+/*****************************************************************************/
+ISR_PROFILED(TIMER2_COMPB_vect, ISR_PROFILE_SOFT_UART_RX)
+{
+    uint8_t state = soft_uart_rx_state;
+    uint8_t level = PIND & _BV(SOFT_UART_RX_PIN);
+    uint8_t head;
+    uint8_t next;
+
+    OCR2B += BIT_TICKS;
+
+    if (state < 8)
+    {
+        soft_uart_rx_byte = (soft_uart_rx_byte >> 1) | (level ? 0x80 : 0x00);
+        soft_uart_rx_state = state + 1;
+        return;
+    }
+
+    // Stop bit
+    head = soft_uart_rx_head;
+    next = RX_WRAP(head + 1);
+    if ( level && (next != soft_uart_rx_tail) )
+    {
+        soft_uart_rx_buffer[head] = soft_uart_rx_byte;
+        soft_uart_rx_head = next;
+    }
+    else
+    {
+        soft_uart_error_count++;
+    }
+
+    // Wait for the next start bit
+    TIMSK2 &= ~_BV(OCIE2B);
+    PCIFR = _BV(PCIF2);
+    PCMSK2 |= _BV(SOFT_UART_RX_PIN);
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
@@ -0,0 +1,392 @@
+/******************************************************************************
+* Title                 :   SPI source file
+* Filename              :   spi.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        spi.c
+ *  @brief       SPI driver implementation
+ *
+ *  To use the SPI driver, include this header file as follows:
+ *  @code
+ *      #include "spi.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The SPI driver implements a master driven by the SPI transfer complete
+ *  interrupt, so the bytes of a transaction are transferred while the main
+ *  loop keeps running.
+ *
+ *  Every device has its own chip select pin, clock, mode and bit order,
+ *  which are applied when a transaction of the device starts. The
+ *  transactions are queued in a linked list of the transactions submitted,
+ *  which are owned by the caller, so no memory is allocated by the driver.
+ *  When a transaction is completed its status changes to SPI_DONE, the
+ *  callback is executed and the next transaction is started.
+ *
+ *  A transaction with the SPI_KEEP_CS flag keeps the chip select asserted,
+ *  so the command and the data of a device can be sent in two transactions
+ *  submitted one after the other.
+ *
+ *  ## Usage ##
+ *
+ *  To use the SPI driver, the driver must be first initialized using the
+ *  spi_init function, the devices with the spi_device_init function and the
+ *  global interrupts must be enabled.
+ *
+ *  @code
+ *      #include "spi.h"
+ *
+ *      spi_device sensor;
+ *      spi_transaction read = {0};
+ *      uint8_t tx[3] = {0x80, 0x00, 0x00};
+ *      uint8_t rx[3];
+ *
+ *      spi_init();
+ *      spi_device_init(&sensor, B1_PORT, B1_PIN, 1000000, SPI_MODE_0,
+ *                      SPI_MSB_FIRST);
+ *      sei();
+ *
+ *      read.device = &sensor;
+ *      read.tx = tx;
+ *      read.rx = rx;
+ *      read.size = sizeof(tx);
+ *      read.flags = 0;
+ *      read.callback = NULL;
+ *      spi_submit(&read);
+ *
+ *      while (read.status != SPI_DONE)
+ *      {
+ *          // Other work
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "spi.h"
+#include "isr_profile.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! SPI SS pin number */
+#define SPI_SS_PIN      PB2
+/*! SPI MOSI pin number */
+#define SPI_MOSI_PIN    PB3
+/*! SPI MISO pin number */
+#define SPI_MISO_PIN    PB4
+/*! SPI SCK pin number */
+#define SPI_SCK_PIN     PB5
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Transaction in progress, first of the queue */
+static spi_transaction* volatile spi_head;
+/*! Last transaction of the queue */
+static spi_transaction* volatile spi_tail;
+/*! Index of the byte being transferred */
+static volatile uint16_t spi_index;
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static void _spi_start(spi_transaction* transaction);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup spi
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize the SPI driver.
+ *
+ * The MOSI, SCK and SS pins are configured as outputs and the SPI is enabled
+ * in master mode. The SS pin (PB2) must stay as output to keep the master
+ * mode, it can be used as the chip select of a device.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      spi_init();
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+spi_init(void)
+{
+    spi_head = NULL;
+    spi_tail = NULL;
+
+    PORTB |= _BV(SPI_SS_PIN);
+    DDRB |= _BV(SPI_SS_PIN) | _BV(SPI_MOSI_PIN) | _BV(SPI_SCK_PIN);
+    DDRB &= ~_BV(SPI_MISO_PIN);
+
+    SPCR = _BV(SPE) | _BV(MSTR);
+    SPSR = 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize a SPI device.
+ *
+ * The chip select pin is configured as output in the high (deasserted)
+ * state. The clock is the highest one, from F_CPU/2 to F_CPU/128, not
+ * greater than the requested clock.
+ *
+ * @param device Pointer to the device to be initialized.
+ * @param cs_port Chip select pin port address (ex. &PORTB).
+ * @param cs_pin Chip select pin number (ex. PB1).
+ * @param clock Maximum clock of the device in Hz.
+ * @param mode Clock polarity and phase: SPI_MODE_0 to SPI_MODE_3.
+ * @param order Bit order: SPI_MSB_FIRST or SPI_LSB_FIRST.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      spi_device flash;
+ *
+ *      spi_device_init(&flash, B1_PORT, B1_PIN, 8000000, SPI_MODE_0,
+ *                      SPI_MSB_FIRST);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+spi_device_init(spi_device* device, uint8_t* cs_port, uint8_t cs_pin,
+                uint32_t clock, spi_mode mode, spi_bit_order order)
+{
+    uint8_t shift = 1;
+
+    device->cs.port = cs_port;
+    device->cs.pin = cs_pin;
+
+    gpio_write_pin(cs_port, cs_pin, GPIO_PIN_HIGH);
+    gpio_init_pin(cs_port, cs_pin, GPIO_PIN_OUTPUT);
+
+    // F_CPU is divided by 2 to the shift, from 2 to 128
+    while ( (shift < 7) && (((uint32_t) F_CPU >> shift) > clock) )
+    {
+        shift++;
+    }
+
+    device->spcr = _BV(SPIE) | _BV(SPE) | _BV(MSTR);
+    device->spsr = 0;
+
+    if (shift == 7)
+    {
+        device->spcr |= _BV(SPR1) | _BV(SPR0);
+    }
+    else
+    {
+        // The dividers 2, 8 and 32 are 4, 16 and 64 with double speed
+        device->spcr |= ((shift - 1) >> 1) & (_BV(SPR1) | _BV(SPR0));
+        if (shift & 0x01)
+        {
+            device->spsr = _BV(SPI2X);
+        }
+    }
+
+    if (mode & 0x01)
+    {
+        device->spcr |= _BV(CPHA);
+    }
+    if (mode & 0x02)
+    {
+        device->spcr |= _BV(CPOL);
+    }
+    if (order == SPI_LSB_FIRST)
+    {
+        device->spcr |= _BV(DORD);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to queue a transaction.
+ *
+ * The transaction starts at once if the SPI is idle. The tx or rx buffers
+ * can be NULL to only receive (SPI_FILL_BYTE is sent) or only send. A
+ * transaction without bytes is completed at once.
+ *
+ * @pre The device, tx, rx, size, flags and callback of the transaction must
+ *      be set. The status of a new transaction must be SPI_DONE, as it is
+ *      when the transaction is zero initialized.
+ *
+ * @param transaction Pointer to the transaction.
+ *
+ * @return SPI_PENDING if the transaction was queued, SPI_DONE if it has no
+ *         bytes or SPI_BUSY if it is already queued.
+ *
+ * \b Example:
+ * @code
+ *      if (spi_submit(&read) == SPI_BUSY)
+ *      {
+ *          // The previous read is not completed
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+spi_status
+spi_submit(spi_transaction* transaction)
+{
+    uint8_t sreg;
+
+    if (transaction->status == SPI_PENDING)
+    {
+        return SPI_BUSY;
+    }
+
+    if (transaction->size == 0)
+    {
+        transaction->status = SPI_DONE;
+        if (transaction->callback != NULL)
+        {
+            transaction->callback(transaction);
+        }
+
+        return SPI_DONE;
+    }
+
+    transaction->status = SPI_PENDING;
+    transaction->next = NULL;
+
+    sreg = SREG;
+    cli();
+    ISR_PROFILE_ENTER(ISR_PROFILE_CS_SPI);
+    if (spi_head == NULL)
+    {
+        spi_head = transaction;
+        spi_tail = transaction;
+        _spi_start(transaction);
+    }
+    else
+    {
+        spi_tail->next = transaction;
+        spi_tail = transaction;
+    }
+    ISR_PROFILE_EXIT(ISR_PROFILE_CS_SPI);
+    SREG = sreg;
+
+    return SPI_PENDING;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to check if there are transactions in progress.
+ *
+ * @return 1 if a transaction is in progress, 0 otherwise.
+ */
+/*****************************************************************************/
+uint8_t
+spi_busy(void)
+{
+    return (spi_head != NULL);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to start a transaction.
+ *
+ * The settings of the device are applied before the chip select is asserted
+ * and the first byte is sent.
+ *
+ * @param transaction Pointer to the transaction.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_spi_start(spi_transaction* transaction)
+{
+    const spi_device* device = transaction->device;
+
+    SPCR = device->spcr;
+    SPSR = device->spsr;
+    gpio_write_pin(device->cs.port, device->cs.pin, GPIO_PIN_LOW);
+
+    spi_index = 0;
+    SPDR = (transaction->tx != NULL) ? transaction->tx[0] : SPI_FILL_BYTE;
+}
+
+/*****************************************************************************/
+/*!
+ * SPI transfer complete interrupt.
+ */
+/*****************************************************************************/
+ISR_PROFILED(SPI_STC_vect, ISR_PROFILE_SPI)
+{
+    spi_transaction* transaction = spi_head;
+    uint16_t index = spi_index;
+    uint8_t data = SPDR;
+
+    if (transaction == NULL)
+    {
+        return;
+    }
+
+    if (transaction->rx != NULL)
+    {
+        transaction->rx[index] = data;
+    }
+
+    index++;
+    if (index < transaction->size)
+    {
+        spi_index = index;
+        SPDR = (transaction->tx != NULL) ? transaction->tx[index] :
+                                           SPI_FILL_BYTE;
+        return;
+    }
+
+    if ( !(transaction->flags & SPI_KEEP_CS) )
+    {
+        gpio_write_pin(transaction->device->cs.port,
+                       transaction->device->cs.pin, GPIO_PIN_HIGH);
+    }
+
+    // The next transaction starts before the callback, which can queue a
+    // new one
+    spi_head = transaction->next;
+    if (spi_head != NULL)
+    {
+        _spi_start(spi_head);
+    }
+
+    transaction->status = SPI_DONE;
+    if (transaction->callback != NULL)
+    {
+        transaction->callback(transaction);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
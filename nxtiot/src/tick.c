@@ -0,0 +1,163 @@
+/******************************************************************************
+* Title                 :   Tick driver source file 
+* Filename              :   tick.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        tick.c
+ *  @brief       Tick driver implementation
+ *
+ *  To use the tick driver, include this header file as follows:
+ *  @code
+ *      #include "tick.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The tick driver implements a millisecond time base used by the drivers to
+ *  measure timeouts. Timer0 is used in CTC mode with a prescaler of 64, so
+ *  the compare match interrupt is executed every millisecond.
+ *
+ *  ## Usage ##
+ *
+ *  To use the tick driver, the driver must be first initialized using the
+ *  tick_init function and the global interrupts must be enabled.
+ * 
+ *  The following code example waits 10 milliseconds.
+ * 
+ *  @code
+ *      #include "tick.h"
+ *
+ *      uint32_t start;
+ *
+ *      tick_init();
+ *      sei();
+ *
+ *      start = tick_get_ms();
+ *      while ((tick_get_ms() - start) < 10);
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "tick.h"
+#include "isr_profile.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Timer0 prescaler */
+#define TICK_PRESCALER  64UL
+/*! Timer0 compare value for a 1 ms period */
+#define TICK_COMPARE    ((F_CPU / (TICK_PRESCALER * 1000UL)) - 1)
+
+#if TICK_COMPARE > 255
+    #error "F_CPU too high for a 1 ms period on the 8 bit Timer0"
+#endif
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Milliseconds elapsed since the driver was initialized */
+static volatile uint32_t tick_ms;
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup tick
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize the tick driver.
+ * 
+ * Timer0 is configured in CTC mode with a period of 1 ms and the compare
+ * match A interrupt is enabled.
+ * 
+ * @return None.
+ * 
+ * \b Example:
+ * @code
+ *      tick_init();
+ * @endcode
+ * 
+ */
+/*****************************************************************************/
+void
+tick_init(void)
+{
+    tick_ms = 0;
+
+    // CTC mode, TOP = OCR0A
+    TCCR0A = _BV(WGM01);
+    OCR0A = TICK_COMPARE;
+    TCNT0 = 0;
+
+    // Enable compare match A interrupt
+    TIFR0 = _BV(OCF0A);
+    TIMSK0 |= _BV(OCIE0A);
+
+    // Start the timer with a prescaler of 64
+    TCCR0B = _BV(CS01) | _BV(CS00);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the milliseconds elapsed since the driver was 
+ * initialized.
+ * 
+ * @return Milliseconds elapsed, wraps around after 49 days.
+ */
+/*****************************************************************************/
+uint32_t
+tick_get_ms(void)
+{
+    uint32_t ms;
+    uint8_t sreg = SREG;
+
+    // The counter is read with the interrupts disabled to get a coherent value
+    cli();
+    ISR_PROFILE_ENTER(ISR_PROFILE_CS_TICK);
+    ms = tick_ms;
+    ISR_PROFILE_EXIT(ISR_PROFILE_CS_TICK);
+    SREG = sreg;
+
+    return ms;
+}
+
+/*****************************************************************************/
+/*!
+ * Timer0 compare match A interrupt.
+ */
+/*****************************************************************************/
+ISR_PROFILED(TIMER0_COMPA_vect, ISR_PROFILE_TICK)
+{
+    tick_ms++;
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
@@ -0,0 +1,330 @@
+/******************************************************************************
+* Title                 :   Trace source file
+* Filename              :   trace.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        trace.c
+ *  @brief       Trace implementation
+ *
+ *  To use the trace, include this header file as follows:
+ *  @code
+ *      #include "trace.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The trace records the events of the drivers and the application in a ring
+ *  buffer of binary records: a timestamp, an event identifier and a 16 bit
+ *  argument. Recording an event only stores 6 bytes with the interrupts
+ *  disabled, so it can be done from the interrupts without changing the
+ *  timing of the firmware as the debug messages sent through the UART do.
+ *
+ *  When the buffer is full the oldest records are overwritten, so the buffer
+ *  always holds the last events before a failure. The records are sent on
+ *  demand through the UART with the trace_dump function and the trace_decode
+ *  tool (tools/trace_decode) turns the dump into a timeline.
+ *
+ *  The drivers record their events with the TRACE macro, which is removed
+ *  by the preprocessor unless TRACE_ENABLE is defined to 1.
+ *
+ *  The dump is made of a header and the records from the oldest to the
+ *  newest, all the values are little endian:
+ *      - 'T', 'R'          Magic
+ *      - count             Number of records (1 byte)
+ *      - sub per ms        Timer0 steps per millisecond (1 byte, up to 255)
+ *      - dropped           Records overwritten or lost (2 bytes)
+ *      - ms, sub, id, arg  Records (6 bytes each)
+ *
+ *  ## Usage ##
+ *
+ *  To use the trace, the tick must be initialized and TRACE_ENABLE defined
+ *  to 1 when building the drivers and the application (-DTRACE_ENABLE=1).
+ *
+ *  @code
+ *      #include "trace.h"
+ *
+ *      tick_init();
+ *      uart_init();
+ *      sei();
+ *
+ *      TRACE(TRACE_USER, 1);
+ *      ...
+ *      if (failure)
+ *      {
+ *          trace_dump();
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "trace.h"
+#include "uart.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Timer0 steps in a millisecond, the tick uses OCR0A as TOP */
+#define TRACE_SUB_PER_MS    ((F_CPU / (64UL * 1000UL)))
+
+// The steps are sent in a byte of the header and of every record
+#if TRACE_SUB_PER_MS > 255
+    #error "F_CPU too high, the Timer0 steps of a millisecond exceed a byte"
+#endif
+
+#if (TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) || (TRACE_BUFFER_SIZE > 128)
+    #error "TRACE_BUFFER_SIZE must be a power of 2 not greater than 128"
+#endif
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! Macro used to wrap an index of the trace buffer */
+#define TRACE_WRAP(index)   ((index) & (TRACE_BUFFER_SIZE - 1))
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Records of the trace */
+static trace_record trace_buffer[TRACE_BUFFER_SIZE];
+/*! Index where the next record is written */
+static volatile uint8_t trace_head;
+/*! Number of records in the buffer */
+static volatile uint8_t trace_records;
+/*! Number of records overwritten or lost during a dump */
+static volatile uint16_t trace_lost;
+/*! Flag set while the trace is being dumped */
+static volatile uint8_t trace_frozen;
+
+_Static_assert(sizeof(trace_buffer) == TRACE_RAM_SIZE,
+               "TRACE_RAM_SIZE does not match the buffers");
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup trace
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to remove all the records of the trace.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+trace_clear(void)
+{
+    uint8_t sreg = SREG;
+
+    cli();
+    trace_head = 0;
+    trace_records = 0;
+    trace_lost = 0;
+    trace_frozen = 0;
+    SREG = sreg;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to record an event.
+ *
+ * This function can be called from the interrupts. The drivers use the
+ * TRACE macro instead, so the call is removed when the trace is disabled.
+ *
+ * @param id Event identifier, one of trace_event_id or from TRACE_USER.
+ * @param arg Argument of the event.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      trace_event(TRACE_USER + 1, adc_value);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+trace_event(uint8_t id, uint16_t arg)
+{
+    trace_record* record;
+    uint8_t sreg = SREG;
+    uint8_t sub;
+    uint16_t ms;
+
+    cli();
+
+    if (trace_frozen)
+    {
+        trace_lost++;
+        SREG = sreg;
+        return;
+    }
+
+    sub = TCNT0;
+    ms = (uint16_t) tick_get_ms();
+
+    // A compare match not serviced yet belongs to the next millisecond, the
+    // counter is checked in case the match happened after it was read
+    if ( (TIFR0 & _BV(OCF0A)) && (sub < (TRACE_SUB_PER_MS / 2)) )
+    {
+        ms++;
+    }
+
+    record = &trace_buffer[trace_head];
+    record->ms = ms;
+    record->sub = sub;
+    record->id = id;
+    record->arg = arg;
+
+    trace_head = TRACE_WRAP(trace_head + 1);
+    if (trace_records < TRACE_BUFFER_SIZE)
+    {
+        trace_records++;
+    }
+    else
+    {
+        trace_lost++;
+    }
+
+    SREG = sreg;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of records in the trace.
+ *
+ * @return Number of records.
+ */
+/*****************************************************************************/
+uint8_t
+trace_count(void)
+{
+    return trace_records;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of records overwritten or lost while the
+ * trace was dumped.
+ *
+ * @return Number of dropped records.
+ */
+/*****************************************************************************/
+uint16_t
+trace_dropped(void)
+{
+    uint16_t lost;
+    uint8_t sreg = SREG;
+
+    cli();
+    lost = trace_lost;
+    SREG = sreg;
+
+    return lost;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read a record of the trace.
+ *
+ * @param index Index of the record, 0 is the oldest.
+ * @param record Pointer where the record will be written.
+ *
+ * @return 1 if the record was read, 0 if there is no record at the index.
+ */
+/*****************************************************************************/
+uint8_t
+trace_get(uint8_t index, trace_record* record)
+{
+    uint8_t found = 0;
+    uint8_t sreg = SREG;
+
+    cli();
+    if (index < trace_records)
+    {
+        *record = trace_buffer[TRACE_WRAP(trace_head - trace_records + index)];
+        found = 1;
+    }
+    SREG = sreg;
+
+    return found;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to send the trace through the UART.
+ *
+ * The records are sent in binary from the oldest to the newest and are kept
+ * in the buffer. The events recorded while the trace is sent are lost and
+ * counted as dropped.
+ *
+ * @pre The UART must be initialized using the uart_init function.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+trace_dump(void)
+{
+    trace_record record;
+    uint8_t header[TRACE_HEADER_SIZE];
+    uint8_t data[TRACE_RECORD_SIZE];
+    uint8_t count;
+    uint16_t lost;
+    uint8_t sreg = SREG;
+
+    cli();
+    trace_frozen = 1;
+    count = trace_records;
+    lost = trace_lost;
+    SREG = sreg;
+
+    header[0] = TRACE_MAGIC_0;
+    header[1] = TRACE_MAGIC_1;
+    header[2] = count;
+    header[3] = TRACE_SUB_PER_MS;
+    header[4] = (uint8_t) lost;
+    header[5] = (uint8_t) (lost >> 8);
+    uart_write(header, sizeof(header));
+
+    // The buffer does not change while it is frozen
+    for (uint8_t i = 0; i < count; i++)
+    {
+        record = trace_buffer[TRACE_WRAP(trace_head - count + i)];
+
+        data[0] = (uint8_t) record.ms;
+        data[1] = (uint8_t) (record.ms >> 8);
+        data[2] = record.sub;
+        data[3] = record.id;
+        data[4] = (uint8_t) record.arg;
+        data[5] = (uint8_t) (record.arg >> 8);
+        uart_write(data, sizeof(data));
+    }
+
+    trace_frozen = 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
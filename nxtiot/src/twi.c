@@ -0,0 +1,515 @@
+/******************************************************************************
+* Title                 :   TWI source file
+* Filename              :   twi.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        twi.c
+ *  @brief       TWI driver implementation
+ *
+ *  To use the TWI driver, include this header file as follows:
+ *  @code
+ *      #include "twi.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The TWI driver implements an I2C master as a state machine driven by the
+ *  TWI interrupt. Every status code of the TWI moves the transaction to its
+ *  next step, so the CPU never waits for the TWINT flag.
+ *
+ *  The transactions are queued in a linked list of the transactions
+ *  submitted, owned by the caller. A transaction writes its tx bytes and
+ *  then reads its rx bytes after a repeated start, so a register of a sensor
+ *  is read with a single transaction.
+ *
+ *  A transaction not acknowledged by the slave ends with TWI_NACK and a bus
+ *  error ends with TWI_BUS_ERROR, both releasing the bus with a stop. The
+ *  twi_poll function aborts a transaction without bus activity for
+ *  TWI_TIMEOUT_MS, which happens when a slave holds SDA low, and recovers
+ *  the bus clocking SCL until SDA is released.
+ *
+ *  ## Usage ##
+ *
+ *  To use the TWI driver, the driver must be first initialized using the
+ *  twi_init function, the tick must be initialized and the global
+ *  interrupts must be enabled. The twi_poll function must be called from
+ *  the main loop.
+ *
+ *  @code
+ *      #include "twi.h"
+ *
+ *      twi_transaction read = {0};
+ *      uint8_t reg = 0xE3;
+ *      uint8_t data[2];
+ *
+ *      tick_init();
+ *      twi_init(TWI_CLOCK_STANDARD);
+ *      sei();
+ *
+ *      read.address = 0x40;
+ *      read.tx = &reg;
+ *      read.tx_size = 1;
+ *      read.rx = data;
+ *      read.rx_size = sizeof(data);
+ *      twi_submit(&read);
+ *
+ *      while (read.status == TWI_PENDING)
+ *      {
+ *          twi_poll();
+ *          // Other work
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "twi.h"
+#include "tick.h"
+#include "isr_profile.h"
+#include <util/delay.h>
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! TWI SDA pin number */
+#define TWI_SDA_PIN         PC4
+/*! TWI SCL pin number */
+#define TWI_SCL_PIN         PC5
+
+/*! Mask of the status bits of TWSR */
+#define TWI_STATUS_MASK     0xF8
+
+/*! TWI status codes of the master modes */
+#define TWI_BUS_FAULT       0x00
+#define TWI_START           0x08
+#define TWI_REP_START       0x10
+#define TWI_MT_SLA_ACK      0x18
+#define TWI_MT_SLA_NACK     0x20
+#define TWI_MT_DATA_ACK     0x28
+#define TWI_MT_DATA_NACK    0x30
+#define TWI_ARB_LOST        0x38
+#define TWI_MR_SLA_ACK      0x40
+#define TWI_MR_SLA_NACK     0x48
+#define TWI_MR_DATA_ACK     0x50
+#define TWI_MR_DATA_NACK    0x58
+
+/*! Clock pulses sent to release a slave holding SDA */
+#define TWI_RECOVERY_CLOCKS 9
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! TWCR value to continue with the next step of the transaction */
+#define TWI_CONTINUE        (_BV(TWINT) | _BV(TWEN) | _BV(TWIE))
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Transaction in progress, first of the queue */
+static twi_transaction* volatile twi_head;
+/*! Last transaction of the queue */
+static twi_transaction* volatile twi_tail;
+/*! Index of the byte being transferred */
+static volatile uint8_t twi_index;
+/*! Set while the tx bytes are written, cleared while the rx bytes are read */
+static volatile uint8_t twi_writing;
+/*! Set while a finished transaction is closed */
+static volatile uint8_t twi_closing;
+/*! Tick of the last bus activity */
+static volatile uint32_t twi_activity;
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static void _twi_begin(twi_transaction* transaction);
+static void _twi_finish(twi_status status, uint8_t stop);
+static void _twi_recover(void);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup twi
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize the TWI driver.
+ *
+ * The bus is recovered if a slave holds SDA low, the internal pull-ups of
+ * SDA and SCL are enabled and the bit rate is set without prescaler, from
+ * about 31 kHz to 400 kHz at 16 MHz.
+ *
+ * @param clock SCL clock in Hz (ex. TWI_CLOCK_STANDARD).
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      twi_init(TWI_CLOCK_FAST);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+twi_init(uint32_t clock)
+{
+    uint32_t bitrate = 0;
+
+    twi_head = NULL;
+    twi_tail = NULL;
+    twi_closing = 0;
+
+    _twi_recover();
+
+    if ( ((uint32_t) F_CPU / clock) > 16 )
+    {
+        bitrate = ((uint32_t) F_CPU / clock - 16) / 2;
+    }
+    if (bitrate > 0xFF)
+    {
+        bitrate = 0xFF;
+    }
+
+    TWSR = 0;
+    TWBR = (uint8_t) bitrate;
+    TWCR = _BV(TWEN);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to queue a transaction.
+ *
+ * The transaction starts at once if the TWI is idle. A transaction without
+ * bytes is completed at once.
+ *
+ * @pre The address, tx, tx_size, rx, rx_size and callback of the
+ *      transaction must be set. The status of a new transaction must not be
+ *      TWI_PENDING, it is TWI_DONE when the transaction is zero initialized.
+ *
+ * @param transaction Pointer to the transaction.
+ *
+ * @return TWI_PENDING if the transaction was queued, TWI_DONE if it has no
+ *         bytes or TWI_BUSY if it is already queued.
+ *
+ * \b Example:
+ * @code
+ *      if (twi_submit(&read) == TWI_BUSY)
+ *      {
+ *          // The previous read is not completed
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+twi_status
+twi_submit(twi_transaction* transaction)
+{
+    uint8_t sreg;
+
+    if (transaction->status == TWI_PENDING)
+    {
+        return TWI_BUSY;
+    }
+
+    if ( (transaction->tx_size == 0) && (transaction->rx_size == 0) )
+    {
+        transaction->status = TWI_DONE;
+        if (transaction->callback != NULL)
+        {
+            transaction->callback(transaction);
+        }
+
+        return TWI_DONE;
+    }
+
+    transaction->status = TWI_PENDING;
+    transaction->next = NULL;
+
+    sreg = SREG;
+    cli();
+    ISR_PROFILE_ENTER(ISR_PROFILE_CS_TWI);
+    if (twi_head == NULL)
+    {
+        twi_head = transaction;
+        twi_tail = transaction;
+
+        // The transaction is started when the finished one is closed
+        if (!twi_closing)
+        {
+            _twi_begin(transaction);
+            TWCR = TWI_CONTINUE | _BV(TWSTA);
+        }
+    }
+    else
+    {
+        twi_tail->next = transaction;
+        twi_tail = transaction;
+    }
+    ISR_PROFILE_EXIT(ISR_PROFILE_CS_TWI);
+    SREG = sreg;
+
+    return TWI_PENDING;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to check if there are transactions in progress.
+ *
+ * @return 1 if a transaction is in progress, 0 otherwise.
+ */
+/*****************************************************************************/
+uint8_t
+twi_busy(void)
+{
+    return (twi_head != NULL);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to abort a transaction without bus activity.
+ *
+ * When the bus has no activity for TWI_TIMEOUT_MS the transaction in
+ * progress ends with TWI_TIMEOUT, the bus is recovered and the next
+ * transaction is started. It must be called periodically from the main
+ * loop.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      while (1)
+ *      {
+ *          twi_poll();
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+twi_poll(void)
+{
+    uint8_t sreg;
+
+    sreg = SREG;
+    cli();
+    ISR_PROFILE_ENTER(ISR_PROFILE_CS_TWI);
+    if ( (twi_head != NULL) && ((tick_get_ms() - twi_activity) >=
+                                TWI_TIMEOUT_MS) )
+    {
+        TWCR = 0;
+        _twi_recover();
+        TWCR = _BV(TWEN);
+        _twi_finish(TWI_TIMEOUT, 0);
+    }
+    ISR_PROFILE_EXIT(ISR_PROFILE_CS_TWI);
+    SREG = sreg;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to prepare a transaction before its start condition.
+ *
+ * @param transaction Pointer to the transaction.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_twi_begin(twi_transaction* transaction)
+{
+    twi_index = 0;
+    twi_writing = (transaction->tx_size > 0);
+    twi_activity = tick_get_ms();
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to finish the transaction in progress.
+ *
+ * The transaction is removed from the queue, its callback is executed and
+ * the next transaction is started, after a stop if requested. The stop and
+ * the next start are requested together, so the TWI sends the start once
+ * the stop is completed.
+ *
+ * @param status Final status of the transaction.
+ * @param stop 1 to send a stop condition, 0 if the bus is already released.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_twi_finish(twi_status status, uint8_t stop)
+{
+    twi_transaction* transaction = twi_head;
+    uint8_t control = _BV(TWEN);
+
+    twi_head = transaction->next;
+    if (twi_head == NULL)
+    {
+        twi_tail = NULL;
+    }
+
+    // A transaction submitted by the callback is only queued
+    twi_closing = 1;
+    transaction->status = status;
+    if (transaction->callback != NULL)
+    {
+        transaction->callback(transaction);
+    }
+    twi_closing = 0;
+
+    if (stop)
+    {
+        control |= _BV(TWINT) | _BV(TWSTO);
+    }
+    if (twi_head != NULL)
+    {
+        _twi_begin(twi_head);
+        control |= TWI_CONTINUE | _BV(TWSTA);
+    }
+    TWCR = control;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to release a slave holding SDA low.
+ *
+ * The TWI must be disabled. SCL is clocked as an open drain output until
+ * the slave releases SDA and then a stop condition is generated.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_twi_recover(void)
+{
+    uint8_t i;
+
+    PORTC &= ~(_BV(TWI_SDA_PIN) | _BV(TWI_SCL_PIN));
+    DDRC &= ~(_BV(TWI_SDA_PIN) | _BV(TWI_SCL_PIN));
+
+    for (i = 0; (i < TWI_RECOVERY_CLOCKS) && !(PINC & _BV(TWI_SDA_PIN)); i++)
+    {
+        DDRC |= _BV(TWI_SCL_PIN);
+        _delay_us(5);
+        DDRC &= ~_BV(TWI_SCL_PIN);
+        _delay_us(5);
+    }
+
+    // Stop: SDA rises while SCL is high
+    DDRC |= _BV(TWI_SDA_PIN);
+    _delay_us(5);
+    DDRC &= ~_BV(TWI_SDA_PIN);
+    _delay_us(5);
+
+    PORTC |= _BV(TWI_SDA_PIN) | _BV(TWI_SCL_PIN);
+}
+
+/*****************************************************************************/
+/*!
+ * TWI interrupt, executed for every status of the transaction.
+ */
+/*****************************************************************************/
+ISR_PROFILED(TWI_vect, ISR_PROFILE_TWI)
+{
+    twi_transaction* transaction = twi_head;
+    uint8_t index = twi_index;
+
+    if (transaction == NULL)
+    {
+        TWCR = _BV(TWEN);
+        return;
+    }
+
+    twi_activity = tick_get_ms();
+
+    switch (TWSR & TWI_STATUS_MASK)
+    {
+        case TWI_START:
+        case TWI_REP_START:
+            TWDR = (transaction->address << 1) | (twi_writing ? 0 : 1);
+            TWCR = TWI_CONTINUE;
+            break;
+
+        case TWI_MT_SLA_ACK:
+        case TWI_MT_DATA_ACK:
+            if (index < transaction->tx_size)
+            {
+                TWDR = transaction->tx[index];
+                twi_index = index + 1;
+                TWCR = TWI_CONTINUE;
+            }
+            else if (transaction->rx_size > 0)
+            {
+                twi_index = 0;
+                twi_writing = 0;
+                TWCR = TWI_CONTINUE | _BV(TWSTA);
+            }
+            else
+            {
+                _twi_finish(TWI_DONE, 1);
+            }
+            break;
+
+        case TWI_MR_DATA_ACK:
+            transaction->rx[index++] = TWDR;
+            twi_index = index;
+            // The next byte is requested as after the address
+            // Fall through
+
+        case TWI_MR_SLA_ACK:
+            // The last byte is not acknowledged to end the read
+            if ((index + 1) < transaction->rx_size)
+            {
+                TWCR = TWI_CONTINUE | _BV(TWEA);
+            }
+            else
+            {
+                TWCR = TWI_CONTINUE;
+            }
+            break;
+
+        case TWI_MR_DATA_NACK:
+            transaction->rx[index] = TWDR;
+            twi_index = index + 1;
+            _twi_finish(TWI_DONE, 1);
+            break;
+
+        case TWI_MT_SLA_NACK:
+        case TWI_MT_DATA_NACK:
+        case TWI_MR_SLA_NACK:
+            _twi_finish(TWI_NACK, 1);
+            break;
+
+        case TWI_ARB_LOST:
+            // The transaction is restarted when the bus is free
+            _twi_begin(transaction);
+            TWCR = TWI_CONTINUE | _BV(TWSTA);
+            break;
+
+        case TWI_BUS_FAULT:
+        default:
+            _twi_finish(TWI_BUS_ERROR, 1);
+            break;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
@@ -37,11 +37,35 @@
  *      uart_send(fooStr); 
  *      uart_read(rxStr, sizeof(rxStr));
  *  @endcode
+ *
+ *  The uart_read_until and uart_read_exact functions give up after a timeout
+ *  measured with the tick driver, so the tick driver must be initialized and
+ *  the global interrupts enabled. They can also be cancelled from an 
+ *  interrupt with the uart_cancel_read function.
+ *
+ *  When UART_RX_BUFFER_SIZE is not 0 the received characters are stored in a
+ *  buffer by the RX interrupt once it is enabled with uart_enable_rx_isr, 
+ *  otherwise the characters are read polling the UART.
+ * 
+ *  @code
+ *      uint8_t count;
+ *
+ *      tick_init();
+ *      sei();
+ *
+ *      if (uart_read_until(rxStr, sizeof(rxStr), '\n', 100, &count) == 
+ *          UART_TIMEOUT)
+ *      {
+ *          // Nothing received in 100 ms
+ *      }
+ *  @endcode
  */
 /******************************************************************************
 * Includes
 ******************************************************************************/
 #include "uart.h"
+#include "trace.h"
+#include "isr_profile.h"
 
 /******************************************************************************
 * Module Preprocessor Constants
@@ -58,16 +82,49 @@
 #define UBRR0H_ADDR     &UBRR0H
 /*! UDR0 Memory Address */
 #define UDR0_ADDR       &UDR0
-/*! Uart baud rate constant */
-#define BAUD_RATE       9600
-/*! Uart baud rate prescaler */
-#define BAUD_PRESCALE   ((F_CPU / (16UL * BAUD_RATE)) - 1)
+/*! CPU clock as an unsigned value */
+#define CPU_CLOCK       ((uint32_t) F_CPU)
+/*! Largest divisor of the baud rate generator, UBRR0 + 1 */
+#define DIVISOR_MAX     4096UL
+/*! Mask of the UBRR0 value in a UBRR setting */
+#define UBRR_MASK       0x0FFF
+
+#if (UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1)) != 0
+    #error "UART_RX_BUFFER_SIZE must be 0 or a power of 2"
+#endif
 
 /******************************************************************************
 * Module Preprocessor Macros
 ******************************************************************************/
 /*! Macro used to dereference an IO memory address */
 #define MMIO(addr)      (*(volatile uint8_t *)(addr))
+/*! Macro used to wrap an index of the RX buffer */
+#define RX_WRAP(index)  ((index) & (UART_RX_BUFFER_SIZE - 1))
+
+/*! Macro used to get the rounded divisor of a baud rate in normal mode */
+#define DIV_NORMAL(baud)    ((CPU_CLOCK + 8UL * (baud)) / (16UL * (baud)))
+/*! Macro used to get the rounded divisor of a baud rate in double speed */
+#define DIV_DOUBLE(baud)    ((CPU_CLOCK + 4UL * (baud)) / (8UL * (baud)))
+/*! Macro used to check that a divisor fits in the UBRR0 register */
+#define DIV_VALID(div)      ( ((div) >= 1) && ((div) <= DIVISOR_MAX) )
+/*! Macro used to get the difference between a clock and the CPU clock */
+#define CLOCK_DIFF(clock)   (((clock) > CPU_CLOCK) ? ((clock) - CPU_CLOCK) : \
+                                                     (CPU_CLOCK - (clock)))
+/*! Macro used to get the clock error of a baud rate in normal mode */
+#define ERR_NORMAL(baud)    CLOCK_DIFF(16UL * (baud) * DIV_NORMAL(baud))
+/*! Macro used to get the clock error of a baud rate in double speed */
+#define ERR_DOUBLE(baud)    CLOCK_DIFF(8UL * (baud) * DIV_DOUBLE(baud))
+/*!
+ * Macro used to get the UBRR setting of a baud rate at compile time, same as
+ * the one returned by uart_baud_setting for the CPU clock.
+ */
+#define UBRR_SETTING(baud)                                                  \
+    ( (DIV_VALID(DIV_DOUBLE(baud)) &&                                       \
+       (!DIV_VALID(DIV_NORMAL(baud)) ||                                     \
+        (ERR_DOUBLE(baud) < ERR_NORMAL(baud)))) ?                           \
+      ((DIV_DOUBLE(baud) - 1) | UART_UBRR_U2X) :                            \
+      (DIV_VALID(DIV_NORMAL(baud)) ? (DIV_NORMAL(baud) - 1) :               \
+                                     UART_UBRR_INVALID) )
 
 /******************************************************************************
 * Module Typedefs
@@ -76,12 +133,33 @@
 /******************************************************************************
 * Module Variable Definitions
 ******************************************************************************/
+#if UART_RX_BUFFER_SIZE > 0
+/*! Characters received by the RX interrupt */
+static volatile unsigned char uart_rx_buffer[UART_RX_BUFFER_SIZE];
+/*! Index where the RX interrupt writes the next character */
+static volatile uint8_t uart_rx_head;
+/*! Index of the next character to be read */
+static volatile uint8_t uart_rx_tail;
+#endif
+
+/*! Flag set to cancel the read in progress */
+static volatile uint8_t uart_cancel;
+
+#if UART_RX_BUFFER_SIZE > 0
+_Static_assert(sizeof(uart_rx_buffer) == UART_RAM_SIZE,
+               "UART_RAM_SIZE does not match the buffers");
+#endif
 
 /******************************************************************************
 * Private Function Prototypes
 ******************************************************************************/
+static uint16_t _uart_baud_table(uint32_t baud);
+static int16_t _uart_baud_error(uint32_t f_cpu, uint32_t baud, 
+                                uint16_t setting);
 static void _uart_send_char(unsigned char lChar);
 static unsigned char _uart_read_char(void);
+static uart_status _uart_read(uint8_t* data, uint8_t size, int16_t delim, 
+                              uint16_t timeout, uint8_t* count);
 
 /******************************************************************************
 * Function Definitions
@@ -98,14 +176,17 @@ static unsigned char _uart_read_char(void);
 /*!
  * Function used to initialize the UART.
  * 
- * The UART baud rate is initialized using the BAUD_RATE constant defined in
- * this file. The configuration of the UART port is the following:
- *  * Double speed asynchronous mode disabled
+ * The UART baud rate is initialized using the UART_BAUD_RATE constant, 9600
+ * bauds by default. The configuration of the UART port is the following:
+ *  * Double speed asynchronous mode when it is closer to the baud rate
  *  * RX and TX enabled
  *  * Asynchronous operation mode
  *  * Parity disabled
  *  * Serial frame with 8 data bits and 1 stop bit
  * 
+ * The UBRR setting is computed at compile time, see uart_init_config to
+ * select the baud rate and the frame at run time.
+ * 
  * @return None.
  * 
  * \b Example:
@@ -118,12 +199,21 @@ static unsigned char _uart_read_char(void);
 void
 uart_init(void)
 {
+    uint16_t setting = UBRR_SETTING(UART_BAUD_RATE);
+
     // Set baud rate value
-    UBRR0H = (BAUD_PRESCALE >> 8);
-    UBRR0L = BAUD_PRESCALE;
+    UBRR0H = (setting & UBRR_MASK) >> 8;
+    UBRR0L = setting & 0xFF;
 
-    // Disable double speed - asynch mode
-    UCSR0A &= ~_BV(U2X0);
+    // Select double speed - asynch mode
+    if (setting & UART_UBRR_U2X)
+    {
+        UCSR0A |= _BV(U2X0);
+    }
+    else
+    {
+        UCSR0A &= ~_BV(U2X0);
+    }
 
     // Enable RX and TX
     UCSR0B |= (_BV(RXEN0) | _BV(TXEN0));
@@ -137,6 +227,142 @@ uart_init(void)
     UCSR0C &= ~_BV(USBS0);
 }
 
+/*****************************************************************************/
+/*!
+ * Function used to initialize the UART with a baud rate and a frame format.
+ * 
+ * The normal or the double speed mode is selected to minimise the baud rate
+ * error. The common baud rates (2400 to 1000000 bauds) are taken from a 
+ * table computed at compile time, the other ones are computed with the
+ * uart_baud_setting function.
+ * 
+ * The UART is configured with the closest baud rate even when its error is
+ * larger than UART_BAUD_TOLERANCE.
+ * 
+ * @param baud Baud rate in bauds.
+ * @param frame Frame format, UART_FRAME_8N1 or a combination of a 
+ *              UART_DATA, a UART_PARITY and a UART_STOP constant.
+ * 
+ * @return UART_OK if the UART was configured, UART_BAUD_ERROR if the baud 
+ *         rate error is larger than UART_BAUD_TOLERANCE or the baud rate can
+ *         not be generated (the UART is not changed then).
+ * 
+ * @note A character still being transmitted is corrupted by the change.
+ * 
+ * \b Example:
+ * @code
+ *      uart_init_config(115200, UART_FRAME_8N1);
+ * @endcode
+ * 
+ */
+/*****************************************************************************/
+uart_status
+uart_init_config(uint32_t baud, uint8_t frame)
+{
+    uint16_t setting = _uart_baud_table(baud);
+    int16_t error = 0;
+
+    if (setting == UART_UBRR_INVALID)
+    {
+        setting = uart_baud_setting(CPU_CLOCK, baud, &error);
+        if (setting == UART_UBRR_INVALID)
+        {
+            return UART_BAUD_ERROR;
+        }
+    }
+    else
+    {
+        error = _uart_baud_error(CPU_CLOCK, baud, setting);
+    }
+
+    // Set baud rate value
+    UBRR0H = (setting & UBRR_MASK) >> 8;
+    UBRR0L = setting & 0xFF;
+
+    // Select double speed - asynch mode
+    UCSR0A = (setting & UART_UBRR_U2X) ? _BV(U2X0) : 0;
+
+    // Enable RX and TX
+    UCSR0B |= (_BV(RXEN0) | _BV(TXEN0));
+
+    // Set asynchronous operation mode and serial frame
+    UCSR0C = frame & (UART_DATA_8 | UART_PARITY_ODD | UART_STOP_2);
+
+    if ( (error > UART_BAUD_TOLERANCE) || (error < -UART_BAUD_TOLERANCE) )
+    {
+        return UART_BAUD_ERROR;
+    }
+
+    return UART_OK;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to compute the UBRR setting of a baud rate.
+ * 
+ * Both the normal and the double speed mode are tried, the double speed 
+ * mode is only selected when its error is smaller, since the receiver 
+ * tolerates less error in that mode.
+ * 
+ * @param f_cpu CPU clock in Hz.
+ * @param baud Baud rate in bauds.
+ * @param error Pointer where the baud rate error will be stored, in tenths 
+ *              of percent, positive when the generated baud rate is faster.
+ *              Can be NULL.
+ * 
+ * @return UBRR0 value, with UART_UBRR_U2X when the double speed mode is 
+ *         used, or UART_UBRR_INVALID if the baud rate can not be generated.
+ * 
+ * \b Example:
+ * @code
+ *      int16_t error;
+ *      uint16_t setting = uart_baud_setting(16000000, 115200, &error);
+ *      // setting = 16 | UART_UBRR_U2X, error = 21 (2.1 %)
+ * @endcode
+ * 
+ */
+/*****************************************************************************/
+uint16_t
+uart_baud_setting(uint32_t f_cpu, uint32_t baud, int16_t* error)
+{
+    uint16_t setting = UART_UBRR_INVALID;
+    uint32_t best = UINT32_MAX;
+    uint32_t divisor;
+    uint32_t clock;
+    uint32_t diff;
+    uint8_t scale;
+
+    if (baud == 0)
+    {
+        return UART_UBRR_INVALID;
+    }
+
+    // Normal mode first, so a tie keeps the normal mode
+    for (scale = 16; scale >= 8; scale /= 2)
+    {
+        divisor = (f_cpu + (scale / 2) * baud) / (scale * baud);
+        if ( (divisor < 1) || (divisor > DIVISOR_MAX) )
+        {
+            continue;
+        }
+
+        clock = scale * baud * divisor;
+        diff = (clock > f_cpu) ? (clock - f_cpu) : (f_cpu - clock);
+        if (diff < best)
+        {
+            best = diff;
+            setting = (divisor - 1) | ((scale == 8) ? UART_UBRR_U2X : 0);
+        }
+    }
+
+    if ( (error != NULL) && (setting != UART_UBRR_INVALID) )
+    {
+        *error = _uart_baud_error(f_cpu, baud, setting);
+    }
+
+    return setting;
+}
+
 /*****************************************************************************/
 /*!
  * Function used to send a string through the UART.
@@ -158,6 +384,8 @@ uart_init(void)
 void
 uart_send(const char* str)
 {
+    TRACE(TRACE_UART_SEND, strlen(str));
+
     while (*str != 0x00)
     {
         _uart_send_char(*str);
@@ -165,6 +393,35 @@ uart_send(const char* str)
     }
 }
 
+/*****************************************************************************/
+/*!
+ * Function used to send bytes through the UART.
+ * 
+ * Unlike uart_send, the bytes are sent as they are, including the NULL 
+ * bytes.
+ * 
+ * @param data Pointer to the bytes to be sent.
+ * @param size Number of bytes to be sent.
+ * 
+ * @return None.
+ * 
+ * \b Example:
+ * @code
+ *      uint8_t frame[] = {0x00, 0x01, 0x02};
+ *      uart_write(frame, sizeof(frame));
+ * @endcode
+ * 
+ */
+/*****************************************************************************/
+void
+uart_write(const uint8_t* data, uint8_t size)
+{
+    while (size-- > 0)
+    {
+        _uart_send_char(*data++);
+    }
+}
+
 /*****************************************************************************/
 /*!
  * Function used to read a string from the UART.
@@ -246,6 +503,266 @@ uart_flush(void)
     unsigned char dummy;
     
     while ( UCSR0A & _BV(RXC0) ) dummy = UDR0;
+
+#if UART_RX_BUFFER_SIZE > 0
+    uart_rx_tail = uart_rx_head;
+#endif
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read a string from the UART until a delimiter is 
+ * received.
+ * 
+ * This function reads the characters received from the UART until the 
+ * delimiter is received, the string is full or the timeout expires. The 
+ * delimiter is not written to the string and the string is always NULL 
+ * terminated.
+ * 
+ * @param str Pointer to the string where the received string will be written.
+ * @param size Size of the string.
+ * @param delim Delimiter character (ex. '\n').
+ * @param timeout Maximum time to wait in milliseconds, UART_TIMEOUT_INFINITE
+ *                to wait forever.
+ * @param count Pointer where the number of characters written to the string
+ *              will be stored, can be NULL.
+ * 
+ * @return UART_OK if the delimiter was received, UART_BUFFER_FULL if the 
+ *         string is full, UART_TIMEOUT if the timeout expired or 
+ *         UART_CANCELLED if the read was cancelled.
+ * 
+ * \b Example:
+ * @code
+ *      char fooStr[20];
+ *      uart_read_until(fooStr, sizeof(fooStr), '\n', 1000, NULL); 
+ * @endcode
+ * 
+ */
+/*****************************************************************************/
+uart_status
+uart_read_until(char* str, uint8_t size, char delim, uint16_t timeout, 
+                uint8_t* count)
+{
+    uint8_t received = 0;
+    uart_status status = UART_BUFFER_FULL;
+
+    if (size > 0)
+    {
+        status = _uart_read((uint8_t *) str, size - 1, (uint8_t) delim, 
+                            timeout, &received);
+        str[received] = '\0';
+    }
+
+    if (count != NULL)
+    {
+        *count = received;
+    }
+
+    return status;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read a number of bytes from the UART.
+ * 
+ * This function reads the bytes received from the UART until the buffer is
+ * full or the timeout expires. No byte is handled as a delimiter.
+ * 
+ * @param data Pointer to the buffer where the bytes will be written.
+ * @param size Number of bytes to read.
+ * @param timeout Maximum time to wait in milliseconds, UART_TIMEOUT_INFINITE
+ *                to wait forever.
+ * @param count Pointer where the number of bytes read will be stored, can be
+ *              NULL.
+ * 
+ * @return UART_OK if all the bytes were read, UART_TIMEOUT if the timeout 
+ *         expired or UART_CANCELLED if the read was cancelled.
+ * 
+ * \b Example:
+ * @code
+ *      uint8_t frame[8];
+ *      uart_read_exact(frame, sizeof(frame), 100, NULL); 
+ * @endcode
+ * 
+ */
+/*****************************************************************************/
+uart_status
+uart_read_exact(uint8_t* data, uint8_t size, uint16_t timeout, uint8_t* count)
+{
+    uint8_t received = 0;
+    uart_status status;
+
+    status = _uart_read(data, size, -1, timeout, &received);
+    if (status == UART_BUFFER_FULL)
+    {
+        status = UART_OK;
+    }
+
+    if (count != NULL)
+    {
+        *count = received;
+    }
+
+    return status;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to cancel the read in progress.
+ * 
+ * This function is intended to be called from an interrupt, the function 
+ * reading from the UART returns UART_CANCELLED. When no read is in progress
+ * the next one is cancelled as soon as it has to wait for a character.
+ * 
+ * @return None.
+ */
+/*****************************************************************************/
+void
+uart_cancel_read(void)
+{
+    uart_cancel = 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the number of characters available to be read.
+ * 
+ * @return Number of characters in the RX buffer, or 1 if a character was 
+ *         received when the RX interrupt is disabled.
+ */
+/*****************************************************************************/
+uint8_t
+uart_available(void)
+{
+#if UART_RX_BUFFER_SIZE > 0
+    if (UCSR0B & _BV(RXCIE0))
+    {
+        return RX_WRAP(uart_rx_head - uart_rx_tail);
+    }
+#endif
+
+    return ( (UCSR0A & _BV(RXC0)) != 0 );
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to read a character from the UART without waiting.
+ * 
+ * This function returns at once. The character is read from the RX buffer
+ * when the RX interrupt is enabled and from the UART otherwise, so it can
+ * be called in a loop that also runs other tasks.
+ * 
+ * @param data Pointer where the character will be written.
+ * 
+ * @return 1 if a character was read, 0 if none was received.
+ * 
+ * \b Example:
+ * @code
+ *      unsigned char data;
+ *      
+ *      while (uart_try_read_char(&data))
+ *      {
+ *          ...
+ *      }
+ * @endcode
+ * 
+ */
+/*****************************************************************************/
+uint8_t
+uart_try_read_char(unsigned char* data)
+{
+#if UART_RX_BUFFER_SIZE > 0
+    uint8_t tail;
+
+    if (UCSR0B & _BV(RXCIE0))
+    {
+        tail = uart_rx_tail;
+        if (tail == uart_rx_head)
+        {
+            return 0;
+        }
+
+        *data = uart_rx_buffer[tail];
+        uart_rx_tail = RX_WRAP(tail + 1);
+
+        return 1;
+    }
+#endif
+
+    if ( !( UCSR0A & _BV(RXC0) ) )
+    {
+        return 0;
+    }
+
+    *data = UDR0;
+
+    return 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the UBRR setting of a common baud rate.
+ * 
+ * The settings are computed at compile time for the CPU clock, so the 
+ * common baud rates need no division at run time.
+ * 
+ * @param baud Baud rate in bauds.
+ * 
+ * @return UBRR setting, or UART_UBRR_INVALID if the baud rate is not in the
+ *         table.
+ */
+/*****************************************************************************/
+static uint16_t
+_uart_baud_table(uint32_t baud)
+{
+    switch (baud)
+    {
+        case 2400UL:
+            return UBRR_SETTING(2400UL);
+        case 4800UL:
+            return UBRR_SETTING(4800UL);
+        case 9600UL:
+            return UBRR_SETTING(9600UL);
+        case 19200UL:
+            return UBRR_SETTING(19200UL);
+        case 38400UL:
+            return UBRR_SETTING(38400UL);
+        case 57600UL:
+            return UBRR_SETTING(57600UL);
+        case 115200UL:
+            return UBRR_SETTING(115200UL);
+        case 230400UL:
+            return UBRR_SETTING(230400UL);
+        case 250000UL:
+            return UBRR_SETTING(250000UL);
+        case 500000UL:
+            return UBRR_SETTING(500000UL);
+        case 1000000UL:
+            return UBRR_SETTING(1000000UL);
+        default:
+            return UART_UBRR_INVALID;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to compute the baud rate error of a UBRR setting.
+ * 
+ * @param f_cpu CPU clock in Hz.
+ * @param baud Baud rate in bauds.
+ * @param setting UBRR setting.
+ * 
+ * @return Baud rate error in tenths of percent.
+ */
+/*****************************************************************************/
+static int16_t
+_uart_baud_error(uint32_t f_cpu, uint32_t baud, uint16_t setting)
+{
+    uint32_t clock = ((setting & UART_UBRR_U2X) ? 8UL : 16UL) * baud *
+                     ((setting & UBRR_MASK) + 1UL);
+    uint32_t permille = (clock >= 1000UL) ? (clock / 1000UL) : 1UL;
+
+    return (int16_t) ((int32_t) (f_cpu - clock) / (int32_t) permille);
 }
 
 /*****************************************************************************/
@@ -285,6 +802,91 @@ _uart_read_char(void)
     return UDR0;
 }
 
+/*****************************************************************************/
+/*!
+ * Function used to read bytes from the UART with a timeout.
+ * 
+ * @param data Pointer to the buffer where the bytes will be written.
+ * @param size Maximum number of bytes to read.
+ * @param delim Delimiter byte, or -1 to read until the buffer is full.
+ * @param timeout Maximum time to wait in milliseconds.
+ * @param count Pointer where the number of bytes read will be stored.
+ * 
+ * @return Result of the read.
+ */
+/*****************************************************************************/
+static uart_status
+_uart_read(uint8_t* data, uint8_t size, int16_t delim, uint16_t timeout,
+           uint8_t* count)
+{
+    uint8_t i = 0;
+    unsigned char rx;
+    uart_status status = UART_BUFFER_FULL;
+    uint32_t start = tick_get_ms();
+
+    while (i < size)
+    {
+        if (uart_try_read_char(&rx))
+        {
+            if (rx == delim)
+            {
+                status = UART_OK;
+                break;
+            }
+
+            data[i++] = rx;
+        }
+        else if (uart_cancel)
+        {
+            status = UART_CANCELLED;
+            break;
+        }
+
+        if ( (timeout != UART_TIMEOUT_INFINITE) && 
+             ((tick_get_ms() - start) >= timeout) )
+        {
+            status = (i < size) ? UART_TIMEOUT : UART_BUFFER_FULL;
+            break;
+        }
+    }
+
+    // A cancel issued before the read started is consumed by it
+    uart_cancel = 0;
+    *count = i;
+
+    TRACE(TRACE_UART_READ, ((uint16_t) status << 8) | i);
+
+    return status;
+}
+
+#if UART_RX_BUFFER_SIZE > 0
+/*****************************************************************************/
+/*!
+ * UART RX complete interrupt.
+ * 
+ * Stores the received character in the RX buffer, the character is lost if
+ * the buffer is full.
+ */
+/*****************************************************************************/
+ISR_PROFILED(USART_RX_vect, ISR_PROFILE_UART_RX)
+{
+    uint8_t head = uart_rx_head;
+    uint8_t next = RX_WRAP(head + 1);
+    unsigned char data = UDR0;
+
+    if (next != uart_rx_tail)
+    {
+        uart_rx_buffer[head] = data;
+        uart_rx_head = next;
+        TRACE(TRACE_UART_RX, data);
+    }
+    else
+    {
+        TRACE(TRACE_UART_RX_DROP, data);
+    }
+}
+#endif
+
 /*****************************************************************************/
 /*!
  * Close the Doxygen group.
@@ -0,0 +1,595 @@
+/******************************************************************************
+* Title                 :   Watchdog scheduler source file
+* Filename              :   wdt_scheduler.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        wdt_scheduler.c
+ *  @brief       Watchdog scheduler implementation
+ *
+ *  To use the watchdog scheduler, include this header file as follows:
+ *  @code
+ *      #include "wdt_scheduler.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The watchdog scheduler runs jobs every N seconds and keeps the CPU in the
+ *  power-down sleep mode in between, the deepest mode of the ATmega328P,
+ *  where only the watchdog oscillator runs. The watchdog is used in
+ *  interrupt mode, with periods from 16 ms to 8 s, and longer intervals are
+ *  chained: before sleeping the largest period that does not pass the next
+ *  job is selected, and the remaining time is slept in shorter periods.
+ *
+ *  The 128 kHz watchdog oscillator drifts about 10% with the voltage and the
+ *  temperature. While the CPU is awake the watchdog keeps running with a
+ *  period of 128 ms and every period is measured against the tick, which
+ *  counts the crystal, to calibrate the length of the periods slept. The
+ *  time awake is taken from the tick as well, so the clock of the scheduler
+ *  only depends on the watchdog for the time asleep.
+ *
+ *  Timer0 is stopped in power-down, so tick_get_ms does not count the time
+ *  asleep, wdt_scheduler_time_ms is the time since the initialization.
+ *
+ *  ## Usage ##
+ *
+ *  The tick must be initialized first, and the global interrupts enabled.
+ *  The peripherals not used while sleeping (ADC, analog comparator) should
+ *  be disabled by the application to get the lowest consumption.
+ *
+ *  The following code example reads a sensor every 10 minutes and sends a
+ *  heartbeat every day.
+ *
+ *  @code
+ *      #include "wdt_scheduler.h"
+ *
+ *      tick_init();
+ *      wdt_scheduler_init();
+ *      sei();
+ *
+ *      wdt_scheduler_every(600, read_sensor);
+ *      wdt_scheduler_every(86400UL, send_heartbeat);
+ *
+ *      while (1)
+ *      {
+ *          wdt_scheduler_run();
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stddef.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include "wdt_scheduler.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Timer0 counts per millisecond of the tick */
+#define WDT_SCHEDULER_SUB_PER_MS    ((F_CPU / (64UL * 1000UL)))
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  Job of the scheduler
+  */
+typedef struct
+{
+    wdt_scheduler_job job;      /*! Function run, NULL when the slot is free */
+    uint32_t period;            /*! Period in milliseconds */
+    uint32_t next;              /*! Time of the next run in milliseconds */
+} wdt_scheduler_entry;
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Jobs */
+static wdt_scheduler_entry wdt_scheduler_jobs[WDT_SCHEDULER_JOBS];
+/*! Milliseconds since the initialization */
+static volatile uint32_t wdt_scheduler_ms;
+/*! Microseconds of the current millisecond */
+static volatile uint16_t wdt_scheduler_us;
+/*! Crystal time of the last update of the clock, in microseconds */
+static volatile uint32_t wdt_scheduler_ref;
+/*! Crystal time of the start of the watchdog period, in microseconds */
+static volatile uint32_t wdt_scheduler_start;
+/*! Set when the watchdog period started awake and can be measured */
+static volatile uint8_t wdt_scheduler_measure;
+/*! Set while the CPU sleeps waiting for the watchdog */
+static volatile uint8_t wdt_scheduler_asleep;
+/*! Set by the watchdog interrupt that ends the sleep */
+static volatile uint8_t wdt_scheduler_woken;
+/*! Current watchdog prescaler */
+static volatile uint8_t wdt_scheduler_prescaler;
+/*! Length of the watchdog periods relative to the nominal one, Q16 */
+static volatile uint32_t wdt_scheduler_cal;
+/*! Set once the first calibration measure is taken */
+static volatile uint8_t wdt_scheduler_calibrated;
+
+#ifdef __AVR__
+// 10 bytes per job on the AVR, with a 2 bytes function pointer
+_Static_assert(sizeof(wdt_scheduler_jobs) == WDT_SCHEDULER_RAM_SIZE,
+               "WDT_SCHEDULER_RAM_SIZE does not match the buffers");
+#endif
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static uint32_t _wdt_scheduler_crystal_us(void);
+static void _wdt_scheduler_add_us(uint32_t us);
+static void _wdt_scheduler_sync(void);
+static void _wdt_scheduler_start(uint8_t prescaler);
+static void _wdt_scheduler_calibrate(uint32_t us);
+static void _wdt_scheduler_sleep(uint32_t deadline);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup wdt_scheduler
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize the watchdog scheduler.
+ *
+ * The jobs are removed, the clock is cleared and the watchdog is started in
+ * interrupt mode with the awake period.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      tick_init();
+ *      wdt_scheduler_init();
+ *      sei();
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+wdt_scheduler_init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < WDT_SCHEDULER_JOBS; i++)
+    {
+        wdt_scheduler_jobs[i].job = NULL;
+    }
+
+    wdt_scheduler_ms = 0;
+    wdt_scheduler_us = 0;
+    wdt_scheduler_asleep = 0;
+    wdt_scheduler_cal = WDT_SCHEDULER_SCALE_ONE;
+    wdt_scheduler_calibrated = 0;
+    wdt_scheduler_ref = _wdt_scheduler_crystal_us();
+
+    // The watchdog reset flag forces the reset mode while it is set
+    MCUSR &= ~_BV(WDRF);
+    _wdt_scheduler_start(WDT_SCHEDULER_AWAKE_PRESCALER);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to run a job periodically. The first run is one period
+ * after the call.
+ *
+ * @param seconds Period of the job, up to 24 days.
+ * @param job Function run from wdt_scheduler_run.
+ *
+ * @return Identifier of the job, or -1 if there is no free slot or the
+ *         arguments are not valid.
+ *
+ * \b Example:
+ * @code
+ *      int8_t id = wdt_scheduler_every(600, read_sensor);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+int8_t
+wdt_scheduler_every(uint32_t seconds, wdt_scheduler_job job)
+{
+    uint8_t i;
+
+    if ( (job == NULL) || (seconds == 0) || (seconds > 2147483UL) )
+    {
+        return -1;
+    }
+
+    for (i = 0; i < WDT_SCHEDULER_JOBS; i++)
+    {
+        if (wdt_scheduler_jobs[i].job == NULL)
+        {
+            _wdt_scheduler_sync();
+            wdt_scheduler_jobs[i].period = seconds * 1000UL;
+            wdt_scheduler_jobs[i].next = wdt_scheduler_time_ms() +
+                                         wdt_scheduler_jobs[i].period;
+            wdt_scheduler_jobs[i].job = job;
+            return (int8_t) i;
+        }
+    }
+
+    return -1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to remove a job.
+ *
+ * @param id Identifier returned by wdt_scheduler_every.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+wdt_scheduler_cancel(int8_t id)
+{
+    if ( (id >= 0) && (id < WDT_SCHEDULER_JOBS) )
+    {
+        wdt_scheduler_jobs[id].job = NULL;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to run the jobs that are due and to sleep until the next
+ * one. It is called from the main loop, with the global interrupts
+ * enabled, and returns right away when there are no jobs.
+ *
+ * A job runs up to 8 ms early, the watchdog can not sleep shorter. A job
+ * that runs longer than its period skips the runs missed instead of running
+ * several times in a row.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      while (1)
+ *      {
+ *          wdt_scheduler_run();
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+wdt_scheduler_run(void)
+{
+    wdt_scheduler_entry* entry;
+    uint32_t deadline = 0;
+    uint32_t now;
+    uint8_t found = 0;
+    uint8_t i;
+
+    for (i = 0; i < WDT_SCHEDULER_JOBS; i++)
+    {
+        entry = &wdt_scheduler_jobs[i];
+        _wdt_scheduler_sync();
+
+        // Under half of the shortest period can not be slept, the job is due
+        now = wdt_scheduler_time_ms() + (wdt_scheduler_period_us(0) / 2000UL);
+
+        if ( (entry->job != NULL) && ((int32_t) (now - entry->next) >= 0) )
+        {
+            entry->next += entry->period;
+            if ((int32_t) (now - entry->next) >= 0)
+            {
+                entry->next = now + entry->period;
+            }
+            entry->job();
+        }
+    }
+
+    for (i = 0; i < WDT_SCHEDULER_JOBS; i++)
+    {
+        entry = &wdt_scheduler_jobs[i];
+        if ( (entry->job != NULL) &&
+             (!found || ((int32_t) (entry->next - deadline) < 0)) )
+        {
+            deadline = entry->next;
+            found = 1;
+        }
+    }
+
+    if (found)
+    {
+        _wdt_scheduler_sleep(deadline);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the time since the initialization, asleep and awake.
+ *
+ * @return Milliseconds, wraps around after 49 days.
+ */
+/*****************************************************************************/
+uint32_t
+wdt_scheduler_time_ms(void)
+{
+    uint32_t ms;
+    uint8_t sreg = SREG;
+
+    cli();
+    ms = wdt_scheduler_ms;
+    SREG = sreg;
+
+    return ms;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the calibration of the watchdog.
+ *
+ * @return Length of the watchdog periods relative to the nominal one, where
+ *         WDT_SCHEDULER_SCALE_ONE is a watchdog on its nominal frequency.
+ */
+/*****************************************************************************/
+uint32_t
+wdt_scheduler_scale(void)
+{
+    uint32_t scale;
+    uint8_t sreg = SREG;
+
+    cli();
+    scale = wdt_scheduler_cal;
+    SREG = sreg;
+
+    return scale;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the calibrated length of a watchdog period.
+ *
+ * @param prescaler Watchdog prescaler, from 0 (16 ms) to 9 (8 s).
+ *
+ * @return Microseconds.
+ */
+/*****************************************************************************/
+uint32_t
+wdt_scheduler_period_us(uint8_t prescaler)
+{
+    return (WDT_SCHEDULER_BASE_US * wdt_scheduler_scale()) >> (16 - prescaler);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the crystal time from the tick and Timer0.
+ *
+ * @return Microseconds, wraps around after 71 minutes.
+ */
+/*****************************************************************************/
+static uint32_t
+_wdt_scheduler_crystal_us(void)
+{
+    uint8_t sreg = SREG;
+    uint32_t ms;
+    uint8_t sub;
+
+    cli();
+    sub = TCNT0;
+    ms = tick_get_ms();
+
+    // A compare match not serviced yet belongs to the next millisecond
+    if ( (TIFR0 & _BV(OCF0A)) && (sub < (WDT_SCHEDULER_SUB_PER_MS / 2)) )
+    {
+        ms++;
+    }
+    SREG = sreg;
+
+    return (ms * 1000UL) + ((sub * 1000UL) / WDT_SCHEDULER_SUB_PER_MS);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to advance the clock, with the interrupts disabled.
+ *
+ * @param us Microseconds elapsed.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wdt_scheduler_add_us(uint32_t us)
+{
+    us += wdt_scheduler_us;
+    wdt_scheduler_ms += us / 1000UL;
+    wdt_scheduler_us = (uint16_t) (us % 1000UL);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to add the crystal time elapsed awake to the clock.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wdt_scheduler_sync(void)
+{
+    uint8_t sreg = SREG;
+    uint32_t now;
+
+    cli();
+    now = _wdt_scheduler_crystal_us();
+    _wdt_scheduler_add_us(now - wdt_scheduler_ref);
+    wdt_scheduler_ref = now;
+    SREG = sreg;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to restart the watchdog in interrupt mode.
+ *
+ * @param prescaler Watchdog prescaler, from 0 (16 ms) to 9 (8 s).
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wdt_scheduler_start(uint8_t prescaler)
+{
+    uint8_t wdp = (prescaler & 0x07) | ((prescaler & 0x08) ? _BV(WDP3) : 0);
+    uint8_t sreg = SREG;
+
+    cli();
+    wdt_reset();
+
+    // Timed sequence, the prescaler is written within 4 cycles of WDCE
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = _BV(WDIE) | wdp;
+
+    wdt_scheduler_prescaler = prescaler;
+    wdt_scheduler_start = _wdt_scheduler_crystal_us();
+    wdt_scheduler_measure = 1;
+    SREG = sreg;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to update the calibration with a watchdog period measured
+ * against the crystal, from the interrupt.
+ *
+ * @param us Microseconds of the period.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wdt_scheduler_calibrate(uint32_t us)
+{
+    uint8_t prescaler = wdt_scheduler_prescaler;
+    uint32_t nominal = WDT_SCHEDULER_BASE_US << prescaler;
+    int32_t scale;
+
+    // A period stretched by the interrupts disabled is discarded
+    if ( (us <= (nominal / 2)) || (us >= (nominal * 2)) )
+    {
+        return;
+    }
+
+    scale = (int32_t) ((us << (16 - prescaler)) / WDT_SCHEDULER_BASE_US);
+
+    if (!wdt_scheduler_calibrated)
+    {
+        wdt_scheduler_cal = (uint32_t) scale;
+        wdt_scheduler_calibrated = 1;
+    }
+    else
+    {
+        wdt_scheduler_cal += (scale - (int32_t) wdt_scheduler_cal) /
+                             (1L << WDT_SCHEDULER_FILTER);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to sleep in power-down until the clock reaches a time,
+ * chaining the watchdog periods.
+ *
+ * @param deadline Time to wake up in milliseconds.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_wdt_scheduler_sleep(uint32_t deadline)
+{
+    int32_t remaining;
+    uint8_t prescaler;
+
+    while (1)
+    {
+        _wdt_scheduler_sync();
+        remaining = (int32_t) (deadline - wdt_scheduler_time_ms());
+
+        // Under half of the shortest period the job runs early, not late
+        if (remaining < (int32_t) (wdt_scheduler_period_us(0) / 2000UL))
+        {
+            break;
+        }
+
+        prescaler = WDT_SCHEDULER_MAX_PRESCALER;
+        while ( (prescaler > 0) &&
+                ((wdt_scheduler_period_us(prescaler) / 1000UL) >
+                 (uint32_t) remaining) )
+        {
+            prescaler--;
+        }
+        _wdt_scheduler_start(prescaler);
+
+        set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+        cli();
+        wdt_scheduler_asleep = 1;
+        wdt_scheduler_woken = 0;
+
+        // Other interrupts also wake the CPU, it sleeps until the watchdog
+        while (!wdt_scheduler_woken)
+        {
+            sleep_enable();
+            sleep_bod_disable();
+            sei();
+            sleep_cpu();
+            sleep_disable();
+            cli();
+        }
+
+        wdt_scheduler_asleep = 0;
+        sei();
+    }
+
+    _wdt_scheduler_start(WDT_SCHEDULER_AWAKE_PRESCALER);
+}
+
+/*****************************************************************************/
+/*!
+ * Watchdog interrupt.
+ */
+/*****************************************************************************/
+ISR(WDT_vect)
+{
+    uint32_t now = _wdt_scheduler_crystal_us();
+
+    if (wdt_scheduler_asleep)
+    {
+        // Timer0 was stopped, the time asleep is the calibrated period
+        _wdt_scheduler_add_us(wdt_scheduler_period_us(wdt_scheduler_prescaler));
+        wdt_scheduler_woken = 1;
+        wdt_scheduler_measure = 0;
+    }
+    else
+    {
+        _wdt_scheduler_add_us(now - wdt_scheduler_ref);
+        if (wdt_scheduler_measure)
+        {
+            _wdt_scheduler_calibrate(now - wdt_scheduler_start);
+        }
+        wdt_scheduler_measure = 1;
+    }
+
+    wdt_scheduler_ref = now;
+    wdt_scheduler_start = now;
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
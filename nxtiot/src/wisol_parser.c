@@ -0,0 +1,397 @@
+/******************************************************************************
+* Title                 :   Wisol parser source file
+* Filename              :   wisol_parser.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        wisol_parser.c
+ *  @brief       Wisol response parser implementation
+ *
+ *  To use the Wisol response parser, include this header file as follows:
+ *  @code
+ *      #include "wisol_parser.h"
+ *  @endcode
+ *
+ *  ## Overview ##
+ *  The Wisol response parser recognizes the lines sent by the Sigfox Wisol
+ *  module while the characters are received, without waiting for the whole
+ *  line to scan it:
+ *      - "OK"                      WISOL_TOKEN_OK
+ *      - "ERROR", "ERR_..."        WISOL_TOKEN_ERROR
+ *      - "0045A3F2" (ID, PAC)      WISOL_TOKEN_HEX
+ *      - "RX=01 02 03 04 ..."      WISOL_TOKEN_DOWNLINK
+ *      - "AT..." (echo)            WISOL_TOKEN_ECHO
+ *      - Any other line            WISOL_TOKEN_TEXT
+ *
+ *  Every character narrows the set of possible line types, so when the end
+ *  of the line is received the type is already known. The characters are
+ *  stored only once, in the line buffer of the parser, and the hexadecimal
+ *  lines are decoded in place in the same buffer. The token returned points
+ *  to the line buffer, nothing is copied. A caller waiting for a line it
+ *  keeps, as the ID of the module, gives its own buffer with
+ *  wisol_parser_set_buffer so the line is received and decoded there.
+ *
+ *  ## Usage ##
+ *
+ *  To use the Wisol response parser, the parser must be first initialized
+ *  using the wisol_parser_init function and then every received character
+ *  is fed with the wisol_parser_feed function.
+ *
+ *  @code
+ *      #include "wisol_parser.h"
+ *
+ *      wisol_token token;
+ *      unsigned char data;
+ *
+ *      wisol_parser_init();
+ *
+ *      while (uart_try_read_char(&data))
+ *      {
+ *          if (wisol_parser_feed(data, &token) == WISOL_TOKEN_HEX)
+ *          {
+ *              // token.data holds token.size bytes of the ID
+ *          }
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "wisol_parser.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! The line can still be "OK" */
+#define CANDIDATE_OK        0x01
+/*! The line can still be an error */
+#define CANDIDATE_ERROR     0x02
+/*! The line can still be a downlink */
+#define CANDIDATE_DOWNLINK  0x04
+/*! The line can still be an echoed command */
+#define CANDIDATE_ECHO      0x08
+/*! The line can still be a hexadecimal line */
+#define CANDIDATE_HEX       0x10
+/*! Every line type is possible */
+#define CANDIDATE_ALL       0x1F
+
+/*! Size of the downlink prefix "RX=" */
+#define DOWNLINK_PREFIX     3
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! Macro used to check if a character is a hexadecimal digit */
+#define IS_HEX(c)           ( (((uint8_t) ((c) - '0')) < 10) || \
+                              (((uint8_t) (((c) | 0x20) - 'a')) < 6) )
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Line buffer of the parser */
+static uint8_t wisol_parser_storage[WISOL_PARSER_LINE_SIZE];
+/*! Characters of the line being received */
+static uint8_t* wisol_parser_line = wisol_parser_storage;
+/*! Size of the buffer of the line */
+static uint8_t wisol_parser_size = WISOL_PARSER_LINE_SIZE;
+/*! Number of characters of the line being received */
+static uint8_t wisol_parser_length;
+/*! Line types still possible for the line being received */
+static uint8_t wisol_parser_candidates;
+/*! Flag set when the line does not fit in the line buffer */
+static uint8_t wisol_parser_overflow;
+/*! Number of hexadecimal digits after the downlink prefix */
+static uint8_t wisol_parser_digits;
+
+_Static_assert(sizeof(wisol_parser_storage) == WISOL_PARSER_RAM_SIZE,
+               "WISOL_PARSER_RAM_SIZE does not match the buffers");
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static wisol_token_type _wisol_parser_end_line(wisol_token* token);
+static uint8_t _wisol_parser_decode(uint8_t start);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * @addtogroup wisol_parser
+ * @{
+ */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize the Wisol response parser.
+ *
+ * Any partially received line is discarded.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+wisol_parser_init(void)
+{
+    wisol_parser_length = 0;
+    wisol_parser_candidates = CANDIDATE_ALL;
+    wisol_parser_overflow = 0;
+    wisol_parser_digits = 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to set the buffer where the lines are received and decoded,
+ * so a line expected by the caller lands where it is used.
+ *
+ * @param line Pointer to the buffer, NULL for the buffer of the parser.
+ * @param size Size of the buffer.
+ *
+ * @return None.
+ *
+ * \b Example:
+ * @code
+ *      uint8_t id[8];
+ *
+ *      wisol_parser_set_buffer(id, sizeof(id));
+ *      ...
+ *      wisol_parser_set_buffer(NULL, 0);
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+void
+wisol_parser_set_buffer(uint8_t* line, uint8_t size)
+{
+    if (line == NULL)
+    {
+        line = wisol_parser_storage;
+        size = WISOL_PARSER_LINE_SIZE;
+    }
+
+    wisol_parser_line = line;
+    wisol_parser_size = size;
+    wisol_parser_init();
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to feed a received character to the parser.
+ *
+ * The carriage return characters are ignored and the empty lines are
+ * skipped.
+ *
+ * @param data Character received from the module.
+ * @param token Pointer where the line will be written when a line is
+ *              completed.
+ *
+ * @return The type of the line completed by the character, or
+ *         WISOL_TOKEN_NONE if the line is not complete yet.
+ *
+ * \b Example:
+ * @code
+ *      wisol_token token;
+ *
+ *      if (wisol_parser_feed(data, &token) == WISOL_TOKEN_OK)
+ *      {
+ *          // Command accepted
+ *      }
+ * @endcode
+ *
+ */
+/*****************************************************************************/
+wisol_token_type
+wisol_parser_feed(uint8_t data, wisol_token* token)
+{
+    uint8_t position = wisol_parser_length;
+    uint8_t candidates = wisol_parser_candidates;
+
+    if (data == '\r')
+    {
+        return WISOL_TOKEN_NONE;
+    }
+
+    if (data == '\n')
+    {
+        return _wisol_parser_end_line(token);
+    }
+
+    if (position < wisol_parser_size)
+    {
+        wisol_parser_line[position] = data;
+        wisol_parser_length = position + 1;
+    }
+    else
+    {
+        wisol_parser_overflow = 1;
+    }
+
+    // Discard the line types that do not match the character
+    if ( (position >= 2) || (data != "OK"[position]) )
+    {
+        candidates &= ~CANDIDATE_OK;
+    }
+
+    if ( (position < 3) && (data != "ERR"[position]) )
+    {
+        candidates &= ~CANDIDATE_ERROR;
+    }
+
+    if (position < DOWNLINK_PREFIX)
+    {
+        if (data != "RX="[position])
+        {
+            candidates &= ~CANDIDATE_DOWNLINK;
+        }
+    }
+    else if (IS_HEX(data))
+    {
+        wisol_parser_digits++;
+    }
+    else if (data != ' ')
+    {
+        candidates &= ~CANDIDATE_DOWNLINK;
+    }
+
+    if ( (position < 2) && (data != "AT"[position]) )
+    {
+        candidates &= ~CANDIDATE_ECHO;
+    }
+
+    if (!IS_HEX(data))
+    {
+        candidates &= ~CANDIDATE_HEX;
+    }
+
+    wisol_parser_candidates = candidates;
+
+    return WISOL_TOKEN_NONE;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to complete the line being received.
+ *
+ * @param token Pointer where the line will be written.
+ *
+ * @return The type of the line.
+ */
+/*****************************************************************************/
+static wisol_token_type
+_wisol_parser_end_line(wisol_token* token)
+{
+    wisol_token_type type = WISOL_TOKEN_TEXT;
+    uint8_t length = wisol_parser_length;
+    uint8_t candidates = wisol_parser_candidates;
+    uint8_t size = length;
+
+    if (length == 0)
+    {
+        return WISOL_TOKEN_NONE;
+    }
+
+    if (wisol_parser_overflow)
+    {
+        type = WISOL_TOKEN_OVERFLOW;
+    }
+    else if ( (candidates & CANDIDATE_OK) && (length == 2) )
+    {
+        type = WISOL_TOKEN_OK;
+    }
+    else if ( (candidates & CANDIDATE_ERROR) && (length >= 3) )
+    {
+        type = WISOL_TOKEN_ERROR;
+    }
+    else if ( (candidates & CANDIDATE_DOWNLINK) && 
+              (wisol_parser_digits != 0) && !(wisol_parser_digits & 0x01) )
+    {
+        size = _wisol_parser_decode(DOWNLINK_PREFIX);
+        type = WISOL_TOKEN_DOWNLINK;
+    }
+    else if ( (candidates & CANDIDATE_ECHO) && (length >= 2) )
+    {
+        type = WISOL_TOKEN_ECHO;
+    }
+    else if ( (candidates & CANDIDATE_HEX) && !(length & 0x01) )
+    {
+        size = _wisol_parser_decode(0);
+        type = WISOL_TOKEN_HEX;
+    }
+
+    token->type = type;
+    token->data = wisol_parser_line;
+    token->size = size;
+
+    wisol_parser_init();
+
+    return type;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to decode in place the hexadecimal digits of the line.
+ *
+ * The decoded bytes are written from the beginning of the line buffer, the
+ * spaces between the digits are skipped. A byte is always written at a
+ * position already read, so the line is decoded in a single pass.
+ *
+ * @pre The number of digits must be even.
+ *
+ * @param start Position of the first digit.
+ *
+ * @return Number of decoded bytes.
+ */
+/*****************************************************************************/
+static uint8_t
+_wisol_parser_decode(uint8_t start)
+{
+    uint8_t size = 0;
+    uint8_t nibbles = 0;
+    uint8_t value = 0;
+    uint8_t c;
+
+    // Digits are handled as their value minus '0', letters are moved next
+    // to the digits in a single branch
+
+    for (uint8_t i = start; i < wisol_parser_length; i++)
+    {
+        c = wisol_parser_line[i];
+        if (c == ' ')
+        {
+            continue;
+        }
+
+        c -= '0';
+        if (c > 9)
+        {
+            c = ((c + '0') | 0x20) - 'a' + 10;
+        }
+
+        value = (value << 4) | c;
+        nibbles++;
+
+        if (!(nibbles & 0x01))
+        {
+            wisol_parser_line[size++] = value;
+        }
+    }
+
+    return size;
+}
+
+/*****************************************************************************/
+/*!
+ * Close the Doxygen group.
+ * @}
+ */
+/*****************************************************************************/
@@ -0,0 +1,148 @@
+#include <string.h>
+#include "unity.h"
+#include "arena.h"
+
+// Text sent by arena_report
+static char sent[256];
+
+void
+uart_send(const char* str)
+{
+    strncat(sent, str, sizeof(sent) - strlen(sent) - 1);
+}
+
+void
+setUp(void)
+{
+    sent[0] = '\0';
+    arena_init();
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_Arena_should_AllocateAlignedBuffersUntilFull(void)
+{
+    uint8_t* first = arena_alloc(3);
+    uint8_t* second = arena_alloc(8);
+    arena_usage usage;
+
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_EQUAL_PTR(first + ARENA_ROUND(3), second);
+    TEST_ASSERT_EQUAL_UINT32(0, (uintptr_t) second % ARENA_ALIGN);
+
+    // The rest of the arena, then nothing
+    arena_get_usage(&usage);
+    TEST_ASSERT_NULL(arena_alloc(usage.size - usage.used + 1));
+    TEST_ASSERT_NOT_NULL(arena_alloc(usage.size - usage.used));
+    TEST_ASSERT_NULL(arena_alloc(1));
+    TEST_ASSERT_NULL(arena_alloc(0));
+
+    arena_get_usage(&usage);
+    TEST_ASSERT_EQUAL_UINT16(usage.size, usage.used);
+    TEST_ASSERT_EQUAL_UINT8(3, usage.failures);
+}
+
+void
+test_Arena_should_RefuseAllocationsAfterLock(void)
+{
+    arena_usage usage;
+
+    TEST_ASSERT_NOT_NULL(arena_alloc(4));
+    arena_lock();
+    TEST_ASSERT_NULL(arena_alloc(4));
+
+    // The pools are still available
+    TEST_ASSERT_NOT_NULL(arena_pool_alloc(ARENA_POOL_SMALL));
+
+    arena_get_usage(&usage);
+    TEST_ASSERT_EQUAL_UINT8(1, usage.locked);
+    TEST_ASSERT_EQUAL_UINT8(1, usage.failures);
+    TEST_ASSERT_EQUAL_UINT16(ARENA_ROUND(4), usage.used);
+}
+
+void
+test_Arena_should_ReuseFreedPoolBlocks(void)
+{
+    uint8_t* blocks[BOARD_POOL_SMALL_COUNT];
+    arena_usage usage;
+    uint8_t i;
+
+    for (i = 0; i < BOARD_POOL_SMALL_COUNT; i++)
+    {
+        blocks[i] = arena_pool_alloc(ARENA_POOL_SMALL);
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+        memset(blocks[i], i, BOARD_POOL_SMALL_BLOCK);
+    }
+    TEST_ASSERT_NULL(arena_pool_alloc(ARENA_POOL_SMALL));
+
+    // The blocks do not overlap
+    for (i = 0; i < BOARD_POOL_SMALL_COUNT; i++)
+    {
+        TEST_ASSERT_EQUAL_HEX8(i, blocks[i][0]);
+        TEST_ASSERT_EQUAL_HEX8(i, blocks[i][BOARD_POOL_SMALL_BLOCK - 1]);
+    }
+
+    arena_pool_free(ARENA_POOL_SMALL, blocks[1]);
+    TEST_ASSERT_EQUAL_PTR(blocks[1], arena_pool_alloc(ARENA_POOL_SMALL));
+
+    // Pointers that are not blocks of the pool are ignored
+    arena_pool_free(ARENA_POOL_SMALL, blocks[2] + 1);
+    arena_pool_free(ARENA_POOL_LARGE, blocks[2]);
+    arena_pool_free(ARENA_POOL_SMALL, NULL);
+    TEST_ASSERT_NULL(arena_pool_alloc(ARENA_POOL_SMALL));
+
+    arena_pool_free(ARENA_POOL_SMALL, blocks[0]);
+    arena_pool_free(ARENA_POOL_SMALL, blocks[3]);
+
+    arena_get_usage(&usage);
+    TEST_ASSERT_EQUAL_UINT16(BOARD_POOL_SMALL_BLOCK,
+                             usage.pools[ARENA_POOL_SMALL].block);
+    TEST_ASSERT_EQUAL_UINT8(BOARD_POOL_SMALL_COUNT - 2,
+                            usage.pools[ARENA_POOL_SMALL].used);
+    TEST_ASSERT_EQUAL_UINT8(BOARD_POOL_SMALL_COUNT,
+                            usage.pools[ARENA_POOL_SMALL].peak);
+    TEST_ASSERT_EQUAL_UINT8(2, usage.pools[ARENA_POOL_SMALL].failures);
+    TEST_ASSERT_EQUAL_UINT8(0, usage.pools[ARENA_POOL_LARGE].used);
+}
+
+void
+test_Arena_should_ReportTheUsage(void)
+{
+    char expected[160];
+
+    arena_alloc(10);
+    arena_pool_alloc(ARENA_POOL_LARGE);
+
+    arena_report();
+
+    snprintf(expected, sizeof(expected),
+             "ARENA budget %u drivers %u used %u/%u fail 0"
+             " pool %u used 0/%u peak 0 fail 0"
+             " pool %u used 1/%u peak 1 fail 0\n",
+             BOARD_DRIVERS_RAM,
+             16 + 32 + 16 + 40 + 12 + 64 + 267 + 19 + 40 + 111,
+             (unsigned) ARENA_ROUND(10),
+             (unsigned) ARENA_ROUND(BOARD_ARENA_SIZE),
+             BOARD_POOL_SMALL_BLOCK, BOARD_POOL_SMALL_COUNT,
+             BOARD_POOL_LARGE_BLOCK, BOARD_POOL_LARGE_COUNT);
+    TEST_ASSERT_EQUAL_STRING(expected, sent);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Arena_should_AllocateAlignedBuffersUntilFull);
+    RUN_TEST(test_Arena_should_RefuseAllocationsAfterLock);
+    RUN_TEST(test_Arena_should_ReuseFreedPoolBlocks);
+    RUN_TEST(test_Arena_should_ReportTheUsage);
+
+    return UNITY_END();
+}
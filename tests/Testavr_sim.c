@@ -0,0 +1,330 @@
+#include "unity.h"
+#include "avr_sim.h"
+#include "avr/interrupt.h"
+#include "util/delay.h"
+
+// CPU cycles of a bit at 9600 baud with UBRR0 = 103
+#define CYCLES_PER_BIT      (16UL * 104UL)
+
+static uint16_t timer_ticks;
+static uint16_t pin_changes;
+
+static uint8_t tx_bytes[8];
+static uint64_t tx_time[8];
+static uint8_t tx_count;
+
+static uint8_t rx_bytes[8];
+static uint8_t rx_count;
+
+static volatile uint8_t* changed_port;
+static uint8_t changed_pin;
+static uint8_t changed_level;
+
+static uint64_t event_time;
+
+ISR(TIMER0_COMPA_vect)
+{
+    timer_ticks++;
+}
+
+ISR(PCINT0_vect)
+{
+    pin_changes++;
+}
+
+ISR(USART_RX_vect)
+{
+    rx_bytes[rx_count++] = UDR0;
+}
+
+static void
+tx_handler(uint8_t data)
+{
+    tx_time[tx_count] = avr_sim_cycles();
+    tx_bytes[tx_count++] = data;
+}
+
+static void
+pin_handler(volatile uint8_t* port, uint8_t pin, uint8_t level)
+{
+    changed_port = port;
+    changed_pin = pin;
+    changed_level = level;
+}
+
+static void
+event_handler(void)
+{
+    event_time = avr_sim_cycles();
+}
+
+static void
+uart_setup(uint8_t enable)
+{
+    UBRR0 = 103;
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);
+    UCSR0B = enable;
+}
+
+void
+setUp(void)
+{
+    avr_sim_start();
+    timer_ticks = 0;
+    pin_changes = 0;
+    tx_count = 0;
+    rx_count = 0;
+    changed_port = NULL;
+    event_time = 0;
+}
+
+void
+tearDown(void)
+{
+    avr_sim_stop();
+}
+
+void
+test_AvrSim_should_KeepRegistersAsMemoryWhenStopped(void)
+{
+    avr_sim_stop();
+
+    TIFR0 = _BV(OCF0A);
+    UDR0 = 0x55;
+    UCSR0A = 0x00;
+    PINB = 0x01;
+
+    TEST_ASSERT_EQUAL_HEX8(_BV(OCF0A), TIFR0);
+    TEST_ASSERT_EQUAL_HEX8(0x55, UDR0);
+    TEST_ASSERT_EQUAL_HEX8(0x00, UCSR0A);
+    TEST_ASSERT_EQUAL_HEX8(0x01, PINB);
+    TEST_ASSERT_EQUAL_HEX8(0x00, PORTB);
+}
+
+void
+test_AvrSim_should_AdvanceClockOnAccessAndDelay(void)
+{
+    uint64_t start = avr_sim_cycles();
+
+    (void) PORTB;
+    TEST_ASSERT_EQUAL_UINT32(AVR_SIM_ACCESS_CYCLES,
+                             (uint32_t) (avr_sim_cycles() - start));
+
+    start = avr_sim_cycles();
+    _delay_ms(2);
+    TEST_ASSERT_EQUAL_UINT32(32000, (uint32_t) (avr_sim_cycles() - start));
+    TEST_ASSERT_EQUAL_UINT32(2000, (uint32_t) avr_sim_micros());
+}
+
+void
+test_AvrSim_should_RunTimerInterruptAtCompareRate(void)
+{
+    // 1 ms period: 16 MHz / 64 / 250
+    TCCR0A = _BV(WGM01);
+    OCR0A = 249;
+    TIMSK0 = _BV(OCIE0A);
+    TCCR0B = _BV(CS01) | _BV(CS00);
+    sei();
+
+    avr_sim_run(10UL * 16000UL);
+
+    TEST_ASSERT_UINT_WITHIN(1, 10, timer_ticks);
+    TEST_ASSERT_TRUE(TCNT0 <= 249);
+    TEST_ASSERT_BITS_LOW(_BV(OCF0A), TIFR0);
+}
+
+void
+test_AvrSim_should_ClearFlagsWrittenToOne(void)
+{
+    TCCR0B = _BV(CS00);
+    avr_sim_run(300);
+
+    TEST_ASSERT_BITS_HIGH(_BV(TOV0), TIFR0);
+    TEST_ASSERT_BITS_HIGH(_BV(TOV0), TIFR0);
+
+    TIFR0 = _BV(OCF0B);
+    TEST_ASSERT_BITS_HIGH(_BV(TOV0), TIFR0);
+
+    TIFR0 = _BV(TOV0);
+    TEST_ASSERT_BITS_LOW(_BV(TOV0), TIFR0);
+}
+
+void
+test_AvrSim_should_SendBytesWithFrameTime(void)
+{
+    uint64_t start;
+
+    avr_sim_uart_set_handler(tx_handler);
+    uart_setup(_BV(TXEN0));
+
+    start = avr_sim_cycles();
+    UDR0 = 'A';
+    TEST_ASSERT_BITS_HIGH(_BV(UDRE0), UCSR0A);
+    UDR0 = 'A';
+    TEST_ASSERT_BITS_LOW(_BV(UDRE0), UCSR0A);
+
+    avr_sim_run(25 * CYCLES_PER_BIT);
+
+    TEST_ASSERT_EQUAL_UINT8(2, tx_count);
+    TEST_ASSERT_EQUAL_HEX8('A', tx_bytes[0]);
+    TEST_ASSERT_EQUAL_HEX8('A', tx_bytes[1]);
+    TEST_ASSERT_UINT_WITHIN(16, 10 * CYCLES_PER_BIT,
+                            (uint32_t) (tx_time[0] - start));
+    TEST_ASSERT_EQUAL_UINT32(10 * CYCLES_PER_BIT,
+                             (uint32_t) (tx_time[1] - tx_time[0]));
+    TEST_ASSERT_BITS_HIGH(_BV(TXC0) | _BV(UDRE0), UCSR0A);
+
+    UCSR0A = _BV(TXC0);
+    TEST_ASSERT_BITS_LOW(_BV(TXC0), UCSR0A);
+}
+
+void
+test_AvrSim_should_ReceiveBytesThroughInterrupt(void)
+{
+    uart_setup(_BV(RXEN0) | _BV(RXCIE0));
+    sei();
+
+    TEST_ASSERT_EQUAL_UINT16(3, avr_sim_uart_rx((const uint8_t *) "OK\n", 3));
+    avr_sim_run(25 * CYCLES_PER_BIT);
+    TEST_ASSERT_EQUAL_UINT8(2, rx_count);
+    TEST_ASSERT_EQUAL_UINT16(1, avr_sim_uart_rx_pending());
+
+    avr_sim_run(10 * CYCLES_PER_BIT);
+    TEST_ASSERT_EQUAL_UINT8(3, rx_count);
+    TEST_ASSERT_EQUAL_MEMORY("OK\n", rx_bytes, 3);
+    TEST_ASSERT_BITS_LOW(_BV(RXC0), UCSR0A);
+}
+
+void
+test_AvrSim_should_FlagOverrunWhenNotRead(void)
+{
+    uart_setup(_BV(RXEN0));
+
+    avr_sim_uart_rx((const uint8_t *) "abc", 3);
+    avr_sim_run(35 * CYCLES_PER_BIT);
+
+    TEST_ASSERT_BITS_HIGH(_BV(RXC0) | _BV(DOR0), UCSR0A);
+    TEST_ASSERT_EQUAL_HEX8('a', UDR0);
+    TEST_ASSERT_EQUAL_HEX8('b', UDR0);
+    TEST_ASSERT_BITS_LOW(_BV(RXC0), UCSR0A);
+}
+
+void
+test_AvrSim_should_DrivePinsAndFlagPinChanges(void)
+{
+    avr_sim_pin_set_handler(pin_handler);
+    PCMSK0 = _BV(PB0);
+    PCICR = _BV(PCIE0);
+    sei();
+
+    // Released input with the pull-up enabled
+    PORTB = _BV(PB0);
+    avr_sim_run(1);
+    TEST_ASSERT_BITS_HIGH(_BV(PB0), PINB);
+    TEST_ASSERT_EQUAL_UINT16(1, pin_changes);
+
+    avr_sim_pin_drive(&PORTB, PB0, 0);
+    avr_sim_run(1);
+    TEST_ASSERT_BITS_LOW(_BV(PB0), PINB);
+    TEST_ASSERT_EQUAL_UINT16(2, pin_changes);
+
+    // Output toggled by writing PINB
+    DDRB = _BV(PB1);
+    PINB = _BV(PB1);
+    avr_sim_run(1);
+    TEST_ASSERT_EQUAL_HEX8(_BV(PB0) | _BV(PB1), PORTB);
+    TEST_ASSERT_TRUE(changed_port == &PORTB);
+    TEST_ASSERT_EQUAL_UINT8(PB1, changed_pin);
+    TEST_ASSERT_EQUAL_UINT8(1, changed_level);
+    TEST_ASSERT_EQUAL_UINT16(2, pin_changes);
+}
+
+void
+test_AvrSim_should_FlagExternalInterruptEdges(void)
+{
+    // INT0 on the falling edge of PD2
+    EICRA = _BV(ISC01);
+    avr_sim_pin_drive(&PORTD, PD2, 1);
+    avr_sim_run(1);
+    TEST_ASSERT_BITS_LOW(_BV(INTF0), EIFR);
+
+    avr_sim_pin_drive(&PORTD, PD2, 0);
+    avr_sim_run(1);
+    TEST_ASSERT_BITS_HIGH(_BV(INTF0), EIFR);
+}
+
+void
+test_AvrSim_should_CallScheduledEvents(void)
+{
+    uint64_t start = avr_sim_cycles();
+
+    TEST_ASSERT_EQUAL_UINT8(1, avr_sim_schedule(100, event_handler));
+    avr_sim_run(1000);
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t) event_time);
+
+    avr_sim_run(1000);
+    TEST_ASSERT_EQUAL_UINT32(1600, (uint32_t) (event_time - start));
+}
+
+void
+test_AvrSim_should_DecodeAndDrivePinUart(void)
+{
+    uint8_t data = 0xA5;
+    uint8_t received = 0;
+    uint8_t i;
+
+    avr_sim_pin_uart(&PORTD, PD1, PD0, 9600, tx_handler);
+    DDRD = _BV(PD1);
+    PORTD = _BV(PD1);
+    avr_sim_run(CYCLES_PER_BIT);
+
+    // Bit banged 8N1 frame at 9600 baud
+    PORTD = 0;
+    _delay_us(104);
+    for (i = 0; i < 8; i++)
+    {
+        PORTD = (data & _BV(i)) ? _BV(PD1) : 0;
+        _delay_us(104);
+    }
+    PORTD = _BV(PD1);
+    _delay_us(208);
+
+    TEST_ASSERT_EQUAL_UINT8(1, tx_count);
+    TEST_ASSERT_EQUAL_HEX8(0xA5, tx_bytes[0]);
+
+    // Frame sent on PD0, sampled in the middle of every bit
+    avr_sim_pin_uart_rx(&data, 1);
+    while (PIND & _BV(PD0))
+    {
+    }
+    _delay_us(52);
+    for (i = 0; i < 8; i++)
+    {
+        _delay_us(104);
+        received |= (PIND & _BV(PD0)) ? _BV(i) : 0;
+    }
+    _delay_us(104);
+
+    TEST_ASSERT_EQUAL_HEX8(0xA5, received);
+    TEST_ASSERT_BITS_HIGH(_BV(PD0), PIND);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_AvrSim_should_KeepRegistersAsMemoryWhenStopped);
+    RUN_TEST(test_AvrSim_should_AdvanceClockOnAccessAndDelay);
+    RUN_TEST(test_AvrSim_should_RunTimerInterruptAtCompareRate);
+    RUN_TEST(test_AvrSim_should_ClearFlagsWrittenToOne);
+    RUN_TEST(test_AvrSim_should_SendBytesWithFrameTime);
+    RUN_TEST(test_AvrSim_should_ReceiveBytesThroughInterrupt);
+    RUN_TEST(test_AvrSim_should_FlagOverrunWhenNotRead);
+    RUN_TEST(test_AvrSim_should_DrivePinsAndFlagPinChanges);
+    RUN_TEST(test_AvrSim_should_FlagExternalInterruptEdges);
+    RUN_TEST(test_AvrSim_should_CallScheduledEvents);
+    RUN_TEST(test_AvrSim_should_DecodeAndDrivePinUart);
+
+    return UNITY_END();
+}
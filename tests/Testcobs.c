@@ -0,0 +1,339 @@
+#include <string.h>
+#include "unity.h"
+#include "cobs.h"
+#include <util/crc16.h>
+
+#define MAX_FRAME       600
+
+// Bytes sent by the encoder
+static uint8_t sent[MAX_FRAME * 2];
+static uint16_t sent_count;
+static const uint8_t* write_data[MAX_FRAME];
+static uint8_t write_size[MAX_FRAME];
+static uint16_t writes;
+
+static uint8_t frame[MAX_FRAME];
+static uint8_t raw[MAX_FRAME + COBS_CRC_SIZE];
+static uint8_t expected[MAX_FRAME * 2];
+static uint8_t decoded[MAX_FRAME + COBS_CRC_SIZE];
+
+static void
+fake_write(const uint8_t* data, uint8_t size)
+{
+    write_data[writes] = data;
+    write_size[writes] = size;
+    writes++;
+
+    memcpy(&sent[sent_count], data, size);
+    sent_count += size;
+}
+
+// Reference COBS encoder of a complete buffer
+static uint16_t
+reference_encode(const uint8_t* data, uint16_t size, uint8_t* out)
+{
+    uint16_t code_index = 0;
+    uint16_t index = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        if (data[i] == 0)
+        {
+            out[code_index] = code;
+            code_index = index++;
+            code = 1;
+        }
+        else
+        {
+            out[index++] = data[i];
+            code++;
+            if ( (code == 0xFF) && ((i + 1) < size) )
+            {
+                out[code_index] = code;
+                code_index = index++;
+                code = 1;
+            }
+        }
+    }
+    out[code_index] = code;
+
+    return index;
+}
+
+// Expected bytes sent for a frame: the frame and its CRC encoded and the
+// delimiter
+static uint16_t
+expected_frame(const uint8_t* data, uint16_t size)
+{
+    uint16_t crc = 0xFFFF;
+    uint16_t length;
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        crc = _crc_xmodem_update(crc, data[i]);
+    }
+    memcpy(raw, data, size);
+    raw[size] = (uint8_t) (crc >> 8);
+    raw[size + 1] = (uint8_t) crc;
+
+    length = reference_encode(raw, size + COBS_CRC_SIZE, expected);
+    expected[length++] = 0x00;
+
+    return length;
+}
+
+// Fills the frame with non zero bytes and a zero every zeros bytes, if
+// zeros is not 0
+static void
+fill_frame(uint16_t size, uint8_t zeros)
+{
+    for (uint16_t i = 0; i < size; i++)
+    {
+        frame[i] = (uint8_t) (i * 37 + 1);
+        if (zeros == 0)
+        {
+            frame[i] = frame[i] ? frame[i] : 0x5A;
+        }
+        else if ((i % zeros) == 0)
+        {
+            frame[i] = 0;
+        }
+    }
+}
+
+static cobs_status
+decode_sent(cobs_decoder* decoder)
+{
+    cobs_status status = COBS_PENDING;
+
+    for (uint16_t i = 0; i < sent_count; i++)
+    {
+        status = cobs_decode(decoder, sent[i]);
+        if (i + 1 < sent_count)
+        {
+            TEST_ASSERT_EQUAL(COBS_PENDING, status);
+        }
+    }
+
+    return status;
+}
+
+void
+setUp(void)
+{
+    sent_count = 0;
+    writes = 0;
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_Cobs_should_EncodeAsReference(void)
+{
+    const uint16_t sizes[] = {0, 1, 2, 3, 200, 251, 252, 253, 254, 255, 256,
+                              507, 508, 509, MAX_FRAME};
+    const uint8_t zeros[] = {0, 1, 2, 7, 254, 255};
+    uint16_t length;
+
+    for (uint8_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        for (uint8_t z = 0; z < sizeof(zeros); z++)
+        {
+            fill_frame(sizes[s], zeros[z]);
+            length = expected_frame(frame, sizes[s]);
+
+            sent_count = 0;
+            writes = 0;
+            cobs_send_frame(frame, sizes[s], fake_write);
+
+            TEST_ASSERT_EQUAL_UINT16(length, sent_count);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sent, length);
+            TEST_ASSERT_TRUE(sent_count <= COBS_FRAME_MAX(sizes[s]));
+            for (uint16_t i = 0; i + 1 < sent_count; i++)
+            {
+                TEST_ASSERT_TRUE(sent[i] != 0);
+            }
+        }
+    }
+}
+
+void
+test_Cobs_should_EncodeSegmentsAsOneFrame(void)
+{
+    cobs_segment segments[5];
+    uint16_t length;
+
+    fill_frame(400, 9);
+    length = expected_frame(frame, 400);
+
+    // Splits between and inside runs, and an empty segment
+    segments[0] = (cobs_segment) {&frame[0], 3};
+    segments[1] = (cobs_segment) {&frame[3], 0};
+    segments[2] = (cobs_segment) {&frame[3], 9};
+    segments[3] = (cobs_segment) {&frame[12], 250};
+    segments[4] = (cobs_segment) {&frame[262], 138};
+    cobs_send(segments, 5, fake_write);
+
+    TEST_ASSERT_EQUAL_UINT16(length, sent_count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sent, length);
+}
+
+void
+test_Cobs_should_EncodeZeroStartingASegment(void)
+{
+    const uint8_t first[] = {0x01, 0x02};
+    const uint8_t second[] = {0x00, 0x03};
+    const uint8_t whole[] = {0x01, 0x02, 0x00, 0x03};
+    cobs_segment segments[2] = {{first, 2}, {second, 2}};
+    uint16_t length;
+
+    length = expected_frame(whole, sizeof(whole));
+    cobs_send(segments, 2, fake_write);
+
+    TEST_ASSERT_EQUAL_UINT16(length, sent_count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sent, length);
+}
+
+void
+test_Cobs_should_EncodeZeroInTheCrc(void)
+{
+    const uint8_t data[] = {0x0E};
+    uint16_t length;
+
+    // The CRC is 0x003E, its first byte is a zero
+    length = expected_frame(data, sizeof(data));
+    TEST_ASSERT_EQUAL_HEX8(0x00, raw[1]);
+    cobs_send_frame(data, sizeof(data), fake_write);
+
+    TEST_ASSERT_EQUAL_UINT16(length, sent_count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sent, length);
+}
+
+void
+test_Cobs_should_SendRunsFromCallerBuffer(void)
+{
+    fill_frame(200, 0);
+    cobs_send_frame(frame, 200, fake_write);
+
+    // Code, run, code, CRC and delimiter: the run is not copied
+    TEST_ASSERT_EQUAL_PTR(frame, write_data[1]);
+    TEST_ASSERT_EQUAL_UINT8(200, write_size[1]);
+}
+
+void
+test_Cobs_should_DecodeFrames(void)
+{
+    const uint16_t sizes[] = {0, 1, 253, 254, 255, 508, MAX_FRAME};
+    cobs_decoder decoder;
+
+    cobs_decoder_init(&decoder, decoded, sizeof(decoded));
+
+    for (uint8_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        fill_frame(sizes[s], (s & 1) ? 3 : 0);
+        sent_count = 0;
+        cobs_send_frame(frame, sizes[s], fake_write);
+
+        TEST_ASSERT_EQUAL(COBS_FRAME, decode_sent(&decoder));
+        TEST_ASSERT_EQUAL_UINT16(sizes[s], cobs_frame_size(&decoder));
+        if (sizes[s] > 0)
+        {
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, decoded, sizes[s]);
+        }
+    }
+}
+
+void
+test_Cobs_should_RejectCorruptedFrames(void)
+{
+    cobs_decoder decoder;
+
+    cobs_decoder_init(&decoder, decoded, sizeof(decoded));
+    fill_frame(40, 5);
+    cobs_send_frame(frame, 40, fake_write);
+
+    // A data byte changed
+    sent[10] ^= 0x20;
+    TEST_ASSERT_EQUAL(COBS_ERROR, decode_sent(&decoder));
+    sent[10] ^= 0x20;
+
+    // A frame cut by the delimiter
+    TEST_ASSERT_EQUAL(COBS_PENDING, cobs_decode(&decoder, sent[0]));
+    TEST_ASSERT_EQUAL(COBS_PENDING, cobs_decode(&decoder, sent[1]));
+    TEST_ASSERT_EQUAL(COBS_ERROR, cobs_decode(&decoder, 0x00));
+
+    // Too short for the CRC
+    TEST_ASSERT_EQUAL(COBS_PENDING, cobs_decode(&decoder, 0x02));
+    TEST_ASSERT_EQUAL(COBS_PENDING, cobs_decode(&decoder, 0x55));
+    TEST_ASSERT_EQUAL(COBS_ERROR, cobs_decode(&decoder, 0x00));
+
+    // The next frame is received
+    TEST_ASSERT_EQUAL(COBS_FRAME, decode_sent(&decoder));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, decoded, 40);
+}
+
+void
+test_Cobs_should_RejectFramesTooLong(void)
+{
+    cobs_decoder decoder;
+    uint8_t small[10 + COBS_CRC_SIZE];
+
+    cobs_decoder_init(&decoder, small, sizeof(small));
+
+    fill_frame(11, 4);
+    cobs_send_frame(frame, 11, fake_write);
+    TEST_ASSERT_EQUAL(COBS_ERROR, decode_sent(&decoder));
+
+    sent_count = 0;
+    cobs_send_frame(frame, 10, fake_write);
+    TEST_ASSERT_EQUAL(COBS_FRAME, decode_sent(&decoder));
+    TEST_ASSERT_EQUAL_UINT16(10, cobs_frame_size(&decoder));
+}
+
+void
+test_Cobs_should_IgnoreEmptyFramesAndResynchronize(void)
+{
+    const uint8_t text[] = "boot\n";
+    cobs_decoder decoder;
+
+    cobs_decoder_init(&decoder, decoded, sizeof(decoded));
+
+    // Delimiters alone are not frames
+    TEST_ASSERT_EQUAL(COBS_PENDING, cobs_decode(&decoder, 0x00));
+    TEST_ASSERT_EQUAL(COBS_PENDING, cobs_decode(&decoder, 0x00));
+
+    // Text received before the frame ends in an error at the delimiter
+    for (uint8_t i = 0; i < sizeof(text) - 1; i++)
+    {
+        cobs_decode(&decoder, text[i]);
+    }
+    fill_frame(20, 6);
+    cobs_send_frame(frame, 20, fake_write);
+    TEST_ASSERT_EQUAL(COBS_ERROR, cobs_decode(&decoder, 0x00));
+
+    TEST_ASSERT_EQUAL(COBS_FRAME, decode_sent(&decoder));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, decoded, 20);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Cobs_should_EncodeAsReference);
+    RUN_TEST(test_Cobs_should_EncodeSegmentsAsOneFrame);
+    RUN_TEST(test_Cobs_should_EncodeZeroStartingASegment);
+    RUN_TEST(test_Cobs_should_EncodeZeroInTheCrc);
+    RUN_TEST(test_Cobs_should_SendRunsFromCallerBuffer);
+    RUN_TEST(test_Cobs_should_DecodeFrames);
+    RUN_TEST(test_Cobs_should_RejectCorruptedFrames);
+    RUN_TEST(test_Cobs_should_RejectFramesTooLong);
+    RUN_TEST(test_Cobs_should_IgnoreEmptyFramesAndResynchronize);
+
+    return UNITY_END();
+}
@@ -0,0 +1,286 @@
+#include <string.h>
+#include "unity.h"
+#include "console.h"
+
+// Keystrokes received and text sent through the software UART
+static const char* keys;
+static char sent[256];
+static uint16_t sent_count;
+static uint8_t tx_pending;
+// Words of the last command run
+static uint8_t runs;
+static uint8_t last_argc;
+static char last_argv[CONSOLE_MAX_ARGS][CONSOLE_LINE_SIZE];
+
+uint8_t
+soft_uart_try_read_char(unsigned char* data)
+{
+    if ( (keys == NULL) || (*keys == 0x00) )
+    {
+        return 0;
+    }
+    *data = (unsigned char) *keys++;
+    return 1;
+}
+
+uint8_t
+soft_uart_write(const uint8_t* data, uint8_t size)
+{
+    uint8_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        sent[sent_count++] = (char) data[i];
+    }
+    sent[sent_count] = 0x00;
+    return size;
+}
+
+void
+soft_uart_send(const char* str)
+{
+    soft_uart_write((const uint8_t *) str, (uint8_t) strlen(str));
+}
+
+uint8_t
+soft_uart_tx_pending(void)
+{
+    return tx_pending;
+}
+
+static void
+record(uint8_t argc, char* argv[])
+{
+    uint8_t i;
+
+    runs++;
+    last_argc = argc;
+    for (i = 0; i < argc; i++)
+    {
+        strcpy(last_argv[i], argv[i]);
+    }
+}
+
+static void
+reply(uint8_t argc, char* argv[])
+{
+    soft_uart_send("pong\r\n");
+}
+
+static const console_command commands[] PROGMEM =
+{
+    {"set", record},
+    {"ping", reply}
+};
+
+// Feeds the keystrokes, polling until all are taken
+static void
+type(const char* str)
+{
+    keys = str;
+    while (*keys != 0x00)
+    {
+        console_poll();
+    }
+}
+
+static void
+clear_sent(void)
+{
+    sent_count = 0;
+    sent[0] = 0x00;
+}
+
+void
+setUp(void)
+{
+    keys = NULL;
+    tx_pending = 0;
+    runs = 0;
+    last_argc = 0;
+    clear_sent();
+    console_init(commands, sizeof(commands) / sizeof(commands[0]));
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_Console_should_ShowPromptOnInit(void)
+{
+    TEST_ASSERT_EQUAL_STRING(CONSOLE_PROMPT, sent);
+}
+
+void
+test_Console_should_TokenizeInPlace(void)
+{
+    char line[] = "  set  \"a b\" c  ";
+    char* argv[4];
+
+    TEST_ASSERT_EQUAL_UINT8(3, console_tokenize(line, argv, 4));
+    TEST_ASSERT_EQUAL_STRING("set", argv[0]);
+    TEST_ASSERT_EQUAL_STRING("a b", argv[1]);
+    TEST_ASSERT_EQUAL_STRING("c", argv[2]);
+    TEST_ASSERT_TRUE(argv[0] >= line && argv[2] < line + sizeof(line));
+
+    strcpy(line, "a b c d e");
+    TEST_ASSERT_EQUAL_UINT8(5, console_tokenize(line, argv, 2));
+    TEST_ASSERT_EQUAL_STRING("b", argv[1]);
+}
+
+void
+test_Console_should_EchoAndRunCommandWithArguments(void)
+{
+    clear_sent();
+    type("set led 1\r");
+
+    TEST_ASSERT_EQUAL_UINT8(1, runs);
+    TEST_ASSERT_EQUAL_UINT8(3, last_argc);
+    TEST_ASSERT_EQUAL_STRING("set", last_argv[0]);
+    TEST_ASSERT_EQUAL_STRING("led", last_argv[1]);
+    TEST_ASSERT_EQUAL_STRING("1", last_argv[2]);
+    TEST_ASSERT_EQUAL_STRING("set led 1\r\n" CONSOLE_PROMPT, sent);
+}
+
+void
+test_Console_should_TakeCrLfAsOneEnter(void)
+{
+    type("set\r\nset\n\n");
+
+    TEST_ASSERT_EQUAL_UINT8(2, runs);
+}
+
+void
+test_Console_should_EraseWithBackspace(void)
+{
+    clear_sent();
+    type("sex\btt\x7F a\r");
+
+    TEST_ASSERT_EQUAL_UINT8(1, runs);
+    TEST_ASSERT_EQUAL_STRING("a", last_argv[1]);
+    TEST_ASSERT_EQUAL_STRING("sex\b \btt\b \b a\r\n" CONSOLE_PROMPT, sent);
+
+    // Nothing to erase
+    clear_sent();
+    type("\b");
+    TEST_ASSERT_EQUAL_STRING("", sent);
+}
+
+void
+test_Console_should_RecallLastLine(void)
+{
+    type("set x \"y z\"\r");
+    type("pin");
+    clear_sent();
+
+    // Up arrow
+    type("\x1B[A");
+    TEST_ASSERT_EQUAL_STRING("\r" CONSOLE_PROMPT "set x \"y z\"\x1B[K", sent);
+
+    type("\r");
+    TEST_ASSERT_EQUAL_UINT8(2, runs);
+    TEST_ASSERT_EQUAL_STRING("y z", last_argv[2]);
+
+    // Ctrl-P, then edited before running
+    type("\x10\b\b\b\b\bw\r");
+    TEST_ASSERT_EQUAL_UINT8(3, runs);
+    TEST_ASSERT_EQUAL_UINT8(3, last_argc);
+    TEST_ASSERT_EQUAL_STRING("w", last_argv[2]);
+
+    // Other escape sequences are ignored
+    type("\x1B[1;5C\x1B" "Oping\r");
+    TEST_ASSERT_EQUAL_UINT8(3, runs);
+}
+
+void
+test_Console_should_ReportUnknownAndTooManyArguments(void)
+{
+    clear_sent();
+    type("foo\r");
+    TEST_ASSERT_EQUAL_STRING("foo\r\nunknown command\r\n" CONSOLE_PROMPT, sent);
+
+    clear_sent();
+    type("set 1 2 3 4 5 6\r");
+    TEST_ASSERT_EQUAL_UINT8(0, runs);
+    TEST_ASSERT_NOT_NULL(strstr(sent, "too many arguments\r\n"));
+
+    // An empty line only shows the prompt
+    clear_sent();
+    type("  \r");
+    TEST_ASSERT_EQUAL_STRING("  \r\n" CONSOLE_PROMPT, sent);
+}
+
+void
+test_Console_should_ListCommandsWithHelp(void)
+{
+    clear_sent();
+    type("help\r");
+    TEST_ASSERT_EQUAL_STRING("help\r\nset\r\nping\r\n" CONSOLE_PROMPT, sent);
+
+    clear_sent();
+    type("ping\r");
+    TEST_ASSERT_EQUAL_STRING("ping\r\npong\r\n" CONSOLE_PROMPT, sent);
+}
+
+void
+test_Console_should_RingBellWhenLineIsFull(void)
+{
+    char line[CONSOLE_LINE_SIZE + 2];
+
+    memset(line, 'a', CONSOLE_LINE_SIZE);
+    line[CONSOLE_LINE_SIZE] = 0x00;
+    clear_sent();
+    type(line);
+
+    TEST_ASSERT_EQUAL_UINT16(CONSOLE_LINE_SIZE, sent_count);
+    TEST_ASSERT_EQUAL_HEX8('\a', sent[CONSOLE_LINE_SIZE - 1]);
+
+    // Ctrl-C drops the line
+    clear_sent();
+    type("\x03");
+    TEST_ASSERT_EQUAL_STRING("^C\r\n" CONSOLE_PROMPT, sent);
+}
+
+void
+test_Console_should_ProcessFewBytesPerPoll(void)
+{
+    const char* stream = "set abcdef\r";
+
+    keys = stream;
+    console_poll();
+    TEST_ASSERT_EQUAL_PTR(stream + CONSOLE_BYTES_PER_POLL, keys);
+
+    // No room in the TX buffer for the echo, nothing is taken
+    tx_pending = SOFT_UART_TX_BUFFER_SIZE - 1;
+    console_poll();
+    TEST_ASSERT_EQUAL_PTR(stream + CONSOLE_BYTES_PER_POLL, keys);
+
+    tx_pending = 0;
+    while (*keys != 0x00)
+    {
+        console_poll();
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, runs);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Console_should_ShowPromptOnInit);
+    RUN_TEST(test_Console_should_TokenizeInPlace);
+    RUN_TEST(test_Console_should_EchoAndRunCommandWithArguments);
+    RUN_TEST(test_Console_should_TakeCrLfAsOneEnter);
+    RUN_TEST(test_Console_should_EraseWithBackspace);
+    RUN_TEST(test_Console_should_RecallLastLine);
+    RUN_TEST(test_Console_should_ReportUnknownAndTooManyArguments);
+    RUN_TEST(test_Console_should_ListCommandsWithHelp);
+    RUN_TEST(test_Console_should_RingBellWhenLineIsFull);
+    RUN_TEST(test_Console_should_ProcessFewBytesPerPoll);
+
+    return UNITY_END();
+}
@@ -0,0 +1,330 @@
+#include "unity.h"
+#include "eeprom_log.h"
+#include <avr/eeprom.h>
+
+// The EEPROM ready interrupt is a plain function on the host
+void EE_READY_vect(void);
+
+static uint8_t msg[EEPROM_LOG_PAYLOAD_SIZE];
+static uint8_t out[EEPROM_LOG_PAYLOAD_SIZE];
+static uint8_t size;
+
+// Runs the EEPROM ready interrupt until the record is written
+static void
+drain(void)
+{
+    while (EECR & _BV(EERIE))
+    {
+        EE_READY_vect();
+    }
+}
+
+// Runs the EEPROM ready interrupt a limited number of times
+static void
+run_isr(uint16_t times)
+{
+    while ( (times-- > 0) && (EECR & _BV(EERIE)) )
+    {
+        EE_READY_vect();
+    }
+}
+
+static void
+append_value(uint8_t value)
+{
+    memset(msg, value, sizeof(msg));
+    TEST_ASSERT_EQUAL(EEPROM_LOG_OK, eeprom_log_append(msg, sizeof(msg)));
+    drain();
+}
+
+static void
+pop(void)
+{
+    TEST_ASSERT_EQUAL(EEPROM_LOG_OK, eeprom_log_pop());
+    drain();
+}
+
+static void
+expect_oldest(uint8_t value)
+{
+    TEST_ASSERT_EQUAL(EEPROM_LOG_OK, eeprom_log_peek(out, &size));
+    TEST_ASSERT_EQUAL_UINT8(sizeof(msg), size);
+    memset(msg, value, sizeof(msg));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, out, sizeof(msg));
+}
+
+void
+setUp(void)
+{
+    memset(avr_sim_eeprom, 0xFF, sizeof(avr_sim_eeprom));
+    memset(avr_sim_eeprom_writes, 0, sizeof(avr_sim_eeprom_writes));
+    memset((void *) avr_sim_io, 0, sizeof(avr_sim_io));
+
+    eeprom_log_init();
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_EepromLog_should_StartEmptyOnErasedEeprom(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(0, eeprom_log_count());
+    TEST_ASSERT_EQUAL(EEPROM_LOG_EMPTY, eeprom_log_peek(out, &size));
+    TEST_ASSERT_EQUAL(EEPROM_LOG_EMPTY, eeprom_log_pop());
+}
+
+void
+test_EepromLog_should_RejectInvalidSizes(void)
+{
+    TEST_ASSERT_EQUAL(EEPROM_LOG_INVALID, eeprom_log_append(msg, 0));
+    TEST_ASSERT_EQUAL(EEPROM_LOG_INVALID,
+                      eeprom_log_append(msg, EEPROM_LOG_PAYLOAD_SIZE + 1));
+}
+
+void
+test_EepromLog_should_WriteInBackground(void)
+{
+    uint8_t data[] = {0xCA, 0xFE};
+    uint8_t calls = 0;
+
+    TEST_ASSERT_EQUAL(EEPROM_LOG_OK, eeprom_log_append(data, sizeof(data)));
+    TEST_ASSERT_TRUE(eeprom_log_busy());
+    TEST_ASSERT_BIT_HIGH(EERIE, EECR);
+    TEST_ASSERT_EQUAL(EEPROM_LOG_BUSY, eeprom_log_append(data, sizeof(data)));
+    TEST_ASSERT_EQUAL(EEPROM_LOG_BUSY, eeprom_log_peek(out, &size));
+    TEST_ASSERT_EQUAL_UINT8(0, eeprom_log_count());
+
+    while (eeprom_log_busy())
+    {
+        EE_READY_vect();
+        calls++;
+    }
+
+    // At most one byte per interrupt: header, payload and CRC
+    TEST_ASSERT_GREATER_THAN(1, calls);
+    TEST_ASSERT_LESS_OR_EQUAL(5 + sizeof(data) + 2 + 1, calls);
+    TEST_ASSERT_BIT_LOW(EERIE, EECR);
+    TEST_ASSERT_EQUAL_UINT8(1, eeprom_log_count());
+    TEST_ASSERT_EQUAL(EEPROM_LOG_OK, eeprom_log_peek(out, &size));
+    TEST_ASSERT_EQUAL_UINT8(sizeof(data), size);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, out, sizeof(data));
+}
+
+void
+test_EepromLog_should_ReturnRecordsInOrder(void)
+{
+    append_value(1);
+    append_value(2);
+    append_value(3);
+
+    TEST_ASSERT_EQUAL_UINT8(3, eeprom_log_count());
+    expect_oldest(1);
+    pop();
+    expect_oldest(2);
+    pop();
+    expect_oldest(3);
+    pop();
+    TEST_ASSERT_EQUAL_UINT8(0, eeprom_log_count());
+    TEST_ASSERT_EQUAL(EEPROM_LOG_EMPTY, eeprom_log_peek(out, &size));
+}
+
+void
+test_EepromLog_should_RecoverAfterReset(void)
+{
+    append_value(1);
+    append_value(2);
+    append_value(3);
+    pop();
+
+    eeprom_log_init();
+
+    TEST_ASSERT_EQUAL_UINT8(2, eeprom_log_count());
+    expect_oldest(2);
+    pop();
+    append_value(4);
+
+    eeprom_log_init();
+
+    TEST_ASSERT_EQUAL_UINT8(2, eeprom_log_count());
+    expect_oldest(3);
+}
+
+// Goes around the ring once so the next writes overwrite valid records
+static void
+fill_ring(void)
+{
+    for (uint8_t i = 0; i < EEPROM_LOG_SLOTS; i++)
+    {
+        append_value(0xEE);
+        pop();
+    }
+}
+
+void
+test_EepromLog_should_SurvivePowerCutDuringAppend(void)
+{
+    uint8_t completed;
+
+    for (uint8_t cut = 0; cut <= EEPROM_LOG_RECORD_SIZE + 1; cut++)
+    {
+        setUp();
+        fill_ring();
+        append_value(1);
+        append_value(2);
+
+        memset(msg, 3, sizeof(msg));
+        eeprom_log_append(msg, sizeof(msg));
+        run_isr(cut);
+
+        eeprom_log_init();
+
+        // The record is kept only once its last byte was written
+        completed = (eeprom_log_count() == 3);
+        if (cut == 0)
+        {
+            TEST_ASSERT_FALSE(completed);
+        }
+        if (cut > EEPROM_LOG_RECORD_SIZE)
+        {
+            TEST_ASSERT_TRUE(completed);
+        }
+        if (!completed)
+        {
+            TEST_ASSERT_EQUAL_UINT8(2, eeprom_log_count());
+        }
+        expect_oldest(1);
+        pop();
+        expect_oldest(2);
+        pop();
+        if (completed)
+        {
+            expect_oldest(3);
+            pop();
+        }
+        TEST_ASSERT_EQUAL(EEPROM_LOG_EMPTY, eeprom_log_peek(out, &size));
+
+        // The log keeps working after the recovery
+        append_value(4);
+        expect_oldest(4);
+    }
+}
+
+void
+test_EepromLog_should_SurvivePowerCutDuringPop(void)
+{
+    uint8_t completed;
+
+    for (uint8_t cut = 0; cut <= 8; cut++)
+    {
+        setUp();
+        fill_ring();
+        append_value(1);
+        append_value(2);
+
+        eeprom_log_pop();
+        run_isr(cut);
+
+        eeprom_log_init();
+
+        // The record is either still pending or consumed
+        completed = (eeprom_log_count() == 1);
+        if (cut == 0)
+        {
+            TEST_ASSERT_FALSE(completed);
+        }
+        if (cut == 8)
+        {
+            TEST_ASSERT_TRUE(completed);
+        }
+        if (!completed)
+        {
+            TEST_ASSERT_EQUAL_UINT8(2, eeprom_log_count());
+        }
+        expect_oldest(completed ? 2 : 1);
+    }
+}
+
+void
+test_EepromLog_should_DropOldestRecordWhenFull(void)
+{
+    for (uint8_t i = 0; i < EEPROM_LOG_SLOTS + 5; i++)
+    {
+        append_value(i);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(EEPROM_LOG_SLOTS, eeprom_log_count());
+    TEST_ASSERT_EQUAL_UINT16(5, eeprom_log_dropped());
+    expect_oldest(5);
+
+    eeprom_log_init();
+
+    TEST_ASSERT_EQUAL_UINT8(EEPROM_LOG_SLOTS, eeprom_log_count());
+    expect_oldest(5);
+}
+
+void
+test_EepromLog_should_LevelTheWearOfTheSlots(void)
+{
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+    uint32_t writes;
+
+    for (uint16_t i = 0; i < 10 * EEPROM_LOG_SLOTS; i++)
+    {
+        append_value(i);
+        pop();
+    }
+
+    // The sequence number changes on every write of a slot
+    for (uint8_t slot = 0; slot < EEPROM_LOG_SLOTS; slot++)
+    {
+        writes = avr_sim_eeprom_writes[EEPROM_LOG_START_ADDR +
+                                       slot * EEPROM_LOG_RECORD_SIZE];
+        min = (writes < min) ? writes : min;
+        max = (writes > max) ? writes : max;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(20, min);
+    TEST_ASSERT_EQUAL_UINT32(20, max);
+}
+
+void
+test_EepromLog_should_HandleSequenceNumberWrap(void)
+{
+    for (uint32_t i = 0; i < 70000UL; i++)
+    {
+        append_value((uint8_t) i);
+        pop();
+    }
+
+    append_value(0xA1);
+    append_value(0xA2);
+
+    eeprom_log_init();
+
+    TEST_ASSERT_EQUAL_UINT8(2, eeprom_log_count());
+    expect_oldest(0xA1);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_EepromLog_should_StartEmptyOnErasedEeprom);
+    RUN_TEST(test_EepromLog_should_RejectInvalidSizes);
+    RUN_TEST(test_EepromLog_should_WriteInBackground);
+    RUN_TEST(test_EepromLog_should_ReturnRecordsInOrder);
+    RUN_TEST(test_EepromLog_should_RecoverAfterReset);
+    RUN_TEST(test_EepromLog_should_SurvivePowerCutDuringAppend);
+    RUN_TEST(test_EepromLog_should_SurvivePowerCutDuringPop);
+    RUN_TEST(test_EepromLog_should_DropOldestRecordWhenFull);
+    RUN_TEST(test_EepromLog_should_LevelTheWearOfTheSlots);
+    RUN_TEST(test_EepromLog_should_HandleSequenceNumberWrap);
+
+    return UNITY_END();
+}
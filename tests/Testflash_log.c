@@ -0,0 +1,449 @@
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+#include "flash_log.h"
+
+#define FLASH_SIZE          (FLASH_LOG_SECTORS * FLASH_LOG_SECTOR_SIZE)
+#define SECTOR_BLOCKS       (FLASH_LOG_SECTOR_SIZE / FLASH_LOG_BLOCK_SIZE)
+#define LAP_RECORDS         ((uint32_t) FLASH_LOG_SECTORS * SECTOR_BLOCKS * \
+                             FLASH_LOG_BLOCK_RECORDS)
+
+// Timing of the simulated flash in microseconds (W25Q80 typical values)
+#define SPI_BYTE_US         1
+#define PROGRAM_US          700
+#define ERASE_US            45000
+#define LOOP_US             20
+
+#define ANY_RECORD          0xFFFFFFFFUL
+
+// Simulated SPI NOR flash
+static uint8_t flash_mem[FLASH_SIZE];
+static uint32_t flash_erases[FLASH_LOG_SECTORS];
+static uint32_t flash_programs;
+static uint32_t flash_violations;
+static uint32_t flash_busy_until;
+static uint8_t flash_wel;
+static uint8_t flash_cmd;
+static uint32_t flash_addr;
+static uint16_t flash_index;
+static uint32_t sim_time_us;
+static uint8_t flash_cs_port;
+
+static uint8_t
+flash_busy(void)
+{
+    return (sim_time_us < flash_busy_until);
+}
+
+static uint8_t
+flash_sim_byte(uint8_t mosi)
+{
+    uint8_t miso = 0xFF;
+    uint32_t address;
+
+    sim_time_us += SPI_BYTE_US;
+
+    if (flash_index == 0)
+    {
+        flash_cmd = mosi;
+        if ( flash_busy() && (flash_cmd != 0x05) )
+        {
+            flash_violations++;
+            flash_cmd = 0;
+        }
+        else if (flash_cmd == 0x06)
+        {
+            flash_wel = 1;
+        }
+    }
+    else if (flash_cmd == 0x05)
+    {
+        miso = (flash_busy() ? 0x01 : 0x00) | (flash_wel << 1);
+    }
+    else if (flash_index < 4)
+    {
+        flash_addr = (flash_addr << 8) | mosi;
+    }
+    else if (flash_cmd == 0x03)
+    {
+        miso = flash_mem[(flash_addr + flash_index - 4) % FLASH_SIZE];
+    }
+    else if (flash_cmd == 0x02)
+    {
+        // The address wraps inside the 256 bytes page
+        address = (flash_addr & ~0xFFUL) |
+                  ((flash_addr + flash_index - 4) & 0xFF);
+        if ((flash_mem[address] & mosi) != mosi)
+        {
+            flash_violations++;
+        }
+        flash_mem[address] &= mosi;
+    }
+
+    flash_index++;
+
+    return miso;
+}
+
+static void
+flash_sim_release(void)
+{
+    if ( (flash_cmd == 0x02) || (flash_cmd == 0x20) )
+    {
+        if (!flash_wel)
+        {
+            flash_violations++;
+        }
+        else if (flash_cmd == 0x02)
+        {
+            flash_programs++;
+            flash_busy_until = sim_time_us + PROGRAM_US;
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_UINT32(0, flash_addr % FLASH_LOG_SECTOR_SIZE);
+            memset(&flash_mem[flash_addr], 0xFF, FLASH_LOG_SECTOR_SIZE);
+            flash_erases[flash_addr / FLASH_LOG_SECTOR_SIZE]++;
+            flash_busy_until = sim_time_us + ERASE_US;
+        }
+        flash_wel = 0;
+    }
+
+    flash_index = 0;
+    flash_addr = 0;
+    flash_cmd = 0;
+}
+
+void
+spi_device_init(spi_device* device, uint8_t* cs_port, uint8_t cs_pin,
+                uint32_t clock, spi_mode mode, spi_bit_order order)
+{
+    TEST_ASSERT_EQUAL(SPI_MODE_0, mode);
+    TEST_ASSERT_EQUAL(SPI_MSB_FIRST, order);
+}
+
+// The transfers are completed at once by the simulated flash
+spi_status
+spi_submit(spi_transaction* transaction)
+{
+    uint8_t miso;
+
+    TEST_ASSERT_TRUE(transaction->status != SPI_PENDING);
+
+    for (uint16_t i = 0; i < transaction->size; i++)
+    {
+        miso = flash_sim_byte(transaction->tx ? transaction->tx[i] : 0xFF);
+        if (transaction->rx != NULL)
+        {
+            transaction->rx[i] = miso;
+        }
+    }
+    if ( !(transaction->flags & SPI_KEEP_CS) )
+    {
+        flash_sim_release();
+    }
+
+    transaction->status = SPI_DONE;
+    if (transaction->callback != NULL)
+    {
+        transaction->callback(transaction);
+    }
+
+    return SPI_DONE;
+}
+
+static void
+run_until_idle(void)
+{
+    uint32_t guard = 0;
+
+    do
+    {
+        flash_log_poll();
+        sim_time_us += LOOP_US;
+    } while (flash_log_busy() && (guard++ < 100000));
+}
+
+static void
+make_record(uint8_t* record, uint32_t value)
+{
+    memset(record, (uint8_t) (value * 7), FLASH_LOG_RECORD_SIZE);
+    memcpy(record, &value, sizeof(value));
+}
+
+static void
+append_records(uint32_t first, uint32_t count)
+{
+    uint8_t record[FLASH_LOG_RECORD_SIZE];
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        make_record(record, first + i);
+        while (flash_log_append(record) == FLASH_LOG_FULL)
+        {
+            flash_log_poll();
+            sim_time_us += LOOP_US;
+        }
+        flash_log_poll();
+        sim_time_us += LOOP_US;
+    }
+}
+
+// Reads all the records checking they are consecutive from first, or from
+// the first one read if first is ANY_RECORD
+static uint32_t
+read_records(uint32_t first, uint32_t* last)
+{
+    flash_log_reader reader;
+    uint8_t record[FLASH_LOG_RECORD_SIZE];
+    uint8_t expected[FLASH_LOG_RECORD_SIZE];
+    uint32_t count = 0;
+    uint32_t value = first;
+
+    flash_log_reader_init(&reader);
+    while (flash_log_read(&reader, record) == FLASH_LOG_OK)
+    {
+        memcpy(&value, record, sizeof(value));
+        if (count == 0)
+        {
+            if (first == ANY_RECORD)
+            {
+                first = value;
+            }
+            TEST_ASSERT_EQUAL_UINT32(first, value);
+        }
+        make_record(expected, first + count);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, record, sizeof(record));
+        count++;
+    }
+
+    if (last != NULL)
+    {
+        *last = value;
+    }
+
+    return count;
+}
+
+void
+setUp(void)
+{
+    memset(flash_mem, 0xFF, sizeof(flash_mem));
+    memset(flash_erases, 0, sizeof(flash_erases));
+    flash_programs = 0;
+    flash_violations = 0;
+    flash_busy_until = 0;
+    flash_wel = 0;
+    flash_index = 0;
+    sim_time_us = 0;
+
+    flash_log_init(&flash_cs_port, 1);
+}
+
+void
+tearDown(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(0, flash_violations);
+}
+
+void
+test_FlashLog_should_EraseAheadOnEmptyFlash(void)
+{
+    flash_log_reader reader;
+    uint8_t record[FLASH_LOG_RECORD_SIZE];
+
+    flash_log_reader_init(&reader);
+    TEST_ASSERT_EQUAL(FLASH_LOG_EMPTY, flash_log_read(&reader, record));
+    TEST_ASSERT_TRUE(flash_log_busy());
+
+    // Only the operation is started, the erase time is not waited
+    flash_log_poll();
+    TEST_ASSERT_EQUAL_UINT32(1, flash_erases[0]);
+    TEST_ASSERT_EQUAL(FLASH_LOG_BUSY, flash_log_read(&reader, record));
+
+    run_until_idle();
+    TEST_ASSERT_EQUAL_UINT32(1, flash_erases[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, flash_erases[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, flash_erases[2]);
+}
+
+void
+test_FlashLog_should_ProgramWholeBlocks(void)
+{
+    run_until_idle();
+
+    append_records(0, FLASH_LOG_BLOCK_RECORDS - 1);
+    run_until_idle();
+    TEST_ASSERT_EQUAL_UINT32(0, flash_programs);
+
+    append_records(FLASH_LOG_BLOCK_RECORDS - 1, 1);
+    run_until_idle();
+    TEST_ASSERT_EQUAL_UINT32(1, flash_programs);
+
+    TEST_ASSERT_EQUAL_UINT32(FLASH_LOG_BLOCK_RECORDS, read_records(0, NULL));
+}
+
+void
+test_FlashLog_should_ReadBackFlushedRecords(void)
+{
+    uint32_t last;
+
+    append_records(0, 40);
+    flash_log_flush();
+    run_until_idle();
+
+    TEST_ASSERT_EQUAL_UINT32(40, read_records(0, &last));
+    TEST_ASSERT_EQUAL_UINT32(39, last);
+    TEST_ASSERT_EQUAL_UINT32((40 + FLASH_LOG_BLOCK_RECORDS - 1) /
+                             FLASH_LOG_BLOCK_RECORDS, flash_programs);
+}
+
+void
+test_FlashLog_should_DropWhenBothBlocksAreFull(void)
+{
+    uint8_t record[FLASH_LOG_RECORD_SIZE];
+
+    make_record(record, 0);
+    for (uint16_t i = 0; i < 2 * FLASH_LOG_BLOCK_RECORDS; i++)
+    {
+        TEST_ASSERT_EQUAL(FLASH_LOG_OK, flash_log_append(record));
+    }
+    TEST_ASSERT_EQUAL(FLASH_LOG_FULL, flash_log_append(record));
+    TEST_ASSERT_EQUAL_UINT16(1, flash_log_dropped());
+
+    run_until_idle();
+    TEST_ASSERT_EQUAL(FLASH_LOG_OK, flash_log_append(record));
+    TEST_ASSERT_EQUAL_UINT32(2, flash_programs);
+}
+
+void
+test_FlashLog_should_RecoverHeadAtBoot(void)
+{
+    uint32_t last;
+
+    append_records(0, 100);
+    flash_log_flush();
+    run_until_idle();
+
+    // Reboot
+    flash_log_init(&flash_cs_port, 1);
+    run_until_idle();
+    TEST_ASSERT_EQUAL_UINT32(1, flash_erases[0]);
+
+    append_records(100, 10);
+    flash_log_flush();
+    run_until_idle();
+
+    TEST_ASSERT_EQUAL_UINT32(110, read_records(0, &last));
+    TEST_ASSERT_EQUAL_UINT32(109, last);
+}
+
+void
+test_FlashLog_should_SkipTornBlocks(void)
+{
+    uint32_t head = 3 * FLASH_LOG_BLOCK_SIZE;
+    flash_log_reader reader;
+    uint8_t record[FLASH_LOG_RECORD_SIZE];
+    uint8_t expected[FLASH_LOG_RECORD_SIZE];
+    uint32_t value = 0;
+
+    append_records(0, 3 * FLASH_LOG_BLOCK_RECORDS);
+    run_until_idle();
+
+    // A record of the second block is corrupted, the block is skipped
+    flash_mem[FLASH_LOG_BLOCK_SIZE + FLASH_LOG_HEADER_SIZE + 5] &= 0x0F;
+
+    flash_log_reader_init(&reader);
+    while (flash_log_read(&reader, record) == FLASH_LOG_OK)
+    {
+        make_record(expected, value);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, record, sizeof(record));
+        value++;
+        if (value == FLASH_LOG_BLOCK_RECORDS)
+        {
+            value += FLASH_LOG_BLOCK_RECORDS;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(3 * FLASH_LOG_BLOCK_RECORDS, value);
+
+    // The power failed while the header of the next block was programmed
+    flash_mem[head] = 0x03;
+    flash_log_init(&flash_cs_port, 1);
+    append_records(0, FLASH_LOG_BLOCK_RECORDS);
+    run_until_idle();
+
+    // The torn block is not programmed again
+    TEST_ASSERT_EQUAL_HEX8(0x03, flash_mem[head]);
+    TEST_ASSERT_EQUAL_HEX8(0x04, flash_mem[head + FLASH_LOG_BLOCK_SIZE]);
+}
+
+void
+test_FlashLog_should_WrapAndLevelWear(void)
+{
+    uint32_t total = LAP_RECORDS * 2 + LAP_RECORDS / 3;
+    uint32_t written = total - (total % FLASH_LOG_BLOCK_RECORDS);
+    uint32_t count;
+    uint32_t last;
+    uint32_t min = 0xFFFFFFFF;
+    uint32_t max = 0;
+
+    append_records(0, total);
+    run_until_idle();
+
+    // All the log but the sectors erased ahead is readable
+    count = read_records(ANY_RECORD, &last);
+    TEST_ASSERT_EQUAL_UINT32(written - 1, last);
+    TEST_ASSERT_TRUE(count >= LAP_RECORDS - 2 * SECTOR_BLOCKS *
+                              FLASH_LOG_BLOCK_RECORDS);
+    TEST_ASSERT_TRUE(count < LAP_RECORDS);
+
+    for (uint16_t i = 0; i < FLASH_LOG_SECTORS; i++)
+    {
+        min = (flash_erases[i] < min) ? flash_erases[i] : min;
+        max = (flash_erases[i] > max) ? flash_erases[i] : max;
+    }
+    TEST_ASSERT_TRUE((max - min) <= 1);
+
+    // Days until 100000 erase cycles of a sector logging a record a second
+    printf("flash_log endurance: %lu records per turn, %lu erases per "
+           "sector, %lu days at 1 record/s\n", (unsigned long) count,
+           (unsigned long) max, (unsigned long) (100000ULL * LAP_RECORDS /
+                                                 86400));
+}
+
+void
+test_FlashLog_should_SustainThroughput(void)
+{
+    uint32_t records = 64 * SECTOR_BLOCKS * FLASH_LOG_BLOCK_RECORDS;
+    uint32_t start;
+    uint32_t rate;
+
+    run_until_idle();
+    start = sim_time_us;
+    append_records(0, records);
+    run_until_idle();
+
+    // Limited by the program and erase times of the flash
+    rate = (uint32_t) ((uint64_t) records * 1000000 / (sim_time_us - start));
+    printf("flash_log throughput: %lu records/s, %lu bytes/s\n",
+           (unsigned long) rate,
+           (unsigned long) (rate * FLASH_LOG_RECORD_SIZE));
+    TEST_ASSERT_TRUE(rate > 5000);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_FlashLog_should_EraseAheadOnEmptyFlash);
+    RUN_TEST(test_FlashLog_should_ProgramWholeBlocks);
+    RUN_TEST(test_FlashLog_should_ReadBackFlushedRecords);
+    RUN_TEST(test_FlashLog_should_DropWhenBothBlocksAreFull);
+    RUN_TEST(test_FlashLog_should_RecoverHeadAtBoot);
+    RUN_TEST(test_FlashLog_should_SkipTornBlocks);
+    RUN_TEST(test_FlashLog_should_WrapAndLevelWear);
+    RUN_TEST(test_FlashLog_should_SustainThroughput);
+
+    return UNITY_END();
+}
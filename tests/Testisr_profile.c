@@ -0,0 +1,213 @@
+#include <string.h>
+#include "unity.h"
+#include "isr_profile.h"
+#include "avr_sim.h"
+
+// Text sent through the UART by the report
+static char sent[512];
+static uint16_t sent_count;
+
+void
+uart_send(const char* str)
+{
+    while (*str != 0x00)
+    {
+        sent[sent_count++] = *str++;
+    }
+    sent[sent_count] = 0x00;
+}
+
+// Entry and exit of a slot at the given Timer1 counts
+static void
+measure(uint8_t slot, uint16_t entry, uint16_t exit)
+{
+    TCNT1 = entry;
+    isr_profile_enter(slot);
+    TCNT1 = exit;
+    isr_profile_exit(slot);
+}
+
+void
+setUp(void)
+{
+    memset((void *) avr_sim_io, 0, sizeof(avr_sim_io));
+    sent_count = 0;
+    sent[0] = 0x00;
+    isr_profile_init();
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_IsrProfile_should_StartTimer1RunningFree(void)
+{
+    isr_profile_stat duration;
+
+    TEST_ASSERT_EQUAL_HEX8(0x00, TCCR1A);
+    TEST_ASSERT_EQUAL_HEX8(_BV(CS10), TCCR1B);
+    TEST_ASSERT_EQUAL_HEX8(0x00, TIMSK1);
+    TEST_ASSERT_FALSE(isr_profile_get(0, &duration, NULL));
+    TEST_ASSERT_EQUAL_UINT16(0, duration.count);
+}
+
+void
+test_IsrProfile_should_AggregateMinAverageMax(void)
+{
+    isr_profile_stat stat = {0};
+
+    TEST_ASSERT_EQUAL_UINT16(0, isr_profile_stat_average(&stat));
+
+    isr_profile_stat_add(&stat, 40);
+    isr_profile_stat_add(&stat, 10);
+    isr_profile_stat_add(&stat, 25);
+    isr_profile_stat_add(&stat, 26);
+
+    TEST_ASSERT_EQUAL_UINT16(4, stat.count);
+    TEST_ASSERT_EQUAL_UINT16(10, stat.min);
+    TEST_ASSERT_EQUAL_UINT16(40, stat.max);
+    TEST_ASSERT_EQUAL_UINT32(101, stat.sum);
+    TEST_ASSERT_EQUAL_UINT16(25, isr_profile_stat_average(&stat));
+}
+
+void
+test_IsrProfile_should_KeepAverageWhenCountIsFull(void)
+{
+    isr_profile_stat stat = {0};
+    uint32_t i;
+
+    for (i = 0; i < 70000UL; i++)
+    {
+        isr_profile_stat_add(&stat, (i & 0x01) ? 65535 : 65533);
+    }
+
+    TEST_ASSERT_TRUE(stat.count >= 32768);
+    TEST_ASSERT_EQUAL_UINT16(65533, stat.min);
+    TEST_ASSERT_EQUAL_UINT16(65535, stat.max);
+    TEST_ASSERT_UINT_WITHIN(1, 65534, isr_profile_stat_average(&stat));
+}
+
+void
+test_IsrProfile_should_MeasureDurationsAndPeriods(void)
+{
+    isr_profile_stat duration;
+    isr_profile_stat period;
+
+    measure(ISR_PROFILE_TICK, 1000, 1041);
+    measure(ISR_PROFILE_TICK, 16998, 17040);
+    measure(ISR_PROFILE_TICK, 33001, 33043);
+
+    TEST_ASSERT_TRUE(isr_profile_get(ISR_PROFILE_TICK, &duration, &period));
+    TEST_ASSERT_EQUAL_UINT16(3, duration.count);
+    TEST_ASSERT_EQUAL_UINT16(41, duration.min);
+    TEST_ASSERT_EQUAL_UINT16(42, duration.max);
+
+    // The first entry has no period, the jitter is max - min
+    TEST_ASSERT_EQUAL_UINT16(2, period.count);
+    TEST_ASSERT_EQUAL_UINT16(15998, period.min);
+    TEST_ASSERT_EQUAL_UINT16(16003, period.max);
+    TEST_ASSERT_FALSE(isr_profile_get(ISR_PROFILE_UART_RX, NULL, NULL));
+}
+
+void
+test_IsrProfile_should_MeasureAcrossOneTimerOverflowOnly(void)
+{
+    isr_profile_stat period;
+
+    measure(ISR_PROFILE_SPI, 60000, 60010);
+
+    // Wrapped once, the flag is cleared by the profile on the target
+    TIFR1 = _BV(TOV1);
+    measure(ISR_PROFILE_SPI, 10000, 10010);
+    TIFR1 = 0;
+    isr_profile_get(ISR_PROFILE_SPI, NULL, &period);
+    TEST_ASSERT_EQUAL_UINT16(1, period.count);
+    TEST_ASSERT_EQUAL_UINT16(15536, period.min);
+
+    // Wrapped twice, longer than the range
+    TIFR1 = _BV(TOV1);
+    measure(ISR_PROFILE_TWI, 100, 110);
+    TIFR1 = 0;
+    TIFR1 = _BV(TOV1);
+    measure(ISR_PROFILE_SPI, 9000, 9010);
+    TIFR1 = 0;
+    isr_profile_get(ISR_PROFILE_SPI, NULL, &period);
+    TEST_ASSERT_EQUAL_UINT16(1, period.count);
+
+    // An overflow flagged with a high count is left to the next entry
+    measure(ISR_PROFILE_SPI, 20000, 20010);
+    TIFR1 = _BV(TOV1);
+    measure(ISR_PROFILE_SPI, 65000, 65010);
+    measure(ISR_PROFILE_SPI, 5000, 5010);
+    isr_profile_get(ISR_PROFILE_SPI, NULL, &period);
+    TEST_ASSERT_EQUAL_UINT16(4, period.count);
+    TEST_ASSERT_EQUAL_UINT16(45000, period.max);
+    TEST_ASSERT_EQUAL_UINT16(5536, period.min);
+}
+
+void
+test_IsrProfile_should_GiveLongestTimeWithInterruptsDisabled(void)
+{
+    measure(ISR_PROFILE_TICK, 0, 40);
+    measure(ISR_PROFILE_CS_TWI, 100, 350);
+    measure(ISR_PROFILE_USER + 1, 400, 520);
+
+    TEST_ASSERT_EQUAL_UINT16(250, isr_profile_worst_off());
+
+    isr_profile_clear();
+    TEST_ASSERT_EQUAL_UINT16(0, isr_profile_worst_off());
+}
+
+void
+test_IsrProfile_should_ReportTableOfSlotsEntered(void)
+{
+    measure(ISR_PROFILE_TICK, 1000, 1041);
+    measure(ISR_PROFILE_TICK, 17000, 17043);
+    measure(ISR_PROFILE_USER + 1, 20000, 20100);
+
+    isr_profile_report();
+
+    TEST_ASSERT_EQUAL_STRING("ISR n dur min/avg/max per min/avg/max\n"
+                             "tick 2 41/42/43 16000/16000/16000\n"
+                             "user1 1 100/100/100 0/0/0\n"
+                             "off 100\n", sent);
+}
+
+void
+test_IsrProfile_should_SubtractOverheadOnSimulatedTimer(void)
+{
+    isr_profile_stat duration;
+
+    avr_sim_start();
+    isr_profile_init();
+
+    cli();
+    isr_profile_enter(ISR_PROFILE_USER);
+    _delay_us(10);
+    isr_profile_exit(ISR_PROFILE_USER);
+
+    isr_profile_get(ISR_PROFILE_USER, &duration, NULL);
+    TEST_ASSERT_UINT_WITHIN(4, 160, duration.max);
+
+    avr_sim_stop();
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_IsrProfile_should_StartTimer1RunningFree);
+    RUN_TEST(test_IsrProfile_should_AggregateMinAverageMax);
+    RUN_TEST(test_IsrProfile_should_KeepAverageWhenCountIsFull);
+    RUN_TEST(test_IsrProfile_should_MeasureDurationsAndPeriods);
+    RUN_TEST(test_IsrProfile_should_MeasureAcrossOneTimerOverflowOnly);
+    RUN_TEST(test_IsrProfile_should_GiveLongestTimeWithInterruptsDisabled);
+    RUN_TEST(test_IsrProfile_should_ReportTableOfSlotsEntered);
+    RUN_TEST(test_IsrProfile_should_SubtractOverheadOnSimulatedTimer);
+
+    return UNITY_END();
+}
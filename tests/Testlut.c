@@ -0,0 +1,127 @@
+#include <math.h>
+#include "unity.h"
+#include "lut.h"
+#include "lut_ntc.h"
+
+// Curve of the generated table, see LUT_NTC_ARGS in the Makefile
+#define NTC_BETA        3950.0
+#define NTC_R0          10000.0
+#define NTC_T0          25.0
+#define NTC_SERIES      10000.0
+#define NTC_LOW         96
+#define NTC_HIGH        928
+#define NTC_SHIFT       4
+// Largest error allowed, in 1/100 of degree
+#define NTC_TOLERANCE   13
+
+static double
+ntc_reference(uint16_t count)
+{
+    double ratio = (count + 0.5) / 1024.0;
+    double r = NTC_SERIES * ratio / (1.0 - ratio);
+
+    return (1.0 / (1.0 / (NTC_T0 + 273.15) + log(r / NTC_R0) / NTC_BETA) -
+            273.15) * 100.0;
+}
+
+void
+setUp(void)
+{
+
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_Lut_should_MatchFloatReferenceOverTheRange(void)
+{
+    double error;
+    double max_error = 0.0;
+    uint16_t count;
+
+    for (count = NTC_LOW; count <= NTC_HIGH; count++)
+    {
+        error = fabs(lut_eval(&lut_ntc, count) - ntc_reference(count));
+        max_error = (error > max_error) ? error : max_error;
+    }
+
+    TEST_ASSERT_TRUE(max_error <= NTC_TOLERANCE);
+    // The table is not flat, the reference matters
+    TEST_ASSERT_TRUE(max_error >= 1.0);
+}
+
+void
+test_Lut_should_BeExactAtThePoints(void)
+{
+    uint16_t count;
+
+    for (count = NTC_LOW; count <= NTC_HIGH; count += (1 << NTC_SHIFT))
+    {
+        TEST_ASSERT_EQUAL_INT16((int16_t) round(ntc_reference(count)),
+                                lut_eval(&lut_ntc, count));
+    }
+
+    // 25 degrees at the middle of the 10 bits ADC
+    TEST_ASSERT_INT_WITHIN(5, 2500, lut_eval(&lut_ntc, 512));
+}
+
+void
+test_Lut_should_ClampOutOfTheRange(void)
+{
+    TEST_ASSERT_EQUAL_INT16(lut_eval(&lut_ntc, NTC_LOW), lut_eval(&lut_ntc, 0));
+    TEST_ASSERT_EQUAL_INT16(lut_ntc_y[sizeof(lut_ntc_y) /
+                                      sizeof(lut_ntc_y[0]) - 1],
+                            lut_eval(&lut_ntc, 1023));
+    TEST_ASSERT_EQUAL_INT16(lut_eval(&lut_ntc, 1023),
+                            lut_eval(&lut_ntc, 0xFFFF));
+}
+
+void
+test_Lut_should_InterpolateAndRoundToTheNearest(void)
+{
+    static const int16_t slope_y[] PROGMEM = {100, -100, 50};
+    static const lut_table slope PROGMEM = {10, 3, 2, slope_y};
+    static const int16_t step_y[] PROGMEM = {0, 1, -1};
+    static const lut_table step PROGMEM = {0, 3, 2, step_y};
+
+    TEST_ASSERT_EQUAL_INT16(100, lut_eval(&slope, 10));
+    TEST_ASSERT_EQUAL_INT16(50, lut_eval(&slope, 11));
+    TEST_ASSERT_EQUAL_INT16(0, lut_eval(&slope, 12));
+    TEST_ASSERT_EQUAL_INT16(-50, lut_eval(&slope, 13));
+    TEST_ASSERT_EQUAL_INT16(-100, lut_eval(&slope, 14));
+    TEST_ASSERT_EQUAL_INT16(-62, lut_eval(&slope, 15));
+    TEST_ASSERT_EQUAL_INT16(50, lut_eval(&slope, 18));
+
+    // Quarters and halves of a step, the halves are rounded up
+    TEST_ASSERT_EQUAL_INT16(0, lut_eval(&step, 1));
+    TEST_ASSERT_EQUAL_INT16(1, lut_eval(&step, 2));
+    TEST_ASSERT_EQUAL_INT16(1, lut_eval(&step, 3));
+    TEST_ASSERT_EQUAL_INT16(0, lut_eval(&step, 6));
+}
+
+void
+test_Lut_should_KeepTheTableSmall(void)
+{
+    // One point every 16 counts, from the first to the last count
+    TEST_ASSERT_EQUAL_UINT16((NTC_HIGH - NTC_LOW) / (1 << NTC_SHIFT) + 1,
+                             sizeof(lut_ntc_y) / sizeof(lut_ntc_y[0]));
+    TEST_ASSERT_TRUE(sizeof(lut_ntc_y) <= 128);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Lut_should_MatchFloatReferenceOverTheRange);
+    RUN_TEST(test_Lut_should_BeExactAtThePoints);
+    RUN_TEST(test_Lut_should_ClampOutOfTheRange);
+    RUN_TEST(test_Lut_should_InterpolateAndRoundToTheNearest);
+    RUN_TEST(test_Lut_should_KeepTheTableSmall);
+
+    return UNITY_END();
+}
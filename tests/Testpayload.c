@@ -0,0 +1,107 @@
+#include <string.h>
+#include "unity.h"
+#include "payload.h"
+
+static uint8_t data[12];
+
+void
+setUp(void)
+{
+    memset(data, 0, sizeof(data));
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_Payload_should_PutFieldsMostSignificantBitFirst(void)
+{
+    payload_put(data, 0, 16, 0x1234);
+    payload_put(data, 16, 8, 0xAB);
+    TEST_ASSERT_EQUAL_HEX8(0x12, data[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x34, data[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xAB, data[2]);
+
+    // 12 bits from bit 28, across two bytes boundaries
+    payload_put(data, 28, 12, 0xFED);
+    TEST_ASSERT_EQUAL_HEX8(0x0F, data[3]);
+    TEST_ASSERT_EQUAL_HEX8(0xED, data[4]);
+
+    // The high bits of the value are not written
+    payload_put(data, 40, 3, 0xFF);
+    TEST_ASSERT_EQUAL_HEX8(0xE0, data[5]);
+}
+
+void
+test_Payload_should_KeepTheOtherBits(void)
+{
+    memset(data, 0xFF, sizeof(data));
+
+    payload_put(data, 5, 6, 0);
+    TEST_ASSERT_EQUAL_HEX8(0xF8, data[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x1F, data[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, data[2]);
+
+    payload_put(data, 64, 32, 0);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, data[7]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, data[8]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, data[11]);
+}
+
+void
+test_Payload_should_GetFieldsWithTheirSign(void)
+{
+    payload_put(data, 3, 10, (uint32_t) -300);
+    payload_put(data, 13, 10, 300);
+    payload_put(data, 40, 32, 0x89ABCDEF);
+
+    TEST_ASSERT_EQUAL_INT32(-300, payload_get(data, 3, 10, 1));
+    TEST_ASSERT_EQUAL_INT32(724, payload_get(data, 3, 10, 0));
+    TEST_ASSERT_EQUAL_INT32(300, payload_get(data, 13, 10, 1));
+    TEST_ASSERT_EQUAL_HEX32(0x89ABCDEF,
+                            (uint32_t) payload_get(data, 40, 32, 0));
+    TEST_ASSERT_EQUAL_INT32(1, payload_get(data, 40, 1, 0));
+    TEST_ASSERT_EQUAL_INT32(-1, payload_get(data, 40, 1, 1));
+}
+
+void
+test_Payload_should_RoundTripTheFieldLists(void)
+{
+    const int32_t summary[] = {-32768, 1234, 32767, 90};
+    int32_t value;
+    uint8_t i = 0;
+
+#define PUT_FIELD(name, first, bits, is_signed) \
+    payload_put(data, first, bits, (uint32_t) summary[i++]);
+#define CHECK_FIELD(name, first, bits, is_signed) \
+    value = payload_get(data, first, bits, is_signed); \
+    TEST_ASSERT_EQUAL_INT32(summary[i++], value);
+#define END_FIELD(name, first, bits, is_signed) \
+    value = first + bits;
+
+    PAYLOAD_SUMMARY_FIELDS(PUT_FIELD)
+    i = 0;
+    PAYLOAD_SUMMARY_FIELDS(CHECK_FIELD)
+
+    // The fields fill the payload
+    PAYLOAD_SUMMARY_FIELDS(END_FIELD)
+    TEST_ASSERT_EQUAL_INT32(PAYLOAD_SUMMARY_SIZE * 8, value);
+    PAYLOAD_UPLINK_STATS_FIELDS(END_FIELD)
+    TEST_ASSERT_EQUAL_INT32(PAYLOAD_UPLINK_STATS_SIZE * 8, value);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Payload_should_PutFieldsMostSignificantBitFirst);
+    RUN_TEST(test_Payload_should_KeepTheOtherBits);
+    RUN_TEST(test_Payload_should_GetFieldsWithTheirSign);
+    RUN_TEST(test_Payload_should_RoundTripTheFieldLists);
+
+    return UNITY_END();
+}
@@ -0,0 +1,220 @@
+#include <string.h>
+#include "unity.h"
+#include "pipeline.h"
+
+// Sigfox driver holding a message, and payloads given to it
+static sigfox_wisol_uplink_state uplink_state;
+static uint8_t uplinks;
+static uint8_t uplink_data[WISOL_FRAME_MAX];
+static uint8_t uplink_size;
+// Samples of the source
+static int16_t next_sample;
+
+sigfox_wisol_uplink_state
+sigfox_wisol_uplink_poll(uint32_t now)
+{
+    return uplink_state;
+}
+
+uint8_t
+sigfox_wisol_uplink(const uint8_t* data, uint8_t size)
+{
+    uplinks++;
+    memcpy(uplink_data, data, size);
+    uplink_size = size;
+    uplink_state = WISOL_UPLINK_PENDING;
+    return 1;
+}
+
+static int16_t
+read_sample(void)
+{
+    return next_sample++;
+}
+
+static pipeline_source source;
+static pipeline_ema ema;
+static pipeline_aggregate aggregate;
+static pipeline_pack pack = {pipeline_pack_summary};
+
+PIPELINE_QUEUE(samples, int16_t, 2);
+PIPELINE_QUEUE(summaries, pipeline_summary, 1);
+PIPELINE_QUEUE(frames, pipeline_frame, 1);
+
+static const pipeline_stage stages[] PROGMEM =
+{
+    {pipeline_source_step,      &source,    NULL,       &samples},
+    {pipeline_aggregate_step,   &aggregate, &samples,   &summaries},
+    {pipeline_pack_step,        &pack,      &summaries, &frames},
+    {pipeline_uplink_step,      NULL,       &frames,    NULL}
+};
+
+#define STAGES  (sizeof(stages) / sizeof(stages[0]))
+
+void
+setUp(void)
+{
+    const pipeline_source source_init = PIPELINE_SOURCE(read_sample, 1000);
+    const pipeline_ema ema_init = PIPELINE_EMA(2);
+    const pipeline_aggregate aggregate_init = PIPELINE_AGGREGATE(4);
+
+    source = source_init;
+    ema = ema_init;
+    aggregate = aggregate_init;
+    samples.head = samples.count = 0;
+    summaries.head = summaries.count = 0;
+    frames.head = frames.count = 0;
+    uplink_state = WISOL_UPLINK_IDLE;
+    uplinks = 0;
+    next_sample = 10;
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_Pipeline_should_ReadSourceOnItsPeriod(void)
+{
+    int16_t sample;
+
+    TEST_ASSERT_EQUAL_HEX8(PIPELINE_GIVEN,
+                           pipeline_source_step(&source, 500, NULL, &sample));
+    TEST_ASSERT_EQUAL_INT16(10, sample);
+    TEST_ASSERT_EQUAL_HEX8(0,
+                           pipeline_source_step(&source, 1499, NULL, &sample));
+    TEST_ASSERT_EQUAL_HEX8(PIPELINE_GIVEN,
+                           pipeline_source_step(&source, 1500, NULL, &sample));
+
+    // Periods missed are skipped, not read in a burst
+    TEST_ASSERT_EQUAL_HEX8(PIPELINE_GIVEN,
+                           pipeline_source_step(&source, 5700, NULL, &sample));
+    TEST_ASSERT_EQUAL_HEX8(0,
+                           pipeline_source_step(&source, 6000, NULL, &sample));
+    TEST_ASSERT_EQUAL_HEX8(PIPELINE_GIVEN,
+                           pipeline_source_step(&source, 6700, NULL, &sample));
+    TEST_ASSERT_EQUAL_INT16(13, sample);
+
+    // Due with the output full
+    TEST_ASSERT_EQUAL_HEX8(0, pipeline_source_step(&source, 7700, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT16(1, source.overruns);
+    TEST_ASSERT_EQUAL_INT16(14, next_sample);
+}
+
+void
+test_Pipeline_should_FilterWithMovingAverage(void)
+{
+    const int16_t in[] = {100, 200, 200, 200, -400};
+    const int16_t expected[] = {100, 125, 143, 157, 18};
+    int16_t out;
+    uint8_t i;
+
+    TEST_ASSERT_EQUAL_HEX8(0, pipeline_ema_step(&ema, 0, &in[0], NULL));
+
+    for (i = 0; i < sizeof(in) / sizeof(in[0]); i++)
+    {
+        TEST_ASSERT_EQUAL_HEX8(PIPELINE_TAKEN | PIPELINE_GIVEN,
+                               pipeline_ema_step(&ema, 0, &in[i], &out));
+        TEST_ASSERT_INT_WITHIN(1, expected[i], out);
+    }
+}
+
+void
+test_Pipeline_should_SummarizeWindows(void)
+{
+    const int16_t in[] = {5, -3, 12, 2};
+    pipeline_summary summary;
+    uint8_t data[PIPELINE_SUMMARY_SIZE];
+    uint8_t i;
+
+    for (i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_EQUAL_HEX8(PIPELINE_TAKEN,
+                               pipeline_aggregate_step(&aggregate, 0, &in[i],
+                                                       NULL));
+    }
+
+    // The last sample waits for room for the summary
+    TEST_ASSERT_EQUAL_HEX8(0, pipeline_aggregate_step(&aggregate, 0, &in[3],
+                                                      NULL));
+    TEST_ASSERT_EQUAL_HEX8(PIPELINE_TAKEN | PIPELINE_GIVEN,
+                           pipeline_aggregate_step(&aggregate, 0, &in[3],
+                                                   &summary));
+    TEST_ASSERT_EQUAL_INT16(-3, summary.min);
+    TEST_ASSERT_EQUAL_INT16(4, summary.mean);
+    TEST_ASSERT_EQUAL_INT16(12, summary.max);
+    TEST_ASSERT_EQUAL_UINT8(4, summary.count);
+
+    TEST_ASSERT_EQUAL_UINT8(0, pipeline_pack_summary(&summary, data,
+                                                     sizeof(data) - 1));
+    TEST_ASSERT_EQUAL_UINT8(PIPELINE_SUMMARY_SIZE,
+                            pipeline_pack_summary(&summary, data,
+                                                  sizeof(data)));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, data[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xFD, data[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x04, data[3]);
+    TEST_ASSERT_EQUAL_HEX8(0x0C, data[5]);
+    TEST_ASSERT_EQUAL_HEX8(0x04, data[6]);
+}
+
+void
+test_Pipeline_should_MoveItemsOneStagePerPoll(void)
+{
+    uint32_t now = 0;
+
+    // 4 samples, then one stage per poll up to the driver
+    while (uplinks == 0)
+    {
+        pipeline_poll(stages, STAGES, now);
+        now += 250;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(3000 + 3 * 250, now - 250);
+    TEST_ASSERT_EQUAL_UINT8(PIPELINE_SUMMARY_SIZE, uplink_size);
+    TEST_ASSERT_EQUAL_HEX8(10, uplink_data[1]);
+    TEST_ASSERT_EQUAL_HEX8(11, uplink_data[3]);
+    TEST_ASSERT_EQUAL_HEX8(13, uplink_data[5]);
+    TEST_ASSERT_EQUAL_UINT8(0, pipeline_poll(stages, STAGES, 3800));
+}
+
+void
+test_Pipeline_should_BackPressureUpToTheSource(void)
+{
+    uint32_t now;
+
+    // The driver holds the first message, as with the daily budget spent
+    for (now = 0; now < 20000; now += 100)
+    {
+        pipeline_poll(stages, STAGES, now);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(1, uplinks);
+    TEST_ASSERT_EQUAL_UINT8(1, pipeline_queue_count(&frames));
+    TEST_ASSERT_EQUAL_UINT8(1, pipeline_queue_count(&summaries));
+    TEST_ASSERT_EQUAL_UINT8(2, pipeline_queue_count(&samples));
+    // 4 sent, 4 in the frame, 4 in the summary, 3 in the aggregate and 2
+    // queued, of the 20 samples due
+    TEST_ASSERT_EQUAL_UINT16(20 - 17, source.overruns);
+
+    // Released, the queued items flow again
+    uplink_state = WISOL_UPLINK_IDLE;
+    pipeline_poll(stages, STAGES, now);
+    TEST_ASSERT_EQUAL_UINT8(2, uplinks);
+    TEST_ASSERT_EQUAL_HEX8(14, uplink_data[1]);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Pipeline_should_ReadSourceOnItsPeriod);
+    RUN_TEST(test_Pipeline_should_FilterWithMovingAverage);
+    RUN_TEST(test_Pipeline_should_SummarizeWindows);
+    RUN_TEST(test_Pipeline_should_MoveItemsOneStagePerPoll);
+    RUN_TEST(test_Pipeline_should_BackPressureUpToTheSource);
+
+    return UNITY_END();
+}
@@ -0,0 +1,337 @@
+#include <string.h>
+#include "unity.h"
+#include "pwm.h"
+#include "tick.h"
+#include "avr_sim.h"
+
+// The overflow interrupts are plain functions on the host, called at TOP
+void TIMER0_OVF_vect(void);
+void TIMER1_OVF_vect(void);
+void TIMER2_OVF_vect(void);
+
+// Timer1 overflows
+static void
+top1(uint16_t count)
+{
+    while (count-- > 0)
+    {
+        TIMER1_OVF_vect();
+    }
+}
+
+// Timer2 overflows
+static void
+top2(uint16_t count)
+{
+    while (count-- > 0)
+    {
+        TIMER2_OVF_vect();
+    }
+}
+
+// Periods of Timer1, the ones with the compare above the TOP and the ones
+// off the duty cycle of 50 %
+static uint16_t periods;
+static uint16_t above_top;
+static uint16_t off_duty;
+
+// End of a period of a simulated timer
+static void
+period(uint8_t timer, uint16_t top, uint16_t compare_a, uint16_t compare_b)
+{
+    (void) compare_b;
+
+    if (timer != 1)
+    {
+        return;
+    }
+
+    periods++;
+    if (compare_a > top)
+    {
+        above_top++;
+    }
+    // The first period after pwm_init runs before the first BOTTOM load
+    else if ( (compare_a != 0) &&
+              ((2UL * compare_a + 2 < top + 1UL) ||
+               (2UL * compare_a > top + 3UL)) )
+    {
+        off_duty++;
+    }
+}
+
+void
+setUp(void)
+{
+    pwm_stop(PWM_B1);
+    pwm_stop(PWM_D3);
+    pwm_stop(PWM_D5);
+    memset((void *) avr_sim_io, 0, sizeof(avr_sim_io));
+}
+
+void
+tearDown(void)
+{
+    avr_sim_stop();
+}
+
+void
+test_Pwm_should_ProgramTimer1FastPwmWithIcr1Top(void)
+{
+    PORTB = _BV(B1_PIN);
+
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_init(PWM_B1, 20000, 800));
+
+    // Mode 14 with a prescaler of 1, output disconnected at duty 0
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM11), TCCR1A);
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM13) | _BV(WGM12) | _BV(CS10), TCCR1B);
+    TEST_ASSERT_EQUAL_UINT16(799, ICR1);
+    TEST_ASSERT_EQUAL_UINT16(0, OCR1A);
+    TEST_ASSERT_EQUAL_UINT16(800, pwm_get_steps(PWM_B1));
+    TEST_ASSERT_BITS_HIGH(_BV(B1_PIN), DDRB);
+    TEST_ASSERT_BITS_LOW(_BV(B1_PIN), PORTB);
+    TEST_ASSERT_BITS_LOW(_BV(TOIE1), TIMSK1);
+
+    // 1 Hz needs a prescaler of 256
+    pwm_stop(PWM_B1);
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_init(PWM_B1, 1, 0));
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM13) | _BV(WGM12) | _BV(CS12), TCCR1B);
+    TEST_ASSERT_EQUAL_UINT16(62499, ICR1);
+}
+
+void
+test_Pwm_should_SelectTimer2PrescalerForFrequencyAndSteps(void)
+{
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_init(PWM_D3, 2000, 0));
+
+    // Mode 7 with TOP = OCR2A and a prescaler of 32
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM21) | _BV(WGM20), TCCR2A);
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM22) | _BV(CS21) | _BV(CS20), TCCR2B);
+    TEST_ASSERT_EQUAL_HEX8(249, OCR2A);
+    TEST_ASSERT_EQUAL_UINT16(250, pwm_get_steps(PWM_D3));
+    TEST_ASSERT_BITS_HIGH(_BV(D3_PIN), DDRD);
+
+    // Out of the range of the timer, the settings are kept
+    TEST_ASSERT_EQUAL(PWM_RANGE, pwm_set_frequency(PWM_D3, 2000, 251));
+    TEST_ASSERT_EQUAL(PWM_RANGE, pwm_set_frequency(PWM_D3, 30, 0));
+    TEST_ASSERT_EQUAL(PWM_RANGE, pwm_set_frequency(PWM_D3, 0, 0));
+    TEST_ASSERT_EQUAL(PWM_RANGE, pwm_set_frequency(PWM_D3, 16000000UL, 0));
+    TEST_ASSERT_EQUAL_UINT16(250, pwm_get_steps(PWM_D3));
+    TEST_ASSERT_FALSE(pwm_busy(PWM_D3));
+}
+
+void
+test_Pwm_should_RefuseTimersUsedByOtherDrivers(void)
+{
+    // Software UART on Timer2, ISR profile on Timer1, no tick on Timer0
+    TCCR2B = _BV(CS21) | _BV(CS20);
+    TCCR1B = _BV(CS10);
+
+    TEST_ASSERT_EQUAL(PWM_BUSY, pwm_init(PWM_D3, 2000, 0));
+    TEST_ASSERT_EQUAL(PWM_BUSY, pwm_init(PWM_B1, 2000, 0));
+    TEST_ASSERT_EQUAL(PWM_BUSY, pwm_init(PWM_D5, 1000, 0));
+    TEST_ASSERT_EQUAL_HEX8(0x00, TCCR2A);
+    TEST_ASSERT_EQUAL_HEX8(0x00, DDRD);
+
+    TEST_ASSERT_EQUAL(PWM_UNSUPPORTED, pwm_set_duty(PWM_D3, 100));
+    TEST_ASSERT_EQUAL(PWM_UNSUPPORTED, pwm_init(PWM_CHANNELS, 2000, 0));
+    TEST_ASSERT_EQUAL_UINT16(0, pwm_get_steps(PWM_B1));
+}
+
+void
+test_Pwm_should_WriteDutyAtTopInTwoStages(void)
+{
+    pwm_init(PWM_B1, 20000, 0);
+
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_set_duty(PWM_B1, PWM_DUTY_MAX / 4));
+
+    // Nothing written before the TOP
+    TEST_ASSERT_EQUAL_UINT16(0, OCR1A);
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM11), TCCR1A);
+    TEST_ASSERT_BITS_HIGH(_BV(TOIE1), TIMSK1);
+    TEST_ASSERT_TRUE(pwm_busy(PWM_B1));
+
+    // First TOP: the compare register, buffered until the next BOTTOM
+    top1(1);
+    TEST_ASSERT_EQUAL_UINT16(199, OCR1A);
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM11), TCCR1A);
+
+    // Second TOP: the output connected, the interrupt disabled
+    top1(1);
+    TEST_ASSERT_EQUAL_HEX8(_BV(COM1A1) | _BV(WGM11), TCCR1A);
+    TEST_ASSERT_BITS_LOW(_BV(TOIE1), TIMSK1);
+    TEST_ASSERT_FALSE(pwm_busy(PWM_B1));
+
+    // Always high at the maximum, disconnected at 0
+    pwm_set_duty(PWM_B1, PWM_DUTY_MAX);
+    top1(2);
+    TEST_ASSERT_EQUAL_UINT16(799, OCR1A);
+    pwm_set_duty(PWM_B1, 0);
+    top1(2);
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM11), TCCR1A);
+}
+
+void
+test_Pwm_should_ChangeFrequencyKeepingDuty(void)
+{
+    pwm_init(PWM_B1, 20000, 0);
+    pwm_set_duty(PWM_B1, PWM_DUTY_MAX / 2 + 1);
+    top1(2);
+    TEST_ASSERT_EQUAL_UINT16(400, OCR1A);
+
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_set_frequency(PWM_B1, 1000, 0));
+    TEST_ASSERT_EQUAL_UINT16(16000, pwm_get_steps(PWM_B1));
+
+    // The compare register first, then ICR1 in the period it applies to
+    top1(1);
+    TEST_ASSERT_EQUAL_UINT16(8000, OCR1A);
+    TEST_ASSERT_EQUAL_UINT16(799, ICR1);
+    top1(1);
+    TEST_ASSERT_EQUAL_UINT16(15999, ICR1);
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM13) | _BV(WGM12) | _BV(CS10), TCCR1B);
+    TEST_ASSERT_EQUAL_HEX8(_BV(COM1A1) | _BV(WGM11), TCCR1A);
+}
+
+void
+test_Pwm_should_PlayToneForItsLength(void)
+{
+    pwm_init(PWM_D3, 2000, 0);
+
+    // 4 kHz for 10 ms: 40 periods of 125 counts with a prescaler of 32
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_tone(PWM_D3, 4000, 10));
+    top2(2);
+    TEST_ASSERT_EQUAL_HEX8(124, OCR2A);
+    TEST_ASSERT_EQUAL_HEX8(62, OCR2B);
+    TEST_ASSERT_EQUAL_HEX8(_BV(COM2B1) | _BV(WGM21) | _BV(WGM20), TCCR2A);
+
+    top2(37);
+    TEST_ASSERT_BITS_HIGH(_BV(COM2B1), TCCR2A);
+    TEST_ASSERT_TRUE(pwm_busy(PWM_D3));
+
+    // The last period ends the tone, the output is disconnected at the next
+    top2(2);
+    TEST_ASSERT_BITS_LOW(_BV(COM2B1), TCCR2A);
+    TEST_ASSERT_BITS_LOW(_BV(TOIE2), TIMSK2);
+    TEST_ASSERT_FALSE(pwm_busy(PWM_D3));
+
+    TEST_ASSERT_EQUAL(PWM_UNSUPPORTED, pwm_tone(PWM_D5, 4000, 10));
+}
+
+void
+test_Pwm_should_FadeLinearlyToTheTarget(void)
+{
+    uint16_t previous = 0;
+    uint8_t i;
+
+    // 1 kHz: a step every 10 periods, 10 steps in 100 ms
+    pwm_init(PWM_B1, 1000, 0);
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_fade(PWM_B1, PWM_DUTY_MAX, 100));
+
+    for (i = 0; i < 9; i++)
+    {
+        top1(10);
+        TEST_ASSERT_TRUE(OCR1A > previous);
+        TEST_ASSERT_UINT_WITHIN(2, 1600U * (i + 1), OCR1A);
+        previous = OCR1A;
+    }
+    TEST_ASSERT_TRUE(pwm_busy(PWM_B1));
+
+    top1(10);
+    TEST_ASSERT_EQUAL_UINT16(15999, OCR1A);
+    top1(1);
+    TEST_ASSERT_FALSE(pwm_busy(PWM_B1));
+    TEST_ASSERT_BITS_LOW(_BV(TOIE1), TIMSK1);
+
+    // A duty cycle set stops the fade
+    pwm_fade(PWM_B1, 0, 1000);
+    pwm_set_duty(PWM_B1, 100);
+    top1(20);
+    TEST_ASSERT_FALSE(pwm_busy(PWM_B1));
+    TEST_ASSERT_EQUAL_UINT16(24, OCR1A);
+}
+
+void
+test_Pwm_should_ShareTimer0WithTheTickOnSimulatedTimers(void)
+{
+    uint32_t start;
+
+    avr_sim_start();
+    tick_init();
+    sei();
+
+    TEST_ASSERT_EQUAL(PWM_RANGE, pwm_init(PWM_D5, 2000, 0));
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_init(PWM_D5, 1000, 250));
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM01) | _BV(WGM00), TCCR0A);
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM02) | _BV(CS01) | _BV(CS00), TCCR0B);
+
+    pwm_set_duty(PWM_D5, PWM_DUTY_MAX / 2 + 1);
+    TEST_ASSERT_EQUAL_HEX8(0, OCR0B);
+
+    // The update is written by the overflow interrupt, the tick keeps 1 ms
+    start = tick_get_ms();
+    avr_sim_run(5UL * 16000UL);
+    TEST_ASSERT_EQUAL_HEX8(125, OCR0B);
+    TEST_ASSERT_EQUAL_HEX8(_BV(COM0B1) | _BV(WGM01) | _BV(WGM00), TCCR0A);
+    TEST_ASSERT_FALSE(pwm_busy(PWM_D5));
+    TEST_ASSERT_UINT_WITHIN(1, 5, tick_get_ms() - start);
+
+    // Back to the CTC mode of the tick
+    pwm_stop(PWM_D5);
+    TEST_ASSERT_EQUAL_HEX8(_BV(WGM01), TCCR0A);
+    TEST_ASSERT_EQUAL_HEX8(_BV(CS01) | _BV(CS00), TCCR0B);
+    start = tick_get_ms();
+    avr_sim_run(3UL * 16000UL);
+    TEST_ASSERT_UINT_WITHIN(1, 3, tick_get_ms() - start);
+}
+
+void
+test_Pwm_should_KeepTheCompareBelowTopAcrossFrequencyChanges(void)
+{
+    periods = 0;
+    above_top = 0;
+    off_duty = 0;
+
+    avr_sim_start();
+    avr_sim_timer_set_handler(period);
+    sei();
+
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_init(PWM_B1, 1000, 0));
+    pwm_set_duty(PWM_B1, PWM_DUTY_MAX / 2 + 1);
+    avr_sim_run(5UL * 16000UL);
+
+    // Up to 20 kHz: the compare of 1 kHz would never match the new TOP
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_set_frequency(PWM_B1, 20000, 0));
+    avr_sim_run(5UL * 16000UL);
+    TEST_ASSERT_EQUAL_UINT16(799, ICR1);
+
+    // Down to 10 Hz: the compare of 20 kHz would give a short pulse
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_set_frequency(PWM_B1, 10, 0));
+    avr_sim_run(300UL * 16000UL);
+    TEST_ASSERT_EQUAL_UINT16(24999, ICR1);
+
+    TEST_ASSERT_EQUAL(PWM_OK, pwm_set_frequency(PWM_B1, 1000, 0));
+    avr_sim_run(300UL * 16000UL);
+    TEST_ASSERT_EQUAL_UINT16(15999, ICR1);
+
+    TEST_ASSERT_TRUE(periods > 200);
+    TEST_ASSERT_EQUAL_UINT16(0, above_top);
+    TEST_ASSERT_EQUAL_UINT16(0, off_duty);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Pwm_should_ProgramTimer1FastPwmWithIcr1Top);
+    RUN_TEST(test_Pwm_should_SelectTimer2PrescalerForFrequencyAndSteps);
+    RUN_TEST(test_Pwm_should_RefuseTimersUsedByOtherDrivers);
+    RUN_TEST(test_Pwm_should_WriteDutyAtTopInTwoStages);
+    RUN_TEST(test_Pwm_should_ChangeFrequencyKeepingDuty);
+    RUN_TEST(test_Pwm_should_PlayToneForItsLength);
+    RUN_TEST(test_Pwm_should_FadeLinearlyToTheTarget);
+    RUN_TEST(test_Pwm_should_ShareTimer0WithTheTickOnSimulatedTimers);
+    RUN_TEST(test_Pwm_should_KeepTheCompareBelowTopAcrossFrequencyChanges);
+
+    return UNITY_END();
+}
@@ -0,0 +1,114 @@
+#include "unity.h"
+#include "ram_profile.h"
+
+// Free RAM between the end of the variables and the top of the stack
+static uint8_t ram[256];
+
+// Simulates the stack growing down from the top of the RAM
+static void
+use_stack(uint16_t depth, uint8_t value)
+{
+    memset(&ram[sizeof(ram) - depth], value, depth);
+}
+
+void
+setUp(void)
+{
+    memset(ram, 0, sizeof(ram));
+    ram_profile_paint(ram, ram + sizeof(ram));
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_RamProfile_should_PaintTheRegion(void)
+{
+    uint8_t guard[4] = {0, 0, 0, 0};
+
+    ram_profile_paint(&guard[1], &guard[3]);
+
+    TEST_ASSERT_EQUAL_UINT8(0, guard[0]);
+    TEST_ASSERT_EQUAL_UINT8(RAM_PROFILE_CANARY, guard[1]);
+    TEST_ASSERT_EQUAL_UINT8(RAM_PROFILE_CANARY, guard[2]);
+    TEST_ASSERT_EQUAL_UINT8(0, guard[3]);
+
+    for (uint16_t i = 0; i < sizeof(ram); i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(RAM_PROFILE_CANARY, ram[i]);
+    }
+}
+
+void
+test_RamProfile_should_ReportUnusedRegion(void)
+{
+    TEST_ASSERT_EQUAL_UINT16(sizeof(ram), ram_profile_scan(ram, ram +
+                                                           sizeof(ram)));
+}
+
+void
+test_RamProfile_should_FindTheDeepestStackPoint(void)
+{
+    use_stack(40, 0x00);
+
+    TEST_ASSERT_EQUAL_UINT16(sizeof(ram) - 40,
+                             ram_profile_scan(ram, ram + sizeof(ram)));
+}
+
+void
+test_RamProfile_should_KeepTheHighWaterMark(void)
+{
+    // The later calls use less stack, the deepest point stays written
+    use_stack(100, 0x12);
+    use_stack(20, 0x34);
+
+    TEST_ASSERT_EQUAL_UINT16(sizeof(ram) - 100,
+                             ram_profile_scan(ram, ram + sizeof(ram)));
+}
+
+void
+test_RamProfile_should_StopAtFirstWrittenByte(void)
+{
+    // Canary values written by the stack below the deepest point are not
+    // counted as unused
+    use_stack(50, RAM_PROFILE_CANARY);
+    ram[sizeof(ram) - 50] = 0x00;
+
+    TEST_ASSERT_EQUAL_UINT16(sizeof(ram) - 50,
+                             ram_profile_scan(ram, ram + sizeof(ram)));
+}
+
+void
+test_RamProfile_should_ReportFullRegion(void)
+{
+    use_stack(sizeof(ram), 0xFF);
+
+    TEST_ASSERT_EQUAL_UINT16(0, ram_profile_scan(ram, ram + sizeof(ram)));
+    TEST_ASSERT_EQUAL_UINT16(0, ram_profile_scan(ram, ram));
+}
+
+void
+test_RamProfile_should_ScanOnlyBelowTheLimit(void)
+{
+    // The scan stops at the current stack pointer
+    TEST_ASSERT_EQUAL_UINT16(128, ram_profile_scan(ram, ram + 128));
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_RamProfile_should_PaintTheRegion);
+    RUN_TEST(test_RamProfile_should_ReportUnusedRegion);
+    RUN_TEST(test_RamProfile_should_FindTheDeepestStackPoint);
+    RUN_TEST(test_RamProfile_should_KeepTheHighWaterMark);
+    RUN_TEST(test_RamProfile_should_StopAtFirstWrittenByte);
+    RUN_TEST(test_RamProfile_should_ReportFullRegion);
+    RUN_TEST(test_RamProfile_should_ScanOnlyBelowTheLimit);
+
+    return UNITY_END();
+}
@@ -0,0 +1,368 @@
+#include <string.h>
+#include "unity.h"
+#include "wisol_sim.h"
+#include "avr_sim.h"
+#include "avr/interrupt.h"
+#include "sigfox_wisol.h"
+#include "tick.h"
+
+static wisol_sim_config config;
+static uint8_t str[20];
+static const uint8_t pac[] =
+{
+    0x12, 0x34, 0x56, 0x78, 0x90, 0xAB, 0xCD, 0xEF
+};
+
+static uint8_t
+enabled(void)
+{
+    return (PORTD & _BV(WISOL_EN_PIN)) != 0;
+}
+
+void
+setUp(void)
+{
+    memset((void *) avr_sim_io, 0, sizeof(avr_sim_io));
+    avr_sim_start();
+    wisol_sim_default_config(&config);
+    // Short air time, the frames time out after WISOL_FRAME_TIMEOUT
+    config.uplink_us = 100000UL;
+    wisol_sim_attach(&config);
+    tick_init();
+    sigfox_wisol_init();
+    sei();
+}
+
+void
+tearDown(void)
+{
+    avr_sim_stop();
+}
+
+void
+test_SigfoxWisol_should_PowerOffWhenNextCommandIsUnknown(void)
+{
+    TEST_ASSERT_EQUAL(WISOL_POWER_OFF, sigfox_wisol_get_power());
+
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_id(str, sizeof(str), NULL));
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_pac(str, sizeof(str), NULL));
+
+    TEST_ASSERT_EQUAL(WISOL_POWER_OFF, sigfox_wisol_get_power());
+    TEST_ASSERT_FALSE(enabled());
+    TEST_ASSERT_EQUAL_UINT32(2, wisol_sim_get_stats()->wakeups);
+    TEST_ASSERT_EQUAL_UINT32(2, wisol_sim_get_stats()->commands);
+}
+
+void
+test_SigfoxWisol_should_StayReadyWhenNextCommandIsImmediate(void)
+{
+    sigfox_wisol_set_next(0);
+
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_id(str, sizeof(str), NULL));
+    TEST_ASSERT_EQUAL(WISOL_POWER_READY, sigfox_wisol_get_power());
+    TEST_ASSERT_TRUE(enabled());
+
+    // No redundant transition, the module is already awake
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_pac(str, sizeof(str), NULL));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(pac, str, sizeof(pac));
+    TEST_ASSERT_EQUAL_UINT32(1, wisol_sim_get_stats()->wakeups);
+
+    sigfox_wisol_power_down();
+    TEST_ASSERT_EQUAL(WISOL_POWER_OFF, sigfox_wisol_get_power());
+    TEST_ASSERT_FALSE(enabled());
+}
+
+void
+test_SigfoxWisol_should_SleepAndWakeUpThroughUart(void)
+{
+    uint64_t start;
+
+    sigfox_wisol_set_next(10000);
+
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_id(str, sizeof(str), NULL));
+    TEST_ASSERT_EQUAL(WISOL_POWER_SLEEP, sigfox_wisol_get_power());
+    TEST_ASSERT_TRUE(enabled());
+    TEST_ASSERT_EQUAL_UINT32(2, wisol_sim_get_stats()->commands);
+
+    // Woken up by a byte in far less than the power on time
+    start = avr_sim_micros();
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_pac(str, sizeof(str), NULL));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(pac, str, sizeof(pac));
+    TEST_ASSERT_TRUE(avr_sim_micros() - start < 200000);
+    TEST_ASSERT_EQUAL_UINT32(2, wisol_sim_get_stats()->wakeups);
+    TEST_ASSERT_EQUAL_UINT32(1, wisol_sim_get_stats()->lost);
+    TEST_ASSERT_EQUAL(WISOL_POWER_SLEEP, sigfox_wisol_get_power());
+}
+
+void
+test_SigfoxWisol_should_DiscardBytesReceivedWhileWakingUp(void)
+{
+    const uint8_t noise[] = "ERROR\r\n";
+
+    sigfox_wisol_set_next(10000);
+    sigfox_wisol_get_id(str, sizeof(str), NULL);
+    TEST_ASSERT_EQUAL(WISOL_POWER_SLEEP, sigfox_wisol_get_power());
+
+    // A line received during the wake up is not the answer of the command
+    avr_sim_uart_rx(noise, sizeof(noise) - 1);
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_pac(str, sizeof(str), NULL));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(pac, str, sizeof(pac));
+}
+
+void
+test_SigfoxWisol_should_PowerOffWhenSleepIsRejected(void)
+{
+    sigfox_wisol_set_next(10000);
+    wisol_sim_inject(WISOL_SIM_FAULT_ERROR, 2);
+
+    // The ID is answered with ERROR, then AT$P=1
+    sigfox_wisol_get_id(str, sizeof(str), NULL);
+
+    TEST_ASSERT_EQUAL(WISOL_POWER_OFF, sigfox_wisol_get_power());
+    TEST_ASSERT_FALSE(enabled());
+}
+
+void
+test_SigfoxWisol_should_DeepSleepWhenAllowed(void)
+{
+    sigfox_wisol_set_next(WISOL_SLEEP_MS);
+
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_id(str, sizeof(str), NULL));
+    // The deep sleep is disabled by default
+    TEST_ASSERT_EQUAL(WISOL_POWER_OFF, sigfox_wisol_get_power());
+}
+
+void
+test_SigfoxWisol_should_ReportTimeInEveryState(void)
+{
+    sigfox_wisol_power_stats stats;
+
+    sigfox_wisol_set_next(10000);
+    sigfox_wisol_get_id(str, sizeof(str), NULL);
+    _delay_ms(5000);
+    sigfox_wisol_set_next(WISOL_NEXT_UNKNOWN);
+    sigfox_wisol_get_pac(str, sizeof(str), NULL);
+    _delay_ms(2000);
+
+    sigfox_wisol_get_power_stats(&stats);
+
+    // Off, ready, sleep, ready, off
+    TEST_ASSERT_EQUAL_UINT16(4, stats.transitions);
+    TEST_ASSERT_EQUAL_UINT16(2, stats.wakeups);
+    TEST_ASSERT_UINT_WITHIN(50, WISOL_POWER_ON_MS + 2000,
+                            stats.ms[WISOL_POWER_OFF]);
+    TEST_ASSERT_UINT_WITHIN(50, 5000, stats.ms[WISOL_POWER_SLEEP]);
+    TEST_ASSERT_UINT_WITHIN(50, 50, stats.ms[WISOL_POWER_READY]);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.ms[WISOL_POWER_DEEP_SLEEP]);
+}
+
+void
+test_SigfoxWisol_should_DecodeIdInTheBufferGiven(void)
+{
+    const uint8_t id[] = {0x01, 0x23, 0xAB, 0xCD};
+    uint8_t length = 0;
+
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_id(str, sizeof(str), &length));
+    TEST_ASSERT_EQUAL_UINT8(sizeof(id), length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(id, str, sizeof(id));
+
+    // The buffer holds the line before it is decoded
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_OVERFLOW,
+                      sigfox_wisol_get_id(str, sizeof(id), &length));
+    TEST_ASSERT_EQUAL_UINT8(0, length);
+}
+
+void
+test_SigfoxWisol_should_SendFrameInHexadecimal(void)
+{
+    const uint8_t payload[] = {0x01, 0xAB, 0xF0};
+
+    TEST_ASSERT_EQUAL(WISOL_SEND_OK,
+                      sigfox_wisol_send_frame(payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL_UINT32(1, wisol_sim_get_stats()->uplinks);
+    TEST_ASSERT_EQUAL_UINT32(0, wisol_sim_get_stats()->errors);
+
+    // Not sent at all
+    TEST_ASSERT_EQUAL(WISOL_SEND_ERROR, sigfox_wisol_send_frame(payload, 0));
+    TEST_ASSERT_EQUAL(WISOL_SEND_ERROR,
+                      sigfox_wisol_send_frame(payload, WISOL_FRAME_MAX + 1));
+    TEST_ASSERT_EQUAL_UINT32(2, wisol_sim_get_stats()->commands);
+}
+
+void
+test_SigfoxWisol_should_ClassifyFailedFrames(void)
+{
+    const uint8_t payload[] = {0x42};
+
+    // AT is answered, AT$SF is not
+    config.error_every = 2;
+    wisol_sim_attach(&config);
+    TEST_ASSERT_EQUAL(WISOL_SEND_ERROR, sigfox_wisol_send_frame(payload, 1));
+
+    config.error_every = 0;
+    config.uplink_us = (WISOL_FRAME_TIMEOUT + 500UL) * 1000UL;
+    wisol_sim_attach(&config);
+    TEST_ASSERT_EQUAL(WISOL_SEND_TIMEOUT, sigfox_wisol_send_frame(payload, 1));
+
+    wisol_sim_inject(WISOL_SIM_FAULT_SILENT, 1);
+    TEST_ASSERT_EQUAL(WISOL_SEND_NOT_READY,
+                      sigfox_wisol_send_frame(payload, 1));
+    TEST_ASSERT_EQUAL(WISOL_POWER_OFF, sigfox_wisol_get_power());
+}
+
+void
+test_SigfoxWisol_should_RetryWithBackoffAndDrop(void)
+{
+    const uint8_t payload[] = {0x42};
+    sigfox_wisol_uplink_stats stats;
+    uint32_t now = 0;
+    uint32_t wait;
+
+    config.uplink_us = (WISOL_FRAME_TIMEOUT + 500UL) * 1000UL;
+    wisol_sim_attach(&config);
+
+    TEST_ASSERT_EQUAL(WISOL_NEXT_UNKNOWN, sigfox_wisol_uplink_next(now));
+    TEST_ASSERT_TRUE(sigfox_wisol_uplink(payload, 1));
+    TEST_ASSERT_FALSE(sigfox_wisol_uplink(payload, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, sigfox_wisol_uplink_next(now));
+
+    TEST_ASSERT_EQUAL(WISOL_UPLINK_PENDING, sigfox_wisol_uplink_poll(now));
+    wait = sigfox_wisol_uplink_next(now);
+    TEST_ASSERT_TRUE(wait > WISOL_RETRY_BASE_MS / 2);
+    TEST_ASSERT_TRUE(wait <= WISOL_RETRY_BASE_MS);
+
+    // Not due yet, the module is not touched
+    TEST_ASSERT_EQUAL(WISOL_UPLINK_PENDING,
+                      sigfox_wisol_uplink_poll(now + wait - 1));
+    TEST_ASSERT_EQUAL_UINT32(2, wisol_sim_get_stats()->commands);
+
+    now += wait;
+    TEST_ASSERT_EQUAL(WISOL_UPLINK_PENDING, sigfox_wisol_uplink_poll(now));
+    wait = sigfox_wisol_uplink_next(now);
+    TEST_ASSERT_TRUE(wait > WISOL_RETRY_BASE_MS);
+    TEST_ASSERT_TRUE(wait <= 2 * WISOL_RETRY_BASE_MS);
+
+    now += wait;
+    TEST_ASSERT_EQUAL(WISOL_UPLINK_DROPPED, sigfox_wisol_uplink_poll(now));
+    TEST_ASSERT_EQUAL(WISOL_NEXT_UNKNOWN, sigfox_wisol_uplink_next(now));
+
+    sigfox_wisol_get_uplink_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT16(WISOL_SEND_ATTEMPTS,
+                             stats.results[WISOL_SEND_TIMEOUT]);
+    TEST_ASSERT_EQUAL_UINT16(WISOL_SEND_ATTEMPTS - 1, stats.retries);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.dropped);
+
+    // A dropped message makes room for the next one
+    TEST_ASSERT_TRUE(sigfox_wisol_uplink(payload, 1));
+}
+
+void
+test_SigfoxWisol_should_KeepTheJitterWhenTheIdHashesToZero(void)
+{
+    const uint8_t payload[] = {0x42};
+    uint32_t wait;
+
+    // The ID takes the seed of the generator to 0
+    config.id = "0026E8E1";
+    config.uplink_us = (WISOL_FRAME_TIMEOUT + 500UL) * 1000UL;
+    wisol_sim_attach(&config);
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_id(str, sizeof(str), NULL));
+
+    TEST_ASSERT_TRUE(sigfox_wisol_uplink(payload, 1));
+    TEST_ASSERT_EQUAL(WISOL_UPLINK_PENDING, sigfox_wisol_uplink_poll(0));
+    wait = sigfox_wisol_uplink_next(0);
+    TEST_ASSERT_TRUE(wait > WISOL_RETRY_BASE_MS / 2);
+    TEST_ASSERT_TRUE(wait < WISOL_RETRY_BASE_MS);
+}
+
+void
+test_SigfoxWisol_should_RecoverAfterOneFailure(void)
+{
+    const uint8_t payload[] = {0x42};
+    sigfox_wisol_uplink_stats stats;
+    uint32_t now = 1000;
+
+    sigfox_wisol_uplink(payload, 1);
+    wisol_sim_inject(WISOL_SIM_FAULT_SILENT, 1);
+
+    TEST_ASSERT_EQUAL(WISOL_UPLINK_PENDING, sigfox_wisol_uplink_poll(now));
+    now += sigfox_wisol_uplink_next(now);
+    TEST_ASSERT_EQUAL(WISOL_UPLINK_IDLE, sigfox_wisol_uplink_poll(now));
+
+    sigfox_wisol_get_uplink_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.results[WISOL_SEND_NOT_READY]);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.results[WISOL_SEND_OK]);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.retries);
+    TEST_ASSERT_EQUAL_UINT16(0, stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(1, wisol_sim_get_stats()->uplinks);
+}
+
+void
+test_SigfoxWisol_should_DeferUplinksOverTheDailyBudget(void)
+{
+    const uint8_t payload[] = {0x42};
+    uint8_t packed[WISOL_UPLINK_STATS_SIZE];
+    uint32_t now = 0;
+    uint16_t i;
+
+    config.uplinks_per_day = WISOL_UPLINKS_PER_DAY + 1;
+    wisol_sim_attach(&config);
+
+    for (i = 0; i < WISOL_UPLINKS_PER_DAY; i++)
+    {
+        sigfox_wisol_uplink(payload, 1);
+        TEST_ASSERT_EQUAL(WISOL_UPLINK_IDLE, sigfox_wisol_uplink_poll(now));
+        now += 60000UL;
+    }
+
+    // Waits for the start of the next day
+    sigfox_wisol_uplink(payload, 1);
+    TEST_ASSERT_EQUAL(WISOL_UPLINK_PENDING, sigfox_wisol_uplink_poll(now));
+    TEST_ASSERT_EQUAL_UINT32(86400000UL - now, sigfox_wisol_uplink_next(now));
+    TEST_ASSERT_EQUAL(WISOL_UPLINK_IDLE, sigfox_wisol_uplink_poll(86400000UL));
+
+    TEST_ASSERT_EQUAL_UINT8(0,
+                            sigfox_wisol_pack_uplink_stats(packed,
+                                                           sizeof(packed) - 1));
+    TEST_ASSERT_EQUAL_UINT8(WISOL_UPLINK_STATS_SIZE,
+                            sigfox_wisol_pack_uplink_stats(packed,
+                                                           sizeof(packed)));
+    TEST_ASSERT_EQUAL_UINT8(WISOL_UPLINKS_PER_DAY + 1, packed[0]);
+    TEST_ASSERT_EQUAL_HEX8(0, packed[1]);
+    TEST_ASSERT_EQUAL_HEX8(0, packed[4]);
+    TEST_ASSERT_EQUAL_HEX8(1, packed[6]);
+    TEST_ASSERT_EQUAL_HEX8(1, packed[7]);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_SigfoxWisol_should_PowerOffWhenNextCommandIsUnknown);
+    RUN_TEST(test_SigfoxWisol_should_StayReadyWhenNextCommandIsImmediate);
+    RUN_TEST(test_SigfoxWisol_should_SleepAndWakeUpThroughUart);
+    RUN_TEST(test_SigfoxWisol_should_DiscardBytesReceivedWhileWakingUp);
+    RUN_TEST(test_SigfoxWisol_should_PowerOffWhenSleepIsRejected);
+    RUN_TEST(test_SigfoxWisol_should_DeepSleepWhenAllowed);
+    RUN_TEST(test_SigfoxWisol_should_ReportTimeInEveryState);
+    RUN_TEST(test_SigfoxWisol_should_DecodeIdInTheBufferGiven);
+    RUN_TEST(test_SigfoxWisol_should_SendFrameInHexadecimal);
+    RUN_TEST(test_SigfoxWisol_should_ClassifyFailedFrames);
+    RUN_TEST(test_SigfoxWisol_should_RetryWithBackoffAndDrop);
+    RUN_TEST(test_SigfoxWisol_should_KeepTheJitterWhenTheIdHashesToZero);
+    RUN_TEST(test_SigfoxWisol_should_RecoverAfterOneFailure);
+    RUN_TEST(test_SigfoxWisol_should_DeferUplinksOverTheDailyBudget);
+
+    return UNITY_END();
+}
@@ -0,0 +1,405 @@
+#include "unity.h"
+#include "soft_uart.h"
+
+// The Timer2 and pin change interrupts are plain functions on the host
+void TIMER2_COMPA_vect(void);
+void TIMER2_COMPB_vect(void);
+void PCINT2_vect(void);
+
+// Simulation steps per Timer2 count, so the RX line can change between two
+// counts as a real transmitter with a different clock
+#define STEPS_PER_COUNT     8
+// Timer2 counts per bit at 16 MHz with a prescaler of 32
+#define COUNTS_PER_BIT      (16000000.0 / 32.0 / SOFT_UART_BAUD)
+// Simulation steps per bit of an ideal transmitter
+#define STEPS_PER_BIT       (COUNTS_PER_BIT * STEPS_PER_COUNT)
+
+static uint32_t now;
+
+// Edges of the TX pin
+static uint32_t tx_edge_time[256];
+static uint8_t tx_edge_level[256];
+static uint16_t tx_edges;
+static uint8_t tx_level;
+
+// Frames driven on the RX pin
+static const uint8_t* rx_bytes;
+static uint8_t rx_count;
+static uint32_t rx_start;
+static double rx_steps_per_bit;
+static uint8_t rx_bad_stop;
+static uint8_t rx_level;
+
+// Level of the RX line at a time, 10 bits per frame and 1 idle bit between
+// the frames
+static uint8_t
+rx_line(uint32_t time)
+{
+    double bit;
+    uint32_t frame;
+    uint8_t index;
+
+    if (time < rx_start)
+    {
+        return 1;
+    }
+
+    bit = (time - rx_start) / rx_steps_per_bit;
+    frame = (uint32_t) (bit / 11.0);
+    index = (uint8_t) (bit - frame * 11.0);
+
+    if (frame >= rx_count)
+    {
+        return 1;
+    }
+
+    if (index == 0)
+    {
+        return 0;
+    }
+    if (index <= 8)
+    {
+        return (rx_bytes[frame] >> (index - 1)) & 0x01;
+    }
+    if (index == 9)
+    {
+        return !rx_bad_stop;
+    }
+
+    return 1;
+}
+
+static void
+schedule_rx(const void* bytes, uint8_t count, uint32_t start, double error)
+{
+    rx_bytes = (const uint8_t *) bytes;
+    rx_count = count;
+    rx_start = start;
+    rx_steps_per_bit = STEPS_PER_BIT * (1.0 + error);
+}
+
+// Advances the simulation one step: drives the RX pin and advances Timer2,
+// executing the interrupts as the hardware does
+static void
+step(void)
+{
+    uint8_t level;
+
+    now++;
+
+    level = rx_line(now);
+    if (level != rx_level)
+    {
+        rx_level = level;
+        if (level)
+        {
+            PIND |= _BV(SOFT_UART_RX_PIN);
+        }
+        else
+        {
+            PIND &= ~_BV(SOFT_UART_RX_PIN);
+        }
+
+        if ( (PCICR & _BV(PCIE2)) && (PCMSK2 & _BV(SOFT_UART_RX_PIN)) )
+        {
+            PCINT2_vect();
+        }
+    }
+
+    if ( (now % STEPS_PER_COUNT) != 0 )
+    {
+        return;
+    }
+
+    TCNT2++;
+    if ( (TIMSK2 & _BV(OCIE2A)) && (TCNT2 == OCR2A) )
+    {
+        TIMER2_COMPA_vect();
+    }
+    if ( (TIMSK2 & _BV(OCIE2B)) && (TCNT2 == OCR2B) )
+    {
+        TIMER2_COMPB_vect();
+    }
+
+    level = (PORTD & _BV(SOFT_UART_TX_PIN)) ? 1 : 0;
+    if ( (level != tx_level) && (tx_edges < 256) )
+    {
+        tx_edge_time[tx_edges] = now;
+        tx_edge_level[tx_edges] = level;
+        tx_edges++;
+        tx_level = level;
+    }
+}
+
+static void
+run_bits(double bits)
+{
+    uint32_t end = now + (uint32_t) (bits * STEPS_PER_BIT);
+
+    while (now < end)
+    {
+        step();
+    }
+}
+
+// Level of the TX pin at a time, from the recorded edges
+static uint8_t
+tx_line(uint32_t time)
+{
+    uint8_t level = 1;
+
+    for (uint16_t i = 0; (i < tx_edges) && (tx_edge_time[i] <= time); i++)
+    {
+        level = tx_edge_level[i];
+    }
+
+    return level;
+}
+
+// Decodes the frame sent from a start bit edge sampling in the middle of the
+// bits
+static uint8_t
+decode_tx(uint32_t start, uint8_t* stop)
+{
+    uint8_t data = 0;
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        data |= tx_line(start + (uint32_t) ((i + 1.5) * STEPS_PER_BIT)) << i;
+    }
+    *stop = tx_line(start + (uint32_t) (9.5 * STEPS_PER_BIT));
+
+    return data;
+}
+
+void
+setUp(void)
+{
+    memset((void *) avr_sim_io, 0, sizeof(avr_sim_io));
+    now = 0;
+    tx_edges = 0;
+    tx_level = 1;
+    schedule_rx("", 0, 0, 0.0);
+    rx_bad_stop = 0;
+    rx_level = 1;
+    PIND |= _BV(SOFT_UART_RX_PIN);
+
+    soft_uart_init();
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_SoftUart_should_InitializePinsAndTimer(void)
+{
+    TEST_ASSERT_BIT_HIGH(SOFT_UART_TX_PIN, DDRD);
+    TEST_ASSERT_BIT_HIGH(SOFT_UART_TX_PIN, PORTD);
+    TEST_ASSERT_BIT_LOW(SOFT_UART_RX_PIN, DDRD);
+    TEST_ASSERT_BIT_HIGH(SOFT_UART_RX_PIN, PORTD);
+    TEST_ASSERT_EQUAL_HEX8(0, TCCR2A);
+    TEST_ASSERT_EQUAL_HEX8(_BV(CS21) | _BV(CS20), TCCR2B);
+    TEST_ASSERT_BIT_HIGH(PCIE2, PCICR);
+    TEST_ASSERT_BIT_HIGH(SOFT_UART_RX_PIN, PCMSK2);
+    TEST_ASSERT_BIT_LOW(OCIE2A, TIMSK2);
+}
+
+void
+test_SoftUart_should_SendFrameWithBitTiming(void)
+{
+    uint8_t data = 0x4B;
+    uint8_t stop;
+    uint32_t start;
+    uint32_t period;
+
+    TEST_ASSERT_EQUAL_UINT8(1, soft_uart_write(&data, 1));
+    run_bits(12);
+
+    // The first edge is the start bit and the first data bit is high, so the
+    // second edge gives the bit period, within 1% of the baud rate
+    TEST_ASSERT_TRUE(tx_edges > 1);
+    TEST_ASSERT_EQUAL_UINT8(0, tx_edge_level[0]);
+    start = tx_edge_time[0];
+    period = tx_edge_time[1] - start;
+    TEST_ASSERT_UINT_WITHIN((uint32_t) (STEPS_PER_BIT / 100),
+                            (uint32_t) STEPS_PER_BIT, period);
+
+    // Every edge is a whole number of bits after the start bit
+    for (uint16_t i = 1; i < tx_edges; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(0, (tx_edge_time[i] - start) % period);
+    }
+
+    TEST_ASSERT_EQUAL_HEX8(data, decode_tx(start, &stop));
+    TEST_ASSERT_EQUAL_UINT8(1, stop);
+    TEST_ASSERT_EQUAL_UINT8(1, tx_level);
+    TEST_ASSERT_EQUAL_UINT8(0, soft_uart_tx_pending());
+    TEST_ASSERT_BIT_LOW(OCIE2A, TIMSK2);
+}
+
+void
+test_SoftUart_should_SendBackToBackFrames(void)
+{
+    const uint8_t data[] = {0x00, 0xFF, 0x55};
+    uint32_t start;
+    uint8_t stop;
+
+    soft_uart_write(data, sizeof(data));
+    run_bits(35);
+
+    start = tx_edge_time[0];
+    for (uint8_t i = 0; i < sizeof(data); i++)
+    {
+        // A frame is 10 bits long
+        TEST_ASSERT_EQUAL_UINT8(0, tx_line(start + (uint32_t) ((i * 10 + 0.5) *
+                                                               STEPS_PER_BIT)));
+        TEST_ASSERT_EQUAL_HEX8(data[i],
+                               decode_tx(start + (uint32_t) (i * 10 *
+                                                             STEPS_PER_BIT),
+                                         &stop));
+        TEST_ASSERT_EQUAL_UINT8(1, stop);
+    }
+}
+
+void
+test_SoftUart_should_QueueWithoutBlocking(void)
+{
+    uint8_t data[SOFT_UART_TX_BUFFER_SIZE + 8];
+
+    memset(data, 'x', sizeof(data));
+
+    // Returns without any timer count, the bytes that do not fit are not
+    // queued
+    TEST_ASSERT_EQUAL_UINT8(SOFT_UART_TX_BUFFER_SIZE - 1,
+                            soft_uart_write(data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT32(0, now);
+    TEST_ASSERT_EQUAL_UINT8(SOFT_UART_TX_BUFFER_SIZE - 1,
+                            soft_uart_tx_pending());
+    TEST_ASSERT_EQUAL_UINT8(0, soft_uart_write(data, 1));
+
+    // After the first frame the second byte is being sent
+    run_bits(12);
+    TEST_ASSERT_EQUAL_UINT8(SOFT_UART_TX_BUFFER_SIZE - 3,
+                            soft_uart_tx_pending());
+    TEST_ASSERT_EQUAL_UINT8(2, soft_uart_write(data, 2));
+}
+
+void
+test_SoftUart_should_ReceiveBytes(void)
+{
+    unsigned char data;
+
+    schedule_rx("Hello", 5, 100, 0.0);
+    run_bits(60);
+
+    TEST_ASSERT_EQUAL_UINT8(5, soft_uart_available());
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        TEST_ASSERT_TRUE(soft_uart_try_read_char(&data));
+        TEST_ASSERT_EQUAL_HEX8("Hello"[i], data);
+    }
+    TEST_ASSERT_FALSE(soft_uart_try_read_char(&data));
+    TEST_ASSERT_EQUAL_UINT16(0, soft_uart_errors());
+}
+
+void
+test_SoftUart_should_TolerateBaudRateError(void)
+{
+    const uint8_t data[] = {0x00, 0xFF, 0xA5, 0x5A, 0x80, 0x01};
+    const double errors[] = {-0.03, -0.015, 0.015, 0.03};
+    unsigned char rx;
+
+    for (uint8_t e = 0; e < sizeof(errors) / sizeof(errors[0]); e++)
+    {
+        setUp();
+        schedule_rx(data, sizeof(data), 37, errors[e]);
+        run_bits(sizeof(data) * 11 + 5);
+
+        TEST_ASSERT_EQUAL_UINT8(sizeof(data), soft_uart_available());
+        for (uint8_t i = 0; i < sizeof(data); i++)
+        {
+            soft_uart_try_read_char(&rx);
+            TEST_ASSERT_EQUAL_HEX8(data[i], rx);
+        }
+        TEST_ASSERT_EQUAL_UINT16(0, soft_uart_errors());
+    }
+}
+
+void
+test_SoftUart_should_CountFramingErrors(void)
+{
+    unsigned char rx;
+
+    rx_bad_stop = 1;
+    schedule_rx("\x00", 1, 10, 0.0);
+    run_bits(15);
+
+    TEST_ASSERT_EQUAL_UINT8(0, soft_uart_available());
+    TEST_ASSERT_EQUAL_UINT16(1, soft_uart_errors());
+
+    // The next frame is received
+    rx_bad_stop = 0;
+    schedule_rx("K", 1, now + 10, 0.0);
+    run_bits(15);
+
+    TEST_ASSERT_TRUE(soft_uart_try_read_char(&rx));
+    TEST_ASSERT_EQUAL_HEX8('K', rx);
+}
+
+void
+test_SoftUart_should_CountBytesLostWhenFull(void)
+{
+    uint8_t data[SOFT_UART_RX_BUFFER_SIZE + 2];
+
+    memset(data, 0x33, sizeof(data));
+    schedule_rx(data, sizeof(data), 10, 0.0);
+    run_bits(sizeof(data) * 11 + 5);
+
+    TEST_ASSERT_EQUAL_UINT8(SOFT_UART_RX_BUFFER_SIZE - 1,
+                            soft_uart_available());
+    TEST_ASSERT_EQUAL_UINT16(3, soft_uart_errors());
+}
+
+void
+test_SoftUart_should_SendAndReceiveAtTheSameTime(void)
+{
+    const char msg[] = "full duplex";
+    unsigned char rx;
+    uint8_t stop;
+
+    soft_uart_send(msg);
+    schedule_rx(msg, sizeof(msg) - 1, 333, 0.01);
+    run_bits((sizeof(msg) - 1) * 11 + 5);
+
+    for (uint8_t i = 0; i < sizeof(msg) - 1; i++)
+    {
+        TEST_ASSERT_TRUE(soft_uart_try_read_char(&rx));
+        TEST_ASSERT_EQUAL_HEX8(msg[i], rx);
+        TEST_ASSERT_EQUAL_HEX8(msg[i],
+                               decode_tx(tx_edge_time[0] +
+                                         (uint32_t) (i * 10 * STEPS_PER_BIT),
+                                         &stop));
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, soft_uart_errors());
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_SoftUart_should_InitializePinsAndTimer);
+    RUN_TEST(test_SoftUart_should_SendFrameWithBitTiming);
+    RUN_TEST(test_SoftUart_should_SendBackToBackFrames);
+    RUN_TEST(test_SoftUart_should_QueueWithoutBlocking);
+    RUN_TEST(test_SoftUart_should_ReceiveBytes);
+    RUN_TEST(test_SoftUart_should_TolerateBaudRateError);
+    RUN_TEST(test_SoftUart_should_CountFramingErrors);
+    RUN_TEST(test_SoftUart_should_CountBytesLostWhenFull);
+    RUN_TEST(test_SoftUart_should_SendAndReceiveAtTheSameTime);
+
+    return UNITY_END();
+}
@@ -0,0 +1,330 @@
+#include <string.h>
+#include "unity.h"
+#include "spi.h"
+
+// The SPI interrupt is a plain function on the host
+void SPI_STC_vect(void);
+
+// Chip select pins of the simulated devices
+static uint8_t cs_port_a;
+static uint8_t cs_port_b;
+
+// Chip select events: the port and the level written
+static uint8_t* cs_event_port[32];
+static uint8_t cs_event_level[32];
+static uint8_t cs_events;
+
+// Bytes sent by the master (MOSI) and the SPCR of every byte
+static uint8_t mosi[64];
+static uint8_t mosi_spcr[64];
+static uint8_t mosi_count;
+
+static spi_device device_a;
+static spi_device device_b;
+static uint8_t callbacks;
+static spi_transaction* chained;
+
+void
+gpio_init_pin(uint8_t* port, uint8_t pin, gpio_pin_mode mode)
+{
+
+}
+
+void
+gpio_write_pin(uint8_t* port, uint8_t pin, gpio_pin_state state)
+{
+    cs_event_port[cs_events] = port;
+    cs_event_level[cs_events] = state;
+    cs_events++;
+}
+
+// The simulated slave answers every byte with its complement
+static void
+run_spi(void)
+{
+    uint16_t guard = 0;
+
+    while (spi_busy() && (guard++ < 1000))
+    {
+        TEST_ASSERT_BIT_HIGH(SPIE, SPCR);
+
+        mosi[mosi_count] = SPDR;
+        mosi_spcr[mosi_count] = SPCR;
+        mosi_count++;
+
+        SPDR = ~mosi[mosi_count - 1];
+        SPSR |= _BV(SPIF);
+        SPI_STC_vect();
+    }
+}
+
+static void
+count_callback(spi_transaction* transaction)
+{
+    TEST_ASSERT_EQUAL(SPI_DONE, transaction->status);
+    callbacks++;
+}
+
+static void
+chain_callback(spi_transaction* transaction)
+{
+    callbacks++;
+    if (chained != NULL)
+    {
+        spi_submit(chained);
+        chained = NULL;
+    }
+}
+
+static void
+set_transaction(spi_transaction* transaction, spi_device* device,
+                const uint8_t* tx, uint8_t* rx, uint16_t size)
+{
+    memset(transaction, 0, sizeof(*transaction));
+    transaction->device = device;
+    transaction->tx = tx;
+    transaction->rx = rx;
+    transaction->size = size;
+    transaction->callback = count_callback;
+}
+
+void
+setUp(void)
+{
+    memset((void *) avr_sim_io, 0, sizeof(avr_sim_io));
+    cs_events = 0;
+    mosi_count = 0;
+    callbacks = 0;
+    chained = NULL;
+
+    spi_init();
+    spi_device_init(&device_a, &cs_port_a, 1, 1000000, SPI_MODE_0,
+                    SPI_MSB_FIRST);
+    spi_device_init(&device_b, &cs_port_b, 2, 8000000, SPI_MODE_3,
+                    SPI_LSB_FIRST);
+    cs_events = 0;
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_Spi_should_InitializeMasterPins(void)
+{
+    TEST_ASSERT_BIT_HIGH(PB2, DDRB);
+    TEST_ASSERT_BIT_HIGH(PB3, DDRB);
+    TEST_ASSERT_BIT_LOW(PB4, DDRB);
+    TEST_ASSERT_BIT_HIGH(PB5, DDRB);
+    TEST_ASSERT_BIT_HIGH(SPE, SPCR);
+    TEST_ASSERT_BIT_HIGH(MSTR, SPCR);
+    TEST_ASSERT_FALSE(spi_busy());
+}
+
+void
+test_Spi_should_SelectTheClockDivider(void)
+{
+    const uint32_t clocks[] = {8000000, 5000000, 4000000, 2000000, 1000000,
+                               500000, 250000, 125000, 100000};
+    const uint8_t spr[] = {0, 0, 0, 1, 1, 2, 2, 3, 3};
+    const uint8_t x2[] = {1, 0, 0, 1, 0, 1, 0, 0, 0};
+    spi_device device;
+
+    for (uint8_t i = 0; i < sizeof(spr); i++)
+    {
+        spi_device_init(&device, &cs_port_a, 0, clocks[i], SPI_MODE_0,
+                        SPI_MSB_FIRST);
+        TEST_ASSERT_EQUAL_HEX8(spr[i], device.spcr & 0x03);
+        TEST_ASSERT_EQUAL_HEX8(x2[i] ? _BV(SPI2X) : 0, device.spsr);
+    }
+}
+
+void
+test_Spi_should_ApplyModeAndBitOrder(void)
+{
+    TEST_ASSERT_BIT_LOW(CPOL, device_a.spcr);
+    TEST_ASSERT_BIT_LOW(CPHA, device_a.spcr);
+    TEST_ASSERT_BIT_LOW(DORD, device_a.spcr);
+    TEST_ASSERT_BIT_HIGH(CPOL, device_b.spcr);
+    TEST_ASSERT_BIT_HIGH(CPHA, device_b.spcr);
+    TEST_ASSERT_BIT_HIGH(DORD, device_b.spcr);
+}
+
+void
+test_Spi_should_TransferInBackground(void)
+{
+    const uint8_t tx[] = {0x9F, 0x00, 0x5A};
+    const uint8_t expected[] = {0x60, 0xFF, 0xA5};
+    uint8_t rx[3];
+    spi_transaction transaction;
+
+    set_transaction(&transaction, &device_a, tx, rx, sizeof(tx));
+
+    // Only the first byte is written, the rest is sent by the interrupt
+    TEST_ASSERT_EQUAL(SPI_PENDING, spi_submit(&transaction));
+    TEST_ASSERT_EQUAL_HEX8(0x9F, SPDR);
+    TEST_ASSERT_EQUAL(SPI_PENDING, transaction.status);
+    TEST_ASSERT_EQUAL_UINT8(1, cs_events);
+    TEST_ASSERT_EQUAL_PTR(&cs_port_a, cs_event_port[0]);
+    TEST_ASSERT_EQUAL_UINT8(GPIO_PIN_LOW, cs_event_level[0]);
+
+    run_spi();
+
+    TEST_ASSERT_EQUAL(SPI_DONE, transaction.status);
+    TEST_ASSERT_EQUAL_UINT8(1, callbacks);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(tx, mosi, sizeof(tx));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, rx, sizeof(rx));
+    TEST_ASSERT_EQUAL_UINT8(2, cs_events);
+    TEST_ASSERT_EQUAL_UINT8(GPIO_PIN_HIGH, cs_event_level[1]);
+}
+
+void
+test_Spi_should_SendFillWithoutTxBuffer(void)
+{
+    uint8_t rx[2];
+    spi_transaction read;
+    spi_transaction write;
+    const uint8_t tx[] = {0x12};
+
+    set_transaction(&read, &device_a, NULL, rx, sizeof(rx));
+    set_transaction(&write, &device_a, tx, NULL, sizeof(tx));
+    spi_submit(&read);
+    spi_submit(&write);
+    run_spi();
+
+    TEST_ASSERT_EQUAL_HEX8(SPI_FILL_BYTE, mosi[0]);
+    TEST_ASSERT_EQUAL_HEX8(SPI_FILL_BYTE, mosi[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, rx[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x12, mosi[2]);
+    TEST_ASSERT_EQUAL(SPI_DONE, write.status);
+}
+
+void
+test_Spi_should_RunQueuedTransactionsInOrder(void)
+{
+    const uint8_t tx_a[] = {0x01, 0x02};
+    const uint8_t tx_b[] = {0x03};
+    spi_transaction first;
+    spi_transaction second;
+    spi_transaction third;
+
+    set_transaction(&first, &device_a, tx_a, NULL, sizeof(tx_a));
+    set_transaction(&second, &device_b, tx_b, NULL, sizeof(tx_b));
+    set_transaction(&third, &device_a, tx_b, NULL, sizeof(tx_b));
+
+    TEST_ASSERT_EQUAL(SPI_PENDING, spi_submit(&first));
+    TEST_ASSERT_EQUAL(SPI_PENDING, spi_submit(&second));
+    TEST_ASSERT_EQUAL(SPI_PENDING, spi_submit(&third));
+    TEST_ASSERT_EQUAL_UINT8(1, cs_events);
+
+    run_spi();
+
+    TEST_ASSERT_EQUAL_UINT8(3, callbacks);
+    TEST_ASSERT_EQUAL_UINT8(4, mosi_count);
+
+    // Every device is transferred with its own settings
+    TEST_ASSERT_EQUAL_HEX8(device_a.spcr, mosi_spcr[0]);
+    TEST_ASSERT_EQUAL_HEX8(device_a.spcr, mosi_spcr[1]);
+    TEST_ASSERT_EQUAL_HEX8(device_b.spcr, mosi_spcr[2]);
+    TEST_ASSERT_EQUAL_HEX8(device_a.spcr, mosi_spcr[3]);
+
+    // A chip select is released before the next one is asserted
+    TEST_ASSERT_EQUAL_UINT8(6, cs_events);
+    TEST_ASSERT_EQUAL_PTR(&cs_port_a, cs_event_port[1]);
+    TEST_ASSERT_EQUAL_UINT8(GPIO_PIN_HIGH, cs_event_level[1]);
+    TEST_ASSERT_EQUAL_PTR(&cs_port_b, cs_event_port[2]);
+    TEST_ASSERT_EQUAL_UINT8(GPIO_PIN_LOW, cs_event_level[2]);
+    TEST_ASSERT_EQUAL_PTR(&cs_port_b, cs_event_port[3]);
+    TEST_ASSERT_EQUAL_UINT8(GPIO_PIN_HIGH, cs_event_level[3]);
+}
+
+void
+test_Spi_should_KeepChipSelectBetweenTransactions(void)
+{
+    const uint8_t cmd[] = {0x03, 0x00, 0x10, 0x00};
+    uint8_t data[4];
+    spi_transaction command;
+    spi_transaction read;
+
+    set_transaction(&command, &device_a, cmd, NULL, sizeof(cmd));
+    command.flags = SPI_KEEP_CS;
+    set_transaction(&read, &device_a, NULL, data, sizeof(data));
+
+    spi_submit(&command);
+    spi_submit(&read);
+    run_spi();
+
+    // Asserted by both transactions and released only at the end
+    TEST_ASSERT_EQUAL_UINT8(3, cs_events);
+    TEST_ASSERT_EQUAL_UINT8(GPIO_PIN_LOW, cs_event_level[0]);
+    TEST_ASSERT_EQUAL_UINT8(GPIO_PIN_LOW, cs_event_level[1]);
+    TEST_ASSERT_EQUAL_UINT8(GPIO_PIN_HIGH, cs_event_level[2]);
+    TEST_ASSERT_EQUAL_UINT8(8, mosi_count);
+}
+
+void
+test_Spi_should_RejectTransactionAlreadyQueued(void)
+{
+    const uint8_t tx[] = {0x01};
+    spi_transaction transaction;
+    spi_transaction empty;
+
+    set_transaction(&transaction, &device_a, tx, NULL, sizeof(tx));
+    TEST_ASSERT_EQUAL(SPI_PENDING, spi_submit(&transaction));
+    TEST_ASSERT_EQUAL(SPI_BUSY, spi_submit(&transaction));
+    run_spi();
+    TEST_ASSERT_EQUAL_UINT8(1, mosi_count);
+
+    // Once completed it can be submitted again
+    TEST_ASSERT_EQUAL(SPI_PENDING, spi_submit(&transaction));
+    run_spi();
+    TEST_ASSERT_EQUAL_UINT8(2, mosi_count);
+
+    // A transaction without bytes is completed at once
+    set_transaction(&empty, &device_a, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL(SPI_DONE, spi_submit(&empty));
+    TEST_ASSERT_EQUAL_UINT8(3, callbacks);
+    TEST_ASSERT_FALSE(spi_busy());
+}
+
+void
+test_Spi_should_AllowSubmittingFromCallback(void)
+{
+    const uint8_t tx[] = {0xAA, 0xBB};
+    spi_transaction first;
+    spi_transaction second;
+
+    set_transaction(&first, &device_a, tx, NULL, 1);
+    first.callback = chain_callback;
+    set_transaction(&second, &device_b, &tx[1], NULL, 1);
+    chained = &second;
+
+    spi_submit(&first);
+    run_spi();
+
+    TEST_ASSERT_EQUAL_UINT8(2, callbacks);
+    TEST_ASSERT_EQUAL_UINT8(2, mosi_count);
+    TEST_ASSERT_EQUAL_HEX8(0xBB, mosi[1]);
+    TEST_ASSERT_EQUAL(SPI_DONE, second.status);
+    TEST_ASSERT_FALSE(spi_busy());
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Spi_should_InitializeMasterPins);
+    RUN_TEST(test_Spi_should_SelectTheClockDivider);
+    RUN_TEST(test_Spi_should_ApplyModeAndBitOrder);
+    RUN_TEST(test_Spi_should_TransferInBackground);
+    RUN_TEST(test_Spi_should_SendFillWithoutTxBuffer);
+    RUN_TEST(test_Spi_should_RunQueuedTransactionsInOrder);
+    RUN_TEST(test_Spi_should_KeepChipSelectBetweenTransactions);
+    RUN_TEST(test_Spi_should_RejectTransactionAlreadyQueued);
+    RUN_TEST(test_Spi_should_AllowSubmittingFromCallback);
+
+    return UNITY_END();
+}
@@ -0,0 +1,210 @@
+#include "unity.h"
+#include "trace.h"
+
+static uint32_t now_ms;
+
+// Bytes sent through the UART by the dump
+static uint8_t sent[TRACE_HEADER_SIZE + TRACE_BUFFER_SIZE * TRACE_RECORD_SIZE];
+static uint16_t sent_count;
+// Event recorded while the dump is sent
+static uint8_t trace_while_sending;
+
+uint32_t
+tick_get_ms(void)
+{
+    return now_ms;
+}
+
+void
+uart_write(const uint8_t* data, uint8_t size)
+{
+    while (size-- > 0)
+    {
+        sent[sent_count++] = *data++;
+    }
+
+    if (trace_while_sending)
+    {
+        trace_event(TRACE_USER, 0);
+    }
+}
+
+void
+setUp(void)
+{
+    memset((void *) avr_sim_io, 0, sizeof(avr_sim_io));
+    now_ms = 0;
+    sent_count = 0;
+    trace_while_sending = 0;
+    trace_clear();
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_Trace_should_StartEmpty(void)
+{
+    trace_record record;
+
+    TEST_ASSERT_EQUAL_UINT8(0, trace_count());
+    TEST_ASSERT_EQUAL_UINT16(0, trace_dropped());
+    TEST_ASSERT_FALSE(trace_get(0, &record));
+}
+
+void
+test_Trace_should_RecordEventsWithTimestamp(void)
+{
+    trace_record record;
+
+    now_ms = 0x12345;
+    TCNT0 = 100;
+    trace_event(TRACE_UART_RX, 'A');
+    now_ms++;
+    TCNT0 = 3;
+    trace_event(TRACE_USER + 2, 0xBEEF);
+
+    TEST_ASSERT_EQUAL_UINT8(2, trace_count());
+
+    TEST_ASSERT_TRUE(trace_get(0, &record));
+    TEST_ASSERT_EQUAL_UINT16(0x2345, record.ms);
+    TEST_ASSERT_EQUAL_UINT8(100, record.sub);
+    TEST_ASSERT_EQUAL_UINT8(TRACE_UART_RX, record.id);
+    TEST_ASSERT_EQUAL_UINT16('A', record.arg);
+
+    TEST_ASSERT_TRUE(trace_get(1, &record));
+    TEST_ASSERT_EQUAL_UINT16(0x2346, record.ms);
+    TEST_ASSERT_EQUAL_UINT8(3, record.sub);
+    TEST_ASSERT_EQUAL_UINT8(TRACE_USER + 2, record.id);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, record.arg);
+
+    TEST_ASSERT_FALSE(trace_get(2, &record));
+}
+
+void
+test_Trace_should_CountPendingTickInterrupt(void)
+{
+    trace_record record;
+
+    // Timer0 restarted but the tick interrupt was not serviced yet
+    now_ms = 10;
+    TCNT0 = 2;
+    TIFR0 = _BV(OCF0A);
+    trace_event(TRACE_USER, 0);
+
+    // The match happened after the counter was read
+    TCNT0 = 249;
+    trace_event(TRACE_USER, 1);
+
+    trace_get(0, &record);
+    TEST_ASSERT_EQUAL_UINT16(11, record.ms);
+    trace_get(1, &record);
+    TEST_ASSERT_EQUAL_UINT16(10, record.ms);
+}
+
+void
+test_Trace_should_KeepTheNewestEventsWhenFull(void)
+{
+    trace_record record;
+
+    for (uint16_t i = 0; i < TRACE_BUFFER_SIZE + 5; i++)
+    {
+        trace_event(TRACE_USER, i);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(TRACE_BUFFER_SIZE, trace_count());
+    TEST_ASSERT_EQUAL_UINT16(5, trace_dropped());
+
+    trace_get(0, &record);
+    TEST_ASSERT_EQUAL_UINT16(5, record.arg);
+    trace_get(TRACE_BUFFER_SIZE - 1, &record);
+    TEST_ASSERT_EQUAL_UINT16(TRACE_BUFFER_SIZE + 4, record.arg);
+}
+
+void
+test_Trace_should_DumpHeaderAndRecords(void)
+{
+    const uint8_t expected[] =
+    {
+        'T', 'R', 2, 250, 0, 0,
+        0x34, 0x12, 7, TRACE_GPIO_WRITE, 0x51, 0x25,
+        0x35, 0x12, 0, TRACE_WISOL_CMD, 0x03, 0x00
+    };
+
+    now_ms = 0x1234;
+    TCNT0 = 7;
+    trace_event(TRACE_GPIO_WRITE, 0x2551);
+    now_ms++;
+    TCNT0 = 0;
+    trace_event(TRACE_WISOL_CMD, 3);
+
+    trace_dump();
+
+    TEST_ASSERT_EQUAL_UINT16(sizeof(expected), sent_count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sent, sizeof(expected));
+
+    // The records are kept after the dump
+    TEST_ASSERT_EQUAL_UINT8(2, trace_count());
+}
+
+void
+test_Trace_should_DropEventsWhileDumping(void)
+{
+    trace_event(TRACE_USER, 1);
+    trace_event(TRACE_USER, 2);
+
+    trace_while_sending = 1;
+    trace_dump();
+    trace_while_sending = 0;
+
+    // Header and the two records, each write recorded an event
+    TEST_ASSERT_EQUAL_UINT16(TRACE_HEADER_SIZE + 2 * TRACE_RECORD_SIZE,
+                             sent_count);
+    TEST_ASSERT_EQUAL_UINT8(2, trace_count());
+    TEST_ASSERT_EQUAL_UINT16(3, trace_dropped());
+
+    trace_event(TRACE_USER, 3);
+    TEST_ASSERT_EQUAL_UINT8(3, trace_count());
+}
+
+void
+test_Trace_should_RemoveTheMacroWhenDisabled(void)
+{
+    TEST_ASSERT_EQUAL(0, TRACE_ENABLE);
+
+    TRACE(TRACE_USER, 1);
+
+    TEST_ASSERT_EQUAL_UINT8(0, trace_count());
+}
+
+void
+test_Trace_should_KeepInterruptsState(void)
+{
+    sei();
+    trace_event(TRACE_USER, 0);
+    TEST_ASSERT_BIT_HIGH(SREG_I, SREG);
+
+    cli();
+    trace_event(TRACE_USER, 0);
+    TEST_ASSERT_BIT_LOW(SREG_I, SREG);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Trace_should_StartEmpty);
+    RUN_TEST(test_Trace_should_RecordEventsWithTimestamp);
+    RUN_TEST(test_Trace_should_CountPendingTickInterrupt);
+    RUN_TEST(test_Trace_should_KeepTheNewestEventsWhenFull);
+    RUN_TEST(test_Trace_should_DumpHeaderAndRecords);
+    RUN_TEST(test_Trace_should_DropEventsWhileDumping);
+    RUN_TEST(test_Trace_should_RemoveTheMacroWhenDisabled);
+    RUN_TEST(test_Trace_should_KeepInterruptsState);
+
+    return UNITY_END();
+}
@@ -0,0 +1,466 @@
+#include <string.h>
+#include "unity.h"
+#include "twi.h"
+#include <util/delay.h>
+
+// The TWI interrupt is a plain function on the host
+void TWI_vect(void);
+
+#define SLAVE_ADDRESS   0x40
+#define NO_NACK         0xFF
+
+// Simulated slave
+static uint8_t slave_present;
+static uint8_t slave_nack_after;
+static uint8_t slave_received[16];
+static uint8_t slave_received_count;
+static uint8_t slave_response[8];
+static uint8_t slave_response_index;
+static uint8_t slave_acks[8];
+
+// Simulated bus
+static uint8_t bus_active;
+static uint8_t bus_phase;
+static uint8_t bus_fault;
+static uint8_t bus_arbitration;
+static char conditions[16];
+static uint8_t conditions_count;
+
+static uint32_t fake_ms;
+static uint8_t callbacks;
+static twi_transaction* chained;
+
+uint32_t
+tick_get_ms(void)
+{
+    return fake_ms;
+}
+
+static void
+log_condition(char condition)
+{
+    conditions[conditions_count++] = condition;
+    conditions[conditions_count] = '\0';
+}
+
+// Executes the action requested through TWCR and the interrupt of its
+// status, as the TWI hardware. Returns 0 when no action is requested.
+static uint8_t
+twi_sequencer_step(void)
+{
+    uint8_t control = TWCR;
+    uint8_t data;
+
+    if ( !(control & _BV(TWINT)) )
+    {
+        return 0;
+    }
+    TWCR = control & ~_BV(TWINT);
+
+    if (control & _BV(TWSTO))
+    {
+        log_condition('P');
+        bus_active = 0;
+        TWCR &= ~_BV(TWSTO);
+        if ( !(control & _BV(TWSTA)) )
+        {
+            return 0;
+        }
+    }
+
+    if (bus_fault)
+    {
+        bus_fault = 0;
+        TWSR = 0x00;
+    }
+    else if (control & _BV(TWSTA))
+    {
+        log_condition(bus_active ? 'R' : 'S');
+        TWSR = bus_active ? 0x10 : 0x08;
+        bus_active = 1;
+        bus_phase = 1;
+    }
+    else if (bus_phase == 1)
+    {
+        data = TWDR;
+        if (bus_arbitration)
+        {
+            bus_arbitration = 0;
+            bus_active = 0;
+            TWSR = 0x38;
+        }
+        else if (data & 0x01)
+        {
+            bus_phase = 3;
+            TWSR = (slave_present && ((data >> 1) == SLAVE_ADDRESS)) ?
+                    0x40 : 0x48;
+        }
+        else
+        {
+            bus_phase = 2;
+            TWSR = (slave_present && ((data >> 1) == SLAVE_ADDRESS)) ?
+                    0x18 : 0x20;
+        }
+    }
+    else if (bus_phase == 2)
+    {
+        slave_received[slave_received_count++] = TWDR;
+        TWSR = (slave_received_count > slave_nack_after) ? 0x30 : 0x28;
+    }
+    else
+    {
+        slave_acks[slave_response_index] = (control & _BV(TWEA)) ? 1 : 0;
+        TWDR = slave_response[slave_response_index++];
+        TWSR = (control & _BV(TWEA)) ? 0x50 : 0x58;
+    }
+
+    // The status is only handled by the interrupt
+    TEST_ASSERT_BIT_HIGH(TWIE, control);
+    TWI_vect();
+
+    return 1;
+}
+
+static void
+run_twi(void)
+{
+    uint16_t guard = 0;
+
+    while (twi_sequencer_step() && (guard++ < 200))
+    {
+
+    }
+}
+
+static void
+count_callback(twi_transaction* transaction)
+{
+    TEST_ASSERT_TRUE(transaction->status != TWI_PENDING);
+    callbacks++;
+}
+
+static void
+chain_callback(twi_transaction* transaction)
+{
+    callbacks++;
+    if (chained != NULL)
+    {
+        twi_submit(chained);
+        chained = NULL;
+    }
+}
+
+static void
+set_transaction(twi_transaction* transaction, uint8_t address,
+                const uint8_t* tx, uint8_t tx_size, uint8_t* rx,
+                uint8_t rx_size)
+{
+    memset(transaction, 0, sizeof(*transaction));
+    transaction->address = address;
+    transaction->tx = tx;
+    transaction->tx_size = tx_size;
+    transaction->rx = rx;
+    transaction->rx_size = rx_size;
+    transaction->callback = count_callback;
+}
+
+void
+setUp(void)
+{
+    const uint8_t response[] = {0x66, 0x4C, 0x9E, 0x01};
+
+    memset((void *) avr_sim_io, 0, sizeof(avr_sim_io));
+    avr_sim_delay_us = 0;
+    fake_ms = 1000;
+    callbacks = 0;
+    chained = NULL;
+
+    slave_present = 1;
+    slave_nack_after = NO_NACK;
+    slave_received_count = 0;
+    slave_response_index = 0;
+    memcpy(slave_response, response, sizeof(response));
+    memset(slave_acks, 0xFF, sizeof(slave_acks));
+
+    bus_active = 0;
+    bus_phase = 0;
+    bus_fault = 0;
+    bus_arbitration = 0;
+    conditions_count = 0;
+    conditions[0] = '\0';
+
+    twi_init(TWI_CLOCK_STANDARD);
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_Twi_should_SetBitRateAndPullUps(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(72, TWBR);
+    TEST_ASSERT_EQUAL_UINT8(0, TWSR & 0x03);
+    TEST_ASSERT_EQUAL_HEX8(_BV(TWEN), TWCR);
+    TEST_ASSERT_BIT_HIGH(PC4, PORTC);
+    TEST_ASSERT_BIT_HIGH(PC5, PORTC);
+    TEST_ASSERT_BIT_LOW(PC4, DDRC);
+    TEST_ASSERT_BIT_LOW(PC5, DDRC);
+
+    twi_init(TWI_CLOCK_FAST);
+    TEST_ASSERT_EQUAL_UINT8(12, TWBR);
+
+    twi_init(10000);
+    TEST_ASSERT_EQUAL_UINT8(255, TWBR);
+}
+
+void
+test_Twi_should_WriteInBackground(void)
+{
+    const uint8_t tx[] = {0xFE, 0x12, 0x34};
+    twi_transaction write;
+
+    set_transaction(&write, SLAVE_ADDRESS, tx, sizeof(tx), NULL, 0);
+
+    // Only the start is requested, the rest is done by the interrupt
+    TEST_ASSERT_EQUAL(TWI_PENDING, twi_submit(&write));
+    TEST_ASSERT_EQUAL_HEX8(_BV(TWINT) | _BV(TWSTA) | _BV(TWEN) | _BV(TWIE),
+                           TWCR);
+    TEST_ASSERT_TRUE(twi_busy());
+
+    run_twi();
+
+    TEST_ASSERT_EQUAL(TWI_DONE, write.status);
+    TEST_ASSERT_EQUAL_UINT8(1, callbacks);
+    TEST_ASSERT_EQUAL_STRING("SP", conditions);
+    TEST_ASSERT_EQUAL_UINT8(sizeof(tx), slave_received_count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(tx, slave_received, sizeof(tx));
+    TEST_ASSERT_FALSE(twi_busy());
+}
+
+void
+test_Twi_should_ReadAndNackLastByte(void)
+{
+    uint8_t rx[3];
+    twi_transaction read;
+
+    set_transaction(&read, SLAVE_ADDRESS, NULL, 0, rx, sizeof(rx));
+    twi_submit(&read);
+    run_twi();
+
+    TEST_ASSERT_EQUAL(TWI_DONE, read.status);
+    TEST_ASSERT_EQUAL_STRING("SP", conditions);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(slave_response, rx, sizeof(rx));
+    TEST_ASSERT_EQUAL_UINT8(1, slave_acks[0]);
+    TEST_ASSERT_EQUAL_UINT8(1, slave_acks[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, slave_acks[2]);
+    TEST_ASSERT_EQUAL_UINT8(3, slave_response_index);
+}
+
+void
+test_Twi_should_WriteThenReadWithRepeatedStart(void)
+{
+    const uint8_t reg = 0xE3;
+    uint8_t rx[2];
+    twi_transaction read;
+
+    set_transaction(&read, SLAVE_ADDRESS, &reg, 1, rx, sizeof(rx));
+    twi_submit(&read);
+    run_twi();
+
+    TEST_ASSERT_EQUAL(TWI_DONE, read.status);
+    TEST_ASSERT_EQUAL_STRING("SRP", conditions);
+    TEST_ASSERT_EQUAL_UINT8(1, slave_received_count);
+    TEST_ASSERT_EQUAL_HEX8(0xE3, slave_received[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x66, rx[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x4C, rx[1]);
+}
+
+void
+test_Twi_should_ReportNack(void)
+{
+    const uint8_t tx[] = {0x01, 0x02, 0x03};
+    uint8_t rx[1];
+    twi_transaction missing;
+    twi_transaction write;
+
+    // Address not acknowledged
+    set_transaction(&missing, 0x21, NULL, 0, rx, sizeof(rx));
+    twi_submit(&missing);
+    run_twi();
+    TEST_ASSERT_EQUAL(TWI_NACK, missing.status);
+    TEST_ASSERT_EQUAL_STRING("SP", conditions);
+
+    // Data not acknowledged after the second byte
+    slave_nack_after = 1;
+    set_transaction(&write, SLAVE_ADDRESS, tx, sizeof(tx), NULL, 0);
+    twi_submit(&write);
+    run_twi();
+    TEST_ASSERT_EQUAL(TWI_NACK, write.status);
+    TEST_ASSERT_EQUAL_UINT8(2, slave_received_count);
+    TEST_ASSERT_EQUAL_STRING("SPSP", conditions);
+    TEST_ASSERT_EQUAL_UINT8(2, callbacks);
+    TEST_ASSERT_FALSE(twi_busy());
+}
+
+void
+test_Twi_should_RunQueuedTransactionsInOrder(void)
+{
+    const uint8_t tx_a[] = {0xAA};
+    const uint8_t tx_b[] = {0xBB, 0xCC};
+    uint8_t rx[2];
+    twi_transaction first;
+    twi_transaction second;
+    twi_transaction third;
+
+    set_transaction(&first, SLAVE_ADDRESS, tx_a, sizeof(tx_a), NULL, 0);
+    set_transaction(&second, SLAVE_ADDRESS, tx_b, sizeof(tx_b), NULL, 0);
+    set_transaction(&third, SLAVE_ADDRESS, NULL, 0, rx, sizeof(rx));
+
+    TEST_ASSERT_EQUAL(TWI_PENDING, twi_submit(&first));
+    TEST_ASSERT_EQUAL(TWI_PENDING, twi_submit(&second));
+    TEST_ASSERT_EQUAL(TWI_PENDING, twi_submit(&third));
+    TEST_ASSERT_EQUAL(TWI_BUSY, twi_submit(&second));
+
+    run_twi();
+
+    TEST_ASSERT_EQUAL_UINT8(3, callbacks);
+    TEST_ASSERT_EQUAL_STRING("SPSPSP", conditions);
+    TEST_ASSERT_EQUAL_UINT8(3, slave_received_count);
+    TEST_ASSERT_EQUAL_HEX8(0xAA, slave_received[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xBB, slave_received[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xCC, slave_received[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x66, rx[0]);
+    TEST_ASSERT_EQUAL(TWI_DONE, third.status);
+}
+
+void
+test_Twi_should_RecoverFromBusError(void)
+{
+    const uint8_t tx[] = {0x55};
+    twi_transaction first;
+    twi_transaction second;
+
+    set_transaction(&first, SLAVE_ADDRESS, tx, sizeof(tx), NULL, 0);
+    set_transaction(&second, SLAVE_ADDRESS, tx, sizeof(tx), NULL, 0);
+    twi_submit(&first);
+    twi_submit(&second);
+
+    bus_fault = 1;
+    run_twi();
+
+    TEST_ASSERT_EQUAL(TWI_BUS_ERROR, first.status);
+    TEST_ASSERT_EQUAL(TWI_DONE, second.status);
+    TEST_ASSERT_EQUAL_UINT8(1, slave_received_count);
+    TEST_ASSERT_FALSE(twi_busy());
+}
+
+void
+test_Twi_should_RestartAfterArbitrationLost(void)
+{
+    const uint8_t tx[] = {0x10, 0x20};
+    twi_transaction write;
+
+    set_transaction(&write, SLAVE_ADDRESS, tx, sizeof(tx), NULL, 0);
+    twi_submit(&write);
+
+    bus_arbitration = 1;
+    run_twi();
+
+    TEST_ASSERT_EQUAL(TWI_DONE, write.status);
+    TEST_ASSERT_EQUAL_STRING("SSP", conditions);
+    TEST_ASSERT_EQUAL_UINT8(2, slave_received_count);
+}
+
+void
+test_Twi_should_TimeoutAndRecoverBus(void)
+{
+    const uint8_t tx[] = {0x01};
+    twi_transaction stuck;
+    twi_transaction next;
+
+    set_transaction(&stuck, SLAVE_ADDRESS, tx, sizeof(tx), NULL, 0);
+    set_transaction(&next, SLAVE_ADDRESS, tx, sizeof(tx), NULL, 0);
+    twi_submit(&stuck);
+    twi_submit(&next);
+
+    // The slave holds the bus, no interrupt is executed
+    avr_sim_delay_us = 0;
+    fake_ms += TWI_TIMEOUT_MS - 1;
+    twi_poll();
+    TEST_ASSERT_EQUAL(TWI_PENDING, stuck.status);
+    TEST_ASSERT_EQUAL_UINT32(0, avr_sim_delay_us);
+
+    fake_ms += 1;
+    twi_poll();
+    TEST_ASSERT_EQUAL(TWI_TIMEOUT, stuck.status);
+    TEST_ASSERT_EQUAL_UINT8(1, callbacks);
+
+    // SDA reads low on the host, so all the recovery clocks are sent
+    TEST_ASSERT_EQUAL_UINT32(9 * 10 + 10, avr_sim_delay_us);
+    TEST_ASSERT_BIT_LOW(PC4, DDRC);
+    TEST_ASSERT_BIT_LOW(PC5, DDRC);
+
+    // The next transaction is started on the recovered bus
+    TEST_ASSERT_BIT_HIGH(TWSTA, TWCR);
+    bus_active = 0;
+    run_twi();
+    TEST_ASSERT_EQUAL(TWI_DONE, next.status);
+    TEST_ASSERT_FALSE(twi_busy());
+
+    // The timeout is counted from the last bus activity
+    twi_submit(&stuck);
+    fake_ms += TWI_TIMEOUT_MS;
+    twi_sequencer_step();
+    twi_poll();
+    TEST_ASSERT_EQUAL(TWI_PENDING, stuck.status);
+}
+
+void
+test_Twi_should_AllowSubmittingFromCallback(void)
+{
+    const uint8_t tx[] = {0xA1, 0xB2};
+    twi_transaction first;
+    twi_transaction second;
+    twi_transaction empty;
+
+    set_transaction(&first, SLAVE_ADDRESS, tx, 1, NULL, 0);
+    first.callback = chain_callback;
+    set_transaction(&second, SLAVE_ADDRESS, &tx[1], 1, NULL, 0);
+    chained = &second;
+
+    twi_submit(&first);
+    run_twi();
+
+    TEST_ASSERT_EQUAL_UINT8(2, callbacks);
+    TEST_ASSERT_EQUAL(TWI_DONE, second.status);
+    TEST_ASSERT_EQUAL_STRING("SPSP", conditions);
+    TEST_ASSERT_EQUAL_HEX8(0xB2, slave_received[1]);
+
+    // A transaction without bytes is completed at once
+    set_transaction(&empty, SLAVE_ADDRESS, NULL, 0, NULL, 0);
+    TEST_ASSERT_EQUAL(TWI_DONE, twi_submit(&empty));
+    TEST_ASSERT_EQUAL_UINT8(3, callbacks);
+    TEST_ASSERT_FALSE(twi_busy());
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Twi_should_SetBitRateAndPullUps);
+    RUN_TEST(test_Twi_should_WriteInBackground);
+    RUN_TEST(test_Twi_should_ReadAndNackLastByte);
+    RUN_TEST(test_Twi_should_WriteThenReadWithRepeatedStart);
+    RUN_TEST(test_Twi_should_ReportNack);
+    RUN_TEST(test_Twi_should_RunQueuedTransactionsInOrder);
+    RUN_TEST(test_Twi_should_RecoverFromBusError);
+    RUN_TEST(test_Twi_should_RestartAfterArbitrationLost);
+    RUN_TEST(test_Twi_should_TimeoutAndRecoverBus);
+    RUN_TEST(test_Twi_should_AllowSubmittingFromCallback);
+
+    return UNITY_END();
+}
@@ -0,0 +1,440 @@
+#include "unity.h"
+#include "uart.h"
+
+// The UART RX interrupt is a plain function on the host
+void USART_RX_vect(void);
+
+// Virtual time advanced by every call to tick_get_ms, the drivers poll the
+// UART once between two calls
+#define POLL_PERIOD_US  100UL
+// Time to receive a character at 9600 bauds
+#define CHAR_TIME_US    1042UL
+
+// Baud rate settings of the ATmega328P datasheet examples
+typedef struct
+{
+    uint32_t f_cpu;
+    uint32_t baud;
+    uint16_t ubrr;
+    uint8_t u2x;
+    int16_t error;
+} baud_example;
+
+static const baud_example baud_examples[] =
+{
+    { 1000000UL,    9600UL, 12, 1,   2},
+    { 1000000UL,  115200UL,  0, 1,  85},
+    { 8000000UL,    9600UL, 51, 0,   2},
+    { 8000000UL,   38400UL, 12, 0,   2},
+    { 8000000UL,  115200UL,  8, 1, -35},
+    { 8000000UL, 1000000UL,  0, 1,   0},
+    {11059200UL,  115200UL,  5, 0,   0},
+    {11059200UL,  230400UL,  2, 0,   0},
+    {16000000UL,    9600UL,103, 0,   2},
+    {16000000UL,   57600UL, 34, 1,  -8},
+    {16000000UL,  115200UL, 16, 1,  21},
+    {16000000UL,  250000UL,  3, 0,   0},
+    {16000000UL,  500000UL,  1, 0,   0},
+    {16000000UL, 1000000UL,  0, 0,   0},
+    {18432000UL,  115200UL,  9, 0,   0},
+    {18432000UL,  230400UL,  4, 0,   0},
+    {20000000UL,  115200UL, 10, 0, -14},
+    {20000000UL,  250000UL,  4, 0,   0},
+    {20000000UL,  500000UL,  4, 1,   0},
+};
+
+// Baud rates of 115200 bauds and above within the tolerance of each clock
+typedef struct
+{
+    uint32_t f_cpu;
+    uint32_t bauds[4];
+} fast_bauds;
+
+static const fast_bauds fast_examples[] =
+{
+    { 8000000UL, { 250000UL,  500000UL, 1000000UL,       0}},
+    {11059200UL, { 115200UL,  230400UL,  460800UL,       0}},
+    {14745600UL, { 115200UL,  230400UL,  460800UL,  921600UL}},
+    {16000000UL, { 115200UL,  250000UL,  500000UL, 1000000UL}},
+    {18432000UL, { 115200UL,  230400UL,  460800UL,       0}},
+    {20000000UL, { 115200UL,  250000UL,  500000UL,       0}},
+};
+
+static uint32_t now_us;
+static uint32_t cancel_at_us;
+
+static const uint8_t* rx_bytes;
+static uint8_t rx_count;
+static uint8_t rx_index;
+static uint32_t rx_start_us;
+static uint32_t rx_gap_us;
+
+// Schedules the reception of a string, one character every gap
+static void
+schedule_rx(const void* bytes, uint8_t count, uint32_t start_us,
+            uint32_t gap_us)
+{
+    rx_bytes = (const uint8_t *) bytes;
+    rx_count = count;
+    rx_index = 0;
+    rx_start_us = start_us;
+    rx_gap_us = gap_us;
+}
+
+// Delivers the characters received until now, through the RX interrupt when
+// it is enabled or through the UDR0 and RXC0 registers otherwise
+static void
+deliver_rx(void)
+{
+    UCSR0A &= ~_BV(RXC0);
+
+    while ( (rx_index < rx_count) &&
+            (rx_start_us + rx_index * rx_gap_us <= now_us) )
+    {
+        UDR0 = rx_bytes[rx_index++];
+
+        if (UCSR0B & _BV(RXCIE0))
+        {
+            USART_RX_vect();
+        }
+        else
+        {
+            UCSR0A |= _BV(RXC0);
+            break;
+        }
+    }
+}
+
+uint32_t
+tick_get_ms(void)
+{
+    now_us += POLL_PERIOD_US;
+
+    if ( (cancel_at_us != 0) && (now_us >= cancel_at_us) )
+    {
+        cancel_at_us = 0;
+        uart_cancel_read();
+    }
+
+    deliver_rx();
+
+    return now_us / 1000UL;
+}
+
+void
+setUp(void)
+{
+    memset((void *) avr_sim_io, 0, sizeof(avr_sim_io));
+    now_us = 0;
+    cancel_at_us = 0;
+    schedule_rx("", 0, 0, 0);
+    uart_flush();
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_Uart_should_ReadUntilDelimiter(void)
+{
+    char str[20];
+    uint8_t count = 0xFF;
+
+    schedule_rx("ABC\n", 4, 2000, CHAR_TIME_US);
+
+    TEST_ASSERT_EQUAL(UART_OK, uart_read_until(str, sizeof(str), '\n', 100,
+                                               &count));
+    TEST_ASSERT_EQUAL_UINT8(3, count);
+    TEST_ASSERT_EQUAL_STRING("ABC", str);
+    // Returns as soon as the delimiter is received
+    TEST_ASSERT_UINT_WITHIN(POLL_PERIOD_US, 2000 + 3 * CHAR_TIME_US, now_us);
+}
+
+void
+test_Uart_should_TimeoutWhenNothingIsReceived(void)
+{
+    char str[20];
+    uint8_t count = 0xFF;
+
+    TEST_ASSERT_EQUAL(UART_TIMEOUT, uart_read_until(str, sizeof(str), '\n',
+                                                    250, &count));
+    TEST_ASSERT_EQUAL_UINT8(0, count);
+    TEST_ASSERT_EQUAL_STRING("", str);
+    TEST_ASSERT_UINT_WITHIN(1000, 250000, now_us);
+}
+
+void
+test_Uart_should_ReturnPartialLineOnTimeout(void)
+{
+    char str[20];
+    uint8_t count = 0;
+
+    schedule_rx("12345", 5, 0, CHAR_TIME_US);
+
+    TEST_ASSERT_EQUAL(UART_TIMEOUT, uart_read_until(str, sizeof(str), '\n',
+                                                    20, &count));
+    TEST_ASSERT_EQUAL_UINT8(5, count);
+    TEST_ASSERT_EQUAL_STRING("12345", str);
+}
+
+void
+test_Uart_should_StopWhenStringIsFull(void)
+{
+    char str[4];
+    uint8_t count = 0;
+
+    schedule_rx("ABCDEF\n", 7, 0, CHAR_TIME_US);
+
+    TEST_ASSERT_EQUAL(UART_BUFFER_FULL, uart_read_until(str, sizeof(str), '\n',
+                                                        100, &count));
+    TEST_ASSERT_EQUAL_UINT8(3, count);
+    TEST_ASSERT_EQUAL_STRING("ABC", str);
+}
+
+void
+test_Uart_should_ReadExactBinaryBytes(void)
+{
+    const uint8_t frame[] = {0x00, '\n', 0xFF, 0x10};
+    uint8_t data[4];
+    uint8_t count = 0;
+
+    schedule_rx(frame, sizeof(frame), 500, CHAR_TIME_US);
+
+    TEST_ASSERT_EQUAL(UART_OK, uart_read_exact(data, sizeof(data), 100,
+                                               &count));
+    TEST_ASSERT_EQUAL_UINT8(4, count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, data, sizeof(frame));
+}
+
+void
+test_Uart_should_TimeoutReadingExactBytes(void)
+{
+    const uint8_t frame[] = {0x01, 0x02};
+    uint8_t data[4];
+    uint8_t count = 0;
+
+    schedule_rx(frame, sizeof(frame), 0, CHAR_TIME_US);
+
+    TEST_ASSERT_EQUAL(UART_TIMEOUT, uart_read_exact(data, sizeof(data), 10,
+                                                    &count));
+    TEST_ASSERT_EQUAL_UINT8(2, count);
+    TEST_ASSERT_UINT_WITHIN(1000, 10000, now_us);
+}
+
+void
+test_Uart_should_ReadFromBufferWhenRxInterruptIsEnabled(void)
+{
+    char str[20];
+    uint8_t count = 0;
+
+    uart_enable_rx_isr();
+
+    // The characters received before the read are kept in the buffer
+    schedule_rx("OK\n", 3, 0, CHAR_TIME_US);
+    now_us = 5000;
+    deliver_rx();
+    TEST_ASSERT_EQUAL_UINT8(3, uart_available());
+
+    TEST_ASSERT_EQUAL(UART_OK, uart_read_until(str, sizeof(str), '\n', 100,
+                                               &count));
+    TEST_ASSERT_EQUAL_STRING("OK", str);
+    TEST_ASSERT_EQUAL_UINT8(0, uart_available());
+
+    // And the timeout also applies
+    TEST_ASSERT_EQUAL(UART_TIMEOUT, uart_read_until(str, sizeof(str), '\n', 50,
+                                                    &count));
+    TEST_ASSERT_EQUAL_UINT8(0, count);
+}
+
+void
+test_Uart_should_DropCharactersWhenBufferIsFull(void)
+{
+    uint8_t burst[UART_RX_BUFFER_SIZE + 4];
+    uint8_t data[UART_RX_BUFFER_SIZE];
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < sizeof(burst); i++)
+    {
+        burst[i] = i;
+    }
+
+    uart_enable_rx_isr();
+    schedule_rx(burst, sizeof(burst), 0, CHAR_TIME_US);
+    now_us = sizeof(burst) * CHAR_TIME_US;
+    deliver_rx();
+
+    TEST_ASSERT_EQUAL_UINT8(UART_RX_BUFFER_SIZE - 1, uart_available());
+    TEST_ASSERT_EQUAL(UART_TIMEOUT, uart_read_exact(data, sizeof(data), 5,
+                                                    &count));
+    TEST_ASSERT_EQUAL_UINT8(UART_RX_BUFFER_SIZE - 1, count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(burst, data, count);
+}
+
+void
+test_Uart_should_CancelRead(void)
+{
+    char str[20];
+    uint8_t count = 0;
+
+    cancel_at_us = 30000;
+
+    TEST_ASSERT_EQUAL(UART_CANCELLED, uart_read_until(str, sizeof(str), '\n',
+                                                      60000, &count));
+    TEST_ASSERT_EQUAL_UINT8(0, count);
+    TEST_ASSERT_UINT_WITHIN(POLL_PERIOD_US, 30000, now_us);
+}
+
+void
+test_Uart_should_CancelReadRequestedBeforeItStarts(void)
+{
+    char str[20];
+    uint8_t count = 0;
+
+    // Issued by an interrupt right before the read
+    uart_cancel_read();
+
+    TEST_ASSERT_EQUAL(UART_CANCELLED, uart_read_until(str, sizeof(str), '\n',
+                                                      60000, &count));
+    TEST_ASSERT_EQUAL_UINT8(0, count);
+    TEST_ASSERT_TRUE(now_us < POLL_PERIOD_US * 2);
+
+    // Consumed by that read
+    TEST_ASSERT_EQUAL(UART_TIMEOUT, uart_read_until(str, sizeof(str), '\n',
+                                                    10, &count));
+}
+
+void
+test_Uart_should_ComputeUbrrForEachClock(void)
+{
+    const baud_example* example;
+    uint16_t setting;
+    int16_t error;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(baud_examples) / sizeof(baud_examples[0]); i++)
+    {
+        example = &baud_examples[i];
+        error = 0x7FFF;
+        setting = uart_baud_setting(example->f_cpu, example->baud, &error);
+
+        TEST_ASSERT_EQUAL_UINT16(example->ubrr, setting & 0x0FFF);
+        TEST_ASSERT_EQUAL_UINT8(example->u2x, (setting & UART_UBRR_U2X) != 0);
+        TEST_ASSERT_INT_WITHIN(1, example->error, error);
+    }
+}
+
+void
+test_Uart_should_SupportFastBaudRates(void)
+{
+    const fast_bauds* example;
+    uint16_t setting;
+    int16_t error;
+    uint8_t i;
+    uint8_t j;
+
+    for (i = 0; i < sizeof(fast_examples) / sizeof(fast_examples[0]); i++)
+    {
+        example = &fast_examples[i];
+        for (j = 0; (j < 4) && (example->bauds[j] != 0); j++)
+        {
+            setting = uart_baud_setting(example->f_cpu, example->bauds[j],
+                                        &error);
+
+            TEST_ASSERT_TRUE(setting != UART_UBRR_INVALID);
+            TEST_ASSERT_INT_WITHIN(UART_BAUD_TOLERANCE, 0, error);
+        }
+    }
+}
+
+void
+test_Uart_should_RejectBaudRatesOutOfRange(void)
+{
+    int16_t error = 0x1234;
+
+    TEST_ASSERT_EQUAL_HEX16(UART_UBRR_INVALID,
+                            uart_baud_setting(16000000UL, 0, &error));
+    TEST_ASSERT_EQUAL_HEX16(UART_UBRR_INVALID,
+                            uart_baud_setting(16000000UL, 200UL, &error));
+    TEST_ASSERT_EQUAL_HEX16(UART_UBRR_INVALID,
+                            uart_baud_setting(16000000UL, 5000000UL, &error));
+    TEST_ASSERT_EQUAL_INT16(0x1234, error);
+    // Only the normal mode reaches 300 bauds with a 16 MHz clock
+    TEST_ASSERT_EQUAL_HEX16(3332, uart_baud_setting(16000000UL, 300UL, NULL));
+}
+
+void
+test_Uart_should_ConfigureRegistersFromTable(void)
+{
+    static const uint32_t bauds[] = {2400UL, 4800UL, 9600UL, 19200UL,
+                                     38400UL, 57600UL, 115200UL, 230400UL,
+                                     250000UL, 500000UL, 1000000UL};
+    uint16_t setting;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(bauds) / sizeof(bauds[0]); i++)
+    {
+        setting = uart_baud_setting((uint32_t) F_CPU, bauds[i], NULL);
+
+        uart_init_config(bauds[i], UART_FRAME_8N1);
+
+        TEST_ASSERT_EQUAL_UINT8((setting & 0x0FFF) >> 8, UBRR0H);
+        TEST_ASSERT_EQUAL_UINT8(setting & 0xFF, UBRR0L);
+        TEST_ASSERT_EQUAL_UINT8((setting & UART_UBRR_U2X) != 0,
+                                (UCSR0A & _BV(U2X0)) != 0);
+    }
+}
+
+void
+test_Uart_should_ConfigureFrameAndReportBaudError(void)
+{
+    // 31250 bauds (MIDI) is not in the table and is exact at 16 MHz
+    TEST_ASSERT_EQUAL(UART_OK, uart_init_config(31250UL, UART_FRAME_8E1));
+    TEST_ASSERT_EQUAL_UINT8(31, UBRR0L);
+    TEST_ASSERT_EQUAL_HEX8(_BV(UPM01) | _BV(UCSZ01) | _BV(UCSZ00), UCSR0C);
+    TEST_ASSERT_BITS_HIGH(_BV(RXEN0) | _BV(TXEN0), UCSR0B);
+
+    // 230400 bauds is 3.5 % slow at 16 MHz but still configured
+    TEST_ASSERT_EQUAL(UART_BAUD_ERROR, uart_init_config(230400UL,
+                                                        UART_FRAME_8N2));
+    TEST_ASSERT_EQUAL_UINT8(8, UBRR0L);
+    TEST_ASSERT_BITS_HIGH(_BV(U2X0), UCSR0A);
+    TEST_ASSERT_EQUAL_HEX8(_BV(USBS0) | _BV(UCSZ01) | _BV(UCSZ00), UCSR0C);
+
+    // A baud rate out of range leaves the UART unchanged
+    TEST_ASSERT_EQUAL(UART_BAUD_ERROR, uart_init_config(5000000UL,
+                                                        UART_FRAME_8N1));
+    TEST_ASSERT_EQUAL_UINT8(8, UBRR0L);
+
+    // The default configuration keeps 9600 bauds in normal mode
+    uart_init();
+    TEST_ASSERT_EQUAL_UINT8(0, UBRR0H);
+    TEST_ASSERT_EQUAL_UINT8(103, UBRR0L);
+    TEST_ASSERT_BITS_LOW(_BV(U2X0), UCSR0A);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_Uart_should_ReadUntilDelimiter);
+    RUN_TEST(test_Uart_should_TimeoutWhenNothingIsReceived);
+    RUN_TEST(test_Uart_should_ReturnPartialLineOnTimeout);
+    RUN_TEST(test_Uart_should_StopWhenStringIsFull);
+    RUN_TEST(test_Uart_should_ReadExactBinaryBytes);
+    RUN_TEST(test_Uart_should_TimeoutReadingExactBytes);
+    RUN_TEST(test_Uart_should_ReadFromBufferWhenRxInterruptIsEnabled);
+    RUN_TEST(test_Uart_should_DropCharactersWhenBufferIsFull);
+    RUN_TEST(test_Uart_should_CancelRead);
+    RUN_TEST(test_Uart_should_CancelReadRequestedBeforeItStarts);
+    RUN_TEST(test_Uart_should_ComputeUbrrForEachClock);
+    RUN_TEST(test_Uart_should_SupportFastBaudRates);
+    RUN_TEST(test_Uart_should_RejectBaudRatesOutOfRange);
+    RUN_TEST(test_Uart_should_ConfigureRegistersFromTable);
+    RUN_TEST(test_Uart_should_ConfigureFrameAndReportBaudError);
+
+    return UNITY_END();
+}
@@ -0,0 +1,288 @@
+#include <string.h>
+#include "unity.h"
+#include "wdt_scheduler.h"
+#include "avr_sim.h"
+
+void WDT_vect(void);
+
+// Real time and crystal time, which is stopped while sleeping
+static uint32_t real_us;
+static uint32_t crystal_us;
+// Length of the watchdog periods relative to the nominal ones, in percent
+static uint32_t drift;
+// Real time of the start of the watchdog period
+static uint32_t wdt_start;
+// Prescalers slept and runs of the jobs
+static uint8_t slept[16];
+static uint8_t slept_count;
+static uint32_t runs[64];
+static uint8_t run_count;
+static uint32_t job_awake_us;
+
+static uint8_t
+prescaler(void)
+{
+    return (WDTCSR & 0x07) | ((WDTCSR & _BV(WDP3)) ? 0x08 : 0x00);
+}
+
+static uint32_t
+wdt_period(void)
+{
+    return ((WDT_SCHEDULER_BASE_US << prescaler()) / 100UL) * drift;
+}
+
+static uint32_t
+wdt_due(void)
+{
+    return wdt_start + wdt_period();
+}
+
+static void
+set_crystal(void)
+{
+    TCNT0 = (uint8_t) ((crystal_us % 1000UL) / 4UL);
+}
+
+uint32_t
+tick_get_ms(void)
+{
+    return crystal_us / 1000UL;
+}
+
+void
+wdt_reset(void)
+{
+    wdt_start = real_us;
+}
+
+// Power-down until the watchdog interrupt
+void
+sleep_cpu(void)
+{
+    if (slept_count < sizeof(slept))
+    {
+        slept[slept_count++] = prescaler();
+    }
+    real_us = wdt_due();
+    wdt_start = real_us;
+    WDT_vect();
+}
+
+// CPU awake, the watchdog interrupts are measured against the crystal
+static void
+awake(uint32_t us)
+{
+    uint32_t end = real_us + us;
+
+    while ((int32_t) (end - wdt_due()) >= 0)
+    {
+        crystal_us += wdt_due() - real_us;
+        real_us = wdt_due();
+        wdt_start = real_us;
+        set_crystal();
+        WDT_vect();
+    }
+    crystal_us += end - real_us;
+    real_us = end;
+    set_crystal();
+}
+
+static void
+job(void)
+{
+    runs[run_count++] = real_us;
+    awake(job_awake_us);
+}
+
+static void
+other_job(void)
+{
+
+}
+
+void
+setUp(void)
+{
+    memset((void *) avr_sim_io, 0, sizeof(avr_sim_io));
+    real_us = 0;
+    crystal_us = 0;
+    drift = 100;
+    slept_count = 0;
+    run_count = 0;
+    job_awake_us = 0;
+    MCUSR = _BV(WDRF);
+    wdt_scheduler_init();
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_WdtScheduler_should_StartWatchdogInInterruptMode(void)
+{
+    TEST_ASSERT_EQUAL_HEX8(_BV(WDIE) | _BV(WDP1) | _BV(WDP0), WDTCSR);
+    TEST_ASSERT_BITS_LOW(_BV(WDRF), MCUSR);
+    TEST_ASSERT_EQUAL_UINT32(WDT_SCHEDULER_SCALE_ONE, wdt_scheduler_scale());
+    TEST_ASSERT_EQUAL_UINT32(16000, wdt_scheduler_period_us(0));
+    TEST_ASSERT_EQUAL_UINT32(8192000, wdt_scheduler_period_us(9));
+    TEST_ASSERT_EQUAL_UINT32(0, wdt_scheduler_time_ms());
+}
+
+void
+test_WdtScheduler_should_RejectJobsWhenFull(void)
+{
+    uint8_t i;
+
+    TEST_ASSERT_EQUAL_INT8(-1, wdt_scheduler_every(10, NULL));
+    TEST_ASSERT_EQUAL_INT8(-1, wdt_scheduler_every(0, job));
+
+    for (i = 0; i < WDT_SCHEDULER_JOBS; i++)
+    {
+        TEST_ASSERT_EQUAL_INT8(i, wdt_scheduler_every(10, job));
+    }
+    TEST_ASSERT_EQUAL_INT8(-1, wdt_scheduler_every(10, job));
+
+    wdt_scheduler_cancel(1);
+    TEST_ASSERT_EQUAL_INT8(1, wdt_scheduler_every(10, job));
+}
+
+void
+test_WdtScheduler_should_ChainPeriodsUpToTheNextJob(void)
+{
+    wdt_scheduler_every(10, job);
+
+    wdt_scheduler_run();
+
+    // 8192 + 1024 + 512 + 256 + 16 ms
+    TEST_ASSERT_EQUAL_UINT8(5, slept_count);
+    TEST_ASSERT_EQUAL_UINT8(9, slept[0]);
+    TEST_ASSERT_EQUAL_UINT8(6, slept[1]);
+    TEST_ASSERT_EQUAL_UINT8(5, slept[2]);
+    TEST_ASSERT_EQUAL_UINT8(4, slept[3]);
+    TEST_ASSERT_EQUAL_UINT8(0, slept[4]);
+    TEST_ASSERT_EQUAL_UINT32(10000, wdt_scheduler_time_ms());
+    TEST_ASSERT_BITS_HIGH(_BV(SM1), SMCR);
+    TEST_ASSERT_BITS_LOW(_BV(SE), SMCR);
+    TEST_ASSERT_EQUAL_UINT8(0, run_count);
+
+    // Back to the awake period, the job runs on the next call
+    TEST_ASSERT_EQUAL_UINT8(WDT_SCHEDULER_AWAKE_PRESCALER, prescaler());
+    slept_count = 0;
+    wdt_scheduler_run();
+    TEST_ASSERT_EQUAL_UINT8(1, run_count);
+    TEST_ASSERT_EQUAL_UINT32(10000000UL, runs[0]);
+}
+
+void
+test_WdtScheduler_should_RunJobsOnTheirPeriods(void)
+{
+    uint8_t i;
+
+    wdt_scheduler_every(60, job);
+    wdt_scheduler_every(300, other_job);
+
+    while (real_us <= 3600000000UL)
+    {
+        wdt_scheduler_run();
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(60, run_count);
+    for (i = 0; i < run_count; i++)
+    {
+        TEST_ASSERT_UINT_WITHIN(16000, (i + 1) * 60000000UL, runs[i]);
+    }
+}
+
+void
+test_WdtScheduler_should_CountTheTimeAwake(void)
+{
+    job_awake_us = 5000000UL;
+    wdt_scheduler_every(30, job);
+
+    while (run_count < 4)
+    {
+        wdt_scheduler_run();
+    }
+
+    // Every 30 s, not 30 s plus the 5 s of the job
+    TEST_ASSERT_UINT_WITHIN(16000, 30000000UL, runs[0]);
+    TEST_ASSERT_UINT_WITHIN(16000, 120000000UL, runs[3]);
+}
+
+void
+test_WdtScheduler_should_CorrectSlowWatchdogWhileAwake(void)
+{
+    // Watchdog 10% slow, the first sleep is 10% long
+    drift = 110;
+    job_awake_us = 2000000UL;
+    wdt_scheduler_every(60, job);
+
+    while (run_count < 4)
+    {
+        wdt_scheduler_run();
+    }
+
+    TEST_ASSERT_UINT_WITHIN(100000, 66000000UL, runs[0]);
+    TEST_ASSERT_UINT_WITHIN(WDT_SCHEDULER_SCALE_ONE / 200,
+                            (WDT_SCHEDULER_SCALE_ONE * 110) / 100,
+                            wdt_scheduler_scale());
+
+    // Calibrated by the time awake of the first run
+    TEST_ASSERT_UINT_WITHIN(300000, 60000000UL, runs[2] - runs[1]);
+    TEST_ASSERT_UINT_WITHIN(300000, 60000000UL, runs[3] - runs[2]);
+}
+
+void
+test_WdtScheduler_should_CorrectFastWatchdogWhileAwake(void)
+{
+    drift = 92;
+    job_awake_us = 1000000UL;
+    wdt_scheduler_every(120, job);
+
+    while (run_count < 3)
+    {
+        wdt_scheduler_run();
+    }
+
+    TEST_ASSERT_UINT_WITHIN(WDT_SCHEDULER_SCALE_ONE / 200,
+                            (WDT_SCHEDULER_SCALE_ONE * 92) / 100,
+                            wdt_scheduler_scale());
+    TEST_ASSERT_UINT_WITHIN(600000, 120000000UL, runs[2] - runs[1]);
+}
+
+void
+test_WdtScheduler_should_SkipRunsMissedByLongJob(void)
+{
+    job_awake_us = 25000000UL;
+    wdt_scheduler_every(10, job);
+
+    while (run_count < 3)
+    {
+        wdt_scheduler_run();
+    }
+
+    // The runs at 20 s and 30 s are done once at 35 s, when the job returns
+    TEST_ASSERT_UINT_WITHIN(16000, 10000000UL, runs[0]);
+    TEST_ASSERT_UINT_WITHIN(16000, 35000000UL, runs[1]);
+    TEST_ASSERT_UINT_WITHIN(16000, 60000000UL, runs[2]);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_WdtScheduler_should_StartWatchdogInInterruptMode);
+    RUN_TEST(test_WdtScheduler_should_RejectJobsWhenFull);
+    RUN_TEST(test_WdtScheduler_should_ChainPeriodsUpToTheNextJob);
+    RUN_TEST(test_WdtScheduler_should_RunJobsOnTheirPeriods);
+    RUN_TEST(test_WdtScheduler_should_CountTheTimeAwake);
+    RUN_TEST(test_WdtScheduler_should_CorrectSlowWatchdogWhileAwake);
+    RUN_TEST(test_WdtScheduler_should_CorrectFastWatchdogWhileAwake);
+    RUN_TEST(test_WdtScheduler_should_SkipRunsMissedByLongJob);
+
+    return UNITY_END();
+}
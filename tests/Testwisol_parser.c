@@ -0,0 +1,326 @@
+#include "unity.h"
+#include "wisol_parser.h"
+#include <stdio.h>
+#include <time.h>
+
+static wisol_token token;
+
+// Deterministic pseudo random generator for the fuzz tests
+static uint32_t seed;
+
+static uint8_t
+random_byte(void)
+{
+    seed = seed * 1103515245UL + 12345UL;
+    return (uint8_t) (seed >> 16);
+}
+
+// Feeds a string and returns the type of the last completed line
+static wisol_token_type
+feed_string(const char* str)
+{
+    wisol_token_type type = WISOL_TOKEN_NONE;
+    wisol_token_type last = WISOL_TOKEN_NONE;
+
+    while (*str != '\0')
+    {
+        type = wisol_parser_feed((uint8_t) *str++, &token);
+        if (type != WISOL_TOKEN_NONE)
+        {
+            last = type;
+        }
+    }
+
+    return last;
+}
+
+void
+setUp(void)
+{
+    wisol_parser_init();
+    memset(&token, 0, sizeof(token));
+}
+
+void
+tearDown(void)
+{
+
+}
+
+void
+test_WisolParser_should_RecognizeOk(void)
+{
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_NONE, wisol_parser_feed('O', &token));
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_NONE, wisol_parser_feed('K', &token));
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_NONE, wisol_parser_feed('\r', &token));
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_OK, wisol_parser_feed('\n', &token));
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_OK, token.type);
+    TEST_ASSERT_EQUAL_UINT8(2, token.size);
+}
+
+void
+test_WisolParser_should_RecognizeErrors(void)
+{
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_ERROR, feed_string("ERROR\r\n"));
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_ERROR,
+                      feed_string("ERR_SFX_ERR_SEND_FRAME_WAIT_TIMEOUT\r\n"));
+    TEST_ASSERT_EQUAL_STRING_LEN("ERR_SFX", (const char *) token.data, 7);
+}
+
+void
+test_WisolParser_should_DecodeIdInPlace(void)
+{
+    const uint8_t id[] = {0x00, 0x45, 0xA3, 0xF2};
+
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX, feed_string("0045a3F2\r\n"));
+    TEST_ASSERT_EQUAL_UINT8(sizeof(id), token.size);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(id, token.data, sizeof(id));
+}
+
+void
+test_WisolParser_should_DecodePac(void)
+{
+    const uint8_t pac[] = {0x1A, 0x2B, 0x3C, 0x4D, 0x5E, 0x6F, 0x7A, 0x8B};
+
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX, feed_string("1A2B3C4D5E6F7A8B\r\n"));
+    TEST_ASSERT_EQUAL_UINT8(sizeof(pac), token.size);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pac, token.data, sizeof(pac));
+}
+
+void
+test_WisolParser_should_DecodeDownlink(void)
+{
+    const uint8_t payload[] = {0x01, 0x02, 0xAB, 0xCD, 0xEF, 0x00, 0x11, 0x22};
+
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_DOWNLINK,
+                      feed_string("RX=01 02 AB CD EF 00 11 22\r\n"));
+    TEST_ASSERT_EQUAL_UINT8(sizeof(payload), token.size);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, token.data, sizeof(payload));
+}
+
+void
+test_WisolParser_should_RecognizeEchoedCommands(void)
+{
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_ECHO, feed_string("AT$I=10\r\n"));
+    TEST_ASSERT_EQUAL_UINT8(7, token.size);
+    TEST_ASSERT_EQUAL_STRING_LEN("AT$I=10", (const char *) token.data, 7);
+}
+
+void
+test_WisolParser_should_ReturnOtherLinesAsText(void)
+{
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_TEXT, feed_string("OKAY\r\n"));
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_TEXT, feed_string("ABC\r\n"));
+    TEST_ASSERT_EQUAL_STRING_LEN("ABC", (const char *) token.data, 3);
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_TEXT, feed_string("RX=01 2\r\n"));
+    TEST_ASSERT_EQUAL_STRING_LEN("RX=01 2", (const char *) token.data, 7);
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_TEXT, feed_string("RX=\r\n"));
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_TEXT, feed_string("RX=GG\r\n"));
+}
+
+void
+test_WisolParser_should_SkipEmptyLines(void)
+{
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_NONE, feed_string("\r\n\n\r\r\n"));
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_OK, feed_string("\r\nOK\r\n\r\n"));
+}
+
+void
+test_WisolParser_should_ReportLongLinesAndRecover(void)
+{
+    for (uint8_t i = 0; i < WISOL_PARSER_LINE_SIZE + 10; i++)
+    {
+        TEST_ASSERT_EQUAL(WISOL_TOKEN_NONE, wisol_parser_feed('A', &token));
+    }
+
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_OVERFLOW, wisol_parser_feed('\n', &token));
+    TEST_ASSERT_EQUAL_UINT8(WISOL_PARSER_LINE_SIZE, token.size);
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_OK, feed_string("OK\n"));
+}
+
+void
+test_WisolParser_should_NotCopyTheLine(void)
+{
+    const uint8_t* line;
+
+    feed_string("OK\r\n");
+    line = token.data;
+    feed_string("0045A3F2\r\n");
+
+    TEST_ASSERT_EQUAL_PTR(line, token.data);
+}
+
+void
+test_WisolParser_should_DecodeInTheBufferGiven(void)
+{
+    uint8_t id[8];
+
+    wisol_parser_set_buffer(id, sizeof(id));
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX, feed_string("0045A3F2\r\n"));
+    TEST_ASSERT_EQUAL_PTR(id, token.data);
+    TEST_ASSERT_EQUAL_UINT8(4, token.size);
+    TEST_ASSERT_EQUAL_HEX8(0xF2, id[3]);
+
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_OVERFLOW, feed_string("1234567890\r\n"));
+    TEST_ASSERT_EQUAL_UINT8(sizeof(id), token.size);
+
+    // Back to the buffer of the parser
+    wisol_parser_set_buffer(NULL, 0);
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX, feed_string("1234567890\r\n"));
+    TEST_ASSERT_TRUE(token.data != id);
+}
+
+void
+test_WisolParser_should_SurviveRandomInput(void)
+{
+    static const uint8_t alphabet[] = "OKERX=AT0123456789abcdefABCDEF $\r\n";
+    wisol_token_type type;
+    uint32_t lines = 0;
+    uint8_t data;
+
+    seed = 1;
+
+    for (uint32_t i = 0; i < 1000000UL; i++)
+    {
+        // Half of the characters from the response alphabet, half random
+        data = random_byte();
+        if (data & 0x80)
+        {
+            data = alphabet[data % (sizeof(alphabet) - 1)];
+        }
+
+        token.type = WISOL_TOKEN_NONE;
+        type = wisol_parser_feed(data, &token);
+
+        TEST_ASSERT_TRUE(type <= WISOL_TOKEN_OVERFLOW);
+        if (type != WISOL_TOKEN_NONE)
+        {
+            lines++;
+            TEST_ASSERT_EQUAL(type, token.type);
+            TEST_ASSERT_NOT_NULL(token.data);
+            TEST_ASSERT_TRUE(token.size > 0);
+            TEST_ASSERT_TRUE(token.size <= WISOL_PARSER_LINE_SIZE);
+        }
+    }
+
+    TEST_ASSERT_TRUE(lines > 1000);
+
+    // The parser synchronizes again on the next line
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_OK, feed_string("\nOK\r\n"));
+}
+
+void
+test_WisolParser_should_DecodeRandomResponses(void)
+{
+    static const char digits[] = "0123456789ABCDEFabcdef";
+    char line[WISOL_PARSER_LINE_SIZE + 3];
+    uint8_t expected[16];
+    uint8_t size;
+    uint8_t pos;
+    uint8_t value;
+
+    seed = 42;
+
+    for (uint16_t n = 0; n < 10000; n++)
+    {
+        size = 1 + (random_byte() % 8);
+        pos = 0;
+
+        if (n & 0x01)
+        {
+            memcpy(line, "RX=", 3);
+            pos = 3;
+        }
+
+        for (uint8_t i = 0; i < size; i++)
+        {
+            value = 0;
+            for (uint8_t nibble = 0; nibble < 2; nibble++)
+            {
+                char c = digits[random_byte() % (sizeof(digits) - 1)];
+                line[pos++] = c;
+                value = (value << 4) | (uint8_t) ((c <= '9') ? (c - '0') :
+                                                  ((c | 0x20) - 'a' + 10));
+            }
+            expected[i] = value;
+
+            if ( (n & 0x01) && (i + 1 < size) )
+            {
+                line[pos++] = ' ';
+            }
+        }
+
+        // Random line endings
+        if (random_byte() & 0x01)
+        {
+            line[pos++] = '\r';
+        }
+        line[pos++] = '\n';
+        line[pos] = '\0';
+
+        TEST_ASSERT_EQUAL((n & 0x01) ? WISOL_TOKEN_DOWNLINK : WISOL_TOKEN_HEX,
+                          feed_string(line));
+        TEST_ASSERT_EQUAL_UINT8(size, token.size);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, token.data, size);
+    }
+}
+
+void
+test_WisolParser_should_ParseFasterThanTheUart(void)
+{
+    static const char traffic[] =
+        "AT$I=10\r\n0045A3F2\r\n"
+        "AT$I=11\r\n1A2B3C4D5E6F7A8B\r\n"
+        "AT$SF=0102030405060708090A0B0C,1\r\nOK\r\n"
+        "RX=01 02 AB CD EF 00 11 22\r\n"
+        "ERROR\r\n";
+    const uint32_t rounds = 200000UL;
+    uint32_t lines = 0;
+    clock_t start;
+    double seconds;
+    double rate;
+
+    start = clock();
+    for (uint32_t r = 0; r < rounds; r++)
+    {
+        for (const char* c = traffic; *c != '\0'; c++)
+        {
+            if (wisol_parser_feed((uint8_t) *c, &token) != WISOL_TOKEN_NONE)
+            {
+                lines++;
+            }
+        }
+    }
+    seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    rate = (rounds * (sizeof(traffic) - 1)) / (seconds > 0 ? seconds : 1e-9);
+
+    printf("wisol_parser: %.1f MB/s, %.1f ns per character\n", rate / 1e6,
+           1e9 / rate);
+
+    TEST_ASSERT_EQUAL_UINT32(rounds * 8, lines);
+    // Orders of magnitude above the 960 characters per second of the UART
+    TEST_ASSERT_TRUE(rate > 1e6);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_WisolParser_should_RecognizeOk);
+    RUN_TEST(test_WisolParser_should_RecognizeErrors);
+    RUN_TEST(test_WisolParser_should_DecodeIdInPlace);
+    RUN_TEST(test_WisolParser_should_DecodePac);
+    RUN_TEST(test_WisolParser_should_DecodeDownlink);
+    RUN_TEST(test_WisolParser_should_RecognizeEchoedCommands);
+    RUN_TEST(test_WisolParser_should_ReturnOtherLinesAsText);
+    RUN_TEST(test_WisolParser_should_SkipEmptyLines);
+    RUN_TEST(test_WisolParser_should_ReportLongLinesAndRecover);
+    RUN_TEST(test_WisolParser_should_NotCopyTheLine);
+    RUN_TEST(test_WisolParser_should_DecodeInTheBufferGiven);
+    RUN_TEST(test_WisolParser_should_SurviveRandomInput);
+    RUN_TEST(test_WisolParser_should_DecodeRandomResponses);
+    RUN_TEST(test_WisolParser_should_ParseFasterThanTheUart);
+
+    return UNITY_END();
+}
@@ -0,0 +1,269 @@
+#include <string.h>
+#include "unity.h"
+#include "wisol_sim.h"
+#include "avr_sim.h"
+#include "avr/interrupt.h"
+#include "sigfox_wisol.h"
+#include "tick.h"
+
+#define DAY_US      86400000000ULL
+
+// Times are 64 bits, not supported by every Unity configuration
+#define ASSERT_TIME(expected, actual) \
+    TEST_ASSERT_TRUE((uint64_t) (expected) == (uint64_t) (actual))
+
+static wisol_sim_config config;
+static char out[128];
+static uint16_t out_size;
+
+static void
+output(const uint8_t* data, uint16_t size)
+{
+    memcpy(&out[out_size], data, size);
+    out_size += size;
+    out[out_size] = 0x00;
+}
+
+// Sends a command line at once and returns the time its response is due
+static uint64_t
+command(const char* line, uint64_t now)
+{
+    while (*line != 0x00)
+    {
+        wisol_sim_receive((uint8_t) *line++, now);
+    }
+
+    return wisol_sim_poll(now);
+}
+
+// Sends a command line and returns its response
+static const char*
+answer(const char* line, uint64_t* now)
+{
+    uint64_t due = command(line, *now);
+
+    out_size = 0;
+    out[0] = 0x00;
+    if (due != WISOL_SIM_IDLE)
+    {
+        *now = due;
+        wisol_sim_poll(due);
+    }
+
+    return out;
+}
+
+void
+setUp(void)
+{
+    wisol_sim_default_config(&config);
+    out_size = 0;
+    out[0] = 0x00;
+}
+
+void
+tearDown(void)
+{
+}
+
+void
+test_WisolSim_should_ListenAfterWakeUpDelay(void)
+{
+    wisol_sim_init(&config, output);
+
+    ASSERT_TIME(WISOL_SIM_IDLE, command("AT\n", 0));
+    wisol_sim_enable(1, 0);
+    ASSERT_TIME(WISOL_SIM_IDLE, command("AT\n", 1000));
+    TEST_ASSERT_EQUAL_UINT32(6, wisol_sim_get_stats()->lost);
+
+    ASSERT_TIME(45000, command("AT\n", 40000));
+    ASSERT_TIME(45000, wisol_sim_poll(44999));
+    ASSERT_TIME(WISOL_SIM_IDLE, wisol_sim_poll(45000));
+    TEST_ASSERT_EQUAL_STRING("OK\r\n", out);
+    TEST_ASSERT_EQUAL_UINT32(5000, wisol_sim_get_stats()->last_latency_us);
+}
+
+void
+test_WisolSim_should_AnswerInformationCommands(void)
+{
+    uint64_t now = 50000;
+
+    wisol_sim_init(&config, output);
+    wisol_sim_enable(1, 0);
+
+    TEST_ASSERT_EQUAL_STRING("0123ABCD\r\n", answer("AT$I=10\n", &now));
+    TEST_ASSERT_EQUAL_STRING("1234567890ABCDEF\r\n", answer("AT$I=11\r", &now));
+    TEST_ASSERT_EQUAL_STRING("OK\r\n", answer("AT$RC\n", &now));
+    TEST_ASSERT_EQUAL_STRING("ERROR\r\n", answer("AT$X\n", &now));
+    TEST_ASSERT_EQUAL_UINT32(4, wisol_sim_get_stats()->commands);
+    TEST_ASSERT_EQUAL_UINT32(1, wisol_sim_get_stats()->errors);
+}
+
+void
+test_WisolSim_should_InjectErrorsAndMissingResponses(void)
+{
+    uint64_t now = 50000;
+
+    config.error_every = 4;
+    wisol_sim_init(&config, output);
+    wisol_sim_enable(1, 0);
+
+    wisol_sim_inject(WISOL_SIM_FAULT_ERROR, 1);
+    TEST_ASSERT_EQUAL_STRING("ERROR\r\n", answer("AT\n", &now));
+
+    wisol_sim_inject(WISOL_SIM_FAULT_SILENT, 2);
+    TEST_ASSERT_EQUAL_STRING("", answer("AT\n", &now));
+    TEST_ASSERT_EQUAL_STRING("", answer("AT\n", &now));
+
+    // Fourth command
+    TEST_ASSERT_EQUAL_STRING("ERROR\r\n", answer("AT\n", &now));
+    TEST_ASSERT_EQUAL_STRING("OK\r\n", answer("AT\n", &now));
+    TEST_ASSERT_EQUAL_UINT32(2, wisol_sim_get_stats()->errors);
+}
+
+void
+test_WisolSim_should_SendFramesWithDownlink(void)
+{
+    uint64_t now = 50000;
+
+    wisol_sim_init(&config, output);
+    wisol_sim_enable(1, 0);
+
+    ASSERT_TIME(now + config.uplink_us, command("AT$SF=0102AB\n", now));
+
+    // Not listening while sending
+    command("AT\n", now + 1000);
+    TEST_ASSERT_EQUAL_UINT32(3, wisol_sim_get_stats()->lost);
+    wisol_sim_poll(now + config.uplink_us);
+    TEST_ASSERT_EQUAL_STRING("OK\r\n", out);
+
+    now += config.uplink_us;
+    TEST_ASSERT_EQUAL_STRING("OK\r\nRX=01 02 03 04 05 06 07 08\r\n",
+                             answer("AT$SB=1,1\n", &now));
+    TEST_ASSERT_EQUAL_UINT32(config.uplink_us + config.downlink_us,
+                             wisol_sim_get_stats()->last_latency_us);
+    TEST_ASSERT_EQUAL_UINT32(2, wisol_sim_get_stats()->uplinks);
+    TEST_ASSERT_EQUAL_UINT32(1, wisol_sim_get_stats()->downlinks);
+
+    TEST_ASSERT_EQUAL_STRING("ERROR\r\n", answer("AT$SF=012\n", &now));
+    TEST_ASSERT_EQUAL_STRING("ERROR\r\n", answer("AT$SF=%s%s\n", &now));
+    TEST_ASSERT_EQUAL_STRING("ERROR\r\n", answer("AT$SB=2\n", &now));
+}
+
+void
+test_WisolSim_should_EnforceQuotasPerDay(void)
+{
+    uint64_t now = 50000;
+
+    config.uplinks_per_day = 2;
+    config.downlinks_per_day = 1;
+    wisol_sim_init(&config, output);
+    wisol_sim_enable(1, 0);
+
+    TEST_ASSERT_EQUAL_STRING("OK\r\nRX=01 02 03 04 05 06 07 08\r\n",
+                             answer("AT$SF=00,1\n", &now));
+    TEST_ASSERT_EQUAL_STRING("ERR_SFX_ERR_SEND_FRAME_WAIT_TIMEOUT\r\n",
+                             answer("AT$SF=00,1\n", &now));
+    TEST_ASSERT_EQUAL_STRING("ERROR\r\n", answer("AT$SF=00\n", &now));
+
+    now = DAY_US;
+    TEST_ASSERT_EQUAL_STRING("OK\r\n", answer("AT$SF=00\n", &now));
+    TEST_ASSERT_EQUAL_UINT32(3, wisol_sim_get_stats()->uplinks);
+    TEST_ASSERT_EQUAL_UINT32(1, wisol_sim_get_stats()->downlinks);
+}
+
+void
+test_WisolSim_should_AbortFrameWhenPoweredOff(void)
+{
+    wisol_sim_init(&config, output);
+    wisol_sim_enable(1, 0);
+    command("AT$SF=00\n", 50000);
+
+    wisol_sim_enable(0, 1050000);
+    ASSERT_TIME(WISOL_SIM_IDLE, wisol_sim_poll(10000000));
+    TEST_ASSERT_EQUAL_STRING("", out);
+    TEST_ASSERT_EQUAL_UINT32(1, wisol_sim_get_stats()->aborted);
+    TEST_ASSERT_EQUAL_UINT32(0, wisol_sim_get_stats()->uplinks);
+    ASSERT_TIME(1050000, wisol_sim_get_stats()->awake_us);
+}
+
+void
+test_WisolSim_should_SleepUntilWokenUp(void)
+{
+    uint64_t now = 50000;
+
+    wisol_sim_init(&config, output);
+    wisol_sim_enable(1, 0);
+
+    TEST_ASSERT_EQUAL_STRING("OK\r\n", answer("AT$P=1\n", &now));
+    ASSERT_TIME(now, wisol_sim_get_stats()->awake_us);
+
+    // The first byte wakes the module up
+    now += 1000000;
+    ASSERT_TIME(WISOL_SIM_IDLE, command("AT\n", now));
+    TEST_ASSERT_EQUAL_UINT32(2, wisol_sim_get_stats()->wakeups);
+    now += config.wakeup_us;
+    TEST_ASSERT_EQUAL_STRING("OK\r\n", answer("AT$P=2\n", &now));
+
+    // Deep sleep until powered off and on
+    ASSERT_TIME(WISOL_SIM_IDLE, command("AT\n", now + 100000));
+    TEST_ASSERT_EQUAL_UINT32(2, wisol_sim_get_stats()->wakeups);
+    wisol_sim_enable(0, now + 200000);
+    wisol_sim_enable(1, now + 300000);
+    TEST_ASSERT_EQUAL_UINT32(3, wisol_sim_get_stats()->wakeups);
+}
+
+void
+test_WisolSim_should_RunDriverFlowsOnSimulatedBoard(void)
+{
+    const wisol_sim_stats* stats = wisol_sim_get_stats();
+    const uint8_t id[] = {0x01, 0x23, 0xAB, 0xCD};
+    const uint8_t pac[] = {0x12, 0x34, 0x56, 0x78, 0x90, 0xAB, 0xCD, 0xEF};
+    uint8_t str[20];
+    uint64_t start;
+
+    avr_sim_start();
+    wisol_sim_attach(&config);
+    tick_init();
+    sigfox_wisol_init();
+    sei();
+
+    start = avr_sim_micros();
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_id(str, sizeof(str), NULL));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(id, str, sizeof(id));
+    TEST_ASSERT_EQUAL(WISOL_TOKEN_HEX,
+                      sigfox_wisol_get_pac(str, sizeof(str), NULL));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(pac, str, sizeof(pac));
+
+    // The last write to the enable pin is seen on the next access
+    avr_sim_run(AVR_SIM_ACCESS_CYCLES);
+
+    // 8 bytes at 9600 baud before the latency, on the virtual clock
+    TEST_ASSERT_UINT_WITHIN(200, 7 * 10417 / 10 + config.latency_us,
+                            stats->last_latency_us);
+    TEST_ASSERT_EQUAL_UINT32(2, stats->wakeups);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->lost);
+    // Two sessions of 1 s with the command and its response
+    TEST_ASSERT_UINT_WITHIN(100000, 2000000, (uint32_t) stats->awake_us);
+    TEST_ASSERT_TRUE(avr_sim_micros() - start >= stats->awake_us);
+
+    avr_sim_stop();
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_WisolSim_should_ListenAfterWakeUpDelay);
+    RUN_TEST(test_WisolSim_should_AnswerInformationCommands);
+    RUN_TEST(test_WisolSim_should_InjectErrorsAndMissingResponses);
+    RUN_TEST(test_WisolSim_should_SendFramesWithDownlink);
+    RUN_TEST(test_WisolSim_should_EnforceQuotasPerDay);
+    RUN_TEST(test_WisolSim_should_AbortFrameWhenPoweredOff);
+    RUN_TEST(test_WisolSim_should_SleepUntilWokenUp);
+    RUN_TEST(test_WisolSim_should_RunDriverFlowsOnSimulatedBoard);
+
+    return UNITY_END();
+}
@@ -0,0 +1,454 @@
+/******************************************************************************
+* Title                 :   Driver benchmark source file
+* Filename              :   bench.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file        bench.c
+ *  @brief       Benchmark of the hot paths of the drivers
+ *
+ *  ## Overview ##
+ *  The benchmark runs the hot paths of the gpio, uart and sigfox_wisol
+ *  drivers on the host backend of the HAL and prints two metrics per path,
+ *  one per line as "<metric> <name> <value>":
+ *   * cycles: CPU cycles of one call on the virtual clock of the simulated
+ *     ATmega328P. The clock only advances on the register accesses
+ *     (AVR_SIM_ACCESS_CYCLES each) and on the waits for the peripherals and
+ *     the delays, so it counts the operations on the hardware rather than
+ *     the instructions. They are the same on every run and are compared
+ *     with the baseline.
+ *   * ns: host nanoseconds of one call, averaged over many calls with the
+ *     simulation stopped. They depend on the host and are only reported.
+ *
+ *  The Sigfox flow runs against the Wisol emulator (see wisol_sim.h), so it
+ *  only has cycles.
+ *
+ *  The report paths give the CPU cycles awake per reported measurement, the
+ *  mean of REPORT_SAMPLES samples read every REPORT_PERIOD ms and sent to
+ *  the emulator: report_blocking waits with _delay_ms between the samples,
+ *  as the examples used to, and report_pipeline polls a pipeline and leaves
+ *  the time in between idle, standing for the CPU asleep, which is not
+ *  counted. The air time is shortened to fit the frame timeout of the test
+ *  build.
+ *
+ *  The paths that do not touch the hardware, the baud rate setting, the
+ *  Wisol parser and the NTC conversions, would always count 0 cycles, so
+ *  only their host time is reported. Their cost on the ATmega328P is the
+ *  code size measured by the size target.
+ *
+ *  The lut_eval and ntc_float paths convert the counts of an NTC to 1/100
+ *  of degree, with the generated table and with the float math
+ *  respectively. On the host the float math runs on the FPU, the size
+ *  target gives their flash on the target instead, with the soft float
+ *  library (see ntc_size.c).
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      make bench
+ *      make bench-baseline
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <time.h>
+#include "avr_sim.h"
+#include "avr/interrupt.h"
+#include "wisol_sim.h"
+#include "gpio.h"
+#include "uart.h"
+#include "wisol_parser.h"
+#include "sigfox_wisol.h"
+#include "tick.h"
+#include "pipeline.h"
+#include "lut.h"
+#include "lut_ntc.h"
+#include "ntc_float.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Calls averaged for the host time */
+#define REPEAT          100000UL
+/*! Downlink response parsed by the parser path */
+#define DOWNLINK_LINE   "RX=01 02 03 04 05 06 07 08\r\n"
+/*! Samples of a reported measurement */
+#define REPORT_SAMPLES  10
+/*! Period of the samples in milliseconds */
+#define REPORT_PERIOD   1000UL
+/*! Air time of a frame in microseconds */
+#define REPORT_AIR_US   500000UL
+/*! Idle time between the polls of the pipeline in milliseconds */
+#define REPORT_IDLE_MS  10
+/*! The path touches the hardware, its cycles are measured */
+#define BENCH_CYCLES    0x01
+/*! The host time of the path is measured */
+#define BENCH_NS        0x02
+/*! Range of the counts converted by the NTC paths */
+#define NTC_LOW         96
+#define NTC_HIGH        928
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  Path of a driver
+  */
+typedef struct
+{
+    const char* name;           /*! Name of the path in the results */
+    void (*setup)(void);        /*! Called before the measures, or NULL */
+    void (*run)(void);          /*! Path measured */
+    uint8_t metrics;            /*! Metrics measured, BENCH_CYCLES, BENCH_NS */
+} bench_path;
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Sink of the values read, so the calls are not optimized out */
+static volatile uint8_t bench_sink;
+/*! Idle cycles of the path measured, not counted */
+static uint64_t bench_idle;
+/*! Source of the pipeline of the report path */
+static pipeline_source bench_source;
+/*! Aggregate of the pipeline of the report path */
+static pipeline_aggregate bench_aggregate;
+/*! Packing of the pipeline of the report path */
+static pipeline_pack bench_pack = {pipeline_pack_summary};
+
+PIPELINE_QUEUE(bench_samples, int16_t, 2);
+PIPELINE_QUEUE(bench_summaries, pipeline_summary, 1);
+PIPELINE_QUEUE(bench_frames, pipeline_frame, 1);
+
+/*! Pipeline of the report path */
+static const pipeline_stage bench_stages[] PROGMEM =
+{
+    {pipeline_source_step,      &bench_source,
+     NULL,                      &bench_samples},
+    {pipeline_aggregate_step,   &bench_aggregate,
+     &bench_samples,            &bench_summaries},
+    {pipeline_pack_step,        &bench_pack,
+     &bench_summaries,          &bench_frames},
+    {pipeline_uplink_step,      NULL,
+     &bench_frames,             NULL}
+};
+/*! Count converted by the NTC paths */
+static uint16_t bench_count = NTC_LOW;
+/*! Frame of the UART TX path */
+static const uint8_t bench_frame[12] =
+{
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C
+};
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+static void
+_gpio_setup(void)
+{
+    gpio_init_pin(LED_PORT, LED_PIN, GPIO_PIN_OUTPUT);
+}
+
+static void
+_gpio_init_pin(void)
+{
+    gpio_init_pin(LED_PORT, LED_PIN, GPIO_PIN_OUTPUT);
+}
+
+static void
+_gpio_write_pin(void)
+{
+    gpio_write_pin(LED_PORT, LED_PIN, GPIO_PIN_HIGH);
+}
+
+static void
+_gpio_toggle_pin(void)
+{
+    gpio_toggle_pin(LED_PORT, LED_PIN);
+}
+
+static void
+_gpio_read_pin(void)
+{
+    bench_sink = gpio_read_pin(SW_PORT, SW_PIN);
+}
+
+static void
+_uart_setup(void)
+{
+    uart_init();
+}
+
+static void
+_uart_send(void)
+{
+    uart_send("AT$I=10\n");
+}
+
+static void
+_uart_write(void)
+{
+    uart_write(bench_frame, sizeof(bench_frame));
+}
+
+static void
+_uart_baud_setting(void)
+{
+    int16_t error;
+
+    bench_sink = (uint8_t) uart_baud_setting(F_CPU, 115200UL, &error);
+}
+
+static void
+_wisol_parser_setup(void)
+{
+    wisol_parser_init();
+}
+
+static void
+_wisol_parser_feed(void)
+{
+    const char* line = DOWNLINK_LINE;
+    wisol_token token;
+
+    while (*line != 0x00)
+    {
+        bench_sink = wisol_parser_feed((uint8_t) *line++, &token);
+    }
+}
+
+static void
+_lut_eval(void)
+{
+    bench_sink = (uint8_t) lut_eval(&lut_ntc, bench_count);
+    bench_count = (bench_count < NTC_HIGH) ? bench_count + 1 : NTC_LOW;
+}
+
+static void
+_ntc_float(void)
+{
+    bench_sink = (uint8_t) ntc_float(bench_count);
+    bench_count = (bench_count < NTC_HIGH) ? bench_count + 1 : NTC_LOW;
+}
+
+static void
+_sigfox_wisol_setup(void)
+{
+    wisol_sim_config config;
+
+    wisol_sim_default_config(&config);
+    wisol_sim_attach(&config);
+    tick_init();
+    sigfox_wisol_init();
+    sei();
+}
+
+static void
+_sigfox_wisol_get_id(void)
+{
+    uint8_t id[16];
+
+    bench_sink = sigfox_wisol_get_id(id, sizeof(id), NULL);
+}
+
+static int16_t
+_bench_read_sample(void)
+{
+    return (int16_t) (tick_get_ms() & 0x3FF);
+}
+
+static void
+_report_setup(void)
+{
+    const pipeline_source source = PIPELINE_SOURCE(_bench_read_sample,
+                                                   REPORT_PERIOD);
+    const pipeline_aggregate aggregate = PIPELINE_AGGREGATE(REPORT_SAMPLES);
+    wisol_sim_config config;
+
+    wisol_sim_default_config(&config);
+    config.uplink_us = REPORT_AIR_US;
+    wisol_sim_attach(&config);
+    tick_init();
+    sigfox_wisol_init();
+    sei();
+
+    bench_source = source;
+    bench_aggregate = aggregate;
+}
+
+static void
+_report_blocking(void)
+{
+    pipeline_summary summary = {0};
+    uint8_t frame[PIPELINE_SUMMARY_SIZE];
+    int32_t sum = 0;
+    int16_t sample;
+    uint8_t i;
+
+    for (i = 0; i < REPORT_SAMPLES; i++)
+    {
+        sample = _bench_read_sample();
+        summary.min = ((i == 0) || (sample < summary.min)) ? sample :
+                                                             summary.min;
+        summary.max = ((i == 0) || (sample > summary.max)) ? sample :
+                                                             summary.max;
+        sum += sample;
+        _delay_ms(REPORT_PERIOD);
+    }
+    summary.mean = (int16_t) (sum / REPORT_SAMPLES);
+    summary.count = REPORT_SAMPLES;
+
+    pipeline_pack_summary(&summary, frame, sizeof(frame));
+    bench_sink = sigfox_wisol_send_frame(frame, sizeof(frame));
+}
+
+static void
+_report_pipeline(void)
+{
+    sigfox_wisol_uplink_stats stats;
+    uint64_t start;
+
+    do
+    {
+        pipeline_poll(bench_stages,
+                      sizeof(bench_stages) / sizeof(bench_stages[0]),
+                      tick_get_ms());
+
+        start = avr_sim_cycles();
+        _delay_ms(REPORT_IDLE_MS);
+        bench_idle += avr_sim_cycles() - start;
+
+        sigfox_wisol_get_uplink_stats(&stats);
+    } while (stats.results[WISOL_SEND_OK] == 0);
+}
+
+/*! Paths measured, in the order of the results */
+static const bench_path bench_paths[] =
+{
+    {"gpio_init_pin",       NULL,                   _gpio_init_pin,
+     BENCH_CYCLES | BENCH_NS},
+    {"gpio_write_pin",      _gpio_setup,            _gpio_write_pin,
+     BENCH_CYCLES | BENCH_NS},
+    {"gpio_toggle_pin",     _gpio_setup,            _gpio_toggle_pin,
+     BENCH_CYCLES | BENCH_NS},
+    {"gpio_read_pin",       NULL,                   _gpio_read_pin,
+     BENCH_CYCLES | BENCH_NS},
+    {"uart_send",           _uart_setup,            _uart_send,
+     BENCH_CYCLES | BENCH_NS},
+    {"uart_write",          _uart_setup,            _uart_write,
+     BENCH_CYCLES | BENCH_NS},
+    {"uart_baud_setting",   NULL,                   _uart_baud_setting,
+     BENCH_NS},
+    {"wisol_parser_feed",   _wisol_parser_setup,    _wisol_parser_feed,
+     BENCH_NS},
+    {"lut_eval",            NULL,                   _lut_eval,
+     BENCH_NS},
+    {"ntc_float",           NULL,                   _ntc_float,
+     BENCH_NS},
+    {"sigfox_wisol_get_id", _sigfox_wisol_setup,    _sigfox_wisol_get_id,
+     BENCH_CYCLES},
+    {"report_blocking",     _report_setup,          _report_blocking,
+     BENCH_CYCLES},
+    {"report_pipeline",     _report_setup,          _report_pipeline,
+     BENCH_CYCLES},
+};
+
+/*****************************************************************************/
+/*!
+ * Function used to measure the CPU cycles of one call on the virtual clock,
+ * without the idle cycles of the path.
+ *
+ * @param path Pointer to the path.
+ *
+ * @return CPU cycles of the call.
+ */
+/*****************************************************************************/
+static uint64_t
+_bench_cycles(const bench_path* path)
+{
+    uint64_t start;
+    uint64_t cycles;
+
+    avr_sim_start();
+    if (path->setup != NULL)
+    {
+        path->setup();
+    }
+    avr_sim_run(0);
+
+    bench_idle = 0;
+    start = avr_sim_cycles();
+    path->run();
+    cycles = avr_sim_cycles() - start - bench_idle;
+
+    avr_sim_stop();
+
+    return cycles;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to measure the host time of one call, the registers are
+ * plain memory with the simulation stopped.
+ *
+ * @param path Pointer to the path.
+ *
+ * @return Nanoseconds of one call.
+ */
+/*****************************************************************************/
+static double
+_bench_ns(const bench_path* path)
+{
+    struct timespec start;
+    struct timespec end;
+    uint32_t i;
+
+    // The transmitter is always ready
+    UCSR0A = _BV(UDRE0);
+    if (path->setup != NULL)
+    {
+        path->setup();
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < REPEAT; i++)
+    {
+        path->run();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return ((end.tv_sec - start.tv_sec) * 1e9 +
+            (end.tv_nsec - start.tv_nsec)) / REPEAT;
+}
+
+int
+main(void)
+{
+    const bench_path* path;
+    uint8_t i;
+
+    printf("# metric name value\n");
+
+    for (i = 0; i < sizeof(bench_paths) / sizeof(bench_paths[0]); i++)
+    {
+        path = &bench_paths[i];
+        if (path->metrics & BENCH_CYCLES)
+        {
+            printf("cycles %s %lu\n", path->name,
+                   (unsigned long) _bench_cycles(path));
+        }
+        if (path->metrics & BENCH_NS)
+        {
+            printf("ns %s %.1f\n", path->name, _bench_ns(path));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+# Compares benchmark results with the baseline, both as lines of
+# "<metric> <name> <value>":
+#
+#   awk -v metric=cycles -v tolerance=2 -f bench_compare.awk baseline.txt results.txt
+#
+# A value above the baseline by more than tolerance percent is a regression
+# and the exit status is 1. Every baseline entry of the given metric must be
+# in the results, a missing entry or a metric without baseline fails as
+# well. The metrics not in the baseline (ns) are only reported.
+
+FNR == NR {
+    if ( ($1 !~ /^#/) && (NF == 3) )
+    {
+        baseline[$1 " " $2] = $3
+        if ($1 == metric)
+        {
+            expected[$1 " " $2] = $3
+            expected_count++
+        }
+    }
+    next
+}
+
+($1 ~ /^#/) || (NF != 3) {
+    next
+}
+
+{
+    key = $1 " " $2
+    seen[key] = 1
+    if (!(key in baseline))
+    {
+        printf "%-9s %-32s %12s %12s  -\n", $1, $2, $3, "-"
+        next
+    }
+
+    status = "ok"
+    if ($3 > baseline[key] * (1 + tolerance / 100))
+    {
+        status = "REGRESSION"
+        failed = 1
+    }
+    else if ($3 < baseline[key])
+    {
+        status = "improved"
+    }
+    printf "%-9s %-32s %12s %12s  %s\n", $1, $2, $3, baseline[key], status
+}
+
+END {
+    for (key in expected)
+    {
+        if (!(key in seen))
+        {
+            split(key, field, " ")
+            printf "%-9s %-32s %12s %12s  MISSING\n", field[1], field[2], "-",
+                   expected[key]
+            failed = 1
+        }
+    }
+    if (expected_count == 0)
+    {
+        printf "no %s baseline, run the baseline target first\n", metric
+        failed = 1
+    }
+    exit failed
+}
@@ -0,0 +1,41 @@
+/******************************************************************************
+* Title                 :   NTC float conversion header file
+* Filename              :   ntc_float.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc, avr-gcc
+* Target                :   Host, AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file ntc_float.h
+ *  @brief Conversion of the counts of an NTC with the float math.
+ *
+ *  Reference of the generated table of the benchmark and of the size
+ *  programs: a 10 kOhm NTC with a beta of 3950 below a 10 kOhm resistor,
+ *  in 1/100 of degree.
+ */
+
+#ifndef __NTC_FLOAT_H
+#define __NTC_FLOAT_H
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <math.h>
+#include <stdint.h>
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+static inline int16_t
+ntc_float(uint16_t count)
+{
+    float ratio = (count + 0.5f) / 1024.0f;
+    float r = 10000.0f * ratio / (1.0f - ratio);
+
+    return (int16_t) ((1.0f / (1.0f / 298.15f + logf(r / 10000.0f) / 3950.0f) -
+                       273.15f) * 100.0f);
+}
+
+#endif /* __NTC_FLOAT_H */
@@ -0,0 +1,53 @@
+/******************************************************************************
+* Title                 :   NTC conversion size program source file
+* Filename              :   ntc_size.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   avr-gcc
+* Target                :   AVR
+* Notes                 :   None
+******************************************************************************/
+/*! @file        ntc_size.c
+ *  @brief       Program converting a count of an NTC, for its flash size
+ *
+ *  ## Overview ##
+ *  The size target links this program for the ATmega328P twice: with the
+ *  generated table and lut_eval, and with NTC_FLOAT defined, with the float
+ *  math. The flash of each program, the soft float library included, is
+ *  the cost of the conversion on the target, which the host times of the
+ *  benchmark do not tell.
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#ifdef NTC_FLOAT
+    #include "ntc_float.h"
+#else
+    #include "lut.h"
+    #include "lut_ntc.h"
+#endif
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Count converted, volatile so the conversion is not optimized out */
+static volatile uint16_t ntc_count;
+/*! Temperature in 1/100 of degree */
+static volatile int16_t ntc_temperature;
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+int
+main(void)
+{
+#ifdef NTC_FLOAT
+    ntc_temperature = ntc_float(ntc_count);
+#else
+    ntc_temperature = lut_eval(&lut_ntc, ntc_count);
+#endif
+
+    return 0;
+}
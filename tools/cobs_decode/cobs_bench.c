@@ -0,0 +1,218 @@
+/******************************************************************************
+* Title                 :   COBS benchmark source file
+* Filename              :   cobs_bench.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file        cobs_bench.c
+ *  @brief       COBS benchmark implementation
+ *
+ *  ## Overview ##
+ *  The benchmark compares the COBS frames with the text path used so far,
+ *  binary data sent as hexadecimal text terminated by a new line. For
+ *  several payload sizes it prints the bytes sent on the wire, the time to
+ *  send them through the UART at 9600 and 115200 baud (8N1) and the time
+ *  the gateway needs to decode them.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      make
+ *      ./cobs_bench
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cobs_host.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Largest payload of the benchmark */
+#define MAX_PAYLOAD     2048
+/*! Bytes decoded to measure the decode time */
+#define DECODE_BYTES    (64UL * 1024 * 1024)
+/*! Bits sent per byte by the UART (8N1) */
+#define BITS_PER_BYTE   10
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+static uint8_t payload[MAX_PAYLOAD];
+static uint8_t encoded[COBS_HOST_FRAME_MAX(MAX_PAYLOAD)];
+static uint8_t text[MAX_PAYLOAD * 2 + 1];
+static uint8_t decoded[MAX_PAYLOAD + COBS_HOST_CRC_SIZE];
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+/*****************************************************************************/
+/*!
+ * Function used to encode a payload as the text path: hexadecimal and a
+ * new line.
+ *
+ * @param data Pointer to the payload.
+ * @param size Number of bytes of the payload.
+ * @param out Buffer of the text.
+ *
+ * @return Number of characters of the text.
+ */
+/*****************************************************************************/
+static size_t
+_text_encode(const uint8_t* data, size_t size, uint8_t* out)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        out[2 * i] = digits[data[i] >> 4];
+        out[2 * i + 1] = digits[data[i] & 0x0F];
+    }
+    out[2 * size] = '\n';
+
+    return 2 * size + 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to decode a line of the text path.
+ *
+ * @param data Pointer to the text.
+ * @param size Number of characters of the text.
+ * @param out Buffer of the payload.
+ *
+ * @return Number of bytes of the payload.
+ */
+/*****************************************************************************/
+static size_t
+_text_decode(const uint8_t* data, size_t size, uint8_t* out)
+{
+    size_t count = 0;
+    uint8_t nibble;
+    size_t i;
+
+    for (i = 0; (i + 1 < size) && (data[i] != '\n'); i++)
+    {
+        nibble = (data[i] <= '9') ? data[i] - '0' : data[i] - 'A' + 10;
+        if (i & 1)
+        {
+            out[count++] |= nibble;
+        }
+        else
+        {
+            out[count] = (uint8_t) (nibble << 4);
+        }
+    }
+
+    return count;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to measure the time to decode frames.
+ *
+ * @param frame Pointer to the frame.
+ * @param size Number of bytes of the frame.
+ * @param cobs 1 to decode COBS frames, 0 to decode text lines.
+ *
+ * @return Decode time in nanoseconds per payload byte.
+ */
+/*****************************************************************************/
+static double
+_decode_time(const uint8_t* frame, size_t size, size_t payload_size,
+             int cobs)
+{
+    cobs_host_decoder decoder;
+    unsigned long rounds = DECODE_BYTES / size + 1;
+    unsigned long frames = 0;
+    unsigned long r;
+    clock_t start;
+    double seconds;
+    size_t i;
+
+    cobs_host_decoder_init(&decoder, decoded, sizeof(decoded));
+
+    start = clock();
+    for (r = 0; r < rounds; r++)
+    {
+        if (cobs)
+        {
+            for (i = 0; i < size; i++)
+            {
+                frames += (cobs_host_decode(&decoder, frame[i]) ==
+                           COBS_HOST_FRAME);
+            }
+        }
+        else
+        {
+            frames += (_text_decode(frame, size, decoded) == payload_size);
+        }
+    }
+    seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    if (frames != rounds)
+    {
+        fprintf(stderr, "cobs_bench: %lu of %lu frames decoded\n", frames,
+                rounds);
+        exit(1);
+    }
+
+    return seconds * 1e9 / ((double) rounds * payload_size);
+}
+
+int
+main(void)
+{
+    static const size_t sizes[] = {12, 32, 128, 512, MAX_PAYLOAD};
+    size_t cobs_size;
+    size_t text_size;
+    size_t s;
+    size_t i;
+
+    // Sensor samples: small values with some zero bytes
+    srand(1);
+    for (i = 0; i < MAX_PAYLOAD; i++)
+    {
+        payload[i] = (uint8_t) (rand() % 64);
+    }
+
+    printf("%8s | %6s %6s | %9s %9s | %9s %9s | %8s %8s\n", "payload",
+           "cobs", "text", "cobs 9k6", "text 9k6", "cobs 115k", "text 115k",
+           "cobs rx", "text rx");
+    printf("%8s | %6s %6s | %9s %9s | %9s %9s | %8s %8s\n", "(bytes)",
+           "(B)", "(B)", "(ms)", "(ms)", "(ms)", "(ms)", "(ns/B)", "(ns/B)");
+
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        cobs_size = cobs_host_encode(payload, sizes[s], encoded);
+        text_size = _text_encode(payload, sizes[s], text);
+
+        printf("%8zu | %6zu %6zu | %9.1f %9.1f | %9.2f %9.2f | %8.1f %8.1f\n",
+               sizes[s], cobs_size, text_size,
+               cobs_size * BITS_PER_BYTE * 1000.0 / 9600,
+               text_size * BITS_PER_BYTE * 1000.0 / 9600,
+               cobs_size * BITS_PER_BYTE * 1000.0 / 115200,
+               text_size * BITS_PER_BYTE * 1000.0 / 115200,
+               _decode_time(encoded, cobs_size, sizes[s], 1),
+               _decode_time(text, text_size, sizes[s], 0));
+
+        if (memcmp(decoded, payload, sizes[s]) != 0)
+        {
+            fprintf(stderr, "cobs_bench: payload of %zu bytes corrupted\n",
+                    sizes[s]);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+/******************************************************************************
+* Title                 :   COBS decoder source file
+* Filename              :   cobs_decode.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file        cobs_decode.c
+ *  @brief       COBS decoder implementation
+ *
+ *  ## Overview ##
+ *  The COBS decoder prints the frames sent by the cobs module of the
+ *  firmware as hexadecimal lines, one line per frame. The frames with a
+ *  wrong CRC and the text sent between the frames are counted as errors.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      stty -F /dev/ttyUSB0 9600 raw
+ *      ./cobs_decode < /dev/ttyUSB0
+ *      ./cobs_decode capture.bin
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdio.h>
+#include "cobs_host.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Maximum size of a frame */
+#define FRAME_SIZE      4096
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+int
+main(int argc, char* argv[])
+{
+    static uint8_t frame[FRAME_SIZE + COBS_HOST_CRC_SIZE];
+    cobs_host_decoder decoder;
+    cobs_host_status status;
+    FILE* in = stdin;
+    unsigned long frames = 0;
+    unsigned long errors = 0;
+    size_t size;
+    size_t i;
+    int c;
+
+    if (argc > 2)
+    {
+        fprintf(stderr, "usage: %s [capture.bin]\n", argv[0]);
+        return 2;
+    }
+
+    if ( (argc == 2) && ((in = fopen(argv[1], "rb")) == NULL) )
+    {
+        perror(argv[1]);
+        return 2;
+    }
+
+    cobs_host_decoder_init(&decoder, frame, sizeof(frame));
+
+    while ( (c = fgetc(in)) != EOF )
+    {
+        status = cobs_host_decode(&decoder, (uint8_t) c);
+        if (status == COBS_HOST_FRAME)
+        {
+            size = cobs_host_frame_size(&decoder);
+            printf("%4zu:", size);
+            for (i = 0; i < size; i++)
+            {
+                printf(" %02X", frame[i]);
+            }
+            printf("\n");
+            fflush(stdout);
+            frames++;
+        }
+        else if (status == COBS_HOST_ERROR)
+        {
+            errors++;
+        }
+    }
+
+    fprintf(stderr, "cobs_decode: %lu frames, %lu errors\n", frames, errors);
+
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+
+    return (errors > 0);
+}
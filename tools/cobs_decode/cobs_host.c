@@ -0,0 +1,282 @@
+/******************************************************************************
+* Title                 :   Host COBS library source file
+* Filename              :   cobs_host.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file        cobs_host.c
+ *  @brief       Host COBS library implementation
+ *
+ *  ## Overview ##
+ *  The library encodes and decodes the COBS frames of the cobs module of
+ *  the firmware. The decoder is fed byte by byte, so it can be fed directly
+ *  from a serial port, and it synchronizes with the next zero byte after an
+ *  error or text sent by the firmware.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      cobs_host_decoder decoder;
+ *      uint8_t frame[1024];
+ *
+ *      cobs_host_decoder_init(&decoder, frame, sizeof(frame));
+ *      while ((c = getchar()) != EOF)
+ *      {
+ *          if (cobs_host_decode(&decoder, c) == COBS_HOST_FRAME)
+ *          {
+ *              handle(frame, cobs_host_frame_size(&decoder));
+ *          }
+ *      }
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include "cobs_host.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Initial value of the CRC */
+#define CRC_INIT        0xFFFF
+/*! Code of the decoder waiting for the first block of a frame */
+#define CODE_START      0x00
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! CRC of every byte, built on the first use */
+static uint16_t cobs_host_crc_table[256];
+/*! Flag set when the CRC table is built */
+static int cobs_host_crc_ready;
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static void _cobs_host_emit(cobs_host_decoder* decoder, uint8_t data);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to update a CRC16 (XMODEM) with bytes.
+ *
+ * @param crc CRC of the previous bytes, 0xFFFF for the first ones.
+ * @param data Pointer to the bytes.
+ * @param size Number of bytes.
+ *
+ * @return Updated CRC.
+ */
+/*****************************************************************************/
+uint16_t
+cobs_host_crc16(uint16_t crc, const uint8_t* data, size_t size)
+{
+    uint16_t value;
+    size_t i;
+    int bit;
+
+    if (!cobs_host_crc_ready)
+    {
+        for (i = 0; i < 256; i++)
+        {
+            value = (uint16_t) (i << 8);
+            for (bit = 0; bit < 8; bit++)
+            {
+                value = (value & 0x8000) ? (uint16_t) ((value << 1) ^ 0x1021) :
+                                           (uint16_t) (value << 1);
+            }
+            cobs_host_crc_table[i] = value;
+        }
+        cobs_host_crc_ready = 1;
+    }
+
+    for (i = 0; i < size; i++)
+    {
+        crc = (uint16_t) ((crc << 8) ^
+                          cobs_host_crc_table[(crc >> 8) ^ data[i]]);
+    }
+
+    return crc;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to encode a frame.
+ *
+ * @param data Pointer to the bytes of the frame.
+ * @param size Number of bytes of the frame.
+ * @param out Buffer of COBS_HOST_FRAME_MAX(size) bytes for the encoded
+ *        frame, including the CRC and the delimiter.
+ *
+ * @return Number of bytes of the encoded frame.
+ */
+/*****************************************************************************/
+size_t
+cobs_host_encode(const uint8_t* data, size_t size, uint8_t* out)
+{
+    uint16_t crc = cobs_host_crc16(CRC_INIT, data, size);
+    uint8_t tail[COBS_HOST_CRC_SIZE];
+    size_t code_index = 0;
+    size_t index = 1;
+    size_t total = size + COBS_HOST_CRC_SIZE;
+    size_t i;
+    uint8_t code = 1;
+    uint8_t byte;
+
+    tail[0] = (uint8_t) (crc >> 8);
+    tail[1] = (uint8_t) crc;
+
+    for (i = 0; i < total; i++)
+    {
+        byte = (i < size) ? data[i] : tail[i - size];
+        if (byte == 0)
+        {
+            out[code_index] = code;
+            code_index = index++;
+            code = 1;
+        }
+        else
+        {
+            out[index++] = byte;
+            code++;
+            if ( (code == 0xFF) && ((i + 1) < total) )
+            {
+                out[code_index] = code;
+                code_index = index++;
+                code = 1;
+            }
+        }
+    }
+    out[code_index] = code;
+    out[index++] = 0x00;
+
+    return index;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to initialize a decoder.
+ *
+ * @param decoder Pointer to the decoder.
+ * @param buffer Buffer of the decoded frames, including the CRC.
+ * @param size Size of the buffer.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+cobs_host_decoder_init(cobs_host_decoder* decoder, uint8_t* buffer,
+                       size_t size)
+{
+    decoder->buffer = buffer;
+    decoder->size = size;
+    decoder->length = 0;
+    decoder->crc = CRC_INIT;
+    decoder->code = CODE_START;
+    decoder->remaining = 0;
+    decoder->error = 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to decode a received byte.
+ *
+ * @param decoder Pointer to the decoder.
+ * @param data Received byte.
+ *
+ * @return COBS_HOST_FRAME if a valid frame was completed, COBS_HOST_ERROR
+ *         if a wrong frame was completed or COBS_HOST_PENDING otherwise.
+ */
+/*****************************************************************************/
+cobs_host_status
+cobs_host_decode(cobs_host_decoder* decoder, uint8_t data)
+{
+    cobs_host_status status = COBS_HOST_PENDING;
+
+    if (data == 0x00)
+    {
+        if (decoder->code != CODE_START)
+        {
+            status = ( !decoder->error && (decoder->remaining == 0) &&
+                       (decoder->length >= COBS_HOST_CRC_SIZE) &&
+                       (decoder->crc == 0) ) ? COBS_HOST_FRAME :
+                                               COBS_HOST_ERROR;
+        }
+        decoder->code = CODE_START;
+        decoder->remaining = 0;
+
+        return status;
+    }
+
+    if (decoder->code == CODE_START)
+    {
+        decoder->length = 0;
+        decoder->crc = CRC_INIT;
+        decoder->error = 0;
+    }
+    else if (decoder->error)
+    {
+        return COBS_HOST_PENDING;
+    }
+
+    if (decoder->remaining == 0)
+    {
+        if ( (decoder->code != CODE_START) && (decoder->code != 0xFF) )
+        {
+            _cobs_host_emit(decoder, 0);
+        }
+        decoder->code = data;
+        decoder->remaining = data - 1;
+    }
+    else
+    {
+        _cobs_host_emit(decoder, data);
+        decoder->remaining--;
+    }
+
+    return COBS_HOST_PENDING;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to get the size of the last frame decoded.
+ *
+ * @param decoder Pointer to the decoder.
+ *
+ * @return Number of bytes of the frame, without the CRC.
+ */
+/*****************************************************************************/
+size_t
+cobs_host_frame_size(const cobs_host_decoder* decoder)
+{
+    return decoder->length - COBS_HOST_CRC_SIZE;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to store a decoded byte.
+ *
+ * @param decoder Pointer to the decoder.
+ * @param data Decoded byte.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_cobs_host_emit(cobs_host_decoder* decoder, uint8_t data)
+{
+    if (decoder->length >= decoder->size)
+    {
+        decoder->error = 1;
+        return;
+    }
+
+    decoder->buffer[decoder->length++] = data;
+    decoder->crc = cobs_host_crc16(decoder->crc, &data, 1);
+}
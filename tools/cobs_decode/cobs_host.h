@@ -0,0 +1,87 @@
+/******************************************************************************
+* Title                 :   Host COBS library header file
+* Filename              :   cobs_host.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file cobs_host.h
+ *  @brief Defines the host COBS library function definitions.
+ *
+ *  This is the header file of the COBS framing used by the gateway to talk
+ *  to the firmware. The frames are compatible with the cobs module of the
+ *  firmware: COBS encoded, a big endian CRC16 (XMODEM, initial value
+ *  0xFFFF) after the data and a zero byte after every frame.
+ */
+
+#ifndef __COBS_HOST_H
+#define __COBS_HOST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Size of the CRC appended to every frame */
+#define COBS_HOST_CRC_SIZE      2
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/*! Maximum size of an encoded frame of size bytes */
+#define COBS_HOST_FRAME_MAX(size)   ((size) + COBS_HOST_CRC_SIZE + \
+                                     ((size) + COBS_HOST_CRC_SIZE) / 254 + 2)
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Host COBS decoder result enumeration
+  */
+typedef enum
+{
+    COBS_HOST_PENDING = 0,
+    COBS_HOST_FRAME,
+    COBS_HOST_ERROR
+} cobs_host_status;
+
+/*!
+  * @brief  Host COBS decoder
+  */
+typedef struct
+{
+    uint8_t* buffer;
+    size_t size;
+    size_t length;
+    uint16_t crc;
+    uint8_t code;
+    uint8_t remaining;
+    uint8_t error;
+} cobs_host_decoder;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+uint16_t cobs_host_crc16(uint16_t crc, const uint8_t* data, size_t size);
+size_t cobs_host_encode(const uint8_t* data, size_t size, uint8_t* out);
+void cobs_host_decoder_init(cobs_host_decoder* decoder, uint8_t* buffer,
+                            size_t size);
+cobs_host_status cobs_host_decode(cobs_host_decoder* decoder, uint8_t data);
+size_t cobs_host_frame_size(const cobs_host_decoder* decoder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __COBS_HOST_H */
@@ -0,0 +1,302 @@
+/******************************************************************************
+* Title                 :   Lookup table generator source file
+* Filename              :   lut_gen.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file        lut_gen.c
+ *  @brief       Lookup table generator implementation
+ *
+ *  ## Overview ##
+ *  The lookup table generator writes the header of a lut_table (lut.h)
+ *  from the parameters of a sensor curve, so the firmware converts the ADC
+ *  counts without floating point. The outputs of the curve are computed in
+ *  double at the points, 2^shift counts apart, and scaled to fixed point.
+ *  The largest error of the interpolation, lut_eval computed the same way
+ *  as the firmware, over every count of the range is written in the
+ *  header.
+ *
+ *  The counts are taken at the middle of the ADC step, the ratio to the
+ *  reference is (count + 0.5) / 2^bits. The models are:
+ *  - beta: NTC thermistor with a series resistor, the output in degrees
+ *    Celsius. The thermistor is between the pin and GND, or between the
+ *    pin and the reference with -H.
+ *  - power: output k * ratio^e, as the light dependent resistors.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      ./lut_gen -n ntc_10k -m beta -B 3950 -R 10000 -S 10000 -T 25 \
+ *                -q 100 -l 96 -u 928 -s 4 > ntc_10k.h
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Largest distance between the points, as LUT_MAX_SHIFT of lut.h */
+#define LUT_MAX_SHIFT       8
+/*! Kelvin at 0 degrees Celsius */
+#define KELVIN              273.15
+/*! Size of the table name */
+#define NAME_SIZE           32
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  Parameters of the sensor curve and of the table
+  */
+typedef struct
+{
+    char name[NAME_SIZE];
+    char model;             /*! 'b' beta or 'p' power */
+    double beta;
+    double r0;
+    double t0;
+    double series;
+    int high_side;
+    double k;
+    double e;
+    int bits;
+    double scale;
+    long low;
+    long high;
+    int shift;
+} lut_params;
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to get the output of the sensor curve, not scaled.
+ *
+ * @param params Parameters of the curve.
+ * @param count ADC count.
+ *
+ * @return Output of the curve.
+ */
+/*****************************************************************************/
+static double
+_curve(const lut_params* params, long count)
+{
+    double ratio = (count + 0.5) / (double) (1L << params->bits);
+    double r;
+
+    if (params->model == 'p')
+    {
+        return params->k * pow(ratio, params->e);
+    }
+
+    r = params->high_side ? params->series * (1.0 - ratio) / ratio :
+                            params->series * ratio / (1.0 - ratio);
+
+    return 1.0 / (1.0 / (params->t0 + KELVIN) +
+                  log(r / params->r0) / params->beta) - KELVIN;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to interpolate the table the same way as lut_eval.
+ *
+ * @param y Outputs at the points.
+ * @param points Number of points.
+ * @param params Parameters of the table.
+ * @param x Input.
+ *
+ * @return Output.
+ */
+/*****************************************************************************/
+static int32_t
+_eval(const int16_t* y, long points, const lut_params* params, long x)
+{
+    long index;
+    int32_t frac;
+
+    if (x <= params->low)
+    {
+        return y[0];
+    }
+
+    x -= params->low;
+    index = x >> params->shift;
+    if (index >= (points - 1))
+    {
+        return y[points - 1];
+    }
+
+    frac = x & ((1L << params->shift) - 1);
+
+    return y[index] + ((((int32_t) (y[index + 1] - y[index]) * frac) +
+                        ((1L << params->shift) >> 1)) >> params->shift);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to print the usage.
+ *
+ * @param program Name of the program.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_usage(const char* program)
+{
+    fprintf(stderr,
+            "usage: %s -n name [-m beta|power] [-a bits] [-l low] [-u high]\n"
+            "          [-s shift] [-q scale] [-B beta] [-R r0] [-T t0]\n"
+            "          [-S series] [-H] [-K k] [-E e]\n",
+            program);
+}
+
+int
+main(int argc, char* argv[])
+{
+    lut_params params =
+    {
+        "", 'b', 3950.0, 10000.0, 25.0, 10000.0, 0, 1.0, 1.0, 10, 100.0,
+        -1, -1, 4
+    };
+    char guard[NAME_SIZE] = "";
+    int16_t* y;
+    long points;
+    long count;
+    long worst = 0;
+    double error;
+    double max_error = 0.0;
+    double value;
+    int option;
+
+    while ( (option = getopt(argc, argv, "n:m:a:l:u:s:q:B:R:T:S:HK:E:")) != -1 )
+    {
+        switch (option)
+        {
+            case 'n': snprintf(params.name, NAME_SIZE, "%s", optarg); break;
+            case 'm': params.model = optarg[0]; break;
+            case 'a': params.bits = atoi(optarg); break;
+            case 'l': params.low = atol(optarg); break;
+            case 'u': params.high = atol(optarg); break;
+            case 's': params.shift = atoi(optarg); break;
+            case 'q': params.scale = atof(optarg); break;
+            case 'B': params.beta = atof(optarg); break;
+            case 'R': params.r0 = atof(optarg); break;
+            case 'T': params.t0 = atof(optarg); break;
+            case 'S': params.series = atof(optarg); break;
+            case 'H': params.high_side = 1; break;
+            case 'K': params.k = atof(optarg); break;
+            case 'E': params.e = atof(optarg); break;
+            default: _usage(argv[0]); return 2;
+        }
+    }
+
+    if (params.low < 0)
+    {
+        params.low = 0;
+    }
+    if (params.high < 0)
+    {
+        params.high = (1L << params.bits) - 1;
+    }
+
+    if ( (params.name[0] == '\0') || (optind != argc) ||
+         ((params.model != 'b') && (params.model != 'p')) ||
+         (params.bits < 1) || (params.bits > 16) ||
+         (params.shift < 0) || (params.shift > LUT_MAX_SHIFT) ||
+         (params.low >= params.high) ||
+         (params.high >= (1L << params.bits)) )
+    {
+        _usage(argv[0]);
+        return 2;
+    }
+
+    // The last point is past the range when it is not a multiple of the
+    // distance, its output is taken at the last count of the ADC
+    points = ((params.high - params.low + (1L << params.shift) - 1) >>
+              params.shift) + 1;
+    y = malloc(points * sizeof(*y));
+    if (y == NULL)
+    {
+        perror("lut_gen");
+        return 1;
+    }
+
+    for (long i = 0; i < points; i++)
+    {
+        count = params.low + (i << params.shift);
+        if (count >= (1L << params.bits))
+        {
+            count = (1L << params.bits) - 1;
+        }
+
+        value = round(_curve(&params, count) * params.scale);
+        if ( !isfinite(value) || (value < INT16_MIN) || (value > INT16_MAX) )
+        {
+            fprintf(stderr, "lut_gen: output of count %ld out of int16_t, "
+                    "lower the scale or narrow the range\n", count);
+            free(y);
+            return 1;
+        }
+        y[i] = (int16_t) value;
+    }
+
+    for (count = params.low; count <= params.high; count++)
+    {
+        error = fabs(_eval(y, points, &params, count) -
+                     _curve(&params, count) * params.scale);
+        if (error > max_error)
+        {
+            max_error = error;
+            worst = count;
+        }
+    }
+
+    printf("/* Generated by lut_gen, do not edit\n *\n *  ");
+    for (int i = 0; i < argc; i++)
+    {
+        printf("%s%s", (i == 0) ? "lut_gen" : " ", (i == 0) ? "" : argv[i]);
+    }
+    printf("\n *\n *  %ld points, %ld bytes of flash, largest error %.2f "
+           "(1/%g) at count %ld\n */\n", points,
+           (long) (points * sizeof(*y)) + 7, max_error, params.scale, worst);
+
+    for (int i = 0; params.name[i] != '\0'; i++)
+    {
+        guard[i] = (char) toupper((unsigned char) params.name[i]);
+        guard[i + 1] = '\0';
+    }
+    printf("#ifndef __%s_H\n#define __%s_H\n\n", guard, guard);
+    printf("#include \"lut.h\"\n\n");
+    printf("static const int16_t %s_y[%ld] PROGMEM =\n{", params.name, points);
+    for (long i = 0; i < points; i++)
+    {
+        printf("%s%6d%s", (i % 8) ? " " : "\n    ", y[i],
+               (i < points - 1) ? "," : "");
+    }
+    printf("\n};\n\n");
+    printf("static const lut_table %s PROGMEM =\n{\n"
+           "    %ld, %ld, %d, %s_y\n};\n", params.name, params.low, points,
+           params.shift, params.name);
+    printf("\n#endif /* __%s_H */\n", guard);
+
+    free(y);
+
+    return 0;
+}
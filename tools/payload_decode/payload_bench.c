@@ -0,0 +1,277 @@
+/******************************************************************************
+* Title                 :   Payload benchmark source file
+* Filename              :   payload_bench.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file        payload_bench.c
+ *  @brief       Payload benchmark implementation
+ *
+ *  ## Overview ##
+ *  The benchmark encodes a batch of summaries with payload_put of the
+ *  firmware and the field list of payload.h, as hexadecimal text, and
+ *  decodes it with the host library using 1 to one thread per CPU. It
+ *  prints the payloads decoded per second, next to the ones of a decoder
+ *  written as the scripts used so far: sscanf of every byte and the fields
+ *  built byte by byte. The decoded columns are checked against the values
+ *  encoded on every run.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      make
+ *      ./payload_bench
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "payload_host.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Payloads of the batch */
+#define PAYLOADS        (1UL << 20)
+/*! Decodes of the batch averaged */
+#define ROUNDS          5
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! Writes a field of a summary, as pipeline_pack_summary */
+#define PACK_FIELD(name, first, bits, is_signed)        \
+    payload_put(data, first, bits, (uint32_t) value[field++]);
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Values encoded, one row of the fields per payload */
+static int32_t* values;
+/*! Text of the payloads */
+static char* text;
+/*! Payloads of the batch */
+static const char** hex;
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to get a monotonic time.
+ *
+ * @return Time in seconds.
+ */
+/*****************************************************************************/
+static double
+_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to decode the batch as the scripts: sscanf of every byte
+ * and the fields built byte by byte.
+ *
+ * @param columns Pointer to the columns.
+ *
+ * @return Number of payloads decoded.
+ */
+/*****************************************************************************/
+static size_t
+_decode_sscanf(payload_host_columns* columns)
+{
+    unsigned int byte;
+    uint8_t data[PAYLOAD_SUMMARY_SIZE];
+    size_t decoded = 0;
+    size_t row;
+    size_t i;
+
+    for (row = 0; row < PAYLOADS; row++)
+    {
+        for (i = 0; i < PAYLOAD_SUMMARY_SIZE; i++)
+        {
+            if (sscanf(&hex[row][2 * i], "%2x", &byte) != 1)
+            {
+                break;
+            }
+            data[i] = (uint8_t) byte;
+        }
+
+        columns->valid[row] = (i == PAYLOAD_SUMMARY_SIZE);
+        columns->column[0][row] = (int16_t) ((data[0] << 8) | data[1]);
+        columns->column[1][row] = (int16_t) ((data[2] << 8) | data[3]);
+        columns->column[2][row] = (int16_t) ((data[4] << 8) | data[5]);
+        columns->column[3][row] = data[6];
+        decoded += columns->valid[row];
+    }
+
+    return decoded;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to check the columns against the values encoded.
+ *
+ * @param columns Pointer to the columns.
+ *
+ * @return 1 if every payload matches.
+ */
+/*****************************************************************************/
+static int
+_check(const payload_host_columns* columns)
+{
+    size_t row;
+    size_t i;
+
+    for (row = 0; row < PAYLOADS; row++)
+    {
+        for (i = 0; i < payload_host_summary.count; i++)
+        {
+            if ( !columns->valid[row] ||
+                 (columns->column[i][row] !=
+                  values[row * payload_host_summary.count + i]) )
+            {
+                fprintf(stderr, "payload_bench: payload %zu field %s decoded "
+                        "wrong\n", row, payload_host_summary.fields[i].name);
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to measure a decoder and print its payloads per second.
+ *
+ * @param name Name of the decoder.
+ * @param threads Threads of the batch decoder, 0 for the sscanf decoder.
+ * @param columns Pointer to the columns.
+ * @param base Payloads per second of the sscanf decoder, 0 to print none.
+ *
+ * @return Payloads per second.
+ */
+/*****************************************************************************/
+static double
+_measure(const char* name, unsigned threads, payload_host_columns* columns,
+         double base)
+{
+    double start;
+    double seconds;
+    double rate;
+    unsigned r;
+
+    memset(columns->valid, 0, PAYLOADS);
+
+    start = _now();
+    for (r = 0; r < ROUNDS; r++)
+    {
+        if (threads == 0)
+        {
+            _decode_sscanf(columns);
+        }
+        else
+        {
+            payload_host_decode_batch(&payload_host_summary, hex, PAYLOADS,
+                                      columns, threads);
+        }
+    }
+    seconds = (_now() - start) / ROUNDS;
+
+    if (!_check(columns))
+    {
+        exit(1);
+    }
+
+    rate = PAYLOADS / seconds;
+    printf("%-10s %8u %14.0f %10.1f %8.1f\n", name, threads, rate,
+           seconds * 1e9 / PAYLOADS, base ? rate / base : 1.0);
+
+    return rate;
+}
+
+int
+main(void)
+{
+    static const char digits[] = "0123456789abcdef";
+    payload_host_columns columns;
+    uint8_t data[PAYLOAD_SUMMARY_SIZE];
+    size_t count = payload_host_summary.count;
+    size_t field;
+    size_t row;
+    size_t i;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    double base;
+    unsigned threads;
+
+    values = malloc(PAYLOADS * count * sizeof(*values));
+    text = malloc(PAYLOADS * (2 * PAYLOAD_SUMMARY_SIZE + 1));
+    hex = malloc(PAYLOADS * sizeof(*hex));
+    if ( (values == NULL) || (text == NULL) || (hex == NULL) ||
+         (payload_host_columns_init(&columns, &payload_host_summary,
+                                    PAYLOADS) != 0) )
+    {
+        perror("payload_bench");
+        return 1;
+    }
+
+    // Summaries of a sensor in 1/100 of degree over windows of 1 to 255
+    srand(1);
+    for (row = 0; row < PAYLOADS; row++)
+    {
+        int32_t* value = &values[row * count];
+        int32_t mean = rand() % 8000 - 2000;
+
+        value[0] = mean - rand() % 500;
+        value[1] = mean;
+        value[2] = mean + rand() % 500;
+        value[3] = rand() % 255 + 1;
+
+        field = 0;
+        PAYLOAD_SUMMARY_FIELDS(PACK_FIELD)
+
+        hex[row] = &text[row * (2 * PAYLOAD_SUMMARY_SIZE + 1)];
+        for (i = 0; i < PAYLOAD_SUMMARY_SIZE; i++)
+        {
+            ((char *) hex[row])[2 * i] = digits[data[i] >> 4];
+            ((char *) hex[row])[2 * i + 1] = digits[data[i] & 0x0F];
+        }
+        ((char *) hex[row])[2 * PAYLOAD_SUMMARY_SIZE] = '\0';
+    }
+
+    printf("%lu payloads of %d bytes\n", PAYLOADS, PAYLOAD_SUMMARY_SIZE);
+    printf("%-10s %8s %14s %10s %8s\n", "decoder", "threads", "payloads/s",
+           "ns/payload", "speedup");
+
+    base = _measure("sscanf", 0, &columns, 0);
+
+    for (threads = 1; threads <= (cpus > 0 ? (unsigned) cpus : 1); threads *= 2)
+    {
+        _measure("batch", threads, &columns, base);
+    }
+
+    payload_host_columns_free(&columns);
+    free(values);
+    free(text);
+    free(hex);
+
+    return 0;
+}
@@ -0,0 +1,200 @@
+/******************************************************************************
+* Title                 :   Payload decoder source file
+* Filename              :   payload_decode.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file        payload_decode.c
+ *  @brief       Payload decoder implementation
+ *
+ *  ## Overview ##
+ *  The payload decoder turns a file of uplink payloads, one hexadecimal
+ *  payload per line as exported from the Sigfox callbacks, into CSV with
+ *  one column per field of the format. The whole file is decoded as one
+ *  batch with a thread per CPU, the lines that are not payloads of the
+ *  format are reported and skipped.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      ./payload_decode -f summary payloads.txt > summary.csv
+ *      ./payload_decode -f uplink_stats -j 4 < payloads.txt
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "payload_host.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Lines allocated at a time */
+#define LINES_STEP      65536
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to remove the blanks around a line.
+ *
+ * @param line Pointer to the line.
+ *
+ * @return Pointer to the first character that is not blank.
+ */
+/*****************************************************************************/
+static char*
+_trim(char* line)
+{
+    size_t length;
+
+    while ( (*line == ' ') || (*line == '\t') )
+    {
+        line++;
+    }
+
+    length = strlen(line);
+    while ( (length > 0) && ((line[length - 1] == '\n') ||
+                             (line[length - 1] == '\r') ||
+                             (line[length - 1] == ' ') ||
+                             (line[length - 1] == '\t')) )
+    {
+        line[--length] = '\0';
+    }
+
+    return line;
+}
+
+int
+main(int argc, char* argv[])
+{
+    const payload_host_format* format = &payload_host_summary;
+    payload_host_columns columns;
+    FILE* in = stdin;
+    char** lines = NULL;
+    char** hex = NULL;
+    char* line = NULL;
+    size_t line_size = 0;
+    size_t count = 0;
+    size_t allocated = 0;
+    size_t decoded;
+    size_t row;
+    size_t i;
+    unsigned threads = 0;
+    int option;
+
+    while ( (option = getopt(argc, argv, "f:j:")) != -1 )
+    {
+        switch (option)
+        {
+            case 'f':
+                format = payload_host_find_format(optarg);
+                if (format == NULL)
+                {
+                    fprintf(stderr, "payload_decode: unknown format %s\n",
+                            optarg);
+                    return 2;
+                }
+                break;
+
+            case 'j':
+                threads = (unsigned) atoi(optarg);
+                break;
+
+            default:
+                fprintf(stderr, "usage: %s [-f summary|uplink_stats] "
+                        "[-j threads] [payloads.txt]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    if ( (optind < argc) && ((in = fopen(argv[optind], "r")) == NULL) )
+    {
+        perror(argv[optind]);
+        return 2;
+    }
+
+    while (getline(&line, &line_size, in) != -1)
+    {
+        if (count == allocated)
+        {
+            allocated += LINES_STEP;
+            lines = realloc(lines, allocated * sizeof(*lines));
+            hex = realloc(hex, allocated * sizeof(*hex));
+            if ( (lines == NULL) || (hex == NULL) )
+            {
+                perror("payload_decode");
+                return 1;
+            }
+        }
+        lines[count] = strdup(line);
+        if (lines[count] == NULL)
+        {
+            perror("payload_decode");
+            return 1;
+        }
+        hex[count] = _trim(lines[count]);
+        count++;
+    }
+    free(line);
+
+    if (payload_host_columns_init(&columns, format, count) != 0)
+    {
+        perror("payload_decode");
+        return 1;
+    }
+
+    decoded = payload_host_decode_batch(format, (const char* const*) hex,
+                                        count, &columns, threads);
+
+    for (i = 0; i < format->count; i++)
+    {
+        printf("%s%s", (i == 0) ? "" : ",", format->fields[i].name);
+    }
+    printf("\n");
+
+    for (row = 0; row < count; row++)
+    {
+        if (!columns.valid[row])
+        {
+            fprintf(stderr, "payload_decode: line %zu is not a %s payload\n",
+                    row + 1, format->name);
+            continue;
+        }
+
+        for (i = 0; i < format->count; i++)
+        {
+            printf("%s%d", (i == 0) ? "" : ",", columns.column[i][row]);
+        }
+        printf("\n");
+    }
+
+    fprintf(stderr, "payload_decode: %zu payloads, %zu errors\n", decoded,
+            count - decoded);
+
+    payload_host_columns_free(&columns);
+    for (row = 0; row < count; row++)
+    {
+        free(lines[row]);
+    }
+    free(lines);
+    free(hex);
+
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+
+    return (decoded != count);
+}
@@ -0,0 +1,560 @@
+/******************************************************************************
+* Title                 :   Host payload library source file
+* Filename              :   payload_host.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file        payload_host.c
+ *  @brief       Host payload library implementation
+ *
+ *  ## Overview ##
+ *  The library decodes batches of hexadecimal uplink payloads into one
+ *  array per field, ready to be stored by column. The formats come from the
+ *  field lists of payload.h, so a field added to the firmware encoder is
+ *  decoded without touching the backend.
+ *
+ *  The text is converted 16 characters at a time in two 64 bits words
+ *  (SWAR): every character is validated and turned into its nibble with
+ *  additions and masks, and the nibbles are packed with shifts, without a
+ *  branch or a table lookup per character. The fields are read with one big
+ *  endian 64 bits load and two shifts, the sign extended by a mask instead
+ *  of a branch. The batch is split in equal ranges of rows decoded by
+ *  threads that share nothing but the read only input.
+ *
+ *  A row that is not a payload of the format, wrong length or a character
+ *  that is not hexadecimal, has its valid flag cleared and zero fields.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      payload_host_columns columns;
+ *
+ *      payload_host_columns_init(&columns, &payload_host_summary, count);
+ *      payload_host_decode_batch(&payload_host_summary, hex, count,
+ *                                &columns, 0);
+ *      // columns.column[1][row] is the mean of the row
+ *      payload_host_columns_free(&columns);
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "payload_host.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! A byte of ones in every byte of a word */
+#define ONES            0x0101010101010101ULL
+/*! The most significant bit of every byte of a word */
+#define HIGHS           0x8080808080808080ULL
+/*! The even bytes of a word */
+#define EVENS           0x00FF00FF00FF00FFULL
+/*! Rows below which a batch is not split in threads */
+#define ROWS_PER_THREAD 4096
+/*! Maximum number of threads of a batch */
+#define THREADS_MAX     64
+
+/******************************************************************************
+* Module Preprocessor Macros
+******************************************************************************/
+/*! Entry of a field list of payload.h as a payload_host_field */
+#define _PAYLOAD_HOST_FIELD(name, first, bits, is_signed)   \
+    {#name, first, bits, is_signed},
+
+/******************************************************************************
+* Module Typedefs
+******************************************************************************/
+/*!
+  * @brief  Range of rows of a batch decoded by a thread
+  */
+typedef struct
+{
+    const payload_host_format* format;
+    const char* const* hex;
+    payload_host_columns* columns;
+    size_t begin;
+    size_t end;
+    size_t decoded;
+} payload_host_job;
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+static const payload_host_field payload_host_summary_fields[] =
+{
+    PAYLOAD_SUMMARY_FIELDS(_PAYLOAD_HOST_FIELD)
+};
+
+static const payload_host_field payload_host_uplink_stats_fields[] =
+{
+    PAYLOAD_UPLINK_STATS_FIELDS(_PAYLOAD_HOST_FIELD)
+};
+
+const payload_host_format payload_host_summary =
+{
+    "summary", PAYLOAD_SUMMARY_SIZE,
+    sizeof(payload_host_summary_fields) / sizeof(payload_host_field),
+    payload_host_summary_fields
+};
+
+const payload_host_format payload_host_uplink_stats =
+{
+    "uplink_stats", PAYLOAD_UPLINK_STATS_SIZE,
+    sizeof(payload_host_uplink_stats_fields) / sizeof(payload_host_field),
+    payload_host_uplink_stats_fields
+};
+
+/*! Formats found by name */
+static const payload_host_format* const payload_host_formats[] =
+{
+    &payload_host_summary,
+    &payload_host_uplink_stats
+};
+
+/******************************************************************************
+* Private Function Prototypes
+******************************************************************************/
+static uint64_t _payload_host_nibbles(uint64_t x, uint64_t* valid);
+static uint64_t _payload_host_load_be64(const uint8_t* data);
+static size_t _payload_host_decode_range(const payload_host_format* format,
+                                         const char* const* hex,
+                                         payload_host_columns* columns,
+                                         size_t begin, size_t end);
+static int _payload_host_decode_row(const payload_host_format* format,
+                                    const char* hex,
+                                    payload_host_columns* columns,
+                                    size_t row);
+static void* _payload_host_thread(void* arg);
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to find a format by its name.
+ *
+ * @param name Name of the format, "summary" or "uplink_stats".
+ *
+ * @return Pointer to the format, NULL if there is no such format.
+ */
+/*****************************************************************************/
+const payload_host_format*
+payload_host_find_format(const char* name)
+{
+    size_t i;
+
+    for (i = 0;
+         i < sizeof(payload_host_formats) / sizeof(payload_host_formats[0]);
+         i++)
+    {
+        if (strcmp(payload_host_formats[i]->name, name) == 0)
+        {
+            return payload_host_formats[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to convert hexadecimal text to bytes, upper or lower case.
+ *
+ * @param hex Pointer to the text.
+ * @param length Number of characters, even.
+ * @param out Buffer of length / 2 bytes.
+ *
+ * @return Number of bytes, 0 if the length is odd or a character is not
+ *         hexadecimal.
+ */
+/*****************************************************************************/
+size_t
+payload_host_hex(const char* hex, size_t length, uint8_t* out)
+{
+    uint64_t valid;
+    uint64_t invalid = 0;
+    uint64_t high;
+    uint64_t low;
+    uint64_t x;
+    size_t i = 0;
+
+    if (length & 1)
+    {
+        return 0;
+    }
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    for (; i + 16 <= length; i += 16)
+    {
+        // The characters in the bytes of two words, the first one lowest
+        memcpy(&high, &hex[i], 8);
+        memcpy(&low, &hex[i + 8], 8);
+
+        high = _payload_host_nibbles(high, &valid);
+        invalid |= valid ^ HIGHS;
+        low = _payload_host_nibbles(low, &valid);
+        invalid |= valid ^ HIGHS;
+
+        // Pairs of nibbles in 16 bits, pairs of bytes in 32 bits, then the
+        // 4 bytes of every word in the low half
+        high = ((high & EVENS) << 4) | ((high >> 8) & EVENS);
+        low = ((low & EVENS) << 4) | ((low >> 8) & EVENS);
+        high = (high | (high >> 8)) & 0x0000FFFF0000FFFFULL;
+        low = (low | (low >> 8)) & 0x0000FFFF0000FFFFULL;
+        high = (high | (high >> 16)) & 0xFFFFFFFFULL;
+        low = (low | (low >> 16)) & 0xFFFFFFFFULL;
+
+        x = high | (low << 32);
+        memcpy(&out[i / 2], &x, 8);
+    }
+#endif
+
+    // The rest, a pair of characters at a time with the same arithmetic
+    for (; i < length; i += 2)
+    {
+        x = (uint8_t) hex[i] | ((uint64_t) (uint8_t) hex[i + 1] << 8);
+        x = _payload_host_nibbles(x, &valid);
+        invalid |= valid ^ 0x8080;
+        out[i / 2] = (uint8_t) ((x << 4) | (x >> 8));
+    }
+
+    return invalid ? 0 : length / 2;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to allocate the columns of a batch.
+ *
+ * @param columns Pointer to the columns.
+ * @param format Format of the payloads.
+ * @param rows Number of payloads.
+ *
+ * @return 0 if allocated, -1 if out of memory.
+ */
+/*****************************************************************************/
+int
+payload_host_columns_init(payload_host_columns* columns,
+                          const payload_host_format* format, size_t rows)
+{
+    size_t i;
+
+    memset(columns, 0, sizeof(*columns));
+    columns->rows = rows;
+    columns->valid = malloc(rows ? rows : 1);
+
+    for (i = 0; (i < format->count) && (i < PAYLOAD_HOST_FIELDS_MAX); i++)
+    {
+        columns->column[i] = malloc((rows ? rows : 1) * sizeof(int32_t));
+        if (columns->column[i] == NULL)
+        {
+            break;
+        }
+    }
+
+    if ( (columns->valid == NULL) || (i < format->count) )
+    {
+        payload_host_columns_free(columns);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to free the columns of a batch.
+ *
+ * @param columns Pointer to the columns.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+void
+payload_host_columns_free(payload_host_columns* columns)
+{
+    size_t i;
+
+    for (i = 0; i < PAYLOAD_HOST_FIELDS_MAX; i++)
+    {
+        free(columns->column[i]);
+        columns->column[i] = NULL;
+    }
+    free(columns->valid);
+    columns->valid = NULL;
+    columns->rows = 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to decode a payload in a row of the columns.
+ *
+ * @param format Format of the payload.
+ * @param hex Payload as NUL terminated hexadecimal text.
+ * @param columns Pointer to the columns.
+ * @param row Row of the payload.
+ *
+ * @return 1 if decoded, 0 if the text is not a payload of the format.
+ */
+/*****************************************************************************/
+int
+payload_host_decode(const payload_host_format* format, const char* hex,
+                    payload_host_columns* columns, size_t row)
+{
+    return _payload_host_decode_row(format, hex, columns, row);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to decode a batch of payloads, one per row of the columns.
+ *
+ * @param format Format of the payloads.
+ * @param hex Payloads as NUL terminated hexadecimal text.
+ * @param count Number of payloads, at most the rows of the columns.
+ * @param columns Pointer to the columns.
+ * @param threads Number of threads, 0 for one per online CPU.
+ *
+ * @return Number of payloads decoded, the others are not valid.
+ */
+/*****************************************************************************/
+size_t
+payload_host_decode_batch(const payload_host_format* format,
+                          const char* const* hex, size_t count,
+                          payload_host_columns* columns, unsigned threads)
+{
+    payload_host_job jobs[THREADS_MAX];
+    pthread_t ids[THREADS_MAX];
+    uint8_t started[THREADS_MAX];
+    size_t chunk;
+    size_t decoded = 0;
+    unsigned i;
+
+    if (threads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (unsigned) cpus : 1;
+    }
+    if (threads > THREADS_MAX)
+    {
+        threads = THREADS_MAX;
+    }
+    if (threads > (count + ROWS_PER_THREAD - 1) / ROWS_PER_THREAD)
+    {
+        threads = (unsigned) ((count + ROWS_PER_THREAD - 1) / ROWS_PER_THREAD);
+    }
+    if (threads <= 1)
+    {
+        return _payload_host_decode_range(format, hex, columns, 0, count);
+    }
+
+    chunk = (count + threads - 1) / threads;
+    for (i = 0; i < threads; i++)
+    {
+        jobs[i].format = format;
+        jobs[i].hex = hex;
+        jobs[i].columns = columns;
+        jobs[i].begin = (i * chunk < count) ? i * chunk : count;
+        jobs[i].end = (jobs[i].begin + chunk < count) ? jobs[i].begin + chunk :
+                                                        count;
+        jobs[i].decoded = 0;
+
+        // The range of a thread that cannot be started is decoded here
+        started[i] = (i > 0) &&
+                     (pthread_create(&ids[i], NULL, _payload_host_thread,
+                                     &jobs[i]) == 0);
+    }
+
+    _payload_host_thread(&jobs[0]);
+    for (i = 1; i < threads; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(ids[i], NULL);
+        }
+        else
+        {
+            _payload_host_thread(&jobs[i]);
+        }
+    }
+
+    for (i = 0; i < threads; i++)
+    {
+        decoded += jobs[i].decoded;
+    }
+
+    return decoded;
+}
+
+/******************************************************************************
+* Private Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to convert the hexadecimal characters in the bytes of a
+ * word to their nibbles.
+ *
+ * @param x Characters, one per byte.
+ * @param valid Set to the high bit of every byte holding a hexadecimal
+ *              character.
+ *
+ * @return Nibbles, one per byte.
+ */
+/*****************************************************************************/
+static uint64_t
+_payload_host_nibbles(uint64_t x, uint64_t* valid)
+{
+    uint64_t lower = x | (0x20 * ONES);
+    uint64_t digit;
+    uint64_t letter;
+
+    // The high bit of a byte is set by the addition when it is at least the
+    // bound, the bytes of 0x80 and above are not valid so their carries
+    // into the next byte do not matter
+    digit = (x + 0x50 * ONES) & ~(x + 0x46 * ONES);             // '0' to '9'
+    letter = (lower + 0x1F * ONES) & ~(lower + 0x19 * ONES);    // 'a' to 'f'
+    *valid = (digit | letter) & ~x & HIGHS;
+
+    letter = (letter & HIGHS) >> 7;
+
+    return (x & (0x0F * ONES)) + (letter << 3) + letter;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to load 8 bytes in big endian.
+ *
+ * @param data Pointer to the bytes.
+ *
+ * @return Value.
+ */
+/*****************************************************************************/
+static uint64_t
+_payload_host_load_be64(const uint8_t* data)
+{
+    uint64_t value;
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    memcpy(&value, data, 8);
+    value = __builtin_bswap64(value);
+#elif defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    memcpy(&value, data, 8);
+#else
+    value = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        value = (value << 8) | data[i];
+    }
+#endif
+
+    return value;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to decode a range of rows.
+ *
+ * @param format Format of the payloads.
+ * @param hex Payloads as NUL terminated hexadecimal text.
+ * @param columns Pointer to the columns.
+ * @param begin First row.
+ * @param end Row after the last one.
+ *
+ * @return Number of payloads decoded.
+ */
+/*****************************************************************************/
+static size_t
+_payload_host_decode_range(const payload_host_format* format,
+                           const char* const* hex,
+                           payload_host_columns* columns, size_t begin,
+                           size_t end)
+{
+    size_t decoded = 0;
+    size_t row;
+
+    for (row = begin; row < end; row++)
+    {
+        decoded += (size_t) _payload_host_decode_row(format, hex[row],
+                                                     columns, row);
+    }
+
+    return decoded;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to decode a row.
+ *
+ * @param format Format of the payload.
+ * @param hex Payload as NUL terminated hexadecimal text.
+ * @param columns Pointer to the columns.
+ * @param row Row of the payload.
+ *
+ * @return 1 if decoded, 0 if the text is not a payload of the format.
+ */
+/*****************************************************************************/
+static int
+_payload_host_decode_row(const payload_host_format* format, const char* hex,
+                         payload_host_columns* columns, size_t row)
+{
+    const payload_host_field* field;
+    // Room for the 8 bytes load of a field starting in the last byte
+    uint8_t data[PAYLOAD_HOST_SIZE_MAX + 8] = {0};
+    size_t length;
+    size_t i;
+    uint64_t word;
+    uint64_t sign;
+    uint64_t ok;
+    unsigned shift;
+
+    length = strnlen(hex, 2 * PAYLOAD_HOST_SIZE_MAX + 1);
+    ok = (length == 2 * format->size) &&
+         (payload_host_hex(hex, length, data) == format->size);
+    columns->valid[row] = (uint8_t) ok;
+
+    for (i = 0; i < format->count; i++)
+    {
+        field = &format->fields[i];
+        word = _payload_host_load_be64(&data[field->first >> 3]) <<
+               (field->first & 0x07);
+        shift = 64 - field->bits;
+        sign = -(uint64_t) field->is_signed;
+
+        word = ((word >> shift) & ~sign) |
+               ((uint64_t) ((int64_t) word >> shift) & sign);
+        columns->column[i][row] = (int32_t) (word & -ok);
+    }
+
+    return (int) ok;
+}
+
+/*****************************************************************************/
+/*!
+ * Function run by the threads of a batch.
+ *
+ * @param arg Pointer to the payload_host_job.
+ *
+ * @return NULL.
+ */
+/*****************************************************************************/
+static void*
+_payload_host_thread(void* arg)
+{
+    payload_host_job* job = (payload_host_job *) arg;
+
+    job->decoded = _payload_host_decode_range(job->format, job->hex,
+                                              job->columns, job->begin,
+                                              job->end);
+
+    return NULL;
+}
@@ -0,0 +1,105 @@
+/******************************************************************************
+* Title                 :   Host payload library header file
+* Filename              :   payload_host.h
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file payload_host.h
+ *  @brief Defines the host payload library function definitions.
+ *
+ *  This is the header file of the decoder of the uplink payloads received
+ *  by the backend in the Sigfox callbacks, as hexadecimal text. The formats
+ *  are built from the field lists of payload.h, the same ones expanded by
+ *  the encoders of the firmware.
+ */
+
+#ifndef __PAYLOAD_HOST_H
+#define __PAYLOAD_HOST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "payload.h"
+
+/******************************************************************************
+* Preprocessor Constants
+******************************************************************************/
+/*! Maximum size of a payload, a Sigfox uplink frame */
+#define PAYLOAD_HOST_SIZE_MAX       12
+/*! Maximum number of fields of a format */
+#define PAYLOAD_HOST_FIELDS_MAX     16
+
+/******************************************************************************
+* Typedefs
+******************************************************************************/
+/*!
+  * @brief  Field of a payload, as the FIELD entries of payload.h
+  */
+typedef struct
+{
+    const char* name;
+    uint8_t first;              /*! First bit, from the MSB of the payload */
+    uint8_t bits;               /*! Number of bits, 1 to 32 */
+    uint8_t is_signed;          /*! 1 for two's complement */
+} payload_host_field;
+
+/*!
+  * @brief  Format of a payload
+  */
+typedef struct
+{
+    const char* name;
+    size_t size;                        /*! Bytes of the payload */
+    size_t count;                       /*! Number of fields */
+    const payload_host_field* fields;
+} payload_host_format;
+
+/*!
+  * @brief  Decoded payloads, one array per field
+  */
+typedef struct
+{
+    size_t rows;                                /*! Payloads of the batch */
+    int32_t* column[PAYLOAD_HOST_FIELDS_MAX];   /*! Values of every field */
+    uint8_t* valid;                             /*! 1 if the row decoded */
+} payload_host_columns;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+/*! Summary packed by pipeline_pack_summary */
+extern const payload_host_format payload_host_summary;
+/*! Counters packed by sigfox_wisol_pack_uplink_stats */
+extern const payload_host_format payload_host_uplink_stats;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+const payload_host_format* payload_host_find_format(const char* name);
+size_t payload_host_hex(const char* hex, size_t length, uint8_t* out);
+int payload_host_columns_init(payload_host_columns* columns,
+                              const payload_host_format* format,
+                              size_t rows);
+void payload_host_columns_free(payload_host_columns* columns);
+int payload_host_decode(const payload_host_format* format, const char* hex,
+                        payload_host_columns* columns, size_t row);
+size_t payload_host_decode_batch(const payload_host_format* format,
+                                 const char* const* hex, size_t count,
+                                 payload_host_columns* columns,
+                                 unsigned threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PAYLOAD_HOST_H */
@@ -0,0 +1,346 @@
+/******************************************************************************
+* Title                 :   Trace decoder source file
+* Filename              :   trace_decode.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file        trace_decode.c
+ *  @brief       Trace decoder implementation
+ *
+ *  ## Overview ##
+ *  The trace decoder turns the binary dump sent by the trace_dump function
+ *  into a timeline. The bytes before the magic of the dump are skipped, so
+ *  the dump can be captured together with the text sent by the firmware.
+ *  The timestamps are unwrapped, so the timeline is correct while the
+ *  events are less than 65 seconds apart.
+ *
+ *  The names of the events mirror the trace_event_id enumeration of
+ *  trace.h.
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      stty -F /dev/ttyUSB0 9600 raw
+ *      cat /dev/ttyUSB0 > dump.bin
+ *      ./trace_decode dump.bin
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+
+/******************************************************************************
+* Module Preprocessor Constants
+******************************************************************************/
+/*! Size of the header of a trace dump */
+#define HEADER_SIZE     6
+/*! Size of a record in a trace dump */
+#define RECORD_SIZE     6
+/*! Event identifiers of the drivers, as defined in trace.h */
+#define TRACE_GPIO_INIT         1
+#define TRACE_GPIO_WRITE        2
+#define TRACE_GPIO_TOGGLE       3
+#define TRACE_UART_RX           4
+#define TRACE_UART_RX_DROP      5
+#define TRACE_UART_SEND         6
+#define TRACE_UART_READ         7
+#define TRACE_WISOL_POWER       8
+#define TRACE_WISOL_CMD         9
+#define TRACE_WISOL_RESPONSE    10
+/*! First identifier of the application events */
+#define TRACE_USER              0x80
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Names of the events of the drivers, indexed by the event identifier */
+static const char* event_names[] =
+{
+    "NONE",
+    "GPIO_INIT",
+    "GPIO_WRITE",
+    "GPIO_TOGGLE",
+    "UART_RX",
+    "UART_RX_DROP",
+    "UART_SEND",
+    "UART_READ",
+    "WISOL_POWER",
+    "WISOL_CMD",
+    "WISOL_RESPONSE"
+};
+
+/*! Names of the uart_status values */
+static const char* uart_status_names[] =
+{
+    "OK", "TIMEOUT", "BUFFER_FULL", "CANCELLED"
+};
+
+/*! Names of the Wisol response lines, indexed by the wisol_token_type */
+static const char* wisol_token_names[] =
+{
+    "no answer", "OK", "ERROR", "hex", "downlink", "echo", "text", "overflow"
+};
+
+/*! Names of the Wisol power states, indexed by the state */
+static const char* wisol_power_names[] =
+{
+    "off", "ready", "sleep", "deep sleep"
+};
+
+/*! Names of the Wisol commands, indexed by the command */
+static const char* wisol_cmd_names[] =
+{
+    "AT", "AT$SB", "AT$SF", "AT$I=10", "AT$I=11", "AT$P", "AT$RC"
+};
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+
+/*****************************************************************************/
+/*!
+ * Function used to get the name of a port from its data space address.
+ *
+ * @param address Address of the PORTx register.
+ *
+ * @return Name of the port.
+ */
+/*****************************************************************************/
+static const char*
+_port_name(uint8_t address)
+{
+    switch (address)
+    {
+        case 0x25: return "PORTB";
+        case 0x28: return "PORTC";
+        case 0x2B: return "PORTD";
+        default:   return "PORT?";
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to print the argument of an event.
+ *
+ * @param id Event identifier.
+ * @param arg Argument of the event.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_print_arg(uint8_t id, uint16_t arg)
+{
+    uint8_t low = arg & 0xFF;
+
+    switch (id)
+    {
+        case TRACE_GPIO_INIT:
+        case TRACE_GPIO_WRITE:
+            printf("%s.%u = %u", _port_name(arg >> 8), (arg >> 4) & 0x0F,
+                   arg & 0x0F);
+            break;
+
+        case TRACE_GPIO_TOGGLE:
+            printf("%s.%u", _port_name(arg >> 8), (arg >> 4) & 0x0F);
+            break;
+
+        case TRACE_UART_RX:
+        case TRACE_UART_RX_DROP:
+            printf("0x%02X '%c'", low, ((low >= 0x20) && (low < 0x7F)) ?
+                                       low : '.');
+            break;
+
+        case TRACE_UART_SEND:
+            printf("%u characters", arg);
+            break;
+
+        case TRACE_UART_READ:
+            printf("%s, %u characters", ((arg >> 8) < 4) ?
+                   uart_status_names[arg >> 8] : "?", low);
+            break;
+
+        case TRACE_WISOL_POWER:
+            printf("%s", (arg < 4) ? wisol_power_names[arg] : "?");
+            break;
+
+        case TRACE_WISOL_CMD:
+            printf("%s", (arg < 7) ? wisol_cmd_names[arg] : "?");
+            break;
+
+        case TRACE_WISOL_RESPONSE:
+            printf("%s", (arg < 8) ? wisol_token_names[arg] : "?");
+            break;
+
+        default:
+            printf("0x%04X (%u)", arg, arg);
+            break;
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to print the name of an event.
+ *
+ * @param id Event identifier.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_print_name(uint8_t id)
+{
+    char name[16];
+
+    if (id >= TRACE_USER)
+    {
+        snprintf(name, sizeof(name), "USER+%u", id - TRACE_USER);
+    }
+    else if (id < sizeof(event_names) / sizeof(event_names[0]))
+    {
+        snprintf(name, sizeof(name), "%s", event_names[id]);
+    }
+    else
+    {
+        snprintf(name, sizeof(name), "EVENT_%u", id);
+    }
+
+    printf("%-16s", name);
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to find the header of a dump in the input.
+ *
+ * @param in Input stream.
+ * @param header Buffer where the header will be written.
+ *
+ * @return 1 if a header was found, 0 at the end of the input.
+ */
+/*****************************************************************************/
+static int
+_find_header(FILE* in, uint8_t* header)
+{
+    int c;
+    int previous = EOF;
+
+    while ( (c = fgetc(in)) != EOF )
+    {
+        if ( (previous == 'T') && (c == 'R') )
+        {
+            header[0] = 'T';
+            header[1] = 'R';
+            return fread(&header[2], 1, HEADER_SIZE - 2, in) ==
+                   HEADER_SIZE - 2;
+        }
+        previous = c;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to decode a dump.
+ *
+ * @param in Input stream positioned after the header.
+ * @param header Header of the dump.
+ *
+ * @return 0 if the dump was decoded, 1 if it is truncated.
+ */
+/*****************************************************************************/
+static int
+_decode(FILE* in, const uint8_t* header)
+{
+    uint8_t record[RECORD_SIZE];
+    uint8_t count = header[2];
+    uint8_t sub_per_ms = header[3] ? header[3] : 1;
+    uint16_t dropped = header[4] | (header[5] << 8);
+    uint16_t last_ms = 0;
+    uint64_t ms = 0;
+    double time_us;
+    double previous_us = 0;
+
+    printf("%u records, %u dropped\n", count, dropped);
+    printf("%14s %12s  %-16s %s\n", "time (ms)", "delta (us)", "event",
+           "argument");
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint16_t record_ms;
+
+        if (fread(record, 1, RECORD_SIZE, in) != RECORD_SIZE)
+        {
+            fprintf(stderr, "trace_decode: dump truncated after %u records\n",
+                    i);
+            return 1;
+        }
+
+        // The 16 bit milliseconds are unwrapped from the first record
+        record_ms = record[0] | (record[1] << 8);
+        ms += (i == 0) ? record_ms : (uint16_t) (record_ms - last_ms);
+        last_ms = record_ms;
+
+        time_us = ms * 1000.0 + record[2] * 1000.0 / sub_per_ms;
+
+        printf("%14.3f %12.0f  ", time_us / 1000.0,
+               (i == 0) ? 0.0 : time_us - previous_us);
+        _print_name(record[3]);
+        printf(" ");
+        _print_arg(record[3], record[4] | (record[5] << 8));
+        printf("\n");
+
+        previous_us = time_us;
+    }
+
+    return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint8_t header[HEADER_SIZE];
+    FILE* in = stdin;
+    int dumps = 0;
+    int result = 0;
+
+    if (argc > 2)
+    {
+        fprintf(stderr, "usage: %s [dump.bin]\n", argv[0]);
+        return 2;
+    }
+
+    if ( (argc == 2) && ((in = fopen(argv[1], "rb")) == NULL) )
+    {
+        perror(argv[1]);
+        return 2;
+    }
+
+    while (_find_header(in, header))
+    {
+        if (dumps++ > 0)
+        {
+            printf("\n");
+        }
+        result |= _decode(in, header);
+    }
+
+    if (dumps == 0)
+    {
+        fprintf(stderr, "trace_decode: no trace dump found\n");
+        result = 1;
+    }
+
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+
+    return result;
+}
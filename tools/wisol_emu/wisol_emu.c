@@ -0,0 +1,225 @@
+/******************************************************************************
+* Title                 :   Wisol emulator source file
+* Filename              :   wisol_emu.c
+* Author                :   Maximiliano Valencia
+* Origin Date           :   18/10/2026
+* Version               :   1.0.0
+* Compiler              :   gcc
+* Target                :   Host
+* Notes                 :   None
+******************************************************************************/
+/*! @file        wisol_emu.c
+ *  @brief       Wisol emulator on a pseudo terminal
+ *
+ *  ## Overview ##
+ *  The emulator opens a Linux pseudo terminal and answers the AT commands
+ *  written to it as the Sigfox Wisol module would (see wisol_sim.h), on the
+ *  wall clock. The module is always powered, as the enable pin is not part
+ *  of the serial link. The path of the terminal is printed on start, the
+ *  statistics on exit (Ctrl+C).
+ *
+ *  ## Usage ##
+ *
+ *  @code
+ *      make
+ *      ./wisol_emu -l 10 -e 5 -t 500
+ *      echo 'AT$I=10' > /dev/pts/3
+ *  @endcode
+ */
+/******************************************************************************
+* Includes
+******************************************************************************/
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "wisol_sim.h"
+
+/******************************************************************************
+* Module Variable Definitions
+******************************************************************************/
+/*! Master side of the pseudo terminal */
+static int master;
+/*! Flag set by SIGINT and SIGTERM */
+static volatile sig_atomic_t stop;
+
+/******************************************************************************
+* Function Definitions
+******************************************************************************/
+/*****************************************************************************/
+/*!
+ * Function used to get the wall clock.
+ *
+ * @return Microseconds of the monotonic clock.
+ */
+/*****************************************************************************/
+static uint64_t
+_micros(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/*****************************************************************************/
+/*!
+ * Function used to write a response to the pseudo terminal.
+ *
+ * @param data Pointer to the bytes of the response.
+ * @param size Number of bytes.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_output(const uint8_t* data, uint16_t size)
+{
+    if (write(master, data, size) != (ssize_t) size)
+    {
+        perror("wisol_emu: write");
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * Function called by SIGINT and SIGTERM.
+ *
+ * @param signal Signal number.
+ *
+ * @return None.
+ */
+/*****************************************************************************/
+static void
+_stop(int signal)
+{
+    (void) signal;
+    stop = 1;
+}
+
+int
+main(int argc, char* argv[])
+{
+    wisol_sim_config config;
+    const wisol_sim_stats* stats;
+    struct pollfd pty;
+    struct termios raw;
+    uint8_t data[64];
+    uint64_t start;
+    uint64_t due;
+    uint64_t now;
+    ssize_t size;
+    ssize_t i;
+    int timeout;
+    int option;
+
+    wisol_sim_default_config(&config);
+
+    while ( (option = getopt(argc, argv, "w:l:t:r:e:u:d:n")) != -1 )
+    {
+        switch (option)
+        {
+        case 'w':
+            config.wakeup_us = strtoul(optarg, NULL, 10) * 1000;
+            break;
+        case 'l':
+            config.latency_us = strtoul(optarg, NULL, 10) * 1000;
+            break;
+        case 't':
+            config.uplink_us = strtoul(optarg, NULL, 10) * 1000;
+            break;
+        case 'r':
+            config.downlink_us = strtoul(optarg, NULL, 10) * 1000;
+            break;
+        case 'e':
+            config.error_every = (uint8_t) strtoul(optarg, NULL, 10);
+            break;
+        case 'u':
+            config.uplinks_per_day = (uint16_t) strtoul(optarg, NULL, 10);
+            break;
+        case 'd':
+            config.downlinks_per_day = (uint8_t) strtoul(optarg, NULL, 10);
+            break;
+        case 'n':
+            config.downlink = NULL;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-w wakeup_ms] [-l latency_ms] "
+                    "[-t uplink_ms] [-r downlink_ms] [-e error_every] "
+                    "[-u uplinks_per_day] [-d downlinks_per_day] "
+                    "[-n (no downlink)]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ( (master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0) )
+    {
+        perror("wisol_emu: pseudo terminal");
+        return 1;
+    }
+
+    // No echo nor line editing, as a serial port
+    tcgetattr(master, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(master, TCSANOW, &raw);
+
+    signal(SIGINT, _stop);
+    signal(SIGTERM, _stop);
+    printf("%s\n", ptsname(master));
+    fflush(stdout);
+
+    start = _micros();
+    wisol_sim_init(&config, _output);
+    wisol_sim_enable(1, 0);
+
+    pty.fd = master;
+    pty.events = POLLIN;
+    while (!stop)
+    {
+        due = wisol_sim_poll(_micros() - start);
+        now = _micros() - start;
+        timeout = (due == WISOL_SIM_IDLE) ? -1 :
+                  (due <= now) ? 0 : (int) ((due - now + 999) / 1000);
+
+        if (poll(&pty, 1, timeout) <= 0)
+        {
+            continue;
+        }
+        if (pty.revents & POLLHUP)
+        {
+            // No process has the terminal open
+            usleep(100000);
+            continue;
+        }
+
+        size = read(master, data, sizeof(data));
+        now = _micros() - start;
+        for (i = 0; i < size; i++)
+        {
+            wisol_sim_receive(data[i], now);
+        }
+    }
+
+    wisol_sim_enable(0, _micros() - start);
+    stats = wisol_sim_get_stats();
+    fprintf(stderr, "\ncommands %lu, errors %lu, uplinks %lu, downlinks %lu, "
+            "lost bytes %lu\nlatency last %lu us, max %lu us, awake %lu ms\n",
+            (unsigned long) stats->commands, (unsigned long) stats->errors,
+            (unsigned long) stats->uplinks, (unsigned long) stats->downlinks,
+            (unsigned long) stats->lost,
+            (unsigned long) stats->last_latency_us,
+            (unsigned long) stats->max_latency_us,
+            (unsigned long) (stats->awake_us / 1000));
+
+    close(master);
+
+    return 0;
+}